@@ -17,6 +17,13 @@
 #define DRIVER_PWM_B        26     // PWM kanal B (IN2)
 #define DRIVER_ENABLE       27     // Enable pin (EN)
 
+// Ekstra sløjfer (LOOP_COUNT > 1): én H-bro pr. sløjfe med fælles IN1/IN2
+// og egen enable - kun den aktive sløjfes bro er tændt (tidsmultipleksing).
+// Sløjfe 0 bruger DRIVER_ENABLE.
+#define LOOP_ENABLE_PIN_1   14     // Enable for sløjfe 1
+#define LOOP_ENABLE_PIN_2   32     // Enable for sløjfe 2
+#define LOOP_ENABLE_PIN_3   33     // Enable for sløjfe 3
+
 // Strømmåling
 #define CURRENT_SENSE_PIN   34     // ADC til strømmåling (ADC1_CH6, input-only)
 
@@ -44,7 +51,7 @@
 #define PWM_CHANNEL_B           1       // LEDC kanal for PWM B
 
 // Signal duty cycle (justeres via potentiometer på DC/DC converter)
-#define SIGNAL_DUTY_CYCLE       128     // 50% duty cycle (0-255)
+#define SIGNAL_DUTY_CYCLE       128     // 50% duty cycle (0-255) - fast værdi når ADAPTIVE_POWER er false
 
 // ============================================================================
 // STRØM OVERVÅGNING
@@ -58,6 +65,41 @@
 #define CURRENT_SENSE_MV_PER_A  185     // mV per Ampere (ACS712-5A: 185mV/A)
 #define CURRENT_SENSE_OFFSET    2500    // Offset i mV (2.5V for ACS712)
 
+// ============================================================================
+// ADAPTIV SENDEEFFEKT
+// ============================================================================
+// Duty cycle reguleres så kabelstrømmen rammer CURRENT_TARGET_MA uanset
+// sløjfens længde. Ændringen pr. CURRENT_CHECK_INTERVAL er begrænset, så
+// signalet rampes blødt op ved start.
+
+#define ADAPTIVE_POWER          true    // Regulér duty cycle efter strøm (false = SIGNAL_DUTY_CYCLE)
+#define CURRENT_TARGET_MA       500     // Strøm setpunkt (mA) - ens feltstyrke på alle plæner
+#define DUTY_MIN                20      // Min duty cycle (0-255) - også start værdi
+#define DUTY_MAX                230     // Max duty cycle (0-255)
+#define DUTY_RAMP_STEP          4       // Max duty ændring pr. regulering
+#define POWER_GAIN              0.05    // Duty ændring pr. mA fejl (integral)
+
+// Termisk budget for H-broen (estimeret - ingen temperatur sensor)
+#define DRIVER_RESISTANCE_OHM   0.5     // H-bro samlet on-modstand (MC33926 ~ 2 x 0.225)
+#define DRIVER_RTH_C_PER_W      30.0    // Termisk modstand (°C/W) uden køleplade
+#define DRIVER_THERMAL_TAU_S    60.0    // Termisk tidskonstant (s)
+#define DRIVER_TEMP_RISE_MAX_C  40.0    // Max temperaturstigning før setpunktet sænkes
+#define DRIVER_DERATE_MIN       0.3     // Setpunktet sænkes aldrig under denne andel
+
+// ============================================================================
+// KABEL DIAGNOSTIK
+// ============================================================================
+// Strømmen samples synkront med bit mønsteret (sidst i hver halvperiode)
+// og evalueres pr. kode cyklus: amplitude, impedans og signal integritet.
+
+#define LOOP_DRIVE_VOLTAGE      12.0    // DC/DC output spænding (V) - sæt til potentiometer indstillingen
+#define WIRE_BREAK_CURRENT_MA   10      // Amplitude under denne = kabelbrud (åben sløjfe)
+#define WIRE_SHORT_OHM          2.0     // Impedans under denne = kortslutning (ohm)
+#define WIRE_DEGRADED_RATIO     1.3     // Impedans over baseline * ratio = dårlig samling/fugt
+#define WIRE_INTEGRITY_MIN      0.8     // Min signal integritet (0-1) før DEGRADED
+#define WIRE_BASELINE_CYCLES    20      // Cyklusser efter start der danner impedans baseline
+#define WIRE_FAULT_CYCLES       3       // Ens cyklusser i træk før status skifter
+
 // ============================================================================
 // TIMING KONSTANTER
 // ============================================================================
@@ -73,6 +115,13 @@
 #define WEB_SERVER_PORT         80      // HTTP server port
 #define MDNS_HOSTNAME           "perimeter-sender"  // mDNS navn
 
+// ============================================================================
+// UDP HEARTBEAT KONSTANTER
+// ============================================================================
+// Binær status kanal til robotten (se web/PerimeterProtocol.h)
+
+#define HEARTBEAT_INTERVAL      200     // Heartbeat broadcast interval (ms)
+
 // ============================================================================
 // WIFI KONSTANTER
 // ============================================================================
@@ -105,13 +154,22 @@
 // Ardumower kompatibel pseudo-random sekvens
 // Dette mønster gentages kontinuerligt
 
-// Signal kode sekvens (24 bits)
-// 1 = høj frekvens puls, 0 = lav frekvens puls
-#define SIGNAL_CODE_LENGTH      24
-static const uint8_t SIGNAL_CODE[SIGNAL_CODE_LENGTH] = {
-    1, 1, 0, 0, 0, 1, 0, 0,   // Byte 1
-    0, 0, 1, 1, 1, 0, 1, 0,   // Byte 2
-    1, 0, 1, 0, 0, 1, 1, 0    // Byte 3
+// Kode sekvenserne (24 bits, én pr. sløjfe) ligger i hardware/PerimeterCodes.h,
+// som deles med robottens modtager. Sløjfe 0 bruger den oprindelige
+// Ardumower kode. 1 = høj frekvens puls, 0 = lav frekvens puls
+
+// ============================================================================
+// FLERE SLØJFER
+// ============================================================================
+// Senderen kan drive op til 4 sløjfer (f.eks. plæne + bed + dam) på skift.
+// Hver sløjfe har sin egen kode, så robotten kan se hvilken sløjfe den er
+// tæt på. Strømregulering og kabel diagnostik kører pr. sløjfe.
+
+#define LOOP_COUNT              1       // Antal sløjfer (1-4, 1 = én sløjfe som hidtil)
+#define LOOP_SLOT_CYCLES        4       // Kode cyklusser pr. sløjfe før der skiftes
+
+static const uint8_t LOOP_ENABLE_PINS[4] = {
+    DRIVER_ENABLE, LOOP_ENABLE_PIN_1, LOOP_ENABLE_PIN_2, LOOP_ENABLE_PIN_3
 };
 
 // ============================================================================
@@ -126,4 +184,16 @@ enum SenderState {
     SENDER_OVERCURRENT
 };
 
+// ============================================================================
+// KABEL STATUS
+// ============================================================================
+
+enum WireStatus {
+    WIRE_UNKNOWN,       // Signalet kører ikke / ikke nok cyklusser endnu
+    WIRE_OK,
+    WIRE_OPEN,          // Ingen strøm - kabelbrud
+    WIRE_SHORT,         // For lav impedans - kortslutning
+    WIRE_DEGRADED       // Forhøjet impedans eller støjende strøm
+};
+
 #endif // CONFIG_H
@@ -0,0 +1,32 @@
+#ifndef PERIMETER_CODES_H
+#define PERIMETER_CODES_H
+
+#include <stdint.h>
+
+/**
+ * Perimeter koder - Én pseudo-random kode pr. sløjfe
+ *
+ * Hver bit sendes som én fuld periode: 1 = høj frekvens (4808 Hz),
+ * 0 = lav frekvens (2404 Hz). Sløjfe 0 er den oprindelige Ardumower
+ * kode. De øvrige er valgt så krydskorrelationen mellem to koders
+ * bølgeformer (alle faser, 192 samples à 104 us) højst er 0.42 af
+ * autokorrelationens top - modtageren kan dermed se hvilken sløjfe
+ * den er tættest på selv om de andre også kan høres.
+ *
+ * Filen findes både i src/hardware og perimeterwire_sender/src/hardware -
+ * de skal holdes ens.
+ */
+
+#define PERIMETER_CODE_LENGTH   24
+#define PERIMETER_LOOP_MAX      4
+#define PERIMETER_CODE_HIGH_HZ  4808    // Bit 1 (senderens SIGNAL_HIGH_FREQ)
+#define PERIMETER_CODE_LOW_HZ   2404    // Bit 0 (senderens SIGNAL_LOW_FREQ)
+
+static const uint8_t PERIMETER_LOOP_CODES[PERIMETER_LOOP_MAX][PERIMETER_CODE_LENGTH] = {
+    { 1, 1, 0, 0, 0, 1, 0, 0,  0, 0, 1, 1, 1, 0, 1, 0,  1, 0, 1, 0, 0, 1, 1, 0 },    // Sløjfe 0 (Ardumower)
+    { 0, 0, 0, 0, 1, 1, 1, 1,  0, 0, 0, 1, 0, 1, 1, 1,  0, 0, 0, 0, 1, 1, 1, 1 },    // Sløjfe 1
+    { 1, 1, 1, 1, 0, 0, 0, 0,  0, 0, 1, 1, 1, 0, 0, 1,  1, 0, 0, 0, 0, 0, 1, 0 },    // Sløjfe 2
+    { 0, 1, 0, 1, 0, 0, 1, 0,  0, 1, 0, 1, 0, 1, 1, 1,  1, 1, 0, 1, 0, 0, 1, 0 }     // Sløjfe 3
+};
+
+#endif // PERIMETER_CODES_H
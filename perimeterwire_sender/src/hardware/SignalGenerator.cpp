@@ -16,8 +16,21 @@ SignalGenerator::SignalGenerator()
     , _lastCurrentCheck(0)
     , _startTime(0)
     , _cycleCount(0)
+    , _activeLoop(0)
+    , _slotCycles(0)
+    , _switchPending(false)
+    , _derate(1.0f)
+    , _driverTempRise(0)
+    , _phaseActive(false)
+    , _phasePositive(true)
 {
     memset(_currentSamples, 0, sizeof(_currentSamples));
+    for (int i = 0; i < LOOP_COUNT; i++) {
+        _loops[i].enablePin = LOOP_ENABLE_PINS[i];
+        _loops[i].code = PERIMETER_LOOP_CODES[i];
+        resetLoop(_loops[i]);
+    }
+    resetSyncSamples();
 }
 
 // ============================================================================
@@ -32,7 +45,10 @@ bool SignalGenerator::begin() {
     // Konfigurer PWM pins
     pinMode(DRIVER_PWM_A, OUTPUT);
     pinMode(DRIVER_PWM_B, OUTPUT);
-    pinMode(DRIVER_ENABLE, OUTPUT);
+    for (int i = 0; i < LOOP_COUNT; i++) {
+        pinMode(_loops[i].enablePin, OUTPUT);
+        digitalWrite(_loops[i].enablePin, LOW);
+    }
 
     // Konfigurer strømmåling
     pinMode(CURRENT_SENSE_PIN, INPUT);
@@ -52,13 +68,13 @@ bool SignalGenerator::begin() {
     // Start med output off
     outputOff();
 
-    // Disable driver
-    digitalWrite(DRIVER_ENABLE, LOW);
-
     _initialized = true;
     _state = SENDER_OFF;
 
     Serial.println("[SignalGen] Initialization complete");
+    if (LOOP_COUNT > 1) {
+        Serial.printf("[SignalGen] %d loops, %d code cycles per slot\n", LOOP_COUNT, LOOP_SLOT_CYCLES);
+    }
     return true;
 }
 
@@ -80,8 +96,17 @@ void SignalGenerator::start() {
     _currentPolarity = true;
     _cycleCount = 0;
 
-    // Enable driver
-    digitalWrite(DRIVER_ENABLE, HIGH);
+    // Blød start og ny diagnostik for alle sløjfer - rampes op af updateDrive()
+    for (int i = 0; i < LOOP_COUNT; i++) {
+        resetLoop(_loops[i]);
+    }
+    resetSyncSamples();
+    _activeLoop = 0;
+    _slotCycles = 0;
+    _switchPending = false;
+
+    // Enable driver for første sløjfe
+    digitalWrite(_loops[_activeLoop].enablePin, HIGH);
     delay(10);  // Vent på driver stabilisering
 
     // Start signal
@@ -103,12 +128,18 @@ void SignalGenerator::stop() {
 
     _running = false;
     _state = SENDER_OFF;
+    _phaseActive = false;
+    for (int i = 0; i < LOOP_COUNT; i++) {
+        _loops[i].wire.status = WIRE_UNKNOWN;
+    }
 
     // Stop output
     outputOff();
 
-    // Disable driver
-    digitalWrite(DRIVER_ENABLE, LOW);
+    // Disable alle drivere
+    for (int i = 0; i < LOOP_COUNT; i++) {
+        digitalWrite(_loops[i].enablePin, LOW);
+    }
 
     // Sluk status LED
     digitalWrite(STATUS_LED_PIN, LOW);
@@ -129,6 +160,9 @@ void SignalGenerator::update() {
         if (_running) {
             checkOvercurrent();
         }
+
+        // Reguler sendeeffekt og termisk budget
+        updateDrive();
     }
 
     // Generer signal hvis kørende
@@ -161,6 +195,34 @@ void SignalGenerator::reset() {
     _currentSampleIndex = 0;
 }
 
+String SignalGenerator::getWireStatusString(uint8_t loop) const {
+    switch (_loops[loop].wire.status) {
+        case WIRE_OK:       return "OK";
+        case WIRE_OPEN:     return "OPEN";
+        case WIRE_SHORT:    return "SHORT";
+        case WIRE_DEGRADED: return "DEGRADED";
+        default:            return "UNKNOWN";
+    }
+}
+
+WireStatus SignalGenerator::getWorstWireStatus() const {
+    static const WireStatus severity[] = { WIRE_OPEN, WIRE_SHORT, WIRE_DEGRADED, WIRE_OK };
+
+    for (WireStatus status : severity) {
+        for (int i = 0; i < LOOP_COUNT; i++) {
+            if (_loops[i].wire.status == status) return status;
+        }
+    }
+    return WIRE_UNKNOWN;
+}
+
+float SignalGenerator::getDrivePower() const {
+    if (!_running) return 0;
+    const LoopChannel& loop = _loops[_activeLoop];
+    float amps = (loop.wire.cyclesEvaluated > 0 ? loop.wire.amplitudeMA : _currentMA) / 1000.0f;
+    return LOOP_DRIVE_VOLTAGE * loop.duty / 255.0f * amps;
+}
+
 unsigned long SignalGenerator::getRuntime() const {
     if (!_running || _startTime == 0) return 0;
     return millis() - _startTime;
@@ -176,8 +238,8 @@ void SignalGenerator::generateNextBit() {
     // Beregn tid siden sidste bit
     unsigned long elapsed = nowMicros - _lastBitTime;
 
-    // Hent nuværende bit fra koden
-    uint8_t currentBit = SIGNAL_CODE[_currentBitIndex];
+    // Hent nuværende bit fra den aktive sløjfes kode
+    uint8_t currentBit = _loops[_activeLoop].code[_currentBitIndex];
 
     // Beregn bit varighed baseret på frekvens
     unsigned long bitDuration;
@@ -191,20 +253,38 @@ void SignalGenerator::generateNextBit() {
     if (elapsed >= bitDuration) {
         _lastBitTime = nowMicros;
 
+        // Sample strømmen sidst i halvperioden der slutter nu (før skiftet)
+        if (_phaseActive) {
+            sampleSyncCurrent(_phasePositive);
+        }
+
+        // Næste sløjfe starter på en hel bit (positiv halvperiode)
+        if (_switchPending && _currentPolarity) {
+            switchLoop();
+        }
+        _phaseActive = true;
+        _phasePositive = _currentPolarity;
+        uint8_t duty = _loops[_activeLoop].duty;
+
         if (_currentPolarity) {
             // Positiv halvperiode: A høj, B lav
-            ledcWrite(PWM_CHANNEL_A, SIGNAL_DUTY_CYCLE);
+            ledcWrite(PWM_CHANNEL_A, duty);
             ledcWrite(PWM_CHANNEL_B, 0);
         } else {
             // Negativ halvperiode: A lav, B høj
             ledcWrite(PWM_CHANNEL_A, 0);
-            ledcWrite(PWM_CHANNEL_B, SIGNAL_DUTY_CYCLE);
+            ledcWrite(PWM_CHANNEL_B, duty);
 
             // Gå til næste bit efter fuld periode
             _currentBitIndex++;
-            if (_currentBitIndex >= SIGNAL_CODE_LENGTH) {
+            if (_currentBitIndex >= PERIMETER_CODE_LENGTH) {
                 _currentBitIndex = 0;
                 _cycleCount++;
+                evaluateCycle();
+
+                if (LOOP_COUNT > 1 && ++_slotCycles >= LOOP_SLOT_CYCLES) {
+                    _switchPending = true;
+                }
             }
         }
 
@@ -214,14 +294,14 @@ void SignalGenerator::generateNextBit() {
 
 void SignalGenerator::outputHighFrequency() {
     // Output ved høj frekvens (4808 Hz)
-    ledcWrite(PWM_CHANNEL_A, SIGNAL_DUTY_CYCLE);
+    ledcWrite(PWM_CHANNEL_A, _loops[_activeLoop].duty);
     ledcWrite(PWM_CHANNEL_B, 0);
 }
 
 void SignalGenerator::outputLowFrequency() {
     // Output ved lav frekvens (2404 Hz)
     ledcWrite(PWM_CHANNEL_A, 0);
-    ledcWrite(PWM_CHANNEL_B, SIGNAL_DUTY_CYCLE);
+    ledcWrite(PWM_CHANNEL_B, _loops[_activeLoop].duty);
 }
 
 void SignalGenerator::outputOff() {
@@ -229,7 +309,7 @@ void SignalGenerator::outputOff() {
     ledcWrite(PWM_CHANNEL_B, 0);
 }
 
-void SignalGenerator::updateCurrentReading() {
+float SignalGenerator::readCurrentMA() {
     // Læs ADC værdi
     int adcValue = analogRead(CURRENT_SENSE_PIN);
 
@@ -237,8 +317,12 @@ void SignalGenerator::updateCurrentReading() {
     float voltage_mV = (adcValue / 4095.0) * 3300.0;
 
     // Konverter til strøm (mA) - baseret på ACS712-5A sensor
-    // Output er 2.5V ved 0A, 185mV per A
-    float current_mA = (voltage_mV - CURRENT_SENSE_OFFSET) / (CURRENT_SENSE_MV_PER_A / 1000.0);
+    // Output er 2.5V ved 0A, 185mV per A (fortegn = strømretning)
+    return (voltage_mV - CURRENT_SENSE_OFFSET) / (CURRENT_SENSE_MV_PER_A / 1000.0);
+}
+
+void SignalGenerator::updateCurrentReading() {
+    float current_mA = readCurrentMA();
 
     // Gem i samples array
     _currentSamples[_currentSampleIndex] = abs(current_mA);
@@ -254,8 +338,7 @@ void SignalGenerator::updateCurrentReading() {
     #if DEBUG_CURRENT
     static unsigned long lastDebug = 0;
     if (millis() - lastDebug >= 5000) {
-        Serial.printf("[SignalGen] Current: %.1f mA (ADC: %d, V: %.1f mV)\n",
-                     _currentMA, adcValue, voltage_mV);
+        Serial.printf("[SignalGen] Current: %.1f mA (sample: %.1f mA)\n", _currentMA, current_mA);
         lastDebug = millis();
     }
     #endif
@@ -275,3 +358,170 @@ void SignalGenerator::checkOvercurrent() {
         Serial.printf("[SignalGen] Current warning: %.1f mA\n", _currentMA);
     }
 }
+
+void SignalGenerator::sampleSyncCurrent(bool positive) {
+    float current_mA = readCurrentMA();
+    int phase = positive ? 0 : 1;
+
+    _syncSum[phase] += current_mA;
+    _syncSumSq[phase] += current_mA * current_mA;
+    _syncCount[phase]++;
+}
+
+void SignalGenerator::evaluateCycle() {
+    if (_syncCount[0] == 0 || _syncCount[1] == 0) {
+        return;     // Første cyklus efter start mangler samples
+    }
+
+    LoopChannel& loop = _loops[_activeLoop];
+    WireDiagnostics& wire = loop.wire;
+
+    float meanPos = _syncSum[0] / _syncCount[0];
+    float meanNeg = _syncSum[1] / _syncCount[1];
+
+    // Støj = samlet standardafvigelse indenfor faserne
+    float varPos = _syncSumSq[0] / _syncCount[0] - meanPos * meanPos;
+    float varNeg = _syncSumSq[1] / _syncCount[1] - meanNeg * meanNeg;
+    float noise = sqrtf(max(0.0f, (varPos + varNeg) / 2.0f));
+
+    // Fortegn afhænger af hvilken vej sensoren er monteret
+    wire.amplitudeMA = fabsf(meanPos - meanNeg) / 2.0f;
+    wire.offsetMA = (meanPos + meanNeg) / 2.0f;
+    wire.cyclesEvaluated++;
+
+    float driveVoltage = LOOP_DRIVE_VOLTAGE * loop.duty / 255.0f;
+
+    WireStatus status;
+    if (wire.amplitudeMA < WIRE_BREAK_CURRENT_MA) {
+        wire.impedanceOhm = 0;
+        wire.integrity = 0;
+        status = WIRE_OPEN;
+    } else {
+        wire.impedanceOhm = driveVoltage * 1000.0f / wire.amplitudeMA;
+        wire.integrity = constrain(1.0f - noise / wire.amplitudeMA, 0.0f, 1.0f);
+
+        if (wire.impedanceOhm < WIRE_SHORT_OHM) {
+            status = WIRE_SHORT;
+        } else if (wire.integrity < WIRE_INTEGRITY_MIN ||
+                   (wire.baselineOhm > 0 && wire.impedanceOhm > wire.baselineOhm * WIRE_DEGRADED_RATIO)) {
+            status = WIRE_DEGRADED;
+        } else {
+            status = WIRE_OK;
+
+            // Baseline dannes af de første gode cyklusser efter opstarts rampen
+            if (loop.rampDone && loop.baselineCycles < WIRE_BASELINE_CYCLES) {
+                loop.baselineSum += wire.impedanceOhm;
+                loop.baselineCycles++;
+                if (loop.baselineCycles == WIRE_BASELINE_CYCLES) {
+                    wire.baselineOhm = loop.baselineSum / WIRE_BASELINE_CYCLES;
+                    Serial.printf("[SignalGen] Loop %d wire baseline: %.1f ohm\n", _activeLoop, wire.baselineOhm);
+                }
+            }
+        }
+    }
+
+    // Nulstil til næste cyklus
+    resetSyncSamples();
+
+    // Status skifter først efter WIRE_FAULT_CYCLES ens cyklusser i træk
+    if (status != loop.pendingStatus) {
+        loop.pendingStatus = status;
+        loop.pendingCycles = 0;
+    }
+    if (loop.pendingCycles < WIRE_FAULT_CYCLES) {
+        loop.pendingCycles++;
+    }
+    if (loop.pendingCycles >= WIRE_FAULT_CYCLES && status != wire.status) {
+        wire.status = status;
+        Serial.printf("[SignalGen] Loop %d wire status: %s (%.0f mA, %.1f ohm, integrity %.2f)\n",
+                     _activeLoop, getWireStatusString(_activeLoop).c_str(),
+                     wire.amplitudeMA, wire.impedanceOhm, wire.integrity);
+    }
+}
+
+void SignalGenerator::resetLoop(LoopChannel& loop) {
+    memset(&loop.wire, 0, sizeof(loop.wire));
+    loop.wire.status = WIRE_UNKNOWN;
+    loop.pendingStatus = WIRE_UNKNOWN;
+    loop.pendingCycles = 0;
+    loop.baselineSum = 0;
+    loop.baselineCycles = 0;
+
+    // Blød start med ADAPTIVE_POWER, ellers fast duty cycle
+    loop.duty = ADAPTIVE_POWER ? DUTY_MIN : SIGNAL_DUTY_CYCLE;
+    loop.dutyF = loop.duty;
+    loop.rampDone = !ADAPTIVE_POWER;
+}
+
+void SignalGenerator::resetSyncSamples() {
+    memset(_syncSum, 0, sizeof(_syncSum));
+    memset(_syncSumSq, 0, sizeof(_syncSumSq));
+    memset(_syncCount, 0, sizeof(_syncCount));
+}
+
+void SignalGenerator::switchLoop() {
+    // Kun én bro tændt ad gangen - sluk den gamle før den nye tændes
+    outputOff();
+    digitalWrite(_loops[_activeLoop].enablePin, LOW);
+
+    _activeLoop = (_activeLoop + 1) % LOOP_COUNT;
+    digitalWrite(_loops[_activeLoop].enablePin, HIGH);
+
+    // Samples fra forrige sløjfes sidste halvperiode hører ikke til den nye
+    resetSyncSamples();
+    _slotCycles = 0;
+    _switchPending = false;
+}
+
+void SignalGenerator::updateDrive() {
+    LoopChannel& loop = _loops[_activeLoop];
+
+    // Synkron amplitude når den findes - ellers gennemsnittet
+    float measured = (_running && loop.wire.cyclesEvaluated > 0) ? loop.wire.amplitudeMA : _currentMA;
+    updateThermal(_running ? measured : 0);
+
+    #if ADAPTIVE_POWER
+    if (!_running || _state != SENDER_RUNNING) return;
+
+    // Kabelbrud: skru ikke op mod en åben sløjfe. Kortslutning: mindst muligt
+    if (loop.wire.status == WIRE_OPEN) return;
+    if (loop.wire.status == WIRE_SHORT) {
+        loop.dutyF = DUTY_MIN;
+        loop.duty = DUTY_MIN;
+        return;
+    }
+
+    float target = CURRENT_TARGET_MA * _derate;
+    float step = constrain(POWER_GAIN * (target - measured), -DUTY_RAMP_STEP, DUTY_RAMP_STEP);
+    loop.dutyF = constrain(loop.dutyF + step, DUTY_MIN, DUTY_MAX);
+    loop.duty = (uint8_t)(loop.dutyF + 0.5f);
+
+    if (!loop.rampDone && (measured >= target * 0.95f || loop.duty >= DUTY_MAX)) {
+        loop.rampDone = true;
+        Serial.printf("[SignalGen] Loop %d ramp done: %.0f mA at duty %d%s\n",
+                     _activeLoop, measured, loop.duty, loop.duty >= DUTY_MAX ? " (max - long loop?)" : "");
+    }
+    #endif
+}
+
+void SignalGenerator::updateThermal(float currentMA) {
+    // Første ordens model: stigningen nærmer sig P * Rth med tidskonstant tau
+    float amps = currentMA / 1000.0f;
+    float power = amps * amps * DRIVER_RESISTANCE_OHM;
+    float dt = CURRENT_CHECK_INTERVAL / 1000.0f;
+    _driverTempRise += (power * DRIVER_RTH_C_PER_W - _driverTempRise) * dt / DRIVER_THERMAL_TAU_S;
+
+    // Sænk setpunktet langsomt over budgettet, hæv igen med lidt hysterese
+    float previous = _derate;
+    if (_driverTempRise > DRIVER_TEMP_RISE_MAX_C) {
+        _derate = max((float)DRIVER_DERATE_MIN, _derate - 0.01f);
+    } else if (_driverTempRise < DRIVER_TEMP_RISE_MAX_C * 0.9f) {
+        _derate = min(1.0f, _derate + 0.01f);
+    }
+
+    if (previous >= 1.0f && _derate < 1.0f) {
+        Serial.printf("[SignalGen] Thermal derating (est. +%.1f C)\n", _driverTempRise);
+    } else if (previous < 1.0f && _derate >= 1.0f) {
+        Serial.println("[SignalGen] Thermal derating ended");
+    }
+}
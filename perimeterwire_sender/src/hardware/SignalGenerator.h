@@ -3,6 +3,38 @@
 
 #include <Arduino.h>
 #include "../config/Config.h"
+#include "PerimeterCodes.h"
+
+/**
+ * Kabel diagnostik fra seneste evaluerede kode cyklus
+ */
+struct WireDiagnostics {
+    WireStatus status;
+    float amplitudeMA;      // Halv peak-peak strøm (positiv - negativ fase) / 2
+    float offsetMA;         // DC offset (sensor nulpunkt drift / asymmetrisk driver)
+    float impedanceOhm;     // Sløjfe impedans (drivspænding / amplitude)
+    float baselineOhm;      // Impedans målt de første cyklusser efter start (0 = ikke klar)
+    float integrity;        // 1 - støj/amplitude (1.0 = rent signal)
+    unsigned long cyclesEvaluated;
+};
+
+static_assert(LOOP_COUNT >= 1 && LOOP_COUNT <= PERIMETER_LOOP_MAX, "LOOP_COUNT skal være 1-4");
+
+/**
+ * Én sløjfe: enable pin, kode, sendeeffekt og diagnostik
+ */
+struct LoopChannel {
+    uint8_t enablePin;
+    const uint8_t* code;        // PERIMETER_CODE_LENGTH bits
+    uint8_t duty;
+    float dutyF;                // Regulatorens integrator (duty med decimaler)
+    bool rampDone;
+    WireDiagnostics wire;
+    WireStatus pendingStatus;
+    uint8_t pendingCycles;
+    float baselineSum;
+    uint16_t baselineCycles;
+};
 
 /**
  * SignalGenerator - Genererer perimeter wire signal
@@ -12,6 +44,20 @@
  *
  * Signalet skifter mellem høj (4808 Hz) og lav (2404 Hz) pulsbredde
  * baseret på en kodet sekvens.
+ *
+ * Strømmen samples desuden synkront med mønsteret - sidst i hver
+ * halvperiode hvor strømmen har stabiliseret sig - og evalueres pr.
+ * kode cyklus, så kabelbrud, kortslutning og en dårlig samling kan
+ * skelnes fra hinanden (se getWireDiagnostics()).
+ *
+ * Med ADAPTIVE_POWER reguleres duty cycle så strømmen rammer
+ * CURRENT_TARGET_MA: signalet starter på DUTY_MIN og rampes op, og
+ * setpunktet sænkes hvis H-broens estimerede temperatur bliver for høj.
+ *
+ * Med LOOP_COUNT > 1 drives sløjferne på skift (LOOP_SLOT_CYCLES kode
+ * cyklusser hver) med hver sin kode fra PerimeterCodes.h. Sendeeffekt
+ * og diagnostik holdes pr. sløjfe, så forskellige længder reguleres
+ * hver for sig. Metoder med loop parameter gælder sløjfe 0 som standard.
  */
 class SignalGenerator {
 public:
@@ -79,6 +125,67 @@ public:
     unsigned long getRuntime() const;
     unsigned long getCycleCount() const { return _cycleCount; }
 
+    /**
+     * Henter aktuel duty cycle (0-255)
+     * @param loop Sløjfe
+     */
+    uint8_t getDuty(uint8_t loop = 0) const { return _loops[loop].duty; }
+
+    /**
+     * Henter strøm setpunkt efter termisk derating (mA)
+     */
+    float getTargetMA() const { return CURRENT_TARGET_MA * _derate; }
+
+    /**
+     * Henter termisk derating (1.0 = fuldt setpunkt)
+     */
+    float getDerate() const { return _derate; }
+
+    /**
+     * Henter H-broens estimerede temperaturstigning (°C)
+     */
+    float getDriverTempRise() const { return _driverTempRise; }
+
+    /**
+     * Henter estimeret effekt leveret til den aktive sløjfe (W)
+     */
+    float getDrivePower() const;
+
+    /**
+     * Er opstarts rampen færdig (strømmen har nået setpunktet)?
+     * @param loop Sløjfe
+     */
+    bool isRampDone(uint8_t loop = 0) const { return _loops[loop].rampDone; }
+
+    /**
+     * Henter kabel diagnostik
+     * @param loop Sløjfe
+     * @return Seneste evaluering (status WIRE_UNKNOWN når signalet ikke kører)
+     */
+    const WireDiagnostics& getWireDiagnostics(uint8_t loop = 0) const { return _loops[loop].wire; }
+
+    /**
+     * Henter kabel status som tekst
+     * @param loop Sløjfe
+     */
+    String getWireStatusString(uint8_t loop = 0) const;
+
+    /**
+     * Henter den værste kabel status på tværs af sløjferne
+     * (OPEN før SHORT før DEGRADED før OK)
+     */
+    WireStatus getWorstWireStatus() const;
+
+    /**
+     * Antal sløjfer
+     */
+    uint8_t getLoopCount() const { return LOOP_COUNT; }
+
+    /**
+     * Sløjfen der drives lige nu
+     */
+    uint8_t getActiveLoop() const { return _activeLoop; }
+
 private:
     bool _running;
     bool _initialized;
@@ -99,11 +206,37 @@ private:
     unsigned long _startTime;
     unsigned long _cycleCount;
 
+    // Sløjfer (tidsmultipleksing)
+    LoopChannel _loops[LOOP_COUNT];
+    uint8_t _activeLoop;
+    uint8_t _slotCycles;        // Cyklusser på den aktive sløjfe
+    bool _switchPending;        // Skift sløjfe ved starten af næste bit
+
+    // Termisk budget (fælles for alle sløjfer)
+    float _derate;
+    float _driverTempRise;
+
+    // Synkron strømmåling for indeværende kode cyklus (pr. fase: sum, sum af kvadrater, antal)
+    bool _phaseActive;          // En halvperiode er i gang og kan samples ved næste skift
+    bool _phasePositive;        // Polaritet for halvperioden i gang
+    float _syncSum[2];
+    float _syncSumSq[2];
+    uint16_t _syncCount[2];
+
+
     // Private metoder
     void outputHighFrequency();
     void outputLowFrequency();
     void outputOff();
     void updateCurrentReading();
+    float readCurrentMA();
+    void sampleSyncCurrent(bool positive);
+    void evaluateCycle();
+    void resetLoop(LoopChannel& loop);
+    void resetSyncSamples();
+    void switchLoop();
+    void updateDrive();
+    void updateThermal(float currentMA);
     void checkOvercurrent();
     void generateNextBit();
 };
@@ -14,12 +14,17 @@
  * - 3.2 kHz carrier frekvens
  * - Pseudo-random kodning (Ardumower kompatibel)
  * - Justerbar strøm via potentiometer (maks 1A)
+ * - Adaptiv duty cycle mod strøm setpunkt med blød start (ADAPTIVE_POWER)
  *
  * API Endpoints:
  * - GET  /api/status - Hent status
  * - POST /api/start  - Start signal
  * - POST /api/stop   - Stop signal
  * - POST /api/reset  - Reset efter fejl
+ *
+ * UDP (se web/PerimeterProtocol.h):
+ * - Heartbeat broadcast til port 4210 hvert 200 ms
+ * - Start/stop/reset kommandoer på port 4211 (kvitteres med ack)
  * ============================================================================
  */
 
@@ -27,6 +32,7 @@
 #include "config/Config.h"
 #include "hardware/SignalGenerator.h"
 #include "web/WebServer.h"
+#include "web/UdpLink.h"
 
 // ============================================================================
 // GLOBAL OBJECTS
@@ -34,6 +40,7 @@
 
 SignalGenerator signalGen;
 PerimeterWebServer webServer;
+UdpLink udpLink;
 
 // Timing
 unsigned long lastStatusUpdate = 0;
@@ -76,6 +83,11 @@ void setup() {
     }
     Serial.println("[Main] Web server ready");
 
+    // Initialize UDP heartbeat (efter WiFi er startet af web serveren)
+    if (!udpLink.begin(&signalGen)) {
+        Serial.println("[Main] WARNING: UDP heartbeat not available");
+    }
+
     // Print access information
     Serial.println();
     Serial.println("============================================");
@@ -99,6 +111,9 @@ void loop() {
     // Update web server
     webServer.update();
 
+    // Heartbeat og UDP kommandoer
+    udpLink.update();
+
     // Periodic status update
     unsigned long now = millis();
     if (now - lastStatusUpdate >= STATUS_UPDATE_INTERVAL) {
@@ -127,6 +142,9 @@ void printStartupBanner() {
     Serial.println("============================================");
     Serial.printf("   Signal: %d Hz carrier\n", SIGNAL_CARRIER_FREQ);
     Serial.printf("   Max current: %d mA\n", CURRENT_MAX_MA);
+    #if ADAPTIVE_POWER
+    Serial.printf("   Target current: %d mA (adaptive)\n", CURRENT_TARGET_MA);
+    #endif
     Serial.println("============================================");
     Serial.println();
 }
@@ -148,12 +166,16 @@ void updateStatus() {
 void checkSignalHealth() {
     if (!signalGen.isRunning()) return;
 
-    // Tjek for lav strøm (kan indikere kabelbrud)
-    float current = signalGen.getCurrentMA();
-    if (current < 10 && signalGen.getRuntime() > 5000) {
-        Serial.println("[Health] WARNING: Very low current - check cable connection!");
+    // Kabel diagnostik (kabelbrud, kortslutning, dårlig samling)
+    const WireDiagnostics& wire = signalGen.getWireDiagnostics();
+    if (wire.status == WIRE_OPEN || wire.status == WIRE_SHORT || wire.status == WIRE_DEGRADED) {
+        Serial.printf("[Health] WARNING: Wire %s - %.0f mA, %.1f ohm (baseline %.1f), integrity %.2f\n",
+                     signalGen.getWireStatusString().c_str(), wire.amplitudeMA, wire.impedanceOhm,
+                     wire.baselineOhm, wire.integrity);
     }
 
+    float current = signalGen.getCurrentMA();
+
     // Tjek for ustabil strøm
     static float lastCurrent = 0;
     float diff = abs(current - lastCurrent);
@@ -0,0 +1,151 @@
+#ifndef PERIMETER_PROTOCOL_H
+#define PERIMETER_PROTOCOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+/**
+ * Perimeter UDP protokol - Binær kanal mellem sender og robot
+ *
+ * Senderen broadcaster et heartbeat flere gange i sekundet med tilstand,
+ * kabelstrøm, cycle count og fejlkode. Robotten sender kommandoer til
+ * senderen på samme kanal, og senderen kvitterer med et ack der bærer
+ * kommandoens sekvensnummer.
+ *
+ * Alle pakker starter med PerimeterPacketHeader. Felter er little-endian
+ * (ESP32 og x86 host er begge little-endian) og strukturerne er pakkede,
+ * så de kan kopieres direkte til og fra UDP bufferen.
+ *
+ * Filen findes både i src/system og perimeterwire_sender/src/web - de
+ * skal holdes ens. Ingen Arduino afhængigheder, så host værktøjerne i
+ * tools/perimeter_link kan bruge den direkte.
+ */
+
+#define PERIMETER_UDP_MAGIC         0x5750  // "PW"
+#define PERIMETER_UDP_VERSION       1
+#define PERIMETER_UDP_MOWER_PORT    4210    // Robotten lytter her (heartbeat + ack)
+#define PERIMETER_UDP_SENDER_PORT   4211    // Senderen lytter her (kommandoer)
+
+/**
+ * Pakketyper
+ */
+enum PerimeterPacketType {
+    PERIMETER_PKT_HEARTBEAT = 1,    // Sender -> robot
+    PERIMETER_PKT_COMMAND   = 2,    // Robot -> sender
+    PERIMETER_PKT_ACK       = 3     // Sender -> robot
+};
+
+/**
+ * Kommandoer (samme betydning som HTTP /api/start, /api/stop, /api/reset)
+ */
+enum PerimeterLinkCommand {
+    PERIMETER_LINK_START = 1,
+    PERIMETER_LINK_STOP  = 2,
+    PERIMETER_LINK_RESET = 3
+};
+
+/**
+ * Sender tilstand i heartbeat (svarer til SenderState på senderen)
+ */
+enum PerimeterLinkState {
+    PERIMETER_LINK_OFF          = 0,
+    PERIMETER_LINK_STARTING     = 1,
+    PERIMETER_LINK_RUNNING      = 2,
+    PERIMETER_LINK_ERROR        = 3,
+    PERIMETER_LINK_OVERCURRENT  = 4
+};
+
+/**
+ * Fejlkoder i heartbeat og ack
+ */
+enum PerimeterLinkError {
+    PERIMETER_LINK_OK           = 0,
+    PERIMETER_LINK_ERR_OVERCURRENT = 1,  // Strøm over CURRENT_MAX_MA
+    PERIMETER_LINK_ERR_WIRE_BREAK  = 2,  // Ingen strøm mens signalet kører
+    PERIMETER_LINK_ERR_REJECTED    = 3,  // Kommando afvist (ack)
+    PERIMETER_LINK_ERR_SHORT       = 4,  // Sløjfe impedans for lav
+    PERIMETER_LINK_ERR_DEGRADED    = 5   // Forhøjet impedans/støj - advarsel, signalet kører stadig
+};
+
+#pragma pack(push, 1)
+
+struct PerimeterPacketHeader {
+    uint16_t magic;
+    uint8_t version;
+    uint8_t type;           // PerimeterPacketType
+    uint16_t sequence;      // Stigende pr. afsender
+};
+
+struct PerimeterHeartbeat {
+    PerimeterPacketHeader header;
+    uint8_t state;          // PerimeterLinkState
+    uint8_t error;          // PerimeterLinkError
+    uint16_t currentMA;     // Kabelstrøm
+    uint32_t cycleCount;    // Udsendte kode cyklusser siden start
+    uint32_t runtimeMs;     // Tid siden signalet startede
+    uint32_t uptimeMs;      // Senderens millis()
+};
+
+struct PerimeterCommandPacket {
+    PerimeterPacketHeader header;
+    uint8_t command;        // PerimeterLinkCommand
+};
+
+struct PerimeterAckPacket {
+    PerimeterPacketHeader header;
+    uint16_t ackSequence;   // Sekvensnummer fra kommandoen
+    uint8_t command;        // PerimeterLinkCommand
+    uint8_t error;          // PERIMETER_LINK_OK eller fejlkode
+    uint8_t state;          // Tilstand efter kommandoen
+};
+
+#pragma pack(pop)
+
+/**
+ * Udfyld pakke header
+ */
+inline void perimeterInitHeader(PerimeterPacketHeader& header, PerimeterPacketType type, uint16_t sequence) {
+    header.magic = PERIMETER_UDP_MAGIC;
+    header.version = PERIMETER_UDP_VERSION;
+    header.type = (uint8_t)type;
+    header.sequence = sequence;
+}
+
+/**
+ * Tjek modtaget pakke og returnér typen
+ * @param data Modtagne bytes
+ * @param length Antal bytes
+ * @return PerimeterPacketType, eller 0 hvis pakken er ugyldig
+ */
+inline uint8_t perimeterPacketType(const uint8_t* data, size_t length) {
+    if (length < sizeof(PerimeterPacketHeader)) {
+        return 0;
+    }
+
+    PerimeterPacketHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != PERIMETER_UDP_MAGIC || header.version != PERIMETER_UDP_VERSION) {
+        return 0;
+    }
+
+    size_t expected = 0;
+    switch (header.type) {
+        case PERIMETER_PKT_HEARTBEAT:   expected = sizeof(PerimeterHeartbeat); break;
+        case PERIMETER_PKT_COMMAND:     expected = sizeof(PerimeterCommandPacket); break;
+        case PERIMETER_PKT_ACK:         expected = sizeof(PerimeterAckPacket); break;
+        default:                        return 0;
+    }
+
+    // Nyere versioner må tilføje felter i enden
+    return length >= expected ? header.type : 0;
+}
+
+/**
+ * Er sekvensnummer a nyere end b? (håndterer wrap ved 65535)
+ */
+inline bool perimeterSequenceNewer(uint16_t a, uint16_t b) {
+    return (int16_t)(a - b) > 0;
+}
+
+#endif // PERIMETER_PROTOCOL_H
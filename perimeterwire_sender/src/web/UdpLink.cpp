@@ -0,0 +1,148 @@
+#include "UdpLink.h"
+
+UdpLink::UdpLink()
+    : _signalGen(nullptr),
+      _running(false),
+      _sequence(0),
+      _heartbeatCount(0),
+      _lastHeartbeat(0),
+      _lastState(PERIMETER_LINK_OFF),
+      _lastError(PERIMETER_LINK_OK),
+      _lastCommandSequence(0),
+      _hasLastCommand(false) {
+    memset(&_lastAck, 0, sizeof(_lastAck));
+}
+
+bool UdpLink::begin(SignalGenerator* signalGen) {
+    _signalGen = signalGen;
+
+    if (!_udp.begin(PERIMETER_UDP_SENDER_PORT)) {
+        Serial.println("[UdpLink] ERROR: Could not open UDP port");
+        return false;
+    }
+
+    _running = true;
+    Serial.printf("[UdpLink] Heartbeat every %d ms to port %d, commands on port %d\n",
+                 HEARTBEAT_INTERVAL, PERIMETER_UDP_MOWER_PORT, PERIMETER_UDP_SENDER_PORT);
+    return true;
+}
+
+void UdpLink::update() {
+    if (!_running || !_signalGen) return;
+
+    // Kommandoer - læs højst få pakker pr. loop
+    for (int i = 0; i < 4; i++) {
+        int size = _udp.parsePacket();
+        if (size <= 0) break;
+
+        uint8_t buffer[32];
+        int length = _udp.read(buffer, sizeof(buffer));
+        if (length <= 0) continue;
+
+        if (perimeterPacketType(buffer, length) == PERIMETER_PKT_COMMAND) {
+            PerimeterCommandPacket packet;
+            memcpy(&packet, buffer, sizeof(packet));
+            handleCommand(packet);
+        }
+    }
+
+    // Heartbeat - periodisk, og med det samme ved tilstands- eller fejlskift
+    uint8_t state = (uint8_t)_signalGen->getState();
+    uint8_t error = getLinkError();
+    unsigned long now = millis();
+
+    if (now - _lastHeartbeat >= HEARTBEAT_INTERVAL || state != _lastState || error != _lastError) {
+        if (error != _lastError && error != PERIMETER_LINK_OK) {
+            Serial.printf("[UdpLink] Reporting error %d (current %.0f mA)\n", error, _signalGen->getCurrentMA());
+        }
+        _lastState = state;
+        _lastError = error;
+        _lastHeartbeat = now;
+        sendHeartbeat();
+    }
+}
+
+uint8_t UdpLink::getLinkError() const {
+    if (!_signalGen) return PERIMETER_LINK_OK;
+
+    if (_signalGen->getState() == SENDER_OVERCURRENT) {
+        return PERIMETER_LINK_ERR_OVERCURRENT;
+    }
+
+    if (!_signalGen->isRunning()) return PERIMETER_LINK_OK;
+
+    // Synkron kabel diagnostik (se SignalGenerator::evaluateCycle) - værste sløjfe
+    switch (_signalGen->getWorstWireStatus()) {
+        case WIRE_OPEN:     return PERIMETER_LINK_ERR_WIRE_BREAK;
+        case WIRE_SHORT:    return PERIMETER_LINK_ERR_SHORT;
+        case WIRE_DEGRADED: return PERIMETER_LINK_ERR_DEGRADED;
+        default:            return PERIMETER_LINK_OK;
+    }
+}
+
+void UdpLink::sendHeartbeat() {
+    PerimeterHeartbeat heartbeat;
+    perimeterInitHeader(heartbeat.header, PERIMETER_PKT_HEARTBEAT, ++_sequence);
+    heartbeat.state = _lastState;
+    heartbeat.error = _lastError;
+    heartbeat.currentMA = (uint16_t)constrain(_signalGen->getCurrentMA(), 0.0f, 65535.0f);
+    heartbeat.cycleCount = _signalGen->getCycleCount();
+    heartbeat.runtimeMs = _signalGen->getRuntime();
+    heartbeat.uptimeMs = millis();
+
+    _udp.beginPacket(IPAddress(255, 255, 255, 255), PERIMETER_UDP_MOWER_PORT);
+    _udp.write((const uint8_t*)&heartbeat, sizeof(heartbeat));
+    _udp.endPacket();
+    _heartbeatCount++;
+}
+
+void UdpLink::handleCommand(const PerimeterCommandPacket& packet) {
+    IPAddress remote = _udp.remoteIP();
+
+    // Gensendelse (ack gik tabt) - kvittér igen uden at udføre kommandoen
+    if (_hasLastCommand && remote == _lastCommandIP && packet.header.sequence == _lastCommandSequence) {
+        sendAck(_lastAck);
+        return;
+    }
+
+    PerimeterAckPacket ack;
+    perimeterInitHeader(ack.header, PERIMETER_PKT_ACK, ++_sequence);
+    ack.ackSequence = packet.header.sequence;
+    ack.command = packet.command;
+    ack.error = PERIMETER_LINK_OK;
+
+    switch (packet.command) {
+        case PERIMETER_LINK_START:
+            Serial.println("[UdpLink] Start command");
+            _signalGen->start();
+            if (!_signalGen->isRunning()) {
+                ack.error = PERIMETER_LINK_ERR_REJECTED;
+            }
+            break;
+        case PERIMETER_LINK_STOP:
+            Serial.println("[UdpLink] Stop command");
+            _signalGen->stop();
+            break;
+        case PERIMETER_LINK_RESET:
+            Serial.println("[UdpLink] Reset command");
+            _signalGen->reset();
+            break;
+        default:
+            ack.error = PERIMETER_LINK_ERR_REJECTED;
+            break;
+    }
+    ack.state = (uint8_t)_signalGen->getState();
+
+    _lastCommandIP = remote;
+    _lastCommandSequence = packet.header.sequence;
+    _lastAck = ack;
+    _hasLastCommand = true;
+
+    sendAck(ack);
+}
+
+void UdpLink::sendAck(const PerimeterAckPacket& ack) {
+    _udp.beginPacket(_udp.remoteIP(), _udp.remotePort());
+    _udp.write((const uint8_t*)&ack, sizeof(ack));
+    _udp.endPacket();
+}
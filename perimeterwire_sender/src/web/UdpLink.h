@@ -0,0 +1,70 @@
+#ifndef UDP_LINK_H
+#define UDP_LINK_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WiFiUdp.h>
+#include "../config/Config.h"
+#include "../hardware/SignalGenerator.h"
+#include "PerimeterProtocol.h"
+
+/**
+ * UdpLink - Binær status- og kommandokanal til robotten
+ *
+ * Broadcaster et heartbeat hvert HEARTBEAT_INTERVAL ms (og med det samme
+ * når tilstand eller fejlkode skifter) med tilstand, kabelstrøm, cycle
+ * count og fejlkode. Modtager start/stop/reset kommandoer og kvitterer
+ * med et ack til afsenderen. En gensendt kommando (samme sekvens fra
+ * samme robot) udføres ikke igen - kun ack gensendes.
+ *
+ * HTTP API'et i PerimeterWebServer virker uændret ved siden af.
+ */
+class UdpLink {
+public:
+    UdpLink();
+
+    /**
+     * Åbner UDP socket
+     * @param signalGen Pointer til signal generator
+     * @return true hvis socket blev åbnet
+     */
+    bool begin(SignalGenerator* signalGen);
+
+    /**
+     * Sender heartbeat og behandler kommandoer (skal kaldes i loop, blokerer ikke)
+     */
+    void update();
+
+    /**
+     * Fejlkode der sendes i heartbeat (PerimeterLinkError)
+     */
+    uint8_t getLinkError() const;
+
+    /**
+     * Antal sendte heartbeats
+     */
+    uint32_t getHeartbeatCount() const { return _heartbeatCount; }
+
+private:
+    WiFiUDP _udp;
+    SignalGenerator* _signalGen;
+    bool _running;
+
+    uint16_t _sequence;
+    uint32_t _heartbeatCount;
+    unsigned long _lastHeartbeat;
+    uint8_t _lastState;
+    uint8_t _lastError;
+
+    // Seneste udførte kommando (til at genkende gensendelser)
+    IPAddress _lastCommandIP;
+    uint16_t _lastCommandSequence;
+    bool _hasLastCommand;
+    PerimeterAckPacket _lastAck;
+
+    void sendHeartbeat();
+    void handleCommand(const PerimeterCommandPacket& packet);
+    void sendAck(const PerimeterAckPacket& ack);
+};
+
+#endif // UDP_LINK_H
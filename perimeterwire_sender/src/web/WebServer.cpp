@@ -262,6 +262,18 @@ void PerimeterWebServer::handleRoot(AsyncWebServerRequest* request) {
                 <span class="status-label">Cycles</span>
                 <span class="status-value" id="cycles">0</span>
             </div>
+            <div class="status-row">
+                <span class="status-label">Wire</span>
+                <span class="status-value" id="wire">-</span>
+            </div>
+            <div class="status-row">
+                <span class="status-label">Duty</span>
+                <span class="status-value" id="duty">-</span>
+            </div>
+            <div class="status-row">
+                <span class="status-label">Impedance</span>
+                <span class="status-value" id="impedance">-</span>
+            </div>
             <div class="status-row">
                 <span class="status-label">IP Address</span>
                 <span class="status-value" id="ip">-</span>
@@ -285,6 +297,16 @@ void PerimeterWebServer::handleRoot(AsyncWebServerRequest* request) {
                     document.getElementById('current').textContent = data.current_mA.toFixed(0);
                     document.getElementById('runtime').textContent = formatTime(data.runtime_ms);
                     document.getElementById('cycles').textContent = data.cycles;
+                    if (data.power) {
+                        document.getElementById('duty').textContent = Math.round(data.power.duty / 2.55) + '% / ' +
+                            data.power.target_mA.toFixed(0) + ' mA' + (data.power.derate < 1 ? ' (hot)' : '');
+                    }
+                    if (data.wire) {
+                        document.getElementById('wire').textContent = data.wire.status +
+                            (data.wire.status === 'UNKNOWN' ? '' : ' (' + Math.round(data.wire.integrity * 100) + '%)');
+                        document.getElementById('impedance').textContent = data.wire.impedance_ohm > 0 ?
+                            data.wire.impedance_ohm.toFixed(1) + ' \u03a9' : '-';
+                    }
                     document.getElementById('ip').textContent = data.ip;
                 })
                 .catch(e => console.error('Status error:', e));
@@ -410,6 +432,49 @@ String PerimeterWebServer::createStatusJSON() {
     doc["runtime_ms"] = _signalGen ? _signalGen->getRuntime() : 0;
     doc["cycles"] = _signalGen ? _signalGen->getCycleCount() : 0;
     doc["overcurrent"] = _signalGen ? _signalGen->isOvercurrent() : false;
+
+    // Sendeeffekt (adaptiv duty cycle og termisk budget)
+    if (_signalGen) {
+        JsonObject power = doc.createNestedObject("power");
+        power["adaptive"] = ADAPTIVE_POWER;
+        power["duty"] = _signalGen->getDuty();
+        power["target_mA"] = _signalGen->getTargetMA();
+        power["ramp_done"] = _signalGen->isRampDone();
+        power["derate"] = _signalGen->getDerate();
+        power["driver_temp_rise_C"] = _signalGen->getDriverTempRise();
+        power["drive_W"] = _signalGen->getDrivePower();
+    }
+
+    // Kabel diagnostik (synkron strømmåling pr. kode cyklus) - sløjfe 0
+    if (_signalGen) {
+        const WireDiagnostics& diag = _signalGen->getWireDiagnostics();
+        JsonObject wire = doc.createNestedObject("wire");
+        wire["status"] = _signalGen->getWireStatusString();
+        wire["amplitude_mA"] = diag.amplitudeMA;
+        wire["offset_mA"] = diag.offsetMA;
+        wire["impedance_ohm"] = diag.impedanceOhm;
+        wire["baseline_ohm"] = diag.baselineOhm;
+        wire["integrity"] = diag.integrity;
+        wire["cycles"] = diag.cyclesEvaluated;
+    }
+
+    // Alle sløjfer når senderen driver flere
+    if (_signalGen && _signalGen->getLoopCount() > 1) {
+        doc["active_loop"] = _signalGen->getActiveLoop();
+        JsonArray loops = doc.createNestedArray("loops");
+        for (uint8_t i = 0; i < _signalGen->getLoopCount(); i++) {
+            const WireDiagnostics& diag = _signalGen->getWireDiagnostics(i);
+            JsonObject loop = loops.createNestedObject();
+            loop["loop"] = i;
+            loop["status"] = _signalGen->getWireStatusString(i);
+            loop["duty"] = _signalGen->getDuty(i);
+            loop["ramp_done"] = _signalGen->isRampDone(i);
+            loop["amplitude_mA"] = diag.amplitudeMA;
+            loop["impedance_ohm"] = diag.impedanceOhm;
+            loop["integrity"] = diag.integrity;
+        }
+    }
+
     doc["ip"] = getIPAddress();
     doc["ap_mode"] = _apMode;
     doc["hostname"] = MDNS_HOSTNAME;
@@ -22,11 +22,11 @@
 #define MOTOR_LEFT_R_IS     34     // Strømsensor højre side (ADC1_CH6, input-only)
 #define MOTOR_LEFT_L_IS     35     // Strømsensor venstre side (ADC1_CH7, input-only)
 
-// Højre motor driver - Grupperet på GPIO 13-14, 18, 27, 36, 39
+// Højre motor driver - Grupperet på GPIO 14, 18, 27, 36, 39
 #define MOTOR_RIGHT_RPWM    27     // PWM til højre motor fremad
 #define MOTOR_RIGHT_LPWM    14     // PWM til højre motor baglæns
 #define MOTOR_RIGHT_R_EN    18     // Enable for højre side (fremad) - FLYTTET FRA GPIO 12
-#define MOTOR_RIGHT_L_EN    13     // Enable for venstre side (baglæns)
+#define MOTOR_RIGHT_L_EN    18     // Enable for venstre side (baglæns) - broet til R_EN, GPIO13 bruges til ladekontakt
 #define MOTOR_RIGHT_R_IS    36     // Strømsensor højre side (ADC1_CH0, input-only, VP)
 #define MOTOR_RIGHT_L_IS    39     // Strømsensor venstre side (ADC1_CH3, input-only, VN)
 
@@ -55,6 +55,11 @@
 // LM386 modul: Bypass C3 for 0-3.3V output (ikke -5V til +5V)
 #define PERIMETER_SIGNAL_PIN  0    // ADC pin til perimeter signal (GPIO0/ADC2_CH1)
 
+// Ladekontakt Sense Pin (ladestationens spænding via spændingsdeler, HIGH = i docken)
+// GPIO13 er ikke strapping pin - ladespænding ved opstart påvirker ikke boot.
+// Pin'en er frigjort ved at højre drivers L_EN er broet til R_EN (GPIO18).
+#define DOCK_CONTACT_PIN    13     // Digital input med ekstern pull-down
+
 // Display - IKKE I BRUG (ESP32-WROOM-32U har ikke indbygget display)
 // Display funktionalitet er deaktiveret i denne version
 // #define DISPLAY_SDA         21     // Ville dele I2C med IMU
@@ -76,6 +81,16 @@
 #define SENSOR_UPDATE_INTERVAL      100    // Sensor opdaterings interval (ms)
 #define SENSOR_TIMEOUT              30000  // Sensor timeout (microsekunder)
 
+// Forhindring tracking filter (median + alpha-beta pr. sensor)
+#define OBSTACLE_MEDIAN_WINDOW      3      // Median-of-N - fjerner enkelte falske ekkoer
+#define OBSTACLE_FILTER_ALPHA       0.5    // Alpha-beta: vægt på ny afstand
+#define OBSTACLE_FILTER_BETA        0.2    // Alpha-beta: vægt på ny hastighed
+#define OBSTACLE_FILTER_GATE_CM     40.0   // Spring større end dette = nyt mål (cm)
+#define OBSTACLE_MIN_CLOSING_SPEED  3.0    // Under dette nærmer vi os ikke (cm/s)
+#define OBSTACLE_TTC_TRIGGER        1.5    // Undgå forhindring ved tid til kollision under (s)
+#define OBSTACLE_TTC_SLOWDOWN       4.0    // Sænk farten ved tid til kollision under (s)
+#define OBSTACLE_TRIGGER_DISTANCE   (CRUISE_SPEED_CM_S * OBSTACLE_TTC_TRIGGER)  // Undgå ved denne afstand (cm) - TTC ved marchfart, også når farten er sænket
+
 // IMU kalibrering
 #define IMU_CALIBRATION_SAMPLES     100    // Antal samples til kalibrering
 #define IMU_UPDATE_INTERVAL         50     // IMU opdaterings interval (ms)
@@ -124,10 +139,77 @@
 #define BACKUP_DISTANCE             30     // Afstand at bakke ved forhindring (cm)
 #define BACKUP_DURATION             1500   // Tid at bakke (ms)
 #define MIN_TURNING_RADIUS          50     // Minimum drejnings radius (cm)
+#define CRUISE_SPEED_CM_S           20.0   // Estimeret fart ved MOTOR_CRUISE_SPEED (cm/s)
+#define BACKUP_SPEED_CM_S           15.0   // Estimeret fart ved MOTOR_BACKUP_SPEED (cm/s)
+#define ROBOT_RADIUS_CM             25.0   // Robottens radius inkl. sikkerhedsmargin (cm)
+
+// Bløde vendinger (TurnPlanner)
+#define WHEEL_TRACK_CM              40.0   // Afstand mellem drivhjulene (cm)
+#define TURN_ARC_SPEED              MOTOR_CRUISE_SPEED  // Basis fart i buer (PWM, ydre hjul skaleres op)
+#define TURN_UTURN_MIN_ANGLE        135.0  // Drejninger herover planlægges som vending mellem rækker (grader)
+#define TURN_ALLOW_REVERSE          true   // Tillad kort bak i vendingen (y-turn) i stedet for omega
 
 // Path planning
 #define PATH_UPDATE_INTERVAL        200    // Path planner opdaterings interval (ms)
 #define MAX_ROWS                    50     // Maksimalt antal rækker i mønster
+#define ROW_CROSS_TRACK_GAIN        1.0    // Styring tilbage mod rækken (grader pr. cm afvigelse)
+#define ROW_CROSS_TRACK_MAX_ANGLE   30.0   // Max vinkel tilbage mod rækken (grader)
+
+// Zoner (flere plæner med eget mønster, gemt på LittleFS)
+#define ZONE_FILE                   "/zones.bin"   // Zone definitioner
+#define ZONE_PLAN_PREFIX            "/plan_"       // Plan cache pr. zone (/plan_<id>.bin)
+#define ZONE_MAX_COUNT              8      // Maks antal zoner
+#define ZONE_MAX_VERTICES           16     // Maks hjørner pr. zone polygon
+#define ZONE_MAX_ROWS               100    // Maks segmenter i en plan
+#define ZONE_MIN_ROW_WIDTH          10     // Mindste række bredde (cm)
+#define ZONE_MAX_ROW_WIDTH          200    // Største række bredde (cm)
+#define ZONE_MIN_ROW_LENGTH         20     // Kortere række stykker springes over (cm)
+
+// Energi planlægning (MissionPlanner) - hvor mange rækker rækker batteriet til
+#define MISSION_DEFAULT_WH_PER_M    0.05   // Start gæt på forbrug under klipning (Wh/m)
+#define MISSION_RETURN_FACTOR       0.7    // Hjemkørsel uden kniv - andel af klippeforbruget
+#define MISSION_RETURN_WIRE_M       50.0   // Længste vej hjem langs kablet (m)
+#define MISSION_TURN_COST_M         2.0    // En vending koster som så mange meter klipning
+#define MISSION_RESERVE_PCT         10.0   // Energi tilbage ved ankomst til basen (% af kapacitet)
+#define MISSION_LEARN_DISTANCE_M    10.0   // Forbrug pr. meter måles over så lang en strækning
+#define MISSION_LEARN_GAIN          0.2    // Filter for nye forbrugsmålinger
+#define MISSION_WH_PER_M_MIN        0.005  // Plausibelt forbrug (Wh/m)
+#define MISSION_WH_PER_M_MAX        1.0
+
+// Session checkpoint (genoptag klipning efter opladning, brownout eller OTA)
+#define CHECKPOINT_UPDATE_INTERVAL  1000   // Tilstand registreres så ofte under klipning (ms)
+#define CHECKPOINT_MIN_INTERVAL     15000  // Ny række skrives til NVS højst så ofte (ms)
+#define CHECKPOINT_POSE_INTERVAL    120000 // Kun flyttet position skrives højst så ofte (ms)
+#define CHECKPOINT_POSE_MIN_CM      100.0  // Mindre flytning end dette skrives ikke (cm)
+
+// Statistik (klippetid, distance og energi pr. session, dag og zone på LittleFS)
+#define STATS_FILE                  "/stats.bin"   // Rullende statistik
+#define STATS_UPDATE_INTERVAL       1000   // Tid og energi integreres så ofte (ms)
+#define STATS_SAVE_INTERVAL         600000 // Skriv højst så ofte mens robotten holder stille (ms)
+#define STATS_DAYS                  30     // Dage i historikken
+#define STATS_SESSIONS              20     // Seneste sessioner i historikken
+#define STATS_ZONE_SLOTS            (ZONE_MAX_COUNT + 1)   // Zoner + standard mønster (zone 0)
+#define STATS_NTP_SERVER            "pool.ntp.org" // Tid til dags inddeling (når WiFi er forbundet)
+#define STATS_TIMEZONE              "CET-1CEST,M3.5.0,M10.5.0/3"   // Dansk tid (POSIX TZ)
+
+// Lokalt kort (occupancy grid omkring robotten, dead reckoning)
+#define LOCAL_MAP_SIZE              40     // Celler pr. side (40 x 10cm = 4 x 4 m)
+#define LOCAL_MAP_CELL_CM           10.0   // Celle størrelse (cm)
+#define LOCAL_MAP_RECENTER_CELLS    5      // Flyt kortet når robotten er så langt fra midten
+#define LOCAL_MAP_HIT               7      // Log-odds tillæg ved ekko (x10)
+#define LOCAL_MAP_MISS              2      // Log-odds fradrag for fri bane (x10)
+#define LOCAL_MAP_LOGODDS_MAX       60     // Log-odds loft (x10) - begrænser hukommelse
+#define LOCAL_MAP_MEMORY            64     // Forhindringer der huskes uden for kortet (celler)
+#define LOCAL_MAP_MEMORY_MIN        LOCAL_MAP_HIT  // Mindste log-odds for at huske en celle (x10)
+#define SONAR_CONE_HALF_ANGLE       15.0   // HC-SR04 halv åbningsvinkel (grader)
+#define SONAR_SIDE_ANGLE            30.0   // Venstre/højre sensors vinkel fra midten (grader)
+#define SONAR_MAP_RANGE             150.0  // Længere målinger bruges kun som fri bane (cm)
+
+// Lokal planner (vector field histogram)
+#define VFH_SECTORS                 36     // Sektorer i polær histogram (10 grader)
+#define VFH_WINDOW_CM               120.0  // Aktivt vindue radius (cm)
+#define VFH_THRESHOLD               0.5    // Sektor tæthed over dette = blokeret
+#define VFH_MAX_DEVIATION           60.0   // Max afvigelse fra ønsket heading (grader)
 
 // ============================================================================
 // TIMING KONSTANTER
@@ -151,9 +233,13 @@
 #define BATTERY_CRITICAL_VOLTAGE    10.0   // Kritisk batteri - stop operation
 #define BATTERY_MIN_VOLTAGE         9.0    // Absolut minimum
 
-// Motor batteri (18V - 5S LiPo) - kun til reference
+// Motor batteri (18V - 5S LiPo) - spændingen måles ikke; energien tælles
+// fra BTS7960 strømmen plus klippemotoren (bruges af mission planneren)
 #define MOTOR_BATTERY_MAX_VOLTAGE   21.0   // Fuldt ladet (5S LiPo)
 #define MOTOR_BATTERY_NOMINAL       18.5   // Nominal spænding
+#define MOTOR_BATTERY_CAPACITY_AH   5.0    // Nominel kapacitet (Ah) - juster efter dit batteri
+#define MOTOR_BATTERY_BLADE_LOAD_A  3.0    // Klippemotor når den kører (A) - måles ikke
+#define MOTOR_BATTERY_SAVE_DELTA_AH 0.05   // Gem forbrugt ladning i NVS når den har flyttet sig så meget (Ah)
 
 // Voltage divider beregning (tilpas efter dit hardware)
 #define BATTERY_R1                  10000.0  // Modstand R1 (ohm)
@@ -161,6 +247,60 @@
 #define BATTERY_ADC_MAX             4095.0   // 12-bit ADC
 #define BATTERY_ADC_VREF            3.3      // Reference spænding (V)
 
+// State of charge (coulomb counting med OCV korrektion i hvile)
+#define BATTERY_CELLS               3      // Celler i serie (3S)
+#define BATTERY_CAPACITY_AH         5.0    // Nominel kapacitet (Ah) - juster efter dit batteri
+#define BATTERY_BASE_LOAD_A         0.35   // Styring, sensorer og WiFi (A) - måles ikke
+#define BATTERY_COUNT_MOTOR_CURRENT false  // Tæl BTS7960 motorstrøm med (true kun hvis motorerne kører på BATTERY_PIN batteriet)
+#define BATTERY_SOC_INTERVAL        100    // Strøm integreres med dette interval (ms)
+#define BATTERY_CURRENT_AVG_TAU_S   60.0   // Tidskonstant for gennemsnitsstrøm til resttid (s)
+#define BATTERY_REST_CURRENT_A      0.2    // Motorstrøm herunder = batteriet hviler (A)
+#define BATTERY_REST_TIME_MS        60000  // Hvile så længe før OCV kurven bruges (ms)
+#define BATTERY_OCV_GAIN            0.2    // Andel af OCV afvigelsen der rettes pr. måling i hvile
+#define BATTERY_OCV_RESYNC_PCT      15.0   // Gemt SoC afviger mere fra OCV ved opstart = opladet/skiftet
+#define BATTERY_RINT_DEFAULT        0.05   // Start værdi for indre modstand (ohm)
+#define BATTERY_RINT_MIN            0.005  // Plausibel indre modstand (ohm)
+#define BATTERY_RINT_MAX            0.5
+#define BATTERY_RINT_MIN_STEP_A     1.0    // Mindste strømspring der bruges til at måle modstanden (A)
+#define BATTERY_RINT_GAIN           0.1    // Filter for nye modstands målinger
+#define BATTERY_LOW_SOC             20.0   // Lav SoC - kør hjem (%)
+#define BATTERY_SAVE_INTERVAL       60000  // Gem SoC i NVS højst så ofte (ms)
+#define BATTERY_SAVE_MIN_DELTA      1.0    // ...og kun hvis SoC har flyttet sig mindst så meget (%)
+
+// ============================================================================
+// LADESTATION KONSTANTER
+// ============================================================================
+// Robotten følger kablet hjem. Ladestationen står på kablet, og signalet
+// er stærkest der - over DOCK_APPROACH_STRENGTH sænkes farten og robotten
+// holder kablet i DOCK_WIRE_OFFSET_CM afstand indtil ladekontakten lukker.
+// Kabel følgeren holder styrken på 100 - WIRE_FOLLOW_OFFSET_CM og styrer
+// væk fra kablet når ladestationens felt stiger. Slutindkørslen starter derfor
+// lige over den styrke, før følgeren har flyttet robotten, og sideafstanden
+// er da inden for tolerancen. Feltets ekstra styrke ved kontakterne skal
+// være under DOCK_ALIGN_TOLERANCE_CM (%).
+
+#define DOCK_UPDATE_INTERVAL        50     // Ladekontakt aflæses hver (ms)
+#define DOCK_CONTACT_DEBOUNCE_MS    300    // Kontakten skal være stabil så længe (ms)
+#define DOCK_APPROACH_SPEED         80     // Hastighed under slutindkørsel (PWM)
+#define DOCK_WIRE_OFFSET_CM         WIRE_FOLLOW_OFFSET_CM  // Kablets afstand når kontakterne rammer (cm)
+#define DOCK_ALIGN_GAIN             1.0    // Styring mod kablet (PWM pr. cm)
+#define DOCK_ALIGN_MAX_PWM          20     // Største forskel mellem hjulene under indkørsel
+#define DOCK_ALIGN_TOLERANCE_CM     15     // Større afvigelse = skævt ind (cm)
+#define DOCK_APPROACH_MARGIN        2      // Styrke over følgerens niveau der betyder ladestation (%)
+#define DOCK_APPROACH_STRENGTH      (100 - DOCK_WIRE_OFFSET_CM + DOCK_APPROACH_MARGIN)  // Signalstyrke (%) hvor slutindkørslen starter
+#define DOCK_MISALIGN_MS            1500   // ...i så lang tid = nyt forsøg (ms)
+#define DOCK_APPROACH_TIMEOUT_MS    20000  // Ingen kontakt efter så lang indkørsel = nyt forsøg (ms)
+#define DOCK_STALL_CURRENT_A        8.0    // Motorstrøm uden kontakt = kører mod docken (A)
+#define DOCK_STALL_MS               500    // ...i så lang tid = nyt forsøg (ms)
+#define DOCK_BACKOFF_SPEED          90     // Hastighed når robotten bakker ud til nyt forsøg (PWM)
+#define DOCK_BACKOFF_MS             2000   // Bak så længe før nyt forsøg (ms)
+#define DOCK_MAX_RETRIES            3      // Forsøg før docking opgives (fejl)
+#define DOCK_CHARGED_VOLTAGE        12.5   // Spænding i docken der betyder fuldt opladet (V)
+#define DOCK_CHARGED_HOLD_MS        1800000 // ...holdt så længe (konstant spænding fasen) (ms)
+#define DOCK_AUTO_RESUME            true   // Fortsæt afbrudt mønster når batteriet er ladet
+#define DOCK_UNDOCK_MS              2500   // Bak ud af docken så længe (ms)
+#define DOCK_UNDOCK_TURN_MS         1200   // ...og drej væk fra kablet så længe (ms)
+
 // ============================================================================
 // WEB SERVER KONSTANTER
 // ============================================================================
@@ -172,6 +312,10 @@
 #define MAX_WEBSOCKET_CLIENTS       4      // Maksimalt antal WebSocket klienter
 #define WEBSOCKET_PING_INTERVAL     30000  // WebSocket ping interval (ms)
 
+// Statiske web filer (bygges af tools/build_web_assets.py)
+#define WEB_ASSETS_PROGMEM          false  // true = web UI indlejret i firmware (kræver ikke LittleFS image)
+#define WEB_CACHE_MAX_AGE           31536000 // Cache tid for versionerede filer (?v=, sekunder = 1 år)
+
 // ============================================================================
 // OTA UPDATE KONSTANTER
 // ============================================================================
@@ -188,7 +332,13 @@
 #define CAPTIVE_PORTAL_SSID         "RobotMower-Setup"  // AP SSID ved første opstart
 #define CAPTIVE_PORTAL_PASSWORD     ""                   // Åben AP (ingen password)
 #define WIFI_MAX_RETRY              10                   // Max antal retry før fallback til AP
-#define WIFI_RETRY_INTERVAL         30000                // Retry interval (ms)
+#define WIFI_CONNECT_TIMEOUT_MS     15000                // Forsøg opgives uden IP efter (ms)
+#define WIFI_BACKOFF_MIN_MS         1000                 // Første pause efter mislykket forsøg (ms)
+#define WIFI_BACKOFF_MAX_MS         60000                // Pausen fordobles op til (ms)
+#define WIFI_SCAN_TIMEOUT_MS        8000                 // Asynkron scanning opgives efter (ms)
+#define WIFI_ROAM_RSSI              -75                  // Led efter bedre access point under dette (dBm)
+#define WIFI_ROAM_HYSTERESIS        8                    // Skift kun til access point der er så meget bedre (dB)
+#define WIFI_ROAM_CHECK_MS          30000                // Tjek signal for roaming hver (ms)
 
 // ============================================================================
 // AUTO UPDATE KONSTANTER
@@ -208,6 +358,53 @@
 #define LOG_TO_SERIAL               true   // Log til Serial Monitor
 #define LOG_TO_WEBSOCKET            true   // Log til WebSocket klienter
 
+// Log niveauer: 0 = DEBUG, 1 = INFO, 2 = WARNING, 3 = ERROR
+// Compile-time niveau pr. subsystem - beskeder under niveauet fjernes helt
+// fra firmwaren (inklusiv formatering af argumenter)
+#define LOG_COMPILE_LEVEL_CORE        (DEBUG_MODE ? 0 : 1)
+#define LOG_COMPILE_LEVEL_NAVIGATION  (DEBUG_NAVIGATION ? 0 : 1)
+#define LOG_COMPILE_LEVEL_MOTORS      (DEBUG_MOTORS ? 0 : 1)
+#define LOG_COMPILE_LEVEL_SENSORS     (DEBUG_SENSORS ? 0 : 1)
+#define LOG_COMPILE_LEVEL_PERIMETER   (DEBUG_MODE ? 0 : 1)
+#define LOG_COMPILE_LEVEL_WEB         (DEBUG_WEBSOCKET ? 0 : 1)
+#define LOG_COMPILE_LEVEL_BATTERY     (DEBUG_MODE ? 0 : 1)
+
+// Runtime niveau ved opstart (kan ændres via /api/logs/levels)
+#define LOG_RUNTIME_LEVEL_DEFAULT     1      // INFO - debug beskeder filtreres fra
+
+// ============================================================================
+// BLACK BOX KONSTANTER
+// ============================================================================
+
+#define BLACKBOX_DIR                "/bb"        // Cirkulær optagelse (segment filer)
+#define BLACKBOX_ERROR_DIR          "/bb_error"  // Frosset dump fra seneste fejl
+#define BLACKBOX_SEGMENTS           8      // Segment filer i ringen
+#define BLACKBOX_SEGMENT_PAGES      16     // Sider pr. segment (16 x 512 bytes = 8KB)
+#define BLACKBOX_PAGES              (BLACKBOX_SEGMENTS * BLACKBOX_SEGMENT_PAGES)  // 128 sider = 64KB
+#define BLACKBOX_TELEMETRY_INTERVAL 100    // Telemetri optagelse interval (ms)
+#define BLACKBOX_POST_TRIGGER_MS    2000   // Optag videre efter fejl før freeze (ms)
+#define BLACKBOX_LOG_LEVEL          1      // Laveste log niveau der optages (1 = INFO)
+#define BLACKBOX_TASK_PRIORITY      1      // Writer task prioritet (lav)
+#define BLACKBOX_TASK_CORE          0      // Writer task kører på core 0 (flash sletning standser dog begge kerner)
+
+// ============================================================================
+// PROFILER KONSTANTER
+// ============================================================================
+
+#define PERF_LOOP_BUDGET_US         10000  // Loop budget - længere loop tælles som overrun (us)
+
+// ============================================================================
+// DEADLINE / WATCHDOG KONSTANTER
+// ============================================================================
+
+#define DEADLINE_CHECK_INTERVAL     10     // Supervisor tjekker deadlines hver (ms)
+#define DEADLINE_TASK_PRIORITY      20     // Supervisor prioritet (over AsyncTCP, så den kører selv under HTTP)
+#define DEADLINE_TASK_CORE          0      // Supervisor kører på core 0 (loop på core 1)
+#define DEADLINE_MOTOR_MS           250    // Max tid mellem motor opdateringer før sikkert stop (ms)
+#define DEADLINE_SAFETY_MS          250    // Max tid mellem sikkerhedstjek (ms)
+#define DEADLINE_PERIOD_FACTOR      5      // Periodiske opgaver: deadline = periode x faktor
+#define DEADLINE_MANEUVER_MS        8000   // Kendte blokerende manøvrer (bak + drej) må holde loop så længe (ms)
+
 // ============================================================================
 // STATE MACHINE KONSTANTER
 // ============================================================================
@@ -215,6 +412,7 @@
 #define STATE_TIMEOUT               300000 // Max tid i en state (5 minutter)
 #define CALIBRATION_TIMEOUT         30000  // Kalibrerings timeout (30 sekunder)
 #define MOWING_SESSION_MAX          3600000 // Max klipnings session (1 time)
+#define STATE_EVENT_QUEUE_SIZE      8      // Hændelser i kø fra web handlers til loop
 
 // ============================================================================
 // SIKKERHED KONSTANTER
@@ -224,6 +422,10 @@
 #define AUTO_STOP_ON_TILT           false  // Stop hvis robotten vælter
 #define TILT_ANGLE_THRESHOLD        30.0   // Maksimal hældnings vinkel (grader)
 #define OBSTACLE_STOP_DISTANCE      10     // Stop afstand ved forhindring (cm)
+#define SAFETY_IMU_STALE_MS         500    // Ingen gyldig IMU måling så længe = I2C fejl (ms)
+#define SAFETY_BATTERY_SENSE_MIN    2.0    // Målt spænding herunder = død ADC/ledning (V)
+#define SAFETY_BATTERY_SENSE_MAX    (BATTERY_MAX_VOLTAGE + 1.5)  // Herover = mættet ADC (V)
+#define SAFETY_SIGNAL_LOST_MS       500    // Perimeter signal væk så længe under drift = stop (ms)
 
 // ============================================================================
 // DEBUG KONSTANTER
@@ -247,6 +449,15 @@
 #define ENABLE_WIFI_MANAGER         true   // Aktiver WiFi Manager med captive portal
 #define ENABLE_AUTO_UPDATE          false  // Deaktiver auto-update feature (sparer ~50KB)
 #define ENABLE_PERIMETER            true   // Aktiver perimeter wire detektion
+#define ENABLE_BLACKBOX             true   // Aktiver flash black box recorder
+#define ENABLE_PROFILER             true   // Aktiver loop profiler (/api/perf)
+#define ENABLE_WATCHDOG             true   // Aktiver task watchdog og deadline monitor (/api/deadlines)
+#define ENABLE_ZONES                true   // Aktiver zoner med cachede planer (/api/zones)
+#define ENABLE_SMOOTH_TURNS         true   // Bløde vendinger med buer i stedet for drejning på stedet
+#define ENABLE_MISSION_PLANNER      true   // Kør hjem når batteriet ikke rækker til næste række (/api/mission)
+#define ENABLE_CHECKPOINT           true   // Gem klipnings fremskridt i NVS og genoptag efter genstart (/api/checkpoint)
+#define ENABLE_DOCKING              true   // Ladestation: indkørsel, opladning og genoptagelse (kræver ENABLE_PERIMETER)
+#define ENABLE_STATS                true   // Klippetid, distance og energi pr. session, dag og zone (/api/stats)
 
 // ============================================================================
 // PERIMETER WIRE KONSTANTER
@@ -255,18 +466,73 @@
 // Perimeter sender API (separat ESP32)
 #define PERIMETER_SENDER_IP         "192.168.1.100"  // IP adresse på perimeter sender
 #define PERIMETER_SENDER_PORT       80               // HTTP port på sender
-#define PERIMETER_API_TIMEOUT       5000             // API timeout (ms)
+#define PERIMETER_API_TIMEOUT       5000             // API timeout (ms) - venter asynkront, blokerer ikke loop
+#define PERIMETER_STATUS_INTERVAL   5000             // Hent sender status hver (ms)
+#define PERIMETER_QUEUE_SIZE        4                // Requests i kø til senderen
+#define PERIMETER_RESPONSE_MAX      1024             // Max svar størrelse fra sender (bytes)
+#define PERIMETER_BACKOFF_MIN_MS    1000             // Første ventetid når senderen ikke svarer (ms)
+#define PERIMETER_BACKOFF_MAX_MS    60000            // Max ventetid (fordobles pr. fejl) (ms)
+#define PERIMETER_HEARTBEAT_TIMEOUT 1000             // Intet UDP heartbeat så længe = HTTP igen (ms)
+#define PERIMETER_UDP_RETRY_MS      200              // Gensend UDP kommando uden ack efter (ms)
+#define PERIMETER_UDP_RETRIES       3                // Forsøg over UDP før HTTP bruges
 
 // Signal detektion
 #define PERIMETER_SIGNAL_THRESHOLD  50      // Minimum signal for detektion
 #define PERIMETER_WIRE_THRESHOLD    200     // Signal niveau for "på kablet"
 #define PERIMETER_TIMEOUT_MS        1000    // Timeout før "ingen signal"
 
+// Flere sløjfer - skal matche senderens LOOP_COUNT (koder i hardware/PerimeterCodes.h)
+#define PERIMETER_LOOP_COUNT        1       // Sløjfer senderen driver (1 = ingen identifikation)
+#define PERIMETER_KEEPOUT_LOOPS     0x00    // Bitmaske: sløjfer der er forbudte øer (f.eks. 0x06 = sløjfe 1+2)
+#define PERIMETER_LOOP_ID_INTERVAL  250     // Identificér nærmeste sløjfe hver (ms)
+#define PERIMETER_ID_SAMPLE_US      104     // Sample interval for identifikation (halv korteste halvperiode)
+#define PERIMETER_ID_SAMPLES        192     // Samples pr. burst (længste kode cyklus, ~20 ms)
+#define PERIMETER_LOOP_MIN_LEVEL    20      // Min korrelations niveau for at identificere en sløjfe
+#define PERIMETER_LOOP_DECAY        0.7     // Niveau holdes over skift (pr. burst) - dækker en hel TDM runde
+#define PERIMETER_LOOP_DOMINANCE    2.0     // Fortegn kun fra burstets stærkeste sløjfe, og kun hvis så mange gange
+                                            // stærkere end den næste (kodernes krydskorrelation er op til 0.42)
+#define PERIMETER_ID_TASK_PRIORITY  2       // Identifikations task prioritet
+#define PERIMETER_ID_TASK_CORE      0       // Identifikations task kører på core 0 (loop på core 1)
+
 // Adfærd ved perimeter
 #define PERIMETER_BACKUP_DISTANCE   30      // Afstand at bakke ved perimeter (cm)
 #define PERIMETER_TURN_ANGLE        135.0   // Drejningsvinkel ved perimeter (grader)
 #define PERIMETER_SLOWDOWN_DIST     50      // Afstand til at sænke fart (cm)
 
+// Kabel følgning hjem (PID på sideafstanden, kablet holdes til venstre)
+#define WIRE_FOLLOW_OFFSET_CM       30.0    // Ønsket afstand til kablet (cm)
+#define WIRE_FOLLOW_INTERVAL_MS     20      // Regulering hver (ms) - modtageren behandler med 50 Hz
+#define WIRE_FOLLOW_KP              1.5     // PWM pr. cm afvigelse
+#define WIRE_FOLLOW_KI              0.1     // PWM pr. cm·s
+#define WIRE_FOLLOW_KD              3.0     // PWM pr. cm/s (på målingen - intet spring ved start)
+#define WIRE_FOLLOW_I_MAX           20.0    // Max bidrag fra integralet (PWM)
+#define WIRE_FOLLOW_D_ALPHA         0.3     // Lavpas filter på differentialet (0-1)
+#define WIRE_FOLLOW_STEER_MAX       60      // Max forskel mellem hjul og grundfart (PWM)
+#define WIRE_FOLLOW_SPEED_MAX       150     // Grundfart på lige kabel (PWM)
+#define WIRE_FOLLOW_SPEED_MIN       90      // Grundfart i skarpe sving (PWM)
+#define WIRE_FOLLOW_CURVE_SLOWDOWN  1.0     // Fart trukket fra pr. PWM styring
+
+// Signal søgning (bak ad sporet, derefter udvidende spiral)
+#define SEARCH_TRACK_SIZE           32      // Punkter i spor bufferen
+#define SEARCH_TRACK_SPACING_CM     20      // Afstand mellem punkter (cm) - 32 x 20 = 6,4 m spor
+#define SEARCH_TRACK_MAX_DT_MS      200     // Max tidsskridt i pose integrationen (ms)
+#define SEARCH_UPDATE_INTERVAL_MS   20      // Styring hver (ms)
+#define SEARCH_BACKTRACK_MAX_CM     300     // Max bakket distance før spiral (cm)
+#define SEARCH_POINT_TOLERANCE_CM   10      // Punkt nået inden for (cm)
+#define SEARCH_POINT_TIMEOUT_MS     4000    // Max tid pr. punkt (ms)
+#define SEARCH_PIVOT_ANGLE          45.0    // Drej på stedet ved større vinkelfejl (grader)
+#define SEARCH_STEER_GAIN           2.0     // PWM pr. grad vinkelfejl
+#define SEARCH_STEER_MAX            40      // Max styring (PWM)
+#define SEARCH_SPEED                MOTOR_SLOW_SPEED  // Fart under søgning (PWM)
+#define SEARCH_SPIRAL_START_CM      40.0    // Spiralens start radius (cm)
+#define SEARCH_SPIRAL_GROWTH_CM     50.0    // Radius tilvækst pr. omgang (cm)
+#define SEARCH_SPIRAL_MAX_CM        500.0   // Opgiv ved denne radius (cm)
+#define SEARCH_TIMEOUT_MS           120000  // Opgiv søgning efter (ms)
+
+// Perimeter omgange (klipning langs kablet med stigende afstand)
+#define PERIMETER_OFFSET_MAX_CM     90      // Største afstand signalstyrken kan holde (cm)
+#define WIRE_LAP_PROGRESS_CM        1000    // Kørt langs kablet der tæller som fremskridt (genstarter STATE_TIMEOUT)
+
 // ============================================================================
 // RETNING KONSTANTER
 // ============================================================================
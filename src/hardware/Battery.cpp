@@ -1,14 +1,58 @@
 #include "Battery.h"
+#include "Motors.h"
+#include "CuttingMechanism.h"
+#include <Preferences.h>
+
+static const char* NVS_NAMESPACE = "battery";
+
+// Hvilespænding pr. celle (LiPo) for 0, 10, 20 ... 100 % SoC
+static const float OCV_CELL_CURVE[] = {
+    3.27, 3.69, 3.73, 3.77, 3.80, 3.84, 3.87, 3.95, 4.02, 4.11, 4.20
+};
+static const int OCV_POINTS = sizeof(OCV_CELL_CURVE) / sizeof(OCV_CELL_CURVE[0]);
+
+/**
+ * Er spændingen en batteriet kan have? (død/mættet ADC må ikke flytte SoC)
+ */
+static bool isPlausible(float voltage) {
+    return voltage >= SAFETY_BATTERY_SENSE_MIN && voltage <= SAFETY_BATTERY_SENSE_MAX;
+}
 
 Battery::Battery() {
+    motorsPtr = nullptr;
+    cuttingPtr = nullptr;
     voltage = 0.0;
     percentage = 0;
+    soc = 0.0;
+    current = 0.0;
+    averageCurrent = 0.0;
+    internalResistance = BATTERY_RINT_DEFAULT;
+    lastVoltage = 0.0;
+    lastVoltageCurrent = 0.0;
+    lastCharge = 0;
+    restSince = 0;
+    resting = false;
+    charging = false;
+    savedSoc = -100.0;
+    savedResistance = BATTERY_RINT_DEFAULT;
+    motorPackCurrent = 0.0;
+    motorPackUsedAh = 0.0;
+    savedMotorPackUsedAh = 0.0;
+    lastSave = 0;
     lastUpdate = 0;
     initialized = false;
     lowWarningShown = false;
     criticalWarningShown = false;
 }
 
+void Battery::setMotors(Motors* motors) {
+    motorsPtr = motors;
+}
+
+void Battery::setCuttingMechanism(CuttingMechanism* cutting) {
+    cuttingPtr = cutting;
+}
+
 bool Battery::begin() {
     // Konfigurer ADC pin
     pinMode(BATTERY_PIN, INPUT);
@@ -19,8 +63,28 @@ bool Battery::begin() {
 
     // Tag første måling
     delay(100);
+    current = readCurrent();
+    averageCurrent = current;
     voltage = readVoltage();
-    percentage = calculatePercentage(voltage);
+    lastVoltage = voltage;
+    lastVoltageCurrent = current;
+
+    // Ved opstart hviler batteriet - OCV giver et godt udgangspunkt
+    float ocvSoc = ocvToSoc(getRestVoltage());
+    if (loadState(isPlausible(voltage) ? ocvSoc : -1.0)) {
+        Serial.printf("[Battery] Restored SoC %.1f%% (OCV %.1f%%)\n", soc, ocvSoc);
+    } else {
+        // Opladet eller skiftet mens robotten var slukket - begge batterier lades sammen
+        soc = ocvSoc;
+        motorPackUsedAh = 0.0;
+        Serial.printf("[Battery] SoC from OCV: %.1f%%\n", soc);
+    }
+    percentage = (int)(soc + 0.5);
+
+    unsigned long now = millis();
+    lastCharge = now;
+    restSince = now;
+    lastSave = now;
 
     initialized = true;
 
@@ -41,12 +105,28 @@ void Battery::update() {
         return; // Ikke tid endnu
     }
 
-    // Læs ny spænding
+    updateCharge();
+
+    // Læs ny spænding (strømmen læses først - den hører til spændingen)
+    float newCurrent = readCurrent();
     voltage = readVoltage();
-    percentage = calculatePercentage(voltage);
+    updateResistance(voltage, newCurrent);
+
+    if (resting && !charging) {
+        correctFromOcv();
+    }
+    percentage = (int)(soc + 0.5);
 
     lastUpdate = currentTime;
 
+    // Gem sjældent - NVS flash tåler begrænset antal skrivninger
+    if (currentTime - lastSave >= BATTERY_SAVE_INTERVAL &&
+        (fabs(soc - savedSoc) >= BATTERY_SAVE_MIN_DELTA ||
+         fabs(internalResistance - savedResistance) > 0.1 * savedResistance ||
+         fabs(motorPackUsedAh - savedMotorPackUsedAh) >= MOTOR_BATTERY_SAVE_DELTA_AH)) {
+        saveState();
+    }
+
     // Advarsler
     if (isCritical() && !criticalWarningShown) {
         Serial.println("[Battery] !!! CRITICAL BATTERY LEVEL !!!");
@@ -67,6 +147,48 @@ void Battery::update() {
     #endif
 }
 
+void Battery::updateCharge() {
+    if (!initialized) {
+        return;
+    }
+
+    unsigned long now = millis();
+    unsigned long dt = now - lastCharge;
+    if (dt < BATTERY_SOC_INTERVAL) {
+        return;
+    }
+    lastCharge = now;
+
+    // Coulomb counting: Ah = A * h (ladestrømmen måles ikke - se markFull())
+    current = readCurrent();
+    if (!charging) {
+        soc -= current * (dt / 3600000.0) / BATTERY_CAPACITY_AH * 100.0;
+        soc = constrain(soc, 0.0f, 100.0f);
+    }
+
+    // Motor batteriet (5S) - måles ikke, forbruget tælles fra strømmen
+    motorPackCurrent = 0.0;
+    if (motorsPtr != nullptr) {
+        motorPackCurrent += motorsPtr->getTotalCurrent();
+    }
+    if (cuttingPtr != nullptr && cuttingPtr->isRunning()) {
+        motorPackCurrent += MOTOR_BATTERY_BLADE_LOAD_A;
+    }
+    if (!charging) {
+        motorPackUsedAh = min(motorPackUsedAh + motorPackCurrent * (dt / 3600000.0f),
+                              (float)MOTOR_BATTERY_CAPACITY_AH);
+    }
+
+    float dtS = dt / 1000.0;
+    averageCurrent += (current - averageCurrent) * dtS / (BATTERY_CURRENT_AVG_TAU_S + dtS);
+
+    // Hvile = motorerne har ikke trukket strøm i BATTERY_REST_TIME_MS
+    if (current - BATTERY_BASE_LOAD_A >= BATTERY_REST_CURRENT_A) {
+        restSince = now;
+    }
+    resting = (now - restSince >= BATTERY_REST_TIME_MS);
+}
+
 float Battery::getVoltage() {
     return voltage;
 }
@@ -75,8 +197,85 @@ int Battery::getPercentage() {
     return percentage;
 }
 
+float Battery::getStateOfCharge() {
+    return soc;
+}
+
+float Battery::getRemainingAh() {
+    return soc / 100.0 * BATTERY_CAPACITY_AH;
+}
+
+float Battery::getRemainingWh() {
+    return getRemainingAh() * BATTERY_NOMINAL_VOLTAGE;
+}
+
+float Battery::getCurrent() {
+    return current;
+}
+
+float Battery::getMotorPackCurrent() {
+    return motorPackCurrent;
+}
+
+float Battery::getMotorPackRemainingWh() {
+    #if BATTERY_COUNT_MOTOR_CURRENT
+    return getRemainingWh();    // Motorerne kører på det målte batteri
+    #else
+    return (MOTOR_BATTERY_CAPACITY_AH - motorPackUsedAh) * MOTOR_BATTERY_NOMINAL;
+    #endif
+}
+
+float Battery::getMotorPackCapacityWh() {
+    #if BATTERY_COUNT_MOTOR_CURRENT
+    return BATTERY_CAPACITY_AH * BATTERY_NOMINAL_VOLTAGE;
+    #else
+    return MOTOR_BATTERY_CAPACITY_AH * MOTOR_BATTERY_NOMINAL;
+    #endif
+}
+
+float Battery::getAverageCurrent() {
+    return averageCurrent;
+}
+
+float Battery::getInternalResistance() {
+    return internalResistance;
+}
+
+float Battery::getRestVoltage() {
+    return voltage + lastVoltageCurrent * internalResistance;
+}
+
+bool Battery::isResting() {
+    return resting;
+}
+
+void Battery::setCharging(bool active) {
+    if (charging == active) {
+        return;
+    }
+    charging = active;
+    Serial.printf("[Battery] Charging %s at %.2fV\n", charging ? "started" : "stopped", voltage);
+}
+
+bool Battery::isCharging() {
+    return charging;
+}
+
+void Battery::markFull() {
+    soc = 100.0;
+    motorPackUsedAh = 0.0;
+    percentage = 100;
+    lowWarningShown = false;
+    criticalWarningShown = false;
+    saveState();
+    Serial.println("[Battery] Fully charged");
+}
+
 bool Battery::isLow() {
-    return (voltage < BATTERY_LOW_VOLTAGE && voltage > 0);
+    if (soc < BATTERY_LOW_SOC) {
+        return true;
+    }
+    return (voltage > 0 && getRestVoltage() < BATTERY_LOW_VOLTAGE);
 }
 
 bool Battery::isCritical() {
@@ -84,8 +283,8 @@ bool Battery::isCritical() {
 }
 
 void Battery::printStatus() {
-    Serial.printf("[Battery] Voltage: %.2fV | Percentage: %d%% | Status: ",
-                  voltage, percentage);
+    Serial.printf("[Battery] Voltage: %.2fV | SoC: %.1f%% | Current: %.2fA | Rint: %.0fmOhm | Status: ",
+                  voltage, soc, current, internalResistance * 1000.0);
 
     if (isCritical()) {
         Serial.println("CRITICAL");
@@ -97,24 +296,136 @@ void Battery::printStatus() {
 }
 
 int Battery::getEstimatedTimeRemaining(float currentDraw) {
-    // Simpel estimering baseret på batteri kapacitet
-    // Antager 3S LiPo med 5000mAh kapacitet (juster efter dit batteri)
-    const float BATTERY_CAPACITY = 5.0; // Ah
-
     if (currentDraw <= 0) {
         return 9999; // Uendelig tid hvis ingen forbrug
     }
 
-    // Resterende kapacitet baseret på spænding
-    float remainingCapacity = (percentage / 100.0) * BATTERY_CAPACITY;
-
     // Tid = Kapacitet / Forbrug
-    float hours = remainingCapacity / currentDraw;
+    float hours = getRemainingAh() / currentDraw;
     int minutes = (int)(hours * 60);
 
     return minutes;
 }
 
+int Battery::getEstimatedTimeRemaining() {
+    return getEstimatedTimeRemaining(averageCurrent);
+}
+
+bool Battery::saveState() {
+    Preferences prefs;
+    lastSave = millis();
+
+    if (!prefs.begin(NVS_NAMESPACE, false)) {
+        Serial.println("[Battery] Error: Failed to open NVS");
+        return false;
+    }
+
+    prefs.putFloat("soc", soc);
+    prefs.putFloat("rint", internalResistance);
+    prefs.putFloat("mused", motorPackUsedAh);
+    prefs.putBool("valid", true);
+    prefs.end();
+
+    savedSoc = soc;
+    savedResistance = internalResistance;
+    savedMotorPackUsedAh = motorPackUsedAh;
+    return true;
+}
+
+bool Battery::loadState(float ocvSoc) {
+    Preferences prefs;
+
+    if (!prefs.begin(NVS_NAMESPACE, true)) { // true = read-only
+        return false;
+    }
+
+    if (!prefs.getBool("valid", false)) {
+        prefs.end();
+        return false;
+    }
+
+    float storedSoc = prefs.getFloat("soc", ocvSoc);
+    internalResistance = constrain(prefs.getFloat("rint", BATTERY_RINT_DEFAULT),
+                                   (float)BATTERY_RINT_MIN, (float)BATTERY_RINT_MAX);
+    motorPackUsedAh = constrain(prefs.getFloat("mused", 0.0f), 0.0f, (float)MOTOR_BATTERY_CAPACITY_AH);
+    savedMotorPackUsedAh = motorPackUsedAh;
+    prefs.end();
+
+    savedSoc = storedSoc;
+    savedResistance = internalResistance;
+
+    // Stor afvigelse = batteriet er opladet eller skiftet mens robotten var slukket
+    if (ocvSoc >= 0 && fabs(storedSoc - ocvSoc) > BATTERY_OCV_RESYNC_PCT) {
+        Serial.printf("[Battery] Stored SoC %.1f%% does not match OCV %.1f%% - using OCV\n",
+                      storedSoc, ocvSoc);
+        return false;
+    }
+
+    soc = constrain(storedSoc, 0.0f, 100.0f);
+    return true;
+}
+
+float Battery::readCurrent() {
+    // BATTERY_PIN måler styringens 3S batteri - motorerne har eget 5S batteri.
+    // Uden motorstrøm er strømmen konstant, så indre modstand måles ikke.
+    float total = BATTERY_BASE_LOAD_A;
+
+    #if BATTERY_COUNT_MOTOR_CURRENT
+    if (motorsPtr != nullptr) {
+        total += motorsPtr->getTotalCurrent();
+    }
+    #endif
+
+    return total;
+}
+
+void Battery::updateResistance(float newVoltage, float newCurrent) {
+    if (!isPlausible(newVoltage)) {
+        return;
+    }
+
+    // R = -dV / dI mellem to målinger med tydeligt forskellig belastning
+    float deltaCurrent = newCurrent - lastVoltageCurrent;
+    if (isPlausible(lastVoltage) && fabs(deltaCurrent) >= BATTERY_RINT_MIN_STEP_A) {
+        float measured = (lastVoltage - newVoltage) / deltaCurrent;
+        if (measured >= BATTERY_RINT_MIN && measured <= BATTERY_RINT_MAX) {
+            internalResistance += (measured - internalResistance) * BATTERY_RINT_GAIN;
+        }
+    }
+
+    lastVoltage = newVoltage;
+    lastVoltageCurrent = newCurrent;
+}
+
+void Battery::correctFromOcv() {
+    if (!isPlausible(voltage)) {
+        return;
+    }
+
+    float target = ocvToSoc(getRestVoltage());
+    soc += (target - soc) * BATTERY_OCV_GAIN;
+    soc = constrain(soc, 0.0f, 100.0f);
+}
+
+float Battery::ocvToSoc(float restVoltage) {
+    float cell = restVoltage / BATTERY_CELLS;
+    float step = 100.0 / (OCV_POINTS - 1);
+
+    if (cell <= OCV_CELL_CURVE[0]) {
+        return 0.0;
+    }
+
+    // Lineær interpolation mellem punkterne i kurven
+    for (int i = 0; i < OCV_POINTS - 1; i++) {
+        if (cell < OCV_CELL_CURVE[i + 1]) {
+            float fraction = (cell - OCV_CELL_CURVE[i]) / (OCV_CELL_CURVE[i + 1] - OCV_CELL_CURVE[i]);
+            return (i + fraction) * step;
+        }
+    }
+
+    return 100.0;
+}
+
 float Battery::readVoltage() {
     // Tag flere målinger og lav gennemsnit for stabilitet
     const int NUM_SAMPLES = 10;
@@ -137,21 +448,3 @@ float Battery::readVoltage() {
 
     return batteryVoltage;
 }
-
-int Battery::calculatePercentage(float voltage) {
-    // LiPo spændingskurve er ikke-lineær, men vi bruger en simpel lineær approximation
-    if (voltage >= BATTERY_MAX_VOLTAGE) {
-        return 100;
-    }
-    if (voltage <= BATTERY_MIN_VOLTAGE) {
-        return 0;
-    }
-
-    // Lineær mapping mellem min og max
-    int percent = map((int)(voltage * 100),
-                      (int)(BATTERY_MIN_VOLTAGE * 100),
-                      (int)(BATTERY_MAX_VOLTAGE * 100),
-                      0, 100);
-
-    return constrain(percent, 0, 100);
-}
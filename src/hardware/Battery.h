@@ -4,11 +4,27 @@
 #include <Arduino.h>
 #include "../config/Config.h"
 
+class Motors;
+class CuttingMechanism;
+
 /**
  * Battery klasse - Overvåger batteri status
  *
  * Denne klasse læser batteri spænding via ADC og beregner
  * batteri niveau og status.
+ *
+ * State of charge (SoC) findes ved coulomb counting: strømmen (BTS7960
+ * current sense + fast grundforbrug) integreres over tid. Spændingen
+ * bruges kun når batteriet har hvilet, hvor den slås op i en OCV kurve
+ * og langsomt trækker SoC på plads. Indre modstand estimeres løbende
+ * fra spring i strøm og spænding, så spændingen kan korrigeres for
+ * belastning - isLow() reagerer derfor ikke på spændingsfald op ad bakke.
+ * SoC og modstand gemmes i NVS og overlever genstart.
+ *
+ * Motorerne og klippemotoren kører normalt på et separat 5S batteri uden
+ * spændingsmåling. Dets forbrug tælles for sig (BTS7960 strøm plus
+ * MOTOR_BATTERY_BLADE_LOAD_A når kniven kører) og nulstilles af markFull(),
+ * så mission planneren kan planlægge på det batteri der faktisk tømmes.
  */
 class Battery {
 public:
@@ -23,12 +39,30 @@ public:
      */
     bool begin();
 
+    /**
+     * Sætter motorer der leverer strømmålinger til coulomb counting
+     * @param motors Pointer til Motors (nullptr = kun grundforbrug)
+     */
+    void setMotors(Motors* motors);
+
+    /**
+     * Sætter klippemotoren (tælles med i motor batteriets forbrug når den kører)
+     * @param cutting Pointer til CuttingMechanism (nullptr = kun drivmotorer)
+     */
+    void setCuttingMechanism(CuttingMechanism* cutting);
+
     /**
      * Opdaterer batteri målinger
      * Kalder denne regelmæssigt i loop()
      */
     void update();
 
+    /**
+     * Integrerer strømforbrug siden sidste kald (blokerer ikke)
+     * Kaldes efter Motors::updateCurrentReadings()
+     */
+    void updateCharge();
+
     /**
      * Hent batteri spænding
      * @return Spænding i Volt
@@ -41,14 +75,99 @@ public:
      */
     int getPercentage();
 
+    /**
+     * Hent state of charge
+     * @return Procent (0-100) med decimaler
+     */
+    float getStateOfCharge();
+
+    /**
+     * Hent resterende ladning
+     * @return Ah tilbage
+     */
+    float getRemainingAh();
+
+    /**
+     * Hent resterende energi
+     * @return Wh tilbage (ved nominel spænding)
+     */
+    float getRemainingWh();
+
+    /**
+     * Hent seneste målte strømforbrug
+     * @return Ampere (motorer + grundforbrug)
+     */
+    float getCurrent();
+
+    /**
+     * Hent motor batteriets strøm (drivmotorer + klippemotor)
+     * @return Ampere
+     */
+    float getMotorPackCurrent();
+
+    /**
+     * Hent motor batteriets resterende energi
+     * Med BATTERY_COUNT_MOTOR_CURRENT er det samme batteri som getRemainingWh().
+     * @return Wh tilbage (ved nominel spænding)
+     */
+    float getMotorPackRemainingWh();
+
+    /**
+     * Hent motor batteriets kapacitet
+     * @return Wh ved nominel spænding
+     */
+    float getMotorPackCapacityWh();
+
+    /**
+     * Hent gennemsnitligt strømforbrug
+     * @return Ampere (BATTERY_CURRENT_AVG_TAU_S tidskonstant)
+     */
+    float getAverageCurrent();
+
+    /**
+     * Hent estimeret indre modstand
+     * @return Ohm
+     */
+    float getInternalResistance();
+
+    /**
+     * Hent spænding korrigeret for belastning (V + I * R)
+     * @return Estimeret hvilespænding i Volt
+     */
+    float getRestVoltage();
+
+    /**
+     * Har batteriet hvilet længe nok til OCV korrektion?
+     */
+    bool isResting();
+
+    /**
+     * Sæt om batteriet lades (ladekontakten er lukket)
+     * Under ladning tælles forbrug ikke, og målt spænding er ladespændingen -
+     * OCV korrektionen springes over.
+     * @param active true mens robotten står i docken
+     */
+    void setCharging(bool active);
+
+    /**
+     * Lades batteriet?
+     */
+    bool isCharging();
+
+    /**
+     * Batteriet er ladet op - SoC sættes til 100 % og gemmes
+     */
+    void markFull();
+
     /**
      * Tjek om batteri er lavt
-     * @return true hvis under LOW_VOLTAGE threshold
+     * @return true hvis SoC under BATTERY_LOW_SOC eller hvilespænding under LOW_VOLTAGE
      */
     bool isLow();
 
     /**
      * Tjek om batteri er kritisk lavt
+     * Bruger målt spænding - under belastning er det den regulatoren ser.
      * @return true hvis under CRITICAL_VOLTAGE threshold
      */
     bool isCritical();
@@ -65,6 +184,18 @@ public:
      */
     int getEstimatedTimeRemaining(float currentDraw);
 
+    /**
+     * Hent estimeret resterende tid ud fra gennemsnitligt målt forbrug
+     * @return Estimeret minutter tilbage
+     */
+    int getEstimatedTimeRemaining();
+
+    /**
+     * Gemmer SoC og indre modstand i NVS med det samme
+     * @return true hvis gemt
+     */
+    bool saveState();
+
 private:
     /**
      * Læser rå ADC værdi og konverterer til spænding
@@ -73,16 +204,62 @@ private:
     float readVoltage();
 
     /**
-     * Beregner procent fra spænding
-     * @param voltage Spænding
-     * @return Procent (0-100)
+     * Slår hvilespænding op i OCV kurven
+     * @param restVoltage Spænding uden belastning (hele pakken)
+     * @return SoC i procent (0-100)
+     */
+    static float ocvToSoc(float restVoltage);
+
+    /**
+     * Måler strømforbrug lige nu
+     * @return Ampere (motorer + grundforbrug)
+     */
+    float readCurrent();
+
+    /**
+     * Opdaterer indre modstand fra spring i strøm og spænding
      */
-    int calculatePercentage(float voltage);
+    void updateResistance(float newVoltage, float newCurrent);
+
+    /**
+     * Retter SoC mod OCV kurven når batteriet hviler
+     */
+    void correctFromOcv();
+
+    /**
+     * Indlæser SoC og modstand fra NVS
+     * @param ocvSoc SoC fra OCV kurven ved opstart (negativ = ukendt, brug gemt)
+     * @return true hvis gemt tilstand blev brugt
+     */
+    bool loadState(float ocvSoc);
+
+    Motors* motorsPtr;
+    CuttingMechanism* cuttingPtr;
 
     // Nuværende batteri data
     float voltage;
     int percentage;
 
+    // State of charge
+    float soc;                      // Procent (0-100)
+    float current;                  // Seneste måling (A)
+    float averageCurrent;           // Filtreret (A)
+    float internalResistance;       // Ohm
+    float lastVoltage;              // Forrige spændings måling med tilhørende strøm
+    float lastVoltageCurrent;
+    unsigned long lastCharge;       // Sidste integration (ms)
+    unsigned long restSince;        // Sidst motorerne trak over BATTERY_REST_CURRENT_A (ms)
+    bool resting;
+    bool charging;
+    float savedSoc;
+    float savedResistance;
+
+    // Motor batteri (5S) - forbrug siden fuld opladning
+    float motorPackCurrent;         // Seneste måling (A)
+    float motorPackUsedAh;
+    float savedMotorPackUsedAh;
+    unsigned long lastSave;
+
     // Timing
     unsigned long lastUpdate;
 
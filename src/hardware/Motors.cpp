@@ -1,4 +1,5 @@
 #include "Motors.h"
+#include "../system/Logger.h"
 
 Motors::Motors() {
     currentLeftSpeed = 0;
@@ -7,6 +8,7 @@ Motors::Motors() {
     rightMotorCurrent = 0.0;
     lastCurrentUpdate = 0;
     emergencyStopped = false;
+    mux = portMUX_INITIALIZER_UNLOCKED;
 }
 
 bool Motors::begin() {
@@ -57,9 +59,7 @@ bool Motors::begin() {
 void Motors::setSpeed(int leftSpeed, int rightSpeed) {
     // Tjek for emergency stop
     if (emergencyStopped) {
-        #if DEBUG_MOTORS
-        Serial.println("[Motors] Emergency stop active - ignoring command");
-        #endif
+        LOGD(LOG_SUB_MOTORS, "Emergency stop active - ignoring command");
         return;
     }
 
@@ -75,16 +75,21 @@ void Motors::setSpeed(int leftSpeed, int rightSpeed) {
         rightSpeed = (rightSpeed > 0) ? MOTOR_MIN_SPEED : -MOTOR_MIN_SPEED;
     }
 
-    // Sæt motor hastigheder
+    // Sæt motor hastigheder - begge hjul og hastighederne som én kommando
+    portENTER_CRITICAL(&mux);
+    if (emergencyStopped) {
+        // Nødstop fra anden core mens hastigheden blev beregnet
+        portEXIT_CRITICAL(&mux);
+        return;
+    }
     setLeftMotor(leftSpeed);
     setRightMotor(rightSpeed);
 
     currentLeftSpeed = leftSpeed;
     currentRightSpeed = rightSpeed;
+    portEXIT_CRITICAL(&mux);
 
-    #if DEBUG_MOTORS
-    Serial.printf("[Motors] Set speed - Left: %d, Right: %d\n", leftSpeed, rightSpeed);
-    #endif
+    LOGD(LOG_SUB_MOTORS, "Set speed - Left: %d, Right: %d", leftSpeed, rightSpeed);
 }
 
 void Motors::forward(int speed) {
@@ -112,13 +117,12 @@ void Motors::turnRight(int speed) {
 void Motors::stop() {
     setSpeed(0, 0);
 
-    #if DEBUG_MOTORS
-    Serial.println("[Motors] Stopped");
-    #endif
+    LOGD(LOG_SUB_MOTORS, "Stopped");
 }
 
 void Motors::emergencyStop() {
     // Øjeblikkelig stop - stop alle PWM signaler
+    portENTER_CRITICAL(&mux);
     ledcWrite(MOTOR_LEFT_RPWM, 0);
     ledcWrite(MOTOR_LEFT_LPWM, 0);
     ledcWrite(MOTOR_RIGHT_RPWM, 0);
@@ -133,6 +137,7 @@ void Motors::emergencyStop() {
     currentLeftSpeed = 0;
     currentRightSpeed = 0;
     emergencyStopped = true;
+    portEXIT_CRITICAL(&mux);
 
     Serial.println("[Motors] !!! EMERGENCY STOP ACTIVATED !!!");
 }
@@ -183,14 +188,12 @@ void Motors::updateCurrentReadings() {
         rightMotorCurrent = readCurrent(MOTOR_RIGHT_L_IS);
     }
 
-    #if DEBUG_MOTORS
     static int currentLogCounter = 0;
     if (++currentLogCounter >= 50) { // Log hver 5 sekund
-        Serial.printf("[Motors] Current - Left: %.2fA, Right: %.2fA, Total: %.2fA\n",
-                     leftMotorCurrent, rightMotorCurrent, getTotalCurrent());
+        LOGD(LOG_SUB_MOTORS, "Current - Left: %.2fA, Right: %.2fA, Total: %.2fA",
+             leftMotorCurrent, rightMotorCurrent, getTotalCurrent());
         currentLogCounter = 0;
     }
-    #endif
 }
 
 bool Motors::isCurrentWarning() {
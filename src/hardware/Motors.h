@@ -10,6 +10,10 @@
  * Denne klasse kontrollerer venstre og højre motor via Double BTS7960 43A H-bridge.
  * Hastighed fra -255 (fuld baglæns) til 255 (fuld fremad).
  * Inkluderer strømovervågning via current sense pins.
+ *
+ * Hastighed skrives under en spinlock: DeadlineMonitor's supervisor på
+ * core 0 kan stoppe motorerne mens loop på core 1 sætter ny hastighed,
+ * og begge motorer skal ende med samme kommando.
  */
 class Motors {
 public:
@@ -150,7 +154,10 @@ private:
     unsigned long lastCurrentUpdate;
 
     // Emergency stop flag
-    bool emergencyStopped;
+    volatile bool emergencyStopped;
+
+    // Låser PWM skrivning og hastigheder mellem cores
+    portMUX_TYPE mux;
 
     // Note: PWM kanaler tildeles automatisk af ledcAttach() i ESP32 Arduino Core 3.x
 };
@@ -12,14 +12,24 @@ PerimeterReceiver::PerimeterReceiver()
     , _signalMagnitude(0)
     , _smoothedMagnitude(0)
     , _distanceToCable(0)
+    , _side(0)
     , _calibrationValue(1000)
     , _calibrated(false)
     , _sampleIndex(0)
     , _lastSampleTime(0)
     , _lastUpdate(0)
     , _lastSignalTime(0)
+    , _nearestLoop(PERIMETER_LOOP_COUNT > 1 ? -1 : 0)
+    , _lastLoopId(0)
+    , _loopMux(portMUX_INITIALIZER_UNLOCKED)
+    , _burstBusy(false)
+    , _idTask(nullptr)
 {
     memset(_samples, 0, sizeof(_samples));
+    memset(_loopLevel, 0, sizeof(_loopLevel));
+    memset(_loopPolarity, 0, sizeof(_loopPolarity));
+    memset(_burst, 0, sizeof(_burst));
+    buildCodeWaves();
 }
 
 // ============================================================================
@@ -38,6 +48,15 @@ bool PerimeterReceiver::begin() {
     analogReadResolution(12);  // 12-bit ADC
     analogSetAttenuation(ADC_11db);  // 0-3.3V range
 
+    #if PERIMETER_LOOP_COUNT > 1
+    // Burst og korrelation køres uden for loop()
+    if (xTaskCreatePinnedToCore(identifyTask, "perimeterId", 4096, this,
+                                PERIMETER_ID_TASK_PRIORITY, &_idTask, PERIMETER_ID_TASK_CORE) != pdPASS) {
+        Serial.println("[Perimeter] Loop identification task could not be started");
+        _idTask = nullptr;
+    }
+    #endif
+
     _initialized = true;
     _state = PERIMETER_NO_SIGNAL;
 
@@ -66,6 +85,43 @@ void PerimeterReceiver::update() {
         detectDirection();
         _lastUpdate = nowMs;
     }
+
+    // Identificér nærmeste sløjfe (kun når senderen driver flere) - tasken
+    // optager burstet, loop() springer sine egne samples over imens
+    #if PERIMETER_LOOP_COUNT > 1
+    if (_idTask != nullptr && !_burstBusy && nowMs - _lastLoopId >= PERIMETER_LOOP_ID_INTERVAL) {
+        _burstBusy = true;
+        xTaskNotifyGive(_idTask);
+        _lastLoopId = nowMs;
+    }
+    #endif
+}
+
+float PerimeterReceiver::getLateralOffset() const {
+    if (!hasSignal() || _side == 0) {
+        return 0.0;
+    }
+
+    // Samme skala som _signalStrength
+    float scale = (_calibrated && _calibrationValue > 0) ? 100.0 / _calibrationValue : 0.1;
+    float strength = constrain(_smoothedMagnitude * scale, 0.0f, 100.0f);
+    float distance = 100.0 - strength;
+
+    return (_side < 0) ? -distance : distance;
+}
+
+int PerimeterReceiver::getLoopLevel(uint8_t loop) const {
+    if (loop >= PERIMETER_LOOP_MAX) return 0;
+    return (int)_loopLevel[loop];
+}
+
+int PerimeterReceiver::getLoopPolarity(uint8_t loop) const {
+    if (loop >= PERIMETER_LOOP_MAX) return 0;
+    return _loopPolarity[loop];
+}
+
+bool PerimeterReceiver::isNearKeepOut() const {
+    return _nearestLoop >= 0 && (PERIMETER_KEEPOUT_LOOPS & (1 << _nearestLoop)) != 0;
 }
 
 String PerimeterReceiver::getStateString() const {
@@ -125,21 +181,29 @@ void PerimeterReceiver::reset() {
     _signalStrength = 0;
     _signalMagnitude = 0;
     _smoothedMagnitude = 0;
+    _side = 0;
     _sampleIndex = 0;
     memset(_samples, 0, sizeof(_samples));
+
+    portENTER_CRITICAL(&_loopMux);
+    _nearestLoop = PERIMETER_LOOP_COUNT > 1 ? -1 : 0;
+    memset(_loopLevel, 0, sizeof(_loopLevel));
+    memset(_loopPolarity, 0, sizeof(_loopPolarity));
+    portEXIT_CRITICAL(&_loopMux);
 }
 
 String PerimeterReceiver::getDebugInfo() const {
     char buf[200];
     snprintf(buf, sizeof(buf),
-             "State: %s | Dir: %s | Strength: %d%% | Mag: %d | Smooth: %d | Dist: %dcm | Cal: %d",
+             "State: %s | Dir: %s | Strength: %d%% | Mag: %d | Smooth: %d | Dist: %dcm | Cal: %d | Loop: %d",
              getStateString().c_str(),
              getDirectionString().c_str(),
              _signalStrength,
              _signalMagnitude,
              _smoothedMagnitude,
              _distanceToCable,
-             _calibrationValue);
+             _calibrationValue,
+             _nearestLoop);
     return String(buf);
 }
 
@@ -148,6 +212,9 @@ String PerimeterReceiver::getDebugInfo() const {
 // ============================================================================
 
 void PerimeterReceiver::sampleSignal() {
+    // ADC'en er optaget af identifikations burstet
+    if (_burstBusy) return;
+
     // Læs ADC værdi
     int value = analogRead(PERIMETER_SIGNAL_PIN);
 
@@ -223,12 +290,48 @@ void PerimeterReceiver::detectState() {
         return;
     }
 
+    // Siden bestemmes også på kablet, så sideafstanden er kontinuert
+    // gennem ON_WIRE båndet (se getLateralOffset)
+    int side = detectSide();
+    if (side != 0) {
+        _side = side;
+    }
+
     // Tjek om vi er på kablet (meget stærkt signal)
     if (_smoothedMagnitude > WIRE_THRESHOLD) {
         _state = PERIMETER_ON_WIRE;
         return;
     }
 
+    if (side > 0) {
+        _state = PERIMETER_INSIDE;
+    } else if (side < 0) {
+        _state = PERIMETER_OUTSIDE;
+    } else {
+        // Tæt på nul = på kablet
+        _state = PERIMETER_ON_WIRE;
+    }
+}
+
+int PerimeterReceiver::detectSide() {
+    // Flere sløjfer: fortegnet for den nærmeste sløjfe afgør - de rå samples
+    // kommer fra den sløjfe der sender i dette TDM slot
+    #if PERIMETER_LOOP_COUNT > 1
+    portENTER_CRITICAL(&_loopMux);
+    int nearest = _nearestLoop;
+    int polarity = (nearest >= 0) ? _loopPolarity[nearest] : 0;
+    portEXIT_CRITICAL(&_loopMux);
+
+    if (polarity != 0) {
+        bool insideLoop = polarity > 0;
+        // Inden for en forbudt ø er uden for plænen
+        if (PERIMETER_KEEPOUT_LOOPS & (1 << nearest)) {
+            insideLoop = !insideLoop;
+        }
+        return insideLoop ? 1 : -1;
+    }
+    #endif
+
     // Bestem om vi er inden for eller uden for
     // Dette baseres på signal polaritet
     // Positiv = inden for, Negativ = uden for
@@ -244,13 +347,11 @@ void PerimeterReceiver::detectState() {
     // Bemærk: Denne logik kan skal justeres baseret på hardware setup
     // Positiv gennemsnit indikerer typisk "inden for"
     if (avgSample > 10) {
-        _state = PERIMETER_INSIDE;
+        return 1;
     } else if (avgSample < -10) {
-        _state = PERIMETER_OUTSIDE;
-    } else {
-        // Tæt på nul = på kablet
-        _state = PERIMETER_ON_WIRE;
+        return -1;
     }
+    return 0;
 }
 
 void PerimeterReceiver::detectDirection() {
@@ -287,3 +388,138 @@ void PerimeterReceiver::detectDirection() {
         _direction = PERIMETER_CENTER;
     }
 }
+
+void PerimeterReceiver::buildCodeWaves() {
+    // Samme timing som senderen: 1 = 208 us + 208 us, 0 = 416 us + 416 us
+    const int highHalf = (1000000 / PERIMETER_CODE_HIGH_HZ + PERIMETER_ID_SAMPLE_US / 2) / PERIMETER_ID_SAMPLE_US;
+    const int lowHalf = (1000000 / PERIMETER_CODE_LOW_HZ + PERIMETER_ID_SAMPLE_US / 2) / PERIMETER_ID_SAMPLE_US;
+
+    for (int loop = 0; loop < PERIMETER_LOOP_MAX; loop++) {
+        int n = 0;
+        for (int bit = 0; bit < PERIMETER_CODE_LENGTH; bit++) {
+            int half = PERIMETER_LOOP_CODES[loop][bit] ? highHalf : lowHalf;
+            for (int i = 0; i < half && n < PERIMETER_ID_SAMPLES; i++) _codeWave[loop][n++] = 1;
+            for (int i = 0; i < half && n < PERIMETER_ID_SAMPLES; i++) _codeWave[loop][n++] = -1;
+        }
+        _codeSamples[loop] = n;
+    }
+}
+
+#if PERIMETER_LOOP_COUNT > 1
+void PerimeterReceiver::identifyTask(void* arg) {
+    static_cast<PerimeterReceiver*>(arg)->identifyTaskLoop();
+}
+
+void PerimeterReceiver::identifyTaskLoop() {
+    while (true) {
+        // update() sætter _burstBusy og vækker tasken
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        captureBurst();
+        _burstBusy = false;
+        identifyLoop();
+    }
+}
+#endif
+
+void PerimeterReceiver::captureBurst() {
+    // Burst med fast sample interval (~20 ms) - kører i identifikations tasken
+    unsigned long next = micros();
+    long sum = 0;
+    for (int i = 0; i < PERIMETER_ID_SAMPLES; i++) {
+        long wait = (long)(next - micros());
+        if (wait > 0) {
+            delayMicroseconds(wait);
+        }
+        _burst[i] = analogRead(PERIMETER_SIGNAL_PIN) - 2048;
+        sum += _burst[i];
+        next += PERIMETER_ID_SAMPLE_US;
+    }
+
+    // Fjern DC så kun signalet korreleres
+    int16_t mean = sum / PERIMETER_ID_SAMPLES;
+    for (int i = 0; i < PERIMETER_ID_SAMPLES; i++) {
+        _burst[i] -= mean;
+    }
+}
+
+void PerimeterReceiver::identifyLoop() {
+    // Niveau og fortegn pr. sløjfe holdes over de slots hvor sløjfen ikke sendte
+    float levels[PERIMETER_LOOP_MAX];
+    int8_t polarity[PERIMETER_LOOP_MAX];
+
+    portENTER_CRITICAL(&_loopMux);
+    memcpy(levels, _loopLevel, sizeof(levels));
+    memcpy(polarity, _loopPolarity, sizeof(polarity));
+    int previous = _nearestLoop;
+    portEXIT_CRITICAL(&_loopMux);
+
+    int peaks[PERIMETER_LOOP_MAX];
+    int burstMax = -1;
+    float burstLevel = 0.0;
+    float secondLevel = 0.0;
+    for (int loop = 0; loop < PERIMETER_LOOP_COUNT; loop++) {
+        peaks[loop] = correlateLoop(loop);
+        float level = (float)abs(peaks[loop]);
+        if (level > burstLevel) {
+            secondLevel = burstLevel;
+            burstLevel = level;
+            burstMax = loop;
+        } else if (level > secondLevel) {
+            secondLevel = level;
+        }
+    }
+
+    // Kun sløjfen der sendte i dette burst giver et gyldigt fortegn. De andre
+    // koder korrelerer også med den (op til 0.42) - deres fortegn er støj.
+    if (burstMax >= 0 && burstLevel >= PERIMETER_LOOP_MIN_LEVEL &&
+        burstLevel >= secondLevel * (float)PERIMETER_LOOP_DOMINANCE) {
+        polarity[burstMax] = (peaks[burstMax] > 0) ? 1 : -1;
+    }
+
+    int best = -1;
+    float bestLevel = PERIMETER_LOOP_MIN_LEVEL;
+    for (int loop = 0; loop < PERIMETER_LOOP_COUNT; loop++) {
+        float level = (float)abs(peaks[loop]);
+        levels[loop] = max(level, levels[loop] * (float)PERIMETER_LOOP_DECAY);
+
+        if (levels[loop] >= bestLevel) {
+            bestLevel = levels[loop];
+            best = loop;
+        }
+    }
+
+    portENTER_CRITICAL(&_loopMux);
+    memcpy(_loopLevel, levels, sizeof(levels));
+    memcpy(_loopPolarity, polarity, sizeof(polarity));
+    _nearestLoop = best;
+    portEXIT_CRITICAL(&_loopMux);
+
+    if (best != previous) {
+        Serial.printf("[Perimeter] Nearest loop: %d (level %.0f)%s\n", best, bestLevel,
+                      (best >= 0 && (PERIMETER_KEEPOUT_LOOPS & (1 << best))) ? " - keep-out" : "");
+    }
+}
+
+int PerimeterReceiver::correlateLoop(uint8_t loop) const {
+    // Bedste fase: max |sum(burst * kode)| over alle forskydninger af koden.
+    // Fortegnet bevares - koderne er valgt så den inverterede bølgeform
+    // aldrig korrelerer bedre end den rigtige (polaritet = inden for/uden for)
+    const int8_t* wave = _codeWave[loop];
+    int n = _codeSamples[loop];
+    long best = 0;
+
+    for (int shift = 0; shift < n; shift++) {
+        long acc = 0;
+        int k = shift;
+        for (int i = 0; i < PERIMETER_ID_SAMPLES; i++) {
+            acc += _burst[i] * wave[k];
+            if (++k >= n) k = 0;
+        }
+        if (labs(acc) > labs(best)) {
+            best = acc;
+        }
+    }
+
+    // Gennemsnitlig amplitude i ADC enheder (med fortegn)
+    return best / PERIMETER_ID_SAMPLES;
+}
@@ -3,6 +3,7 @@
 
 #include <Arduino.h>
 #include "../config/Config.h"
+#include "PerimeterCodes.h"
 
 /**
  * PerimeterReceiver - Modtager perimeter wire signal
@@ -14,6 +15,19 @@
  * - Detekterer om robotten er inden for eller uden for perimeteren
  * - Måler signalstyrke for afstandsestimering
  * - Detekterer signalretning (til venstre/højre for kablet)
+ * - Identificerer nærmeste sløjfe når senderen driver flere (PERIMETER_LOOP_COUNT)
+ *
+ * Sløjfe identifikation: hvert PERIMETER_LOOP_ID_INTERVAL ms optager en
+ * task på PERIMETER_ID_TASK_CORE et kort burst (PERIMETER_ID_SAMPLES à
+ * PERIMETER_ID_SAMPLE_US) og korrelerer det mod hver sløjfes kode i alle
+ * faser - loop() venter aldrig på burstet. Niveau og fortegn pr. sløjfe
+ * holdes med PERIMETER_LOOP_DECAY, så en sløjfe der ikke sendte under
+ * burstet ikke forsvinder.
+ *
+ * Med flere sløjfer afgøres inden for/uden for af korrelationens fortegn
+ * for den nærmeste sløjfe - ikke af de rå samples, som kommer fra den
+ * sløjfe der tilfældigvis sender i TDM slottet. Kun en forbudt ø
+ * (PERIMETER_KEEPOUT_LOOPS) får sit resultat byttet om.
  */
 
 // Perimeter tilstande
@@ -99,6 +113,39 @@ public:
      */
     int getDistanceToCable() const { return _distanceToCable; }
 
+    /**
+     * Henter fortegnsbestemt sideafstand til kablet (cm)
+     * Samme model som getDistanceToCable(), men fra glattet magnitude uden
+     * afrunding til hele procent - til kontinuerlig styring. Også i ON_WIRE
+     * båndet: fortegnet er den side signalet sidst viste.
+     * @return Positiv = inden for, negativ = uden for, 0 = på kablet eller intet signal
+     */
+    float getLateralOffset() const;
+
+    /**
+     * Henter nærmeste sløjfe
+     * @return Sløjfe nummer, eller -1 hvis ingen er identificeret
+     */
+    int getNearestLoop() const { return _nearestLoop; }
+
+    /**
+     * Henter korrelations niveau for en sløjfe (holdt over TDM runden)
+     * @param loop Sløjfe
+     */
+    int getLoopLevel(uint8_t loop) const;
+
+    /**
+     * Er nærmeste sløjfe en forbudt ø?
+     */
+    bool isNearKeepOut() const;
+
+    /**
+     * Henter fortegn for en sløjfe (fra seneste burst hvor den sendte)
+     * @param loop Sløjfe
+     * @return 1 = inden for sløjfen, -1 = uden for, 0 = ikke hørt endnu
+     */
+    int getLoopPolarity(uint8_t loop) const;
+
     /**
      * Kalibrerer modtageren (skal udføres på kablet)
      */
@@ -124,6 +171,7 @@ private:
     int _signalMagnitude;       // Rå magnitude
     int _smoothedMagnitude;     // Glattet magnitude
     int _distanceToCable;       // Estimeret afstand i cm
+    int8_t _side;               // 1 = inden for, -1 = uden for, 0 = ukendt (holdes over kablet)
 
     // Kalibrering
     int _calibrationValue;      // Kalibreret max signal
@@ -139,6 +187,18 @@ private:
     unsigned long _lastUpdate;
     unsigned long _lastSignalTime;
 
+    // Sløjfe identifikation (skrives af identifikations tasken under _loopMux)
+    int _nearestLoop;
+    float _loopLevel[PERIMETER_LOOP_MAX];
+    int8_t _loopPolarity[PERIMETER_LOOP_MAX];                       // 1 = inden for, -1 = uden for, 0 = ukendt
+    int8_t _codeWave[PERIMETER_LOOP_MAX][PERIMETER_ID_SAMPLES];    // +1/-1 pr. sample
+    uint16_t _codeSamples[PERIMETER_LOOP_MAX];                      // Samples i én kode cyklus
+    int16_t _burst[PERIMETER_ID_SAMPLES];
+    unsigned long _lastLoopId;
+    portMUX_TYPE _loopMux;
+    volatile bool _burstBusy;   // Tasken ejer ADC'en mens burstet optages
+    TaskHandle_t _idTask;
+
     // Konfiguration
     static const int SIGNAL_TIMEOUT_MS = 1000;      // Timeout for signal tab
     static const int MIN_SIGNAL_THRESHOLD = 50;     // Minimum signal for detektion
@@ -149,9 +209,18 @@ private:
     void sampleSignal();
     void processSignal();
     void detectState();
+    int detectSide();
     void detectDirection();
     int calculateMagnitude();
     void updateSmoothedMagnitude();
+    void buildCodeWaves();
+    void captureBurst();
+    void identifyLoop();
+    int correlateLoop(uint8_t loop) const;
+    #if PERIMETER_LOOP_COUNT > 1
+    void identifyTaskLoop();
+    static void identifyTask(void* arg);
+    #endif
 };
 
 #endif // PERIMETER_RECEIVER_H
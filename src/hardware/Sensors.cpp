@@ -111,6 +111,10 @@ float Sensors::getMinDistance() {
     return minDist;
 }
 
+unsigned long Sensors::getLastUpdateTime() {
+    return lastUpdate;
+}
+
 void Sensors::printValues() {
     Serial.printf("[Sensors] L: %.1f cm, M: %.1f cm, R: %.1f cm | Obstacles: ",
                   leftDistance, middleDistance, rightDistance);
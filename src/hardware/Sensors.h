@@ -77,6 +77,12 @@ public:
      */
     float getMinDistance();
 
+    /**
+     * Hent tidspunkt for seneste måling
+     * @return millis() ved seneste update der målte
+     */
+    unsigned long getLastUpdateTime();
+
     /**
      * Print sensor værdier til Serial (debug)
      */
@@ -40,6 +40,12 @@
 #include "system/StateManager.h"
 #include "system/WiFiManager.h"
 #include "system/UpdateManager.h"
+#include "system/BlackBox.h"
+#include "system/LoopProfiler.h"
+#include "system/SafetyMonitor.h"
+#if ENABLE_WATCHDOG
+#include "system/DeadlineMonitor.h"
+#endif
 
 // Hardware
 #include "hardware/Motors.h"
@@ -53,11 +59,20 @@
 #include "hardware/PerimeterReceiver.h"
 #include "system/PerimeterClient.h"
 #endif
+#include "system/SessionCheckpoint.h"
+#include "system/StatsStore.h"
 
 // Navigation
 #include "navigation/PathPlanner.h"
 #include "navigation/ObstacleAvoidance.h"
 #include "navigation/Movement.h"
+#include "navigation/OccupancyGrid.h"
+#include "navigation/LocalPlanner.h"
+#include "navigation/ZoneManager.h"
+#include "navigation/MissionPlanner.h"
+#include "navigation/DockingController.h"
+#include "navigation/WireFollower.h"
+#include "navigation/SignalSearch.h"
 
 // Web
 #include "web/WebServer.h"
@@ -76,6 +91,16 @@
 StateManager stateManager;
 WiFiManager wifiManager;
 UpdateManager updateManager;
+#if ENABLE_PROFILER
+LoopProfiler profiler;
+#endif
+#if ENABLE_BLACKBOX
+BlackBox blackBox;
+#endif
+SafetyMonitor safetyMonitor;
+#if ENABLE_WATCHDOG
+DeadlineMonitor deadlineMonitor;
+#endif
 
 // Hardware
 Motors motors;
@@ -94,6 +119,29 @@ PerimeterClient perimeterClient;
 PathPlanner pathPlanner;
 ObstacleAvoidance obstacleAvoid;
 Movement movement;
+OccupancyGrid localMap;
+LocalPlanner localPlanner;
+unsigned long lastMapSampleTime = 0;    // Seneste sonar måling indført i kortet
+#if ENABLE_ZONES
+ZoneManager zoneManager;
+#endif
+#if ENABLE_MISSION_PLANNER
+MissionPlanner missionPlanner;
+#endif
+#if ENABLE_PERIMETER
+WireFollower wireFollower;
+SignalSearch signalSearch;
+#endif
+#if ENABLE_PERIMETER && ENABLE_DOCKING
+DockingController docking;
+#endif
+#if ENABLE_CHECKPOINT
+SessionCheckpoint checkpoint;
+volatile bool checkpointClearRequested = false;   // Sat fra web (AsyncTCP task)
+#endif
+#if ENABLE_STATS
+StatsStore stats;
+#endif
 
 // Web
 MowerWebServer webServer;
@@ -110,7 +158,18 @@ Timer websocketUpdateTimer(WEBSOCKET_UPDATE_INTERVAL, true);
 Timer currentUpdateTimer(100, true); // Strømovervågning hver 100ms
 #if ENABLE_PERIMETER
 Timer perimeterUpdateTimer(50, true);  // Perimeter opdatering 20Hz
-Timer perimeterSenderTimer(5000, true); // Sender status check hver 5 sek
+#endif
+#if ENABLE_PERIMETER && ENABLE_DOCKING
+Timer dockTimer(DOCK_UPDATE_INTERVAL, true);
+#endif
+#if ENABLE_BLACKBOX
+Timer blackBoxTimer(BLACKBOX_TELEMETRY_INTERVAL, true);
+#endif
+#if ENABLE_CHECKPOINT
+Timer checkpointTimer(CHECKPOINT_UPDATE_INTERVAL, true);
+#endif
+#if ENABLE_STATS
+Timer statsTimer(STATS_UPDATE_INTERVAL, true);
 #endif
 
 // Kalibrerings type enum
@@ -130,28 +189,57 @@ volatile CalibrationType pendingCalibration = CAL_NONE;
 void initializeHardware();
 void initializeNavigation();
 void initializeWeb();
-void runStateMachine();
-void handleIdleState();
-void handleManualState();
+void registerStateHooks();
+void enterIdleState();
+void enterCalibratingState();
 void handleCalibratingState();
+void enterMowingState();
+bool resumeFromCheckpoint();
+bool checkpointNeedsRowStart();
 void handleMowingState();
+void endRow();
+void exitMowingState();
+void enterTurningState();
 void handleTurningState();
+void exitTurningState();
+void finishTurn();
+void enterAvoidingState();
 void handleAvoidingState();
+void enterErrorState();
 void handleErrorState();
 void updateSensors();
+void updateLocalMap();
+void updateDeadReckoning();
 void updateIMU();
 void updateDisplay();
 void updateBattery();
 void updateWebStatus();
 void updateMotorCurrent();
 void checkSafetyConditions();
+#if ENABLE_BLACKBOX
+void recordBlackBox();
+#endif
+#if ENABLE_CHECKPOINT
+void updateCheckpoint();
+void recordCheckpoint(bool inField);
+#endif
 #if ENABLE_PERIMETER
 void updatePerimeter();
 void handlePerimeterBoundary();
+void enterReturningState();
 void handleReturningState();
+void exitReturningState();
+#if ENABLE_DOCKING
+void updateDock();
+void enterChargingState();
+void handleChargingState();
+void exitChargingState();
+#endif
+void enterSearchingState();
 void handleSearchingSignalState();
+void exitSearchingState();
 void followPerimeterWire();
-void searchForPerimeterSignal();
+void mowAlongWire();
 #endif
 
 // ============================================================================
@@ -177,6 +265,27 @@ void setup() {
         Logger::error("Failed to initialize State Manager");
         while(1) delay(1000);
     }
+    registerStateHooks();
+
+    // Initialize Black Box (før hardware så init-fejl optages)
+    #if ENABLE_BLACKBOX
+    if (blackBox.begin()) {
+        Logger::setBlackBox(&blackBox);
+        stateManager.setBlackBox(&blackBox);
+    } else {
+        Logger::warning("Black box disabled - continuing without");
+    }
+    #endif
+
+    // Initialize Safety Monitor (før hardware, så init-fejl også stopper motorerne)
+    if (safetyMonitor.begin(&stateManager, &motors, &cuttingMech)) {
+        safetyMonitor.setBattery(&battery);
+        safetyMonitor.setIMU(&imu);
+        safetyMonitor.setObstacleAvoidance(&obstacleAvoid, &sensors);
+        #if ENABLE_PERIMETER
+        safetyMonitor.setPerimeterReceiver(&perimeterReceiver);
+        #endif
+    }
 
     // Initialize Hardware
     initializeHardware();
@@ -187,6 +296,22 @@ void setup() {
     // Initialize Web Server
     initializeWeb();
 
+    // Deadlines og task watchdog armeres sidst - init ovenfor må blokere
+    #if ENABLE_WATCHDOG
+    deadlineMonitor.registerTask(DEADLINE_MOTOR, "motor", 0, DEADLINE_MOTOR_MS);
+    deadlineMonitor.registerTask(DEADLINE_SENSORS, "sensors", SENSOR_UPDATE_INTERVAL,
+                                 SENSOR_UPDATE_INTERVAL * DEADLINE_PERIOD_FACTOR);
+    deadlineMonitor.registerTask(DEADLINE_IMU, "imu", IMU_UPDATE_INTERVAL,
+                                 IMU_UPDATE_INTERVAL * DEADLINE_PERIOD_FACTOR);
+    #if ENABLE_PERIMETER
+    deadlineMonitor.registerTask(DEADLINE_PERIMETER, "perimeter", 50, 50 * DEADLINE_PERIOD_FACTOR);
+    #endif
+    deadlineMonitor.registerTask(DEADLINE_SAFETY, "safety", 0, DEADLINE_SAFETY_MS);
+    if (!deadlineMonitor.begin(&motors)) {
+        Logger::warning("Deadline monitor disabled - continuing without");
+    }
+    #endif
+
     // Display startup complete (deaktiveret - ingen display på ESP32-WROOM-32U)
     // #if ENABLE_DISPLAY
     // display.showSplash();
@@ -205,15 +330,27 @@ void setup() {
 // ============================================================================
 
 void loop() {
+    #if ENABLE_PROFILER
+    profiler.beginLoop();
+    #endif
+
     // Update timers
     if (sensorUpdateTimer.isExpired()) {
+        PROFILE_SECTION(profiler, PERF_SENSORS);
         updateSensors();
         sensorUpdateTimer.reset();
+        #if ENABLE_WATCHDOG
+        deadlineMonitor.taskRan(DEADLINE_SENSORS);
+        #endif
     }
 
     if (imuUpdateTimer.isExpired()) {
+        PROFILE_SECTION(profiler, PERF_IMU);
         updateIMU();
         imuUpdateTimer.reset();
+        #if ENABLE_WATCHDOG
+        deadlineMonitor.taskRan(DEADLINE_IMU);
+        #endif
     }
 
     if (displayUpdateTimer.isExpired()) {
@@ -221,50 +358,121 @@ void loop() {
         displayUpdateTimer.reset();
     }
 
+    #if ENABLE_CHECKPOINT
+    if (checkpointTimer.isExpired()) {
+        updateCheckpoint();
+        checkpointTimer.reset();
+    }
+    #endif
+
+    #if ENABLE_STATS
+    if (statsTimer.isExpired()) {
+        stats.update(pathPlanner.getZoneId());
+        statsTimer.reset();
+    }
+    #endif
+
     if (batteryCheckTimer.isExpired()) {
+        PROFILE_SECTION(profiler, PERF_BATTERY);
         updateBattery();
         batteryCheckTimer.reset();
     }
 
     if (statusUpdateTimer.isExpired()) {
+        PROFILE_SECTION(profiler, PERF_WEB_STATUS);
         updateWebStatus();
         statusUpdateTimer.reset();
     }
 
     if (currentUpdateTimer.isExpired()) {
+        PROFILE_SECTION(profiler, PERF_MOTOR_CURRENT);
         updateMotorCurrent();
         currentUpdateTimer.reset();
     }
 
     #if ENABLE_PERIMETER
     if (perimeterUpdateTimer.isExpired()) {
+        PROFILE_SECTION(profiler, PERF_PERIMETER);
         updatePerimeter();
         perimeterUpdateTimer.reset();
+        #if ENABLE_WATCHDOG
+        deadlineMonitor.taskRan(DEADLINE_PERIMETER);
+        #endif
+    }
+
+    #if ENABLE_DOCKING
+    if (dockTimer.isExpired()) {
+        updateDock();
+        dockTimer.reset();
     }
+    #endif
+
+    {
+        // Asynkron - starter requests og behandler svar, venter aldrig på senderen
+        PROFILE_SECTION(profiler, PERF_PERIMETER_CLIENT);
+        perimeterClient.update();
 
-    if (perimeterSenderTimer.isExpired()) {
-        perimeterClient.updateStatus();
-        perimeterSenderTimer.reset();
+        // Heartbeat melder kabelbrud længe før modtagerens signal falder væk
+        if (perimeterClient.hasSenderFault()) {
+            safetyMonitor.reportSenderFault(perimeterClient.getLinkErrorName());
+        }
+    }
+    #endif
+
+    #if ENABLE_BLACKBOX
+    {
+        PROFILE_SECTION(profiler, PERF_BLACKBOX);
+        if (blackBoxTimer.isExpired()) {
+            recordBlackBox();
+            blackBoxTimer.reset();
+        }
+        blackBox.update();
     }
     #endif
 
     // Update WiFi Manager (reconnect handling)
     #if ENABLE_WIFI_MANAGER
-    wifiManager.update();
+    {
+        PROFILE_SECTION(profiler, PERF_WIFI);
+        wifiManager.update();
+    }
+    #endif
+
+    {
+        PROFILE_SECTION(profiler, PERF_STATE_MACHINE);
+
+        // Update state manager
+        stateManager.update();
+
+        // Kør aktiv tilstands onTick hook
+        stateManager.tick();
+    }
+    #if ENABLE_WATCHDOG
+    deadlineMonitor.taskRan(DEADLINE_MOTOR);
     #endif
 
-    // Update state manager
-    stateManager.update();
+    {
+        PROFILE_SECTION(profiler, PERF_WEB);
+
+        // Update web server
+        webServer.update();
+        webSocket.update();
+    }
 
-    // Run state machine
-    runStateMachine();
+    {
+        PROFILE_SECTION(profiler, PERF_SAFETY);
 
-    // Update web server
-    webServer.update();
-    webSocket.update();
+        // Check safety conditions
+        checkSafetyConditions();
+    }
+    #if ENABLE_WATCHDOG
+    deadlineMonitor.taskRan(DEADLINE_SAFETY);
+    deadlineMonitor.feed();
+    #endif
 
-    // Check safety conditions
-    checkSafetyConditions();
+    #if ENABLE_PROFILER
+    profiler.endLoop();
+    #endif
 
     // Small delay to prevent watchdog issues
     delay(1);
@@ -314,7 +522,9 @@ void initializeHardware() {
         return;
     }
 
-    // Battery
+    // Battery (motorstrøm bruges til coulomb counting)
+    battery.setMotors(&motors);
+    battery.setCuttingMechanism(&cuttingMech);
     if (!battery.begin()) {
         Logger::error("Failed to initialize Battery monitor");
         stateManager.handleError("Battery monitor initialization failed");
@@ -330,7 +540,7 @@ void initializeHardware() {
 
     Logger::info("Initializing perimeter wire client...");
     if (!perimeterClient.begin()) {
-        Logger::warning("Failed to connect to Perimeter Sender - will retry");
+        Logger::warning("Failed to initialize Perimeter Client - continuing without");
     }
     #endif
 
@@ -346,6 +556,35 @@ void initializeNavigation() {
         return;
     }
 
+    // Session checkpoint (genoptag mønster efter genstart)
+    #if ENABLE_CHECKPOINT
+    if (!checkpoint.begin()) {
+        Logger::warning("Failed to initialize checkpoint - mowing restarts from row 0 after reboot");
+    }
+    #endif
+
+    // Statistik (klippetid, distance og energi)
+    #if ENABLE_STATS
+    stats.setMotors(&motors);
+    if (!stats.begin(&battery, &stateManager)) {
+        Logger::warning("Failed to initialize stats - no mowing statistics");
+    }
+    #endif
+
+    // Mission planner (hvor mange rækker batteriet rækker til)
+    #if ENABLE_MISSION_PLANNER
+    if (!missionPlanner.begin(&battery, &pathPlanner)) {
+        Logger::warning("Failed to initialize Mission Planner - returning on low battery only");
+    }
+    #endif
+
+    // Zoner (planer beregnes her hvis cachen ikke er aktuel)
+    #if ENABLE_ZONES
+    if (!zoneManager.begin()) {
+        Logger::warning("Failed to load zones - using default pattern");
+    }
+    #endif
+
     // Obstacle Avoidance
     if (!obstacleAvoid.begin()) {
         Logger::error("Failed to initialize Obstacle Avoidance");
@@ -358,6 +597,25 @@ void initializeNavigation() {
         return;
     }
 
+    // Kabel følgning hjem
+    #if ENABLE_PERIMETER
+    if (!wireFollower.begin(&motors, &perimeterReceiver)) {
+        Logger::warning("Failed to initialize wire follower - return to base disabled");
+    }
+
+    // Signal søgning (spor med signal til bak ved signal tab)
+    if (!signalSearch.begin(&motors, &imu, &perimeterReceiver)) {
+        Logger::warning("Failed to initialize signal search - signal loss stops the robot");
+    }
+    #endif
+
+    // Ladestation (ladekontakt og slutindkørsel)
+    #if ENABLE_PERIMETER && ENABLE_DOCKING
+    if (!docking.begin(&motors, &perimeterReceiver)) {
+        Logger::warning("Failed to initialize docking - robot stops at the dock");
+    }
+    #endif
+
     Logger::info("Navigation initialized successfully");
 }
 
@@ -387,6 +645,9 @@ void initializeWeb() {
     #if ENABLE_AUTO_UPDATE
     webServer.setUpdateManager(&updateManager);
     #endif
+    #if ENABLE_WATCHDOG
+    webServer.setDeadlineMonitor(&deadlineMonitor);
+    #endif
 
     if (!webServer.begin()) {
         Logger::error("Failed to initialize Web Server");
@@ -405,6 +666,37 @@ void initializeWeb() {
     #if ENABLE_PERIMETER
     // Set perimeter references for API
     webAPI.setPerimeterReferences(&perimeterReceiver, &perimeterClient);
+    webAPI.setWireFollower(&wireFollower);
+    webAPI.setSignalSearch(&signalSearch);
+    #endif
+
+    #if ENABLE_BLACKBOX
+    webAPI.setBlackBox(&blackBox);
+    #endif
+
+    #if ENABLE_PROFILER
+    webAPI.setProfiler(&profiler);
+    #endif
+    #if ENABLE_WATCHDOG
+    webAPI.setDeadlineMonitor(&deadlineMonitor);
+    #endif
+
+    webAPI.setNavigationReferences(&localMap, &localPlanner);
+
+    #if ENABLE_ZONES
+    webAPI.setZoneManager(&zoneManager);
+    #endif
+    #if ENABLE_MISSION_PLANNER
+    webAPI.setMissionPlanner(&missionPlanner);
+    #endif
+    #if ENABLE_CHECKPOINT
+    webAPI.setSessionCheckpoint(&checkpoint);
+    #endif
+    #if ENABLE_STATS
+    webAPI.setStatsStore(&stats);
+    #endif
+    #if ENABLE_PERIMETER && ENABLE_DOCKING
+    webAPI.setDockingController(&docking);
     #endif
 
     // Setup API routes
@@ -423,104 +715,81 @@ void initializeWeb() {
 
     Logger::info("Web server initialized successfully");
 
-    // Log access info
+    // Log access info (WiFi forbinder i baggrunden - IP logges af WiFiManager når den er klar)
     String accessInfo = wifiManager.isAPMode() ?
         "Captive Portal: Connect to '" + String(CAPTIVE_PORTAL_SSID) + "' and open http://" + wifiManager.getIPAddress() :
-        "Web Interface: http://robot-mower.local or http://" + wifiManager.getIPAddress();
+        wifiManager.isConnected() ?
+        "Web Interface: http://robot-mower.local or http://" + wifiManager.getIPAddress() :
+        "Web Interface: http://robot-mower.local (WiFi connecting...)";
     Logger::info(accessInfo);
 }
 
 // ============================================================================
 // STATE MACHINE
 // ============================================================================
+// Hver tilstand har onEnter/onTick/onExit hooks registreret i StateManager.
+// Overgange sker via hændelser (se transition tabellen i StateManager.cpp).
+// State-lokale data nedenfor nulstilles i onEnter, så intet lækker mellem besøg.
+
+CalibrationType activeCalibration = CAL_NONE;   // CALIBRATING: valgt kalibrering
+bool avoidanceManeuverDone = false;             // AVOIDING: manøvre udført
+bool mowStartRefused = false;                   // MOWING: start afvist, PAUSE er sendt
+bool smoothTurnActive = false;                  // TURNING: profil fra TurnPlanner køres
+#if ENABLE_PERIMETER
+bool resumeAfterCharge = false;                 // RETURNING/CHARGING: klipning afbrudt for at lade
+unsigned long chargedSince = 0;                 // CHARGING: ladespændingen nået (0 = ikke endnu)
+#endif
 
-void runStateMachine() {
-    RobotState currentState = stateManager.getState();
-
-    switch (currentState) {
-        case STATE_IDLE:
-            handleIdleState();
-            break;
-
-        case STATE_MANUAL:
-            handleManualState();
-            break;
-
-        case STATE_CALIBRATING:
-            handleCalibratingState();
-            break;
-
-        case STATE_MOWING:
-            handleMowingState();
-            break;
-
-        case STATE_TURNING:
-            handleTurningState();
-            break;
-
-        case STATE_AVOIDING:
-            handleAvoidingState();
-            break;
-
-        #if ENABLE_PERIMETER
-        case STATE_RETURNING:
-            handleReturningState();
-            break;
-
-        case STATE_SEARCHING_SIGNAL:
-            handleSearchingSignalState();
-            break;
-        #endif
-
-        case STATE_ERROR:
-            handleErrorState();
-            break;
-
-        default:
-            break;
-    }
+void registerStateHooks() {
+    //                          Tilstand                 onEnter                 onTick                       onExit
+    stateManager.setStateHooks(STATE_IDLE,             enterIdleState,         nullptr,                     nullptr);
+    stateManager.setStateHooks(STATE_MANUAL,           nullptr,                nullptr,                     nullptr);
+    stateManager.setStateHooks(STATE_CALIBRATING,      enterCalibratingState,  handleCalibratingState,      nullptr);
+    stateManager.setStateHooks(STATE_MOWING,           enterMowingState,       handleMowingState,           exitMowingState);
+    stateManager.setStateHooks(STATE_TURNING,          enterTurningState,      handleTurningState,          exitTurningState);
+    stateManager.setStateHooks(STATE_AVOIDING,         enterAvoidingState,     handleAvoidingState,         nullptr);
+    #if ENABLE_PERIMETER
+    stateManager.setStateHooks(STATE_RETURNING,        enterReturningState,    handleReturningState,        exitReturningState);
+    stateManager.setStateHooks(STATE_SEARCHING_SIGNAL, enterSearchingState,    handleSearchingSignalState,  exitSearchingState);
+    #endif
+    #if ENABLE_PERIMETER && ENABLE_DOCKING
+    stateManager.setStateHooks(STATE_CHARGING,         enterChargingState,     handleChargingState,         exitChargingState);
+    #endif
+    stateManager.setStateHooks(STATE_ERROR,            enterErrorState,        handleErrorState,            nullptr);
 }
 
-void handleIdleState() {
-    // Robot er idle - venter på kommando
+void enterIdleState() {
+    // Robot er idle - stop alt én gang ved indgang.
+    // Manuelle kommandoer skifter til MANUAL, så intet andet kører motorerne her.
     motors.stop();
     cuttingMech.stop();
 }
 
-void handleManualState() {
-    // Manuel kontrol - state machine gør ingenting
-    // Motorerne styres direkte via API kommandoer
-    // Ingen automatisk stop eller overskriv af kommandoer
+void enterCalibratingState() {
+    // Bestem kalibrerings type
+    activeCalibration = pendingCalibration;
+    if (activeCalibration == CAL_NONE) {
+        activeCalibration = CAL_GYRO; // Default til gyro
+    }
+    pendingCalibration = CAL_NONE;
 }
 
 void handleCalibratingState() {
+    // Kalibrering blokerer loop (magnetometer 30 sek) - motorerne står stille
+    #if ENABLE_WATCHDOG
+    deadlineMonitor.suspend("calibration");
+    #endif
+
     // Håndterer forskellige typer kalibrering
-    static bool calibrationStarted = false;
-    static CalibrationType currentCalType = CAL_NONE;
-
-    if (!calibrationStarted) {
-        // Bestem kalibrerings type
-        currentCalType = pendingCalibration;
-        if (currentCalType == CAL_NONE) {
-            currentCalType = CAL_GYRO; // Default til gyro
-        }
-        pendingCalibration = CAL_NONE;
-        calibrationStarted = true;
-
-        if (currentCalType == CAL_GYRO) {
-            Logger::info("Starting gyro calibration - keep robot still!");
-            imu.calibrateGyro();
-            Logger::info("Gyro calibration complete");
-            stateManager.setState(STATE_IDLE);
-            calibrationStarted = false;
-        }
-        else if (currentCalType == CAL_MAGNETOMETER) {
-            if (!imu.hasMagnetometer()) {
-                Logger::error("Magnetometer not available!");
-                stateManager.setState(STATE_IDLE);
-                calibrationStarted = false;
-                return;
-            }
+    if (activeCalibration == CAL_GYRO) {
+        Logger::info("Starting gyro calibration - keep robot still!");
+        imu.calibrateGyro();
+        Logger::info("Gyro calibration complete");
+    }
+    else if (activeCalibration == CAL_MAGNETOMETER) {
+        if (!imu.hasMagnetometer()) {
+            Logger::error("Magnetometer not available!");
+        } else {
             Logger::info("Starting magnetometer calibration - ROTATE robot slowly!");
             // calibrateMag() blokerer i den angivne tid (30 sek default)
             bool success = imu.calibrateMag(30);
@@ -529,30 +798,148 @@ void handleCalibratingState() {
             } else {
                 Logger::error("Magnetometer calibration failed!");
             }
-            stateManager.setState(STATE_IDLE);
-            calibrationStarted = false;
         }
     }
+
+    activeCalibration = CAL_NONE;
+    #if ENABLE_WATCHDOG
+    deadlineMonitor.resume();
+    #endif
+    stateManager.dispatch(EVENT_CALIBRATION_DONE);
 }
 
 // Funktion til at starte magnetometer kalibrering (kan kaldes fra WebAPI)
 void requestMagCalibration() {
     pendingCalibration = CAL_MAGNETOMETER;
-    stateManager.setState(STATE_CALIBRATING);
+    stateManager.postEvent(EVENT_CALIBRATE);
 }
 
 // Funktion til at starte gyro kalibrering (kan kaldes fra WebAPI)
 void requestGyroCalibration() {
     pendingCalibration = CAL_GYRO;
-    stateManager.setState(STATE_CALIBRATING);
+    stateManager.postEvent(EVENT_CALIBRATE);
+}
+
+void enterMowingState() {
+    mowStartRefused = false;
+
+    // Start nyt mønster med mindre vi genoptager et afbrudt (pause, signal søgning)
+    if (pathPlanner.isPatternComplete()) {
+        #if ENABLE_ZONES
+        pathPlanner.loadPlan(zoneManager);
+        #endif
+
+        // Rækkens start kan ikke findes fra basen - klip ikke den forkerte række
+        #if ENABLE_PERIMETER && ENABLE_DOCKING
+        if (docking.isDocked() && checkpointNeedsRowStart()) {
+            Logger::warning("Cannot resume row " + String(checkpoint.getCheckpoint().row) +
+                            " from the dock - place the robot at the row start "
+                            "(GET /api/zones/plan) or clear the checkpoint");
+            mowStartRefused = true;
+            stateManager.postEvent(EVENT_PAUSE);
+            return;
+        }
+        #endif
+
+        if (!resumeFromCheckpoint()) {
+            pathPlanner.startNewPattern();
+            localMap.reset();
+        }
+    }
+
+    // Rækkens linje starter hvor robotten er nu
+    localPlanner.startRow(localMap, pathPlanner.getTargetHeading());
+
+    #if ENABLE_PERIMETER
+    if (pathPlanner.followsWire()) {
+        wireFollower.reset();
+    }
+    #endif
+
+    // Startet fra ladestationen - bak ud først
+    #if ENABLE_PERIMETER && ENABLE_DOCKING
+    if (docking.isDocked()) {
+        docking.startUndock();
+    }
+    #endif
+}
+
+bool resumeFromCheckpoint() {
+    // Mønster afbrudt af genstart (brownout, OTA) eller opladning - fortsæt ved rækken
+    #if ENABLE_CHECKPOINT
+    if (!checkpoint.hasCheckpoint()) {
+        return false;
+    }
+
+    const MowCheckpoint& saved = checkpoint.getCheckpoint();
+    if (saved.zoneId != pathPlanner.getZoneId() || saved.totalRows != pathPlanner.getTotalRows()) {
+        Logger::info("Checkpoint belongs to another zone or plan - starting from row 0");
+        return false;
+    }
+    if (!pathPlanner.resumePattern(saved.row, (Direction)saved.turnDir)) {
+        return false;   // Mønsteret var færdigt
+    }
+
+    // Positionen gælder kun hvis robotten ikke har været hjemme imellem
+    if (saved.inField) {
+        localMap.setPose(saved.poseX, saved.poseY, saved.heading);
+    } else {
+        localMap.reset();
+    }
+    return true;
+    #else
+    return false;
+    #endif
+}
+
+bool checkpointNeedsRowStart() {
+    // Efter opladning er positionen glemt. Omgange langs kablet finder selv
+    // afstanden til kablet, men en række skal startes fra sit hjørne.
+    #if ENABLE_CHECKPOINT
+    if (!checkpoint.hasCheckpoint() || pathPlanner.isWireMode()) {
+        return false;
+    }
+
+    const MowCheckpoint& saved = checkpoint.getCheckpoint();
+    return !saved.inField &&
+           saved.zoneId == pathPlanner.getZoneId() &&
+           saved.totalRows == pathPlanner.getTotalRows();
+    #else
+    return false;
+    #endif
 }
 
 void handleMowingState() {
-    // Opdater path planner
-    pathPlanner.update();
+    // Start afvist - vent på PAUSE uden at køre
+    if (mowStartRefused) {
+        return;
+    }
+
+    #if ENABLE_PERIMETER && ENABLE_DOCKING
+    if (docking.isUndocking()) {
+        if (docking.updateUndock()) {
+            localPlanner.startRow(localMap, pathPlanner.getTargetHeading());
+        }
+        return;
+    }
+    #endif
 
     // Tjek for perimeter grænse
     #if ENABLE_PERIMETER
+    #if ENABLE_MISSION_PLANNER
+    if (missionPlanner.mustReturnNow()) {
+        Logger::warning("Energy only covers the way home - returning to base");
+        stateManager.dispatch(EVENT_RETURN_HOME);
+        return;
+    }
+    #endif
+
+    if (pathPlanner.followsWire()) {
+        // Perimeter omgange - kablet er både grænse og styring
+        mowAlongWire();
+        return;
+    }
+
     if (perimeterReceiver.hasSignal()) {
         if (perimeterReceiver.isOutside() || perimeterReceiver.getState() == PERIMETER_ON_WIRE) {
             Logger::info("Perimeter boundary detected!");
@@ -567,21 +954,19 @@ void handleMowingState() {
 
     if (obstacleAvoid.hasObstacle()) {
         // Forhindring detekteret - skift til AVOIDING state
-        stateManager.setState(STATE_AVOIDING);
+        stateManager.dispatch(EVENT_OBSTACLE);
         return;
     }
 
     // Tjek om vi skal dreje
     if (pathPlanner.shouldTurn()) {
-        stateManager.setState(STATE_TURNING);
-        pathPlanner.startTurn();
+        endRow();
         return;
     }
 
-    // Kør lige fremad
-    float targetHeading = pathPlanner.getTargetHeading();
-    movement.setTargetHeading(targetHeading);
-    movement.driveStraight(MOTOR_CRUISE_SPEED);
+    // Kør langs rækken - lokal planner styrer uden om kendte forhindringer
+    movement.setTargetHeading(localPlanner.getSteerHeading());
+    movement.driveStraight(obstacleAvoid.getRecommendedSpeed(MOTOR_CRUISE_SPEED));
 
     // Start klippermotor hvis ikke allerede kører
     if (!cuttingMech.isRunning() && !cuttingMech.isSafetyLocked()) {
@@ -589,47 +974,150 @@ void handleMowingState() {
     }
 }
 
-void handleTurningState() {
-    // Stop klippermotor under drejning
+void endRow() {
+    // Række ende - kør hjem hvis energien ikke rækker til næste række
+    #if ENABLE_MISSION_PLANNER && ENABLE_PERIMETER
+    if (missionPlanner.shouldReturnAtRowEnd()) {
+        // Rækken er klippet - efter opladning fortsættes med næste række
+        pathPlanner.nextRow();
+        stateManager.dispatch(EVENT_RETURN_HOME);
+        return;
+    }
+    #endif
+    stateManager.dispatch(EVENT_ROW_END);
+}
+
+void exitMowingState() {
+    // Forlader MOWING (inkl. TURNING/AVOIDING) - stop kniven.
+    // Motorerne røres ikke, så en manuel kommando ikke annulleres.
     cuttingMech.stop();
+    pathPlanner.pauseWireLap();
+
+    #if ENABLE_PERIMETER && ENABLE_DOCKING
+    if (docking.isUndocking()) {
+        docking.stop();
+    }
+    #endif
+
+    #if ENABLE_CHECKPOINT
+    checkpoint.flush();
+    #endif
+}
 
-    // Hent target heading fra path planner
-    float targetHeading = pathPlanner.getTargetHeading();
+void enterTurningState() {
+    pathPlanner.startTurn();
 
-    // Drej til target heading
-    bool turnComplete = movement.turnToHeading(targetHeading);
+    // Vendingen planlægges ud fra rækken vi forlader, så hent retning
+    // og sideforskydning før planneren går videre til næste række
+    Direction turnDir = pathPlanner.getTurnDirection();
+    float shift = pathPlanner.getTurnShift();
+    float fromHeading = imu.getHeading();
 
-    if (turnComplete) {
-        // Drejning færdig
-        pathPlanner.completeTurn();
-        pathPlanner.nextRow();
+    pathPlanner.nextRow();
+    smoothTurnActive = false;
 
-        // Tjek om mønster er færdigt
-        if (pathPlanner.isPatternComplete()) {
-            Logger::info("Mowing pattern complete!");
-            stateManager.setState(STATE_IDLE);
-        } else {
-            // Fortsæt klipning
-            stateManager.setState(STATE_MOWING);
+    #if ENABLE_CHECKPOINT
+    recordCheckpoint(true);     // Rækken er klippet
+    #endif
+
+    #if ENABLE_SMOOTH_TURNS
+    if (!pathPlanner.isPatternComplete()) {
+        TurnProfile profile;
+        if (TurnPlanner::plan(fromHeading, pathPlanner.getTargetHeading(), turnDir, shift, profile)) {
+            Logger::info("Smooth turn: " + String(profile.name) + " " +
+                         String(turnDir == RIGHT ? "RIGHT" : "LEFT") + ", shift " +
+                         String(shift, 0) + " cm");
+            movement.startProfile(profile);
+            smoothTurnActive = true;
         }
     }
+    #endif
+}
+
+void handleTurningState() {
+    // Sidste række kørt - ingen vending
+    if (pathPlanner.isPatternComplete()) {
+        Logger::info("Mowing pattern complete!");
+        stateManager.dispatch(EVENT_PATTERN_DONE);
+        return;
+    }
+
+    if (smoothTurnActive) {
+        // Forhindring i en fremadgående bue - sensorerne sidder foran
+        if (!movement.isProfileReversing()) {
+            obstacleAvoid.update(&sensors);
+            if (obstacleAvoid.hasObstacle()) {
+                movement.stop();
+                localPlanner.startRow(localMap, pathPlanner.getTargetHeading());
+                stateManager.dispatch(EVENT_OBSTACLE);
+                return;
+            }
+        }
+
+        // Kniven kører videre i bløde vendinger
+        if (!cuttingMech.isRunning() && !cuttingMech.isSafetyLocked()) {
+            cuttingMech.start();
+        }
+
+        if (movement.updateProfile()) {
+            finishTurn();
+        }
+        return;
+    }
+
+    // Drejning på stedet river græsset op - stop kniven
+    cuttingMech.stop();
+
+    if (movement.turnToHeading(pathPlanner.getTargetHeading())) {
+        finishTurn();
+    }
+}
+
+void exitTurningState() {
+    // Afbrudt (pause, fejl, forhindring) eller færdig - planneren må dreje igen
+    movement.cancelProfile();
+    smoothTurnActive = false;
+    pathPlanner.completeTurn();
+}
+
+void finishTurn() {
+    // Den nye række starter her
+    localPlanner.startRow(localMap, pathPlanner.getTargetHeading());
+    stateManager.dispatch(EVENT_TURN_DONE);
+}
+
+void enterAvoidingState() {
+    avoidanceManeuverDone = false;
+
+    // Undvigelsens drejning er ikke en del af omgangen langs kablet
+    pathPlanner.pauseWireLap();
+
+    #if ENABLE_STATS
+    stats.countAvoidance();
+    #endif
 }
 
 void handleAvoidingState() {
     // Stop klippermotor
     cuttingMech.stop();
 
-    // Hent undgåelses retning
-    AvoidanceDirection avoidDir = obstacleAvoid.getAvoidanceDirection();
+    if (!avoidanceManeuverDone) {
+        // Eksekvér undgåelses manøvre - kortet husker forhindringer sensorerne ikke ser nu
+        AvoidanceDirection direction = obstacleAvoid.getAvoidanceDirection();
+        if (direction != AVOID_BACK) {
+            direction = localPlanner.chooseSide(localMap, direction);
+        }
 
-    static bool avoidanceComplete = false;
+        // Manøvren nedenfor blokerer (bak + drej med delay)
+        #if ENABLE_WATCHDOG
+        deadlineMonitor.expectBlocking(DEADLINE_MANEUVER_MS);
+        #endif
 
-    if (!avoidanceComplete) {
-        // Eksekvér undgåelses manøvre
-        switch (avoidDir) {
+        switch (direction) {
             case AVOID_LEFT:
                 Logger::info("Avoiding - turning left");
                 movement.backUp(BACKUP_DISTANCE);
+                updateDeadReckoning();
                 delay(500);
                 movement.turnInPlace(LEFT, MOTOR_TURN_SPEED);
                 delay(1000);
@@ -638,6 +1126,7 @@ void handleAvoidingState() {
             case AVOID_RIGHT:
                 Logger::info("Avoiding - turning right");
                 movement.backUp(BACKUP_DISTANCE);
+                updateDeadReckoning();
                 delay(500);
                 movement.turnInPlace(RIGHT, MOTOR_TURN_SPEED);
                 delay(1000);
@@ -646,6 +1135,7 @@ void handleAvoidingState() {
             case AVOID_BACK:
                 Logger::info("Avoiding - backing up");
                 movement.backUp(BACKUP_DISTANCE * 2);
+                updateDeadReckoning();
                 delay(500);
                 movement.turnInPlace(RIGHT, MOTOR_TURN_SPEED);
                 delay(1500);
@@ -653,7 +1143,7 @@ void handleAvoidingState() {
         }
 
         movement.stop();
-        avoidanceComplete = true;
+        avoidanceManeuverDone = true;
     }
 
     // Tjek om vejen er fri
@@ -662,15 +1152,13 @@ void handleAvoidingState() {
 
     if (!obstacleAvoid.hasObstacle()) {
         // Vejen er fri - fortsæt klipning
-        avoidanceComplete = false;
-        stateManager.setState(STATE_MOWING);
+        stateManager.dispatch(EVENT_PATH_CLEAR);
     }
 }
 
-void handleErrorState() {
+void enterErrorState() {
     // Stop alt
-    motors.emergencyStop();
-    cuttingMech.emergencyStop();
+    safetyMonitor.emergencyStop();
 
     // Vis fejl på display (deaktiveret - brug Serial Monitor i stedet)
     // #if ENABLE_DISPLAY
@@ -679,8 +1167,11 @@ void handleErrorState() {
 
     // Log fejl til Serial
     Logger::error("ERROR STATE: " + stateManager.getErrorMessage());
+}
 
-    // Kræver manuel genstart
+void handleErrorState() {
+    // Hold motorerne stoppet - kræver manuel genstart eller recovery
+    motors.emergencyStop();
 }
 
 // ============================================================================
@@ -689,6 +1180,7 @@ void handleErrorState() {
 
 void updateSensors() {
     sensors.update();
+    updateLocalMap();
 
     // Log sensor data periodisk
     #if DEBUG_SENSORS
@@ -702,15 +1194,51 @@ void updateSensors() {
     #endif
 }
 
+void updateDeadReckoning() {
+    // Flyt robotten på kortet med kørt distance og nuværende heading.
+    // Kaldes også lige efter blokerende bak-manøvrer, før robotten drejer.
+    float distance = movement.consumeOdometry();
+    localMap.updatePose(imu.getHeading(), distance);
+
+    #if ENABLE_MISSION_PLANNER
+    missionPlanner.addDistance(distance, stateManager.isInState(STATE_MOWING));
+    #endif
+
+    #if ENABLE_STATS
+    stats.addDistance(distance, cuttingMech.isRunning());
+    #endif
+
+    // Kun kørsel i rækken/langs kablet tæller med (ikke undvigelser og vendinger)
+    if (stateManager.getState() == STATE_MOWING) {
+        pathPlanner.addDistance(distance);
+    }
+}
+
+void updateLocalMap() {
+    updateDeadReckoning();
+
+    // Kun nye sonar målinger indføres i kortet
+    unsigned long sampleTime = sensors.getLastUpdateTime();
+    if (sampleTime == lastMapSampleTime) {
+        return;
+    }
+    lastMapSampleTime = sampleTime;
+
+    localMap.integrateSonar(-SONAR_SIDE_ANGLE, sensors.getLeftDistance());
+    localMap.integrateSonar(0.0, sensors.getMiddleDistance());
+    localMap.integrateSonar(SONAR_SIDE_ANGLE, sensors.getRightDistance());
+
+    if (stateManager.getState() == STATE_MOWING) {
+        localPlanner.update(localMap);
+    }
+}
+
 void updateIMU() {
     #if ENABLE_IMU
-    imu.update();
+    bool readOk = imu.update();
 
-    // Tjek for væltet robot
-    if (imu.isTilted() && stateManager.isActive()) {
-        Logger::error("Robot tilted - emergency stop!");
-        stateManager.handleError("Robot tilted");
-    }
+    // Tjek for væltet robot og hængt I2C bus
+    safetyMonitor.checkIMU(readOk);
     #endif
 }
 
@@ -728,17 +1256,50 @@ void updateDisplay() {
     // #endif
 }
 
+#if ENABLE_CHECKPOINT
+void updateCheckpoint() {
+    if (checkpointClearRequested) {
+        checkpointClearRequested = false;
+        checkpoint.clear();
+        if (!stateManager.isActive()) {
+            pathPlanner.reset();    // Næste start begynder forfra
+        }
+    }
+
+    if (stateManager.isInState(STATE_MOWING) && !pathPlanner.isPatternComplete()) {
+        recordCheckpoint(true);
+    }
+    checkpoint.update();
+}
+
+void recordCheckpoint(bool inField) {
+    MowCheckpoint state = {};
+    state.zoneId = pathPlanner.getZoneId();
+    state.row = pathPlanner.getCurrentRow();
+    state.totalRows = pathPlanner.getTotalRows();
+    state.turnDir = (uint8_t)pathPlanner.getTurnDirection();
+    state.inField = inField ? 1 : 0;
+    state.poseX = localMap.getX();
+    state.poseY = localMap.getY();
+    state.heading = localMap.getHeading();
+    checkpoint.record(state);
+}
+
+// Funktion til at slette checkpoint (kaldes fra WebAPI)
+void requestCheckpointClear() {
+    checkpointClearRequested = true;
+}
+#endif
+
 void updateBattery() {
     battery.update();
 
-    // Tjek batteri niveau
-    if (battery.isCritical()) {
-        Logger::error("Critical battery level!");
-        stateManager.handleError("Critical battery");
-    } else if (battery.isLow() && stateManager.isActive()) {
-        Logger::warning("Low battery - returning to base");
-        stateManager.setState(STATE_RETURNING);
-    }
+    #if ENABLE_MISSION_PLANNER
+    missionPlanner.update(localMap.getX(), localMap.getY());
+    #endif
+
+    // Tjek batteri niveau og måling
+    safetyMonitor.checkBattery();
 }
 
 void updateWebStatus() {
@@ -760,6 +1321,7 @@ void updateWebStatus() {
 void updateMotorCurrent() {
     // Opdater strømmålinger fra BTS7960 current sense pins
     motors.updateCurrentReadings();
+    battery.updateCharge();
 
     // Tjek for strøm advarsel
     if (motors.isCurrentWarning() && stateManager.isActive()) {
@@ -770,39 +1332,44 @@ void updateMotorCurrent() {
 }
 
 void checkSafetyConditions() {
-    // Kritiske sikkerhedstjek
+    // Kritiske sikkerhedstjek (batteri, vælt, forhindring, perimeter)
+    safetyMonitor.check();
+}
 
-    // 1. Batteri kritisk
-    if (battery.isCritical() && !stateManager.hasError()) {
-        stateManager.handleError("Critical battery voltage");
-        return;
-    }
+// ============================================================================
+// BLACK BOX FUNCTIONS
+// ============================================================================
 
-    // 2. Robot væltet
-    #if ENABLE_IMU && AUTO_STOP_ON_TILT
-    if (imu.isTilted() && stateManager.isActive()) {
-        stateManager.handleError("Robot tilted/flipped");
+#if ENABLE_BLACKBOX
+void recordBlackBox() {
+    if (!blackBox.isRecording()) {
         return;
     }
-    #endif
-
-    // 3. Kritisk forhindring direkte foran
-    obstacleAvoid.update(&sensors);
-    if (obstacleAvoid.isCriticalObstacle() && stateManager.isActive()) {
-        motors.stop();
-        Logger::warning("Critical obstacle - stopped");
-    }
 
-    // 4. Perimeter grænse
+    BlackBoxTelemetry t;
+    t.state = (uint8_t)stateManager.getState();
+    t.heading = imu.getHeading();
+    t.pitch = imu.getPitch();
+    t.roll = imu.getRoll();
+    t.batteryVoltage = battery.getVoltage();
+    t.motorLeft = motors.getLeftSpeed();
+    t.motorRight = motors.getRightSpeed();
+    t.currentLeft = motors.getLeftCurrent();
+    t.currentRight = motors.getRightCurrent();
+    t.sonarLeft = sensors.getLeftDistance();
+    t.sonarMiddle = sensors.getMiddleDistance();
+    t.sonarRight = sensors.getRightDistance();
     #if ENABLE_PERIMETER
-    if (perimeterReceiver.hasSignal() && stateManager.isActive()) {
-        if (perimeterReceiver.isOutside()) {
-            motors.stop();
-            Logger::warning("Outside perimeter - stopped!");
-        }
-    }
+    t.perimeterStrength = perimeterReceiver.getSignalStrength();
+    t.perimeterState = (uint8_t)perimeterReceiver.getState();
+    #else
+    t.perimeterStrength = 0;
+    t.perimeterState = 0;
     #endif
+
+    blackBox.recordTelemetry(t);
 }
+#endif
 
 // ============================================================================
 // PERIMETER FUNCTIONS
@@ -813,31 +1380,42 @@ void updatePerimeter() {
     // Opdater perimeter modtager
     perimeterReceiver.update();
 
+    // Spor med signal - bruges til at bakke tilbage ved signal tab
+    signalSearch.track();
+
     // Debug log
-    #if DEBUG_MODE
     static unsigned long lastDebug = 0;
     if (millis() - lastDebug >= 2000) {
         if (perimeterReceiver.hasSignal()) {
-            Serial.printf("[Perimeter] %s | Strength: %d%% | Dir: %s | Dist: %dcm\n",
-                         perimeterReceiver.getStateString().c_str(),
-                         perimeterReceiver.getSignalStrength(),
-                         perimeterReceiver.getDirectionString().c_str(),
-                         perimeterReceiver.getDistanceToCable());
+            LOGD(LOG_SUB_PERIMETER, "%s | Strength: %d%% | Dir: %s | Dist: %dcm",
+                 perimeterReceiver.getStateString().c_str(),
+                 perimeterReceiver.getSignalStrength(),
+                 perimeterReceiver.getDirectionString().c_str(),
+                 perimeterReceiver.getDistanceToCable());
         } else {
-            Serial.println("[Perimeter] No signal");
+            LOGD(LOG_SUB_PERIMETER, "No signal");
         }
         lastDebug = millis();
     }
-    #endif
 }
 
 void handlePerimeterBoundary() {
     // Stop klippermotor
     cuttingMech.stop();
 
+    #if ENABLE_STATS
+    stats.countPerimeterHit();
+    #endif
+
+    // Bak, drej og vent på signal blokerer loop
+    #if ENABLE_WATCHDOG
+    deadlineMonitor.expectBlocking(DEADLINE_MANEUVER_MS);
+    #endif
+
     // Bak væk fra grænsen
     Logger::info("Backing up from perimeter...");
     movement.backUp(PERIMETER_BACKUP_DISTANCE);
+    updateDeadReckoning();
     delay(500);
 
     // Tjek om vi er i et aktivt klipningsmønster
@@ -849,9 +1427,8 @@ void handlePerimeterBoundary() {
         Direction turnDir = pathPlanner.getTurnDirection();
         Logger::info("Pattern-aware turn: " + String(turnDir == RIGHT ? "RIGHT" : "LEFT"));
 
-        // Start drejning via state machine
-        stateManager.setState(STATE_TURNING);
-        pathPlanner.startTurn();
+        // Start drejning via state machine (eller kør hjem)
+        endRow();
 
         // Clear perimeter trigger efter vi har håndteret det
         pathPlanner.clearPerimeterTrigger();
@@ -886,178 +1463,238 @@ void handlePerimeterBoundary() {
         delay(50);
     }
 
-    // Fortsæt klipning
-    stateManager.setState(STATE_MOWING);
+    // Fortsæt klipning - vi er stadig i MOWING
 }
 
 // ============================================================================
 // RETURNING TO BASE - Følger perimeter wire hjem
 // ============================================================================
 
-void handleReturningState() {
-    static bool initialized = false;
-    static unsigned long lastUpdate = 0;
+void enterReturningState() {
+    Logger::info("Starting return to base sequence");
+    cuttingMech.stop();
+    wireFollower.reset();
+
+    // Efter opladning fortsættes fra basen - gem uden position
+    #if ENABLE_CHECKPOINT
+    if (!pathPlanner.isPatternComplete()) {
+        recordCheckpoint(false);
+        checkpoint.flush();
+    }
+    #endif
 
-    if (!initialized) {
-        Logger::info("Starting return to base sequence");
-        cuttingMech.stop();
-        initialized = true;
+    #if ENABLE_DOCKING
+    // Signal søgning vender tilbage hertil - behold beslutningen fra første gang
+    RobotState from = stateManager.getPreviousState();
+    if (from != STATE_SEARCHING_SIGNAL) {
+        bool fromMowing = (from == STATE_MOWING || StateManager::getParent(from) == STATE_MOWING);
+        resumeAfterCharge = fromMowing && !pathPlanner.isPatternComplete();
+
+        // Kun omgange langs kablet kan fortsættes fra basen (se checkpointNeedsRowStart)
+        if (resumeAfterCharge && !pathPlanner.isWireMode()) {
+            resumeAfterCharge = false;
+            Logger::warning("Row pattern cannot resume from the dock - mowing stops after "
+                            "charging, checkpoint kept for row " + String(pathPlanner.getCurrentRow()));
+        }
     }
+    docking.startDocking();
+    #endif
+}
 
+void handleReturningState() {
     // Opdater perimeter ved hver iteration
     perimeterReceiver.update();
 
+    #if ENABLE_DOCKING
+    DockPhase phase = docking.updateApproach();
+    if (phase == DOCK_DOCKED) {
+        stateManager.dispatch(EVENT_DOCKED);
+        return;
+    }
+    if (phase == DOCK_FAILED) {
+        stateManager.handleError("Docking failed");
+        return;
+    }
+    #endif
+
     // Tjek om vi har mistet signalet
     if (!perimeterReceiver.hasSignal()) {
         Logger::warning("Lost perimeter signal during return!");
-        initialized = false;
-        stateManager.searchForSignal();
+        stateManager.dispatch(EVENT_SIGNAL_LOST);
         return;
     }
 
+    // Slutindkørsel og nye forsøg styres af docking controlleren
+    #if ENABLE_DOCKING
+    if (docking.isApproaching()) {
+        return;
+    }
+    #endif
+
     // Følg perimeter wire
     followPerimeterWire();
+}
 
-    // TODO: Tjek om vi er nået frem til ladestationen
-    // Dette kræver en sensor eller et stærkere signal ved stationen
-    // For nu kører vi bare indtil brugeren stopper
-
-    // Reset initialized når vi forlader staten
-    if (stateManager.getState() != STATE_RETURNING) {
-        initialized = false;
-    }
+void exitReturningState() {
+    #if ENABLE_DOCKING
+    docking.stop();
+    #endif
 }
 
-void followPerimeterWire() {
-    // Følg kablet ved at holde det på venstre side
-    // Kør fremad og juster retning baseret på signalstyrke
+#if ENABLE_DOCKING
+void updateDock() {
+    docking.update();
 
-    PerimeterState state = perimeterReceiver.getState();
-    PerimeterDirection dir = perimeterReceiver.getDirection();
-    int signalStrength = perimeterReceiver.getSignalStrength();
-
-    // Målsætning: Hold kablet til venstre, kør langs det
-    const int TARGET_STRENGTH = 30;  // Ca. 30cm fra kablet
-    const int TOLERANCE = 10;
-
-    if (state == PERIMETER_OUTSIDE) {
-        // Vi er udenfor - drej til venstre for at komme ind igen
-        movement.turnInPlace(LEFT, MOTOR_SLOW_SPEED);
-        delay(200);
-    } else if (state == PERIMETER_ON_WIRE) {
-        // Vi er på kablet - drej lidt til højre
-        movement.turnInPlace(RIGHT, MOTOR_SLOW_SPEED);
-        delay(100);
-    } else if (state == PERIMETER_INSIDE) {
-        // Vi er inden for - juster baseret på signalstyrke
-        if (signalStrength > TARGET_STRENGTH + TOLERANCE) {
-            // For tæt på kablet - drej lidt væk (højre)
-            motors.setSpeed(MOTOR_SLOW_SPEED, MOTOR_SLOW_SPEED - 30);
-        } else if (signalStrength < TARGET_STRENGTH - TOLERANCE) {
-            // For langt fra kablet - drej mod det (venstre)
-            motors.setSpeed(MOTOR_SLOW_SPEED - 30, MOTOR_SLOW_SPEED);
-        } else {
-            // God afstand - kør lige frem
-            motors.setSpeed(MOTOR_SLOW_SPEED, MOTOR_SLOW_SPEED);
-        }
-    } else {
-        // Intet signal - stop og søg
-        motors.stop();
-        Logger::warning("No signal in followPerimeterWire");
+    // Docken selv er en kritisk forhindring på de sidste centimeter
+    safetyMonitor.setDockApproach(docking.isApproaching());
+
+    // Sat i docken med hånden - lad op
+    if (docking.isDocked() && stateManager.getState() == STATE_IDLE) {
+        stateManager.dispatch(EVENT_DOCKED);
     }
 }
 
 // ============================================================================
-// SIGNAL SEARCH - Søger efter mistet perimeter signal
+// CHARGING - Står i ladestationen
 // ============================================================================
 
-void handleSearchingSignalState() {
-    static bool initialized = false;
-    static int searchPhase = 0;
-    static unsigned long phaseStartTime = 0;
-    static int spiralRadius = 0;
+void enterChargingState() {
+    motors.stop();
+    cuttingMech.stop();
+    battery.setCharging(true);
+    chargedSince = 0;
 
-    if (!initialized) {
-        Logger::info("Starting perimeter signal search");
-        cuttingMech.stop();
-        searchPhase = 0;
-        spiralRadius = 0;
-        phaseStartTime = millis();
-        initialized = true;
+    if (DOCK_AUTO_RESUME && resumeAfterCharge) {
+        Logger::info("Charging - mowing resumes at row " + String(pathPlanner.getCurrentRow()) +
+                     " when full");
     }
+}
 
-    // Opdater perimeter
-    perimeterReceiver.update();
+void handleChargingState() {
+    // Løftet ud af docken eller kontakten svigter
+    if (!docking.isDocked()) {
+        Logger::warning("Dock contact lost while charging");
+        stateManager.dispatch(EVENT_UNDOCKED);
+        return;
+    }
 
-    // Tjek om vi har fundet signalet
-    if (perimeterReceiver.hasSignal()) {
-        Logger::info("Perimeter signal found!");
-        initialized = false;
-
-        // Gå tilbage til forrige state eller idle
-        RobotState prevState = stateManager.getPreviousState();
-        if (prevState == STATE_RETURNING) {
-            stateManager.setState(STATE_RETURNING);
-        } else if (prevState == STATE_MOWING) {
-            stateManager.setState(STATE_MOWING);
-        } else {
-            stateManager.setState(STATE_IDLE);
-        }
+    // Fuld når ladespændingen er holdt gennem konstant spændings fasen
+    if (!battery.isCharging()) {
+        return;     // Allerede fuld
+    }
+    if (battery.getVoltage() < DOCK_CHARGED_VOLTAGE) {
+        chargedSince = 0;
+        return;
+    }
+    if (chargedSince == 0) {
+        chargedSince = millis();
+        return;
+    }
+    if (millis() - chargedSince < DOCK_CHARGED_HOLD_MS) {
         return;
     }
 
-    // Udfør søgemønster
-    searchForPerimeterSignal();
+    battery.markFull();
+    battery.setCharging(false);
 
-    // Timeout efter 2 minutter
-    if (millis() - phaseStartTime > 120000) {
-        Logger::error("Signal search timeout - could not find perimeter!");
-        initialized = false;
-        stateManager.handleError("Perimeter signal lost");
-        return;
+    if (DOCK_AUTO_RESUME && resumeAfterCharge) {
+        resumeAfterCharge = false;
+        Logger::info("Battery full - resuming mowing");
+        stateManager.dispatch(EVENT_START);
     }
+}
+
+void exitChargingState() {
+    battery.setCharging(false);
+}
+#endif
 
-    // Reset når vi forlader staten
-    if (stateManager.getState() != STATE_SEARCHING_SIGNAL) {
-        initialized = false;
+void followPerimeterWire() {
+    // Følg kablet ved at holde det på venstre side i WIRE_FOLLOW_OFFSET_CM
+    // afstand - PID på sideafstanden, kører uden at stoppe
+    if (!perimeterReceiver.hasSignal()) {
+        // Intet signal - stop og søg
+        motors.stop();
+        wireFollower.reset();
+        Logger::warning("No signal in followPerimeterWire");
+        return;
     }
+
+    wireFollower.update();
 }
 
-void searchForPerimeterSignal() {
-    // Spiral søgemønster
-    // Kør i stadigt større cirkler indtil signal findes
+void mowAlongWire() {
+    // Klip langs kablet i planens afstand med samme regulator som
+    // hjemkørslen (kablet til venstre). Omgangen skifter når robotten har
+    // kørt hele vejen rundt (360 graders drejning).
+    if (pathPlanner.updateWireLap(imu.getHeading())) {
+        // En hel omgang kan vare længere end STATE_TIMEOUT
+        stateManager.reportProgress();
+    }
+
+    if (pathPlanner.isPatternComplete()) {
+        Logger::info("Perimeter laps complete!");
+        stateManager.dispatch(EVENT_PATTERN_DONE);
+        return;
+    }
+
+    obstacleAvoid.update(&sensors);
+    if (obstacleAvoid.hasObstacle()) {
+        stateManager.dispatch(EVENT_OBSTACLE);
+        return;
+    }
+
+    if (!perimeterReceiver.hasSignal()) {
+        // Intet signal - stå stille til safety monitor starter søgningen
+        motors.stop();
+        wireFollower.reset();
+        return;
+    }
 
-    static int searchStep = 0;
-    static unsigned long stepStartTime = 0;
-    static float currentHeading = 0;
+    wireFollower.setTarget(pathPlanner.getWireOffset(),
+                           obstacleAvoid.getRecommendedSpeed(MOTOR_CRUISE_SPEED));
+    wireFollower.update();
 
-    unsigned long now = millis();
+    if (!cuttingMech.isRunning() && !cuttingMech.isSafetyLocked()) {
+        cuttingMech.start();
+    }
+}
 
-    // Hver søge-iteration
-    if (now - stepStartTime > 500) {
-        stepStartTime = now;
-        searchStep++;
+// ============================================================================
+// SIGNAL SEARCH - Søger efter mistet perimeter signal
+// ============================================================================
 
-        // Spiral ud: kør lidt fremad, drej lidt
-        int forwardTime = 200 + (searchStep * 10);  // Længere og længere strækninger
-        int turnTime = 300;
+void enterSearchingState() {
+    Logger::info("Starting perimeter signal search");
+    cuttingMech.stop();
+    signalSearch.start();
+}
 
-        // Kør fremad
-        movement.driveStraight(MOTOR_SLOW_SPEED);
-        delay(min(forwardTime, 2000));
+void handleSearchingSignalState() {
+    // Opdater perimeter
+    perimeterReceiver.update();
 
-        // Drej til højre (med uret spiral)
-        movement.turnInPlace(RIGHT, MOTOR_TURN_SPEED);
-        delay(turnTime);
+    // Tjek om vi har fundet signalet
+    if (perimeterReceiver.hasSignal()) {
+        Logger::info("Perimeter signal found!");
+        signalSearch.stop(true);
 
-        movement.stop();
+        // Gå tilbage til forrige autonome state eller idle
+        stateManager.dispatch(EVENT_SIGNAL_FOUND);
+        return;
+    }
 
-        // Log progress
-        if (searchStep % 10 == 0) {
-            Serial.printf("[Search] Step %d - still searching...\n", searchStep);
-        }
+    // Bak ad sporet, derefter spiral - blokerer aldrig loop
+    if (signalSearch.update() == SEARCH_FAILED) {
+        Logger::error("Signal search failed - could not find perimeter!");
+        stateManager.handleError("Perimeter signal lost");
     }
 }
+
+void exitSearchingState() {
+    // Fejl, nødstop eller manuel stop afbryder søgningen
+    signalSearch.stop(false);
+}
 #endif
 
 // ============================================================================
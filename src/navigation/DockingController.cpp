@@ -0,0 +1,232 @@
+#include "DockingController.h"
+#include "../hardware/Motors.h"
+#include "../hardware/PerimeterReceiver.h"
+
+DockingController::DockingController() {
+    motorsPtr = nullptr;
+    perimeterPtr = nullptr;
+    phase = DOCK_IDLE;
+    phaseStart = 0;
+    misalignSince = 0;
+    stallSince = 0;
+    retries = 0;
+    alignError = 0.0;
+    contact = false;
+    rawContact = false;
+    rawSince = 0;
+    dockings = 0;
+    failures = 0;
+    lastRetryReason = "";
+    initialized = false;
+}
+
+bool DockingController::begin(Motors* motors, PerimeterReceiver* receiver) {
+    if (motors == nullptr || receiver == nullptr) {
+        Logger::error("DockingController: missing motors or perimeter receiver");
+        return false;
+    }
+
+    motorsPtr = motors;
+    perimeterPtr = receiver;
+
+    // Ekstern pull-down - ladespændingen trækker pin'en høj
+    pinMode(DOCK_CONTACT_PIN, INPUT);
+
+    // Startet i docken - ingen debounce ved opstart
+    rawContact = (digitalRead(DOCK_CONTACT_PIN) == HIGH);
+    contact = rawContact;
+    rawSince = millis();
+
+    initialized = true;
+
+    Logger::info(String("DockingController initialized - ") +
+                 (contact ? "robot is docked" : "not docked"));
+    return true;
+}
+
+void DockingController::update() {
+    if (!initialized) {
+        return;
+    }
+
+    unsigned long now = millis();
+    bool raw = (digitalRead(DOCK_CONTACT_PIN) == HIGH);
+
+    if (raw != rawContact) {
+        rawContact = raw;
+        rawSince = now;
+    } else if (raw != contact && now - rawSince >= DOCK_CONTACT_DEBOUNCE_MS) {
+        contact = raw;
+        LOGD(LOG_SUB_NAVIGATION, "Dock contact %s", contact ? "closed" : "open");
+    }
+}
+
+void DockingController::startDocking() {
+    retries = 0;
+    lastRetryReason = "";
+    setPhase(DOCK_FOLLOW);
+}
+
+DockPhase DockingController::updateApproach() {
+    if (!initialized) {
+        return phase;
+    }
+
+    unsigned long now = millis();
+
+    switch (phase) {
+        case DOCK_FOLLOW:
+        case DOCK_APPROACH:
+            if (contact) {
+                motorsPtr->stop();
+                dockings++;
+                Logger::info("Docked after " + String(retries) + " retries");
+                setPhase(DOCK_DOCKED);
+                break;
+            }
+
+            if (phase == DOCK_FOLLOW) {
+                if (perimeterPtr->getSignalStrength() >= DOCK_APPROACH_STRENGTH) {
+                    Logger::info("Dock signal reached - final approach");
+                    setPhase(DOCK_APPROACH);
+                }
+                break;
+            }
+
+            if (now - phaseStart >= DOCK_APPROACH_TIMEOUT_MS) {
+                retry("no contact");
+                break;
+            }
+
+            // Strøm uden kontakt = skubber mod docken ved siden af kontakterne
+            if (motorsPtr->getTotalCurrent() > DOCK_STALL_CURRENT_A) {
+                if (stallSince == 0) {
+                    stallSince = now;
+                } else if (now - stallSince >= DOCK_STALL_MS) {
+                    retry("stalled");
+                    break;
+                }
+            } else {
+                stallSince = 0;
+            }
+
+            steerApproach(now);
+            break;
+
+        case DOCK_BACKOFF:
+            if (now - phaseStart >= DOCK_BACKOFF_MS) {
+                motorsPtr->stop();
+                setPhase(DOCK_APPROACH);
+            } else {
+                motorsPtr->setSpeed(-DOCK_BACKOFF_SPEED, -DOCK_BACKOFF_SPEED);
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    return phase;
+}
+
+void DockingController::startUndock() {
+    Logger::info("Leaving dock");
+    setPhase(DOCK_UNDOCKING);
+}
+
+bool DockingController::updateUndock() {
+    if (!initialized || phase != DOCK_UNDOCKING) {
+        return true;
+    }
+
+    unsigned long elapsed = millis() - phaseStart;
+
+    if (elapsed < DOCK_UNDOCK_MS) {
+        motorsPtr->setSpeed(-DOCK_BACKOFF_SPEED, -DOCK_BACKOFF_SPEED);
+        return false;
+    }
+
+    // Kablet er til venstre - drej ind på plænen
+    if (elapsed < DOCK_UNDOCK_MS + DOCK_UNDOCK_TURN_MS) {
+        motorsPtr->setSpeed(MOTOR_TURN_SPEED, -MOTOR_TURN_SPEED);
+        return false;
+    }
+
+    motorsPtr->stop();
+    setPhase(DOCK_IDLE);
+    return true;
+}
+
+void DockingController::stop() {
+    if (phase == DOCK_APPROACH || phase == DOCK_BACKOFF || phase == DOCK_UNDOCKING) {
+        motorsPtr->stop();
+    }
+    setPhase(DOCK_IDLE);
+}
+
+const char* DockingController::getPhaseName() const {
+    switch (phase) {
+        case DOCK_IDLE:         return "IDLE";
+        case DOCK_FOLLOW:       return "FOLLOW";
+        case DOCK_APPROACH:     return "APPROACH";
+        case DOCK_BACKOFF:      return "BACKOFF";
+        case DOCK_DOCKED:       return "DOCKED";
+        case DOCK_UNDOCKING:    return "UNDOCKING";
+        case DOCK_FAILED:       return "FAILED";
+        default:                return "UNKNOWN";
+    }
+}
+
+String DockingController::getJSON() {
+    String json = "{\"phase\":\"" + String(getPhaseName()) + "\"";
+    json += ",\"contact\":" + String(contact ? "true" : "false");
+    json += ",\"signalStrength\":" + String(perimeterPtr != nullptr ? perimeterPtr->getSignalStrength() : 0);
+    json += ",\"alignError\":" + String(alignError, 1);
+    json += ",\"retries\":" + String(retries);
+    json += ",\"lastRetryReason\":\"" + String(lastRetryReason) + "\"";
+    json += ",\"dockings\":" + String(dockings);
+    json += ",\"failures\":" + String(failures);
+    json += "}";
+    return json;
+}
+
+void DockingController::setPhase(DockPhase newPhase) {
+    phase = newPhase;
+    phaseStart = millis();
+    misalignSince = 0;
+    stallSince = 0;
+}
+
+void DockingController::retry(const char* reason) {
+    lastRetryReason = reason;
+    retries++;
+
+    if (retries > DOCK_MAX_RETRIES) {
+        motorsPtr->stop();
+        failures++;
+        Logger::error("Docking failed after " + String(DOCK_MAX_RETRIES) + " retries (" + reason + ")");
+        setPhase(DOCK_FAILED);
+        return;
+    }
+
+    Logger::warning("Docking attempt " + String(retries) + " failed (" + reason + ") - backing off");
+    setPhase(DOCK_BACKOFF);
+}
+
+void DockingController::steerApproach(unsigned long now) {
+    // Positiv afvigelse = for langt fra kablet (venstre) - udenfor giver negativ sideafstand
+    alignError = perimeterPtr->getLateralOffset() - DOCK_WIRE_OFFSET_CM;
+
+    int correction = constrain((int)(alignError * DOCK_ALIGN_GAIN), -DOCK_ALIGN_MAX_PWM, DOCK_ALIGN_MAX_PWM);
+    motorsPtr->setSpeed(DOCK_APPROACH_SPEED - correction, DOCK_APPROACH_SPEED + correction);
+
+    if (fabs(alignError) > DOCK_ALIGN_TOLERANCE_CM) {
+        if (misalignSince == 0) {
+            misalignSince = now;
+        } else if (now - misalignSince >= DOCK_MISALIGN_MS) {
+            retry("misaligned");
+        }
+    } else {
+        misalignSince = 0;
+    }
+}
@@ -0,0 +1,155 @@
+#ifndef DOCKING_CONTROLLER_H
+#define DOCKING_CONTROLLER_H
+
+#include <Arduino.h>
+#include "../config/Config.h"
+#include "../system/Logger.h"
+
+class Motors;
+class PerimeterReceiver;
+
+/**
+ * Faser i docking forløbet
+ */
+enum DockPhase {
+    DOCK_IDLE,          // Ikke på vej hjem
+    DOCK_FOLLOW,        // Følger kablet hjem (main styrer)
+    DOCK_APPROACH,      // Slutindkørsel - langsom, holder kablets afstand
+    DOCK_BACKOFF,       // Bakker ud til nyt forsøg
+    DOCK_DOCKED,        // Ladekontakt lukket
+    DOCK_UNDOCKING,     // Bakker ud af docken før klipning
+    DOCK_FAILED         // Opgivet efter DOCK_MAX_RETRIES
+};
+
+/**
+ * DockingController klasse - Finder ladestationen for enden af kablet
+ *
+ * Ladekontakten aflæses med update() og skal være stabil i
+ * DOCK_CONTACT_DEBOUNCE_MS. Mens robotten følger kablet hjem holder
+ * updateApproach() øje med signalstyrken; ved DOCK_APPROACH_STRENGTH
+ * overtager controlleren motorerne, kører langsomt og holder kablet i
+ * DOCK_WIRE_OFFSET_CM afstand. Kommer robotten skævt ind, går i stå uden
+ * kontakt eller når den ikke frem i tide, bakkes der ud og forsøges igen.
+ * Efter opladning bakker startUndock()/updateUndock() robotten ud og
+ * drejer den væk fra kablet.
+ */
+class DockingController {
+public:
+    /**
+     * Constructor
+     */
+    DockingController();
+
+    /**
+     * Initialiserer ladekontakt og references
+     * @param motors Motorerne der køres under slutindkørsel
+     * @param receiver Perimeter modtager (signalstyrke og afstand til kablet)
+     * @return true hvis succesfuld
+     */
+    bool begin(Motors* motors, PerimeterReceiver* receiver);
+
+    /**
+     * Aflæser ladekontakten (kaldes periodisk, også uden for docking)
+     */
+    void update();
+
+    /**
+     * Start docking - robotten er begyndt at følge kablet hjem
+     */
+    void startDocking();
+
+    /**
+     * Kør docking forløbet (kaldes fra RETURNING efter perimeter update)
+     * I DOCK_APPROACH og DOCK_BACKOFF styrer controlleren motorerne.
+     * @return Fase efter opdateringen
+     */
+    DockPhase updateApproach();
+
+    /**
+     * Start udkørsel fra docken
+     */
+    void startUndock();
+
+    /**
+     * Kør udkørslen (kaldes hver loop mens isUndocking())
+     * @return true når robotten er fri af docken
+     */
+    bool updateUndock();
+
+    /**
+     * Afbryd docking eller udkørsel (motorerne stoppes)
+     */
+    void stop();
+
+    /**
+     * Er ladekontakten lukket?
+     */
+    bool isDocked() const { return contact; }
+
+    /**
+     * Styrer controlleren motorerne i RETURNING?
+     */
+    bool isApproaching() const { return phase == DOCK_APPROACH || phase == DOCK_BACKOFF; }
+
+    /**
+     * Er udkørsel i gang?
+     */
+    bool isUndocking() const { return phase == DOCK_UNDOCKING; }
+
+    /**
+     * Hent nuværende fase
+     */
+    DockPhase getPhase() const { return phase; }
+
+    /**
+     * Hent fase som tekst
+     */
+    const char* getPhaseName() const;
+
+    /**
+     * Hent status som JSON (/api/dock)
+     */
+    String getJSON();
+
+private:
+    /**
+     * Skift fase og nulstil fase timere
+     */
+    void setPhase(DockPhase newPhase);
+
+    /**
+     * Mislykket forsøg - bak ud eller opgiv
+     * @param reason Årsag (logges og vises i /api/dock)
+     */
+    void retry(const char* reason);
+
+    /**
+     * Styr mod kablets afstand under slutindkørsel
+     * @param now Nuværende tid (ms)
+     */
+    void steerApproach(unsigned long now);
+
+    Motors* motorsPtr;
+    PerimeterReceiver* perimeterPtr;
+
+    DockPhase phase;
+    unsigned long phaseStart;
+    unsigned long misalignSince;    // 0 = på linje
+    unsigned long stallSince;       // 0 = ingen blokering
+    int retries;                    // Mislykkede forsøg i nuværende docking
+    float alignError;               // Seneste afvigelse fra kablets afstand (cm)
+
+    // Ladekontakt (debounced)
+    bool contact;
+    bool rawContact;
+    unsigned long rawSince;
+
+    // Statistik
+    uint32_t dockings;
+    uint32_t failures;
+    const char* lastRetryReason;
+
+    bool initialized;
+};
+
+#endif // DOCKING_CONTROLLER_H
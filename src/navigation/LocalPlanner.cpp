@@ -0,0 +1,154 @@
+#include "LocalPlanner.h"
+
+static const float SECTOR_WIDTH = 360.0 / VFH_SECTORS;
+
+LocalPlanner::LocalPlanner() {
+    memset(histogram, 0, sizeof(histogram));
+    rowX = 0.0;
+    rowY = 0.0;
+    rowHeading = 0.0;
+    rowActive = false;
+    steerHeading = 0.0;
+    blocked = false;
+}
+
+void LocalPlanner::startRow(const OccupancyGrid& map, float heading) {
+    rowX = map.getX();
+    rowY = map.getY();
+    rowHeading = heading;
+    rowActive = true;
+    steerHeading = heading;
+    blocked = false;
+
+    LOGD(LOG_SUB_NAVIGATION, "Row line at (%.0f, %.0f) heading %.0f", rowX, rowY, rowHeading);
+}
+
+float LocalPlanner::getCrossTrackError(const OccupancyGrid& map) {
+    if (!rowActive) {
+        return 0.0;
+    }
+
+    // Fortegn: positiv når robotten er til højre for linjen (set i kørselsretningen)
+    float rad = rowHeading * DEG_TO_RAD;
+    float dx = map.getX() - rowX;
+    float dy = map.getY() - rowY;
+    return dx * cos(rad) - dy * sin(rad);
+}
+
+void LocalPlanner::update(const OccupancyGrid& map) {
+    if (!rowActive) {
+        return;
+    }
+
+    // Styr tilbage mod rækkens linje
+    float correction = constrain(getCrossTrackError(map) * ROW_CROSS_TRACK_GAIN,
+                                 -ROW_CROSS_TRACK_MAX_ANGLE, ROW_CROSS_TRACK_MAX_ANGLE);
+    float desired = MowerMath::normalizeAngle(rowHeading - correction);
+
+    buildHistogram(map);
+
+    // Ønsket retning er fri - kør direkte
+    int desiredSector = sectorFor(desired);
+    if (isSectorFree(desiredSector)) {
+        blocked = false;
+        steerHeading = desired;
+        return;
+    }
+
+    // Søg udad fra ønsket sektor efter nærmeste frie sektor
+    int maxOffset = (int)(VFH_MAX_DEVIATION / SECTOR_WIDTH);
+    for (int offset = 1; offset <= maxOffset; offset++) {
+        for (int sign = -1; sign <= 1; sign += 2) {
+            int sector = (desiredSector + sign * offset + VFH_SECTORS) % VFH_SECTORS;
+            if (isSectorFree(sector)) {
+                blocked = false;
+                steerHeading = (sector + 0.5) * SECTOR_WIDTH;
+                LOGD(LOG_SUB_NAVIGATION, "VFH steer %.0f -> %.0f", desired, steerHeading);
+                return;
+            }
+        }
+    }
+
+    // Ingen fri retning - lad obstacle avoidance tage over
+    blocked = true;
+    steerHeading = desired;
+}
+
+float LocalPlanner::getSteerHeading() {
+    return steerHeading;
+}
+
+bool LocalPlanner::isBlocked() {
+    return blocked;
+}
+
+AvoidanceDirection LocalPlanner::chooseSide(const OccupancyGrid& map, AvoidanceDirection fallback) {
+    buildHistogram(map);
+
+    // Summér tæthed i halvcirklen til venstre og til højre for robotten
+    int robotSector = sectorFor(map.getHeading());
+    float leftDensity = 0.0;
+    float rightDensity = 0.0;
+    for (int offset = 1; offset <= VFH_SECTORS / 4; offset++) {
+        leftDensity += histogram[(robotSector - offset + VFH_SECTORS) % VFH_SECTORS];
+        rightDensity += histogram[(robotSector + offset) % VFH_SECTORS];
+    }
+
+    if (fabs(leftDensity - rightDensity) < VFH_THRESHOLD) {
+        return fallback;
+    }
+    return leftDensity < rightDensity ? AVOID_LEFT : AVOID_RIGHT;
+}
+
+void LocalPlanner::buildHistogram(const OccupancyGrid& map) {
+    memset(histogram, 0, sizeof(histogram));
+
+    float robotX = map.getX();
+    float robotY = map.getY();
+
+    for (int cy = 0; cy < LOCAL_MAP_SIZE; cy++) {
+        for (int cx = 0; cx < LOCAL_MAP_SIZE; cx++) {
+            int8_t value = map.getCell(cx, cy);
+            if (value <= 0) {
+                continue;
+            }
+
+            float x, y;
+            map.cellToWorld(cx, cy, x, y);
+            float dx = x - robotX;
+            float dy = y - robotY;
+            float distance = sqrt(dx * dx + dy * dy);
+            if (distance > VFH_WINDOW_CM || distance < 1.0) {
+                continue;
+            }
+
+            // Magnitude: sikkerhed^2 * (1 - d/vindue) - tætte, sikre celler vejer mest
+            float certainty = (float)value / LOCAL_MAP_LOGODDS_MAX;
+            float magnitude = certainty * certainty * (1.0 - distance / VFH_WINDOW_CM);
+
+            // Forstør med robottens radius - cellen blokerer alle sektorer robotten ikke kan passere i
+            float bearing = MowerMath::normalizeAngle(atan2(dx, dy) * RAD_TO_DEG);
+            float enlarge = distance > ROBOT_RADIUS_CM ? asin(ROBOT_RADIUS_CM / distance) * RAD_TO_DEG : 90.0;
+
+            int first = sectorFor(bearing - enlarge);
+            int count = (int)(2 * enlarge / SECTOR_WIDTH) + 1;
+            for (int i = 0; i <= count && i < VFH_SECTORS; i++) {
+                histogram[(first + i) % VFH_SECTORS] += magnitude;
+            }
+        }
+    }
+}
+
+int LocalPlanner::sectorFor(float angleDeg) {
+    return ((int)(MowerMath::normalizeAngle(angleDeg) / SECTOR_WIDTH)) % VFH_SECTORS;
+}
+
+bool LocalPlanner::isSectorFree(int sector) {
+    // Kræv også fri nabo sektorer, så åbningen er bred nok
+    for (int offset = -1; offset <= 1; offset++) {
+        if (histogram[(sector + offset + VFH_SECTORS) % VFH_SECTORS] > VFH_THRESHOLD) {
+            return false;
+        }
+    }
+    return true;
+}
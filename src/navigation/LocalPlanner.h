@@ -0,0 +1,95 @@
+#ifndef LOCAL_PLANNER_H
+#define LOCAL_PLANNER_H
+
+#include <Arduino.h>
+#include "../config/Config.h"
+#include "../system/Logger.h"
+#include "../utils/Math.h"
+#include "OccupancyGrid.h"
+
+/**
+ * LocalPlanner klasse - Reaktiv styring rundt om kendte forhindringer
+ *
+ * Vector field histogram (VFH): optagede celler i et vindue omkring
+ * robotten samles i et polært histogram, forstørret med robottens
+ * radius. Styringen vælger den frie sektor tættest på ønsket heading.
+ * Ønsket heading er rækkens heading plus en korrektion tilbage mod
+ * rækkens linje, så robotten kan runde en forhindring uden at opgive
+ * rækken.
+ */
+class LocalPlanner {
+public:
+    /**
+     * Constructor
+     */
+    LocalPlanner();
+
+    /**
+     * Start ny række gennem robottens nuværende position
+     * @param map Lokalt kort (giver position)
+     * @param rowHeading Rækkens heading (0-360)
+     */
+    void startRow(const OccupancyGrid& map, float rowHeading);
+
+    /**
+     * Genberegn styre heading fra kortet (kaldes når kortet er opdateret)
+     * @param map Lokalt kort
+     */
+    void update(const OccupancyGrid& map);
+
+    /**
+     * Hent seneste styre heading
+     * @return Heading at køre efter (0-360)
+     */
+    float getSteerHeading();
+
+    /**
+     * Tjek om der ikke var nogen fri retning ved sidste update()
+     * @return true hvis alle sektorer indenfor VFH_MAX_DEVIATION er blokeret
+     */
+    bool isBlocked();
+
+    /**
+     * Vælg undgåelses side ud fra kortet (hvor der er mindst forhindring)
+     * @param map Lokalt kort
+     * @param fallback Retning hvis kortet ikke gør forskel
+     * @return AVOID_LEFT eller AVOID_RIGHT (eller fallback)
+     */
+    AvoidanceDirection chooseSide(const OccupancyGrid& map, AvoidanceDirection fallback);
+
+    /**
+     * Hent afstand fra rækkens linje
+     * @param map Lokalt kort
+     * @return cm (positiv = højre for rækken)
+     */
+    float getCrossTrackError(const OccupancyGrid& map);
+
+private:
+    /**
+     * Opbyg polært histogram fra kortet
+     */
+    void buildHistogram(const OccupancyGrid& map);
+
+    /**
+     * Sektor index for kompas vinkel
+     */
+    static int sectorFor(float angleDeg);
+
+    /**
+     * Tjek om sektor og naboer er frie
+     */
+    bool isSectorFree(int sector);
+
+    float histogram[VFH_SECTORS];
+
+    // Rækkens linje
+    float rowX;
+    float rowY;
+    float rowHeading;
+    bool rowActive;
+
+    float steerHeading;
+    bool blocked;
+};
+
+#endif // LOCAL_PLANNER_H
@@ -0,0 +1,161 @@
+#include "MissionPlanner.h"
+#include "PathPlanner.h"
+#include "../hardware/Battery.h"
+
+MissionPlanner::MissionPlanner() {
+    batteryPtr = nullptr;
+    plannerPtr = nullptr;
+    whPerMeter = MISSION_DEFAULT_WH_PER_M;
+    learnDistanceM = 0.0;
+    learnStartWh = 0.0;
+    learning = false;
+    samples = 0;
+    homeDistanceM = MISSION_RETURN_WIRE_M;
+    returnEnergyWh = 0.0;
+    affordableRows = -1;
+    returnsPlanned = 0;
+    initialized = false;
+}
+
+bool MissionPlanner::begin(Battery* battery, PathPlanner* planner) {
+    if (battery == nullptr || planner == nullptr) {
+        Logger::error("MissionPlanner: missing battery or path planner");
+        return false;
+    }
+
+    batteryPtr = battery;
+    plannerPtr = planner;
+    initialized = true;
+
+    Logger::info("MissionPlanner initialized (reserve " + String(MISSION_RESERVE_PCT, 0) + "%)");
+    return true;
+}
+
+void MissionPlanner::addDistance(float distanceCm, bool mowing) {
+    if (!initialized) {
+        return;
+    }
+
+    // Kun klipning tæller - transport, pauser og ladning giver andet forbrug
+    if (!mowing) {
+        learning = false;
+        return;
+    }
+
+    if (!learning) {
+        learning = true;
+        learnDistanceM = 0.0;
+        learnStartWh = batteryPtr->getMotorPackRemainingWh();
+    }
+
+    learnDistanceM += fabs(distanceCm) / 100.0;
+    if (learnDistanceM < MISSION_LEARN_DISTANCE_M) {
+        return;
+    }
+
+    float usedWh = learnStartWh - batteryPtr->getMotorPackRemainingWh();
+    float measured = usedWh / learnDistanceM;
+    if (measured >= MISSION_WH_PER_M_MIN && measured <= MISSION_WH_PER_M_MAX) {
+        whPerMeter += (measured - whPerMeter) * MISSION_LEARN_GAIN;
+        samples++;
+        LOGD(LOG_SUB_NAVIGATION, "Mission: %.3f Wh/m measured, filtered %.3f Wh/m", measured, whPerMeter);
+    }
+
+    learnDistanceM = 0.0;
+    learnStartWh = batteryPtr->getMotorPackRemainingWh();
+}
+
+void MissionPlanner::update(float poseX, float poseY) {
+    if (!initialized) {
+        return;
+    }
+
+    // Hjem = tilbage til startpunktet og derfra længste vej langs kablet
+    homeDistanceM = sqrt(poseX * poseX + poseY * poseY) / 100.0 + MISSION_RETURN_WIRE_M;
+    returnEnergyWh = homeDistanceM * whPerMeter * MISSION_RETURN_FACTOR;
+
+    if (plannerPtr->isPatternComplete() || plannerPtr->isWireMode()) {
+        affordableRows = -1;
+        return;
+    }
+    affordableRows = countAffordableRows(plannerPtr->getCurrentRow() + 1);
+}
+
+bool MissionPlanner::shouldReturnAtRowEnd() {
+    if (!initialized || plannerPtr->isWireMode()) {
+        return false;
+    }
+
+    int nextRow = plannerPtr->getCurrentRow() + 1;
+    if (nextRow >= plannerPtr->getTotalRows()) {
+        return false;   // Sidste række - mønsteret er færdigt
+    }
+
+    affordableRows = countAffordableRows(nextRow);
+    if (affordableRows > 0) {
+        return false;
+    }
+
+    returnsPlanned++;
+    Logger::info("Mission: row " + String(nextRow) + " does not fit in remaining energy (" +
+                 String(batteryPtr->getMotorPackRemainingWh(), 1) + " Wh, return " +
+                 String(returnEnergyWh, 1) + " Wh) - returning to base");
+    return true;
+}
+
+bool MissionPlanner::mustReturnNow() {
+    if (!initialized) {
+        return false;
+    }
+    return getSpareEnergyWh() < 0.0;
+}
+
+int MissionPlanner::getAffordableRows() {
+    return affordableRows;
+}
+
+float MissionPlanner::getWhPerMeter() {
+    return whPerMeter;
+}
+
+float MissionPlanner::getReturnEnergyWh() {
+    return returnEnergyWh;
+}
+
+String MissionPlanner::getJSON() {
+    String json = "{\"whPerMeter\":" + String(whPerMeter, 3);
+    json += ",\"samples\":" + String(samples);
+    json += ",\"homeDistanceM\":" + String(homeDistanceM, 1);
+    json += ",\"returnEnergyWh\":" + String(returnEnergyWh, 2);
+    if (initialized) {
+        json += ",\"remainingWh\":" + String(batteryPtr->getMotorPackRemainingWh(), 2);
+        json += ",\"spareEnergyWh\":" + String(getSpareEnergyWh(), 2);
+        json += ",\"currentRow\":" + String(plannerPtr->getCurrentRow());
+        json += ",\"totalRows\":" + String(plannerPtr->getTotalRows());
+    }
+    json += ",\"affordableRows\":" + String(affordableRows);
+    json += ",\"returnsPlanned\":" + String(returnsPlanned);
+    json += "}";
+    return json;
+}
+
+float MissionPlanner::getSpareEnergyWh() {
+    float reserveWh = batteryPtr->getMotorPackCapacityWh() * MISSION_RESERVE_PCT / 100.0;
+    return batteryPtr->getMotorPackRemainingWh() - reserveWh - returnEnergyWh;
+}
+
+int MissionPlanner::countAffordableRows(int firstRow) {
+    float spareWh = getSpareEnergyWh();
+    int count = 0;
+
+    for (int row = firstRow; row < plannerPtr->getTotalRows(); row++) {
+        float rowWh = (plannerPtr->getRowLengthCm(row) / 100.0 + MISSION_TURN_COST_M) * whPerMeter;
+        if (rowWh > spareWh) {
+            break;
+        }
+        spareWh -= rowWh;
+        count++;
+    }
+
+    return count;
+}
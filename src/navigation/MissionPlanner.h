@@ -0,0 +1,125 @@
+#ifndef MISSION_PLANNER_H
+#define MISSION_PLANNER_H
+
+#include <Arduino.h>
+#include "../config/Config.h"
+#include "../system/Logger.h"
+
+class Battery;
+class PathPlanner;
+
+/**
+ * MissionPlanner klasse - Passer klipningen ind i resterende batteri
+ *
+ * Forbruget pr. meter måles mens robotten klipper (fald i motor batteriets
+ * resterende Wh over MISSION_LEARN_DISTANCE_M kørsel - se
+ * Battery::getMotorPackRemainingWh()). Ud fra resterende
+ * energi, forbruget og vejen hjem (afstand til startpunktet plus
+ * MISSION_RETURN_WIRE_M langs kablet) regnes hvor mange af de næste
+ * rækker der kan nås, så robotten stadig kommer hjem med
+ * MISSION_RESERVE_PCT i behold.
+ *
+ * Ved hver række ende spørger main om næste række kan nås - hvis ikke,
+ * køres hjem i stedet for at vende, og planneren står klar til at
+ * fortsætte med næste række efter opladning. Rækker energien til
+ * hjemturen ikke længere midt i en række, køres hjem med det samme.
+ */
+class MissionPlanner {
+public:
+    /**
+     * Constructor
+     */
+    MissionPlanner();
+
+    /**
+     * Initialiserer mission planner
+     * @param battery Giver resterende energi
+     * @param planner Giver række længder og fremskridt
+     * @return true hvis succesfuld
+     */
+    bool begin(Battery* battery, PathPlanner* planner);
+
+    /**
+     * Registrér kørt distance (fra dead reckoning)
+     * @param distanceCm Kørt siden sidste kald (cm)
+     * @param mowing true hvis robotten klipper (MOWING og under-tilstande)
+     */
+    void addDistance(float distanceCm, bool mowing);
+
+    /**
+     * Genberegn hjemvej og rækker der kan nås (kaldes efter battery.update())
+     * @param poseX Robottens position i forhold til mønstrets start (cm)
+     * @param poseY Robottens position i forhold til mønstrets start (cm)
+     */
+    void update(float poseX, float poseY);
+
+    /**
+     * Skal robotten køre hjem i stedet for at starte næste række?
+     * Kaldes ved række ende, før PathPlanner::nextRow().
+     * @return true hvis næste række ikke kan nås med reserve til hjemturen
+     */
+    bool shouldReturnAtRowEnd();
+
+    /**
+     * Rækker energien kun lige til hjemturen? (midt i en række)
+     * @return true hvis robotten skal køre hjem nu
+     */
+    bool mustReturnNow();
+
+    /**
+     * Antal af rækkerne efter den nuværende der kan nås
+     * @return Rækker, -1 = ikke beregnet (intet mønster eller wire omgange)
+     */
+    int getAffordableRows();
+
+    /**
+     * Målt forbrug under klipning
+     * @return Wh pr. meter
+     */
+    float getWhPerMeter();
+
+    /**
+     * Energi til hjemturen fra nuværende position
+     * @return Wh
+     */
+    float getReturnEnergyWh();
+
+    /**
+     * Hent status som JSON (/api/mission)
+     */
+    String getJSON();
+
+private:
+    /**
+     * Energi til rådighed for klipning (resterende minus reserve og hjemtur)
+     * @return Wh (negativ = hjemturen æder af reserven)
+     */
+    float getSpareEnergyWh();
+
+    /**
+     * Tæl rækker fra firstRow der kan nås med energien til rådighed
+     * @param firstRow Første række der skal klippes
+     * @return Antal rækker
+     */
+    int countAffordableRows(int firstRow);
+
+    Battery* batteryPtr;
+    PathPlanner* plannerPtr;
+
+    // Forbrugs måling
+    float whPerMeter;           // Filtreret forbrug under klipning
+    float learnDistanceM;       // Kørt i nuværende målevindue
+    float learnStartWh;         // Resterende Wh ved vinduets start
+    bool learning;              // Målevindue i gang
+    int samples;                // Antal målinger bag whPerMeter
+
+    // Seneste beregning
+    float homeDistanceM;        // Vej hjem (m)
+    float returnEnergyWh;
+    int affordableRows;
+    int returnsPlanned;         // Hjemture besluttet af planneren
+
+    bool initialized;
+};
+
+#endif // MISSION_PLANNER_H
@@ -4,6 +4,16 @@ Movement::Movement() {
     motorsPtr = nullptr;
     imuPtr = nullptr;
     targetHeading = 0.0;
+    driveSpeed = MOTOR_CRUISE_SPEED;
+    odometryCm = 0.0;
+    lastOdometryTime = 0;
+    profileSegment = 0;
+    profileActive = false;
+    profileLastHeading = 0.0;
+    profileTurned = 0.0;
+    profileHeading = 0.0;
+    profileSegmentStart = 0;
+    profileStart = 0;
     turningActive = false;
     movingForward = false;
     movingBackward = false;
@@ -33,6 +43,15 @@ void Movement::driveStraight(int speed) {
         return;
     }
 
+    // Integrér distance siden sidste kald (kun hvis vi allerede kørte fremad)
+    unsigned long now = millis();
+    if (movingForward && lastOdometryTime != 0) {
+        float speedCmS = CRUISE_SPEED_CM_S * driveSpeed / MOTOR_CRUISE_SPEED;
+        odometryCm += speedCmS * (now - lastOdometryTime) / 1000.0;
+    }
+    lastOdometryTime = now;
+    driveSpeed = speed;
+
     movingForward = true;
     movingBackward = false;
     turningActive = false;
@@ -43,14 +62,12 @@ void Movement::driveStraight(int speed) {
     // Korrigér kurs for at holde target heading
     correctDrift(currentHeading, targetHeading);
 
-    #if DEBUG_NAVIGATION
     static unsigned long lastDebug = 0;
     if (millis() - lastDebug > 1000) {
-        Logger::debug("Driving straight - Target: " + String(targetHeading) +
-                     "° | Current: " + String(currentHeading) + "°");
+        LOGD(LOG_SUB_NAVIGATION, "Driving straight - Target: %.1f° | Current: %.1f°",
+             targetHeading, currentHeading);
         lastDebug = millis();
     }
-    #endif
 }
 
 bool Movement::turnToHeading(float targetHeading) {
@@ -69,21 +86,18 @@ bool Movement::turnToHeading(float targetHeading) {
     // Beregn heading difference
     float headingError = MowerMath::angleDifference(currentHeading, targetHeading);
 
-    #if DEBUG_NAVIGATION
     static unsigned long lastDebug = 0;
     if (millis() - lastDebug > 500) {
-        Logger::debug("Turning - Target: " + String(targetHeading) +
-                     "° | Current: " + String(currentHeading) +
-                     "° | Error: " + String(headingError) + "°");
+        LOGD(LOG_SUB_NAVIGATION, "Turning - Target: %.1f° | Current: %.1f° | Error: %.1f°",
+             targetHeading, currentHeading, headingError);
         lastDebug = millis();
     }
-    #endif
 
     // Tjek om vi har nået target heading
     if (abs(headingError) < HEADING_TOLERANCE) {
         motorsPtr->stop();
         turningActive = false;
-        Logger::debug("Turn complete - Heading reached");
+        LOGD(LOG_SUB_NAVIGATION, "Turn complete - Heading reached");
         return true; // Heading nået
     }
 
@@ -110,18 +124,18 @@ void Movement::backUp(int distance) {
 
     // Estimér tid baseret på distance og hastighed
     // Antager MOTOR_BACKUP_SPEED giver ca. 15 cm/s (juster efter behov)
-    const float BACKUP_SPEED_CM_PER_SEC = 15.0;
-    int backupTime = (distance / BACKUP_SPEED_CM_PER_SEC) * 1000; // ms
+    int backupTime = (distance / BACKUP_SPEED_CM_S) * 1000; // ms
 
-    Logger::debug("Backing up " + String(distance) + " cm");
+    LOGD(LOG_SUB_NAVIGATION, "Backing up %d cm", distance);
 
     motorsPtr->backward(MOTOR_BACKUP_SPEED);
     delay(backupTime); // Simpel blocking delay for backup
     motorsPtr->stop();
 
     movingBackward = false;
+    odometryCm -= distance;
 
-    Logger::debug("Backup complete");
+    LOGD(LOG_SUB_NAVIGATION, "Backup complete");
 }
 
 void Movement::stop() {
@@ -133,6 +147,7 @@ void Movement::stop() {
     movingForward = false;
     movingBackward = false;
     turningActive = false;
+    profileActive = false;
 
     // Nulstil PID
     lastError = 0.0;
@@ -165,13 +180,125 @@ bool Movement::isTurning() {
 
 void Movement::setTargetHeading(float heading) {
     targetHeading = MowerMath::normalizeAngle(heading);
-    Logger::debug("Target heading set to: " + String(targetHeading) + "°");
+    LOGD(LOG_SUB_NAVIGATION, "Target heading set to: %.1f°", targetHeading);
 }
 
 float Movement::getTargetHeading() {
     return targetHeading;
 }
 
+void Movement::startProfile(const TurnProfile& turnProfile) {
+    if (!initialized || turnProfile.count == 0) {
+        return;
+    }
+
+    profile = turnProfile;
+    profileActive = true;
+    profileStart = millis();
+    lastOdometryTime = profileStart;
+
+    LOGD(LOG_SUB_NAVIGATION, "Profile %s: %d segments, %.0f cm, ~%lu ms",
+         profile.name, profile.count, profile.lengthCm, (unsigned long)profile.durationMs);
+
+    startProfileSegment(0);
+}
+
+void Movement::startProfileSegment(uint8_t index) {
+    profileSegment = index;
+    profileSegmentStart = millis();
+    profileLastHeading = imuPtr->getHeading();
+    profileTurned = 0.0;
+
+    const TurnSegment& segment = profile.segments[index];
+    turningActive = segment.type == TURN_SEG_ARC;
+    movingForward = !segment.reverse;
+    movingBackward = segment.reverse;
+
+    // Lige stykke efter en bue holder den heading buen endte på
+    profileHeading = profileLastHeading;
+
+    // Nulstil PID så en tidligere fejl ikke giver et ryk
+    lastError = 0.0;
+    integralError = 0.0;
+
+    motorsPtr->setSpeed(segment.leftSpeed, segment.rightSpeed);
+}
+
+bool Movement::updateProfile() {
+    if (!initialized || !profileActive) {
+        return true;
+    }
+
+    unsigned long now = millis();
+    const TurnSegment& segment = profile.segments[profileSegment];
+
+    // Odometri - gennemsnit af hjulene giver fart langs buen
+    float speedCmS = segment.reverse
+        ? -BACKUP_SPEED_CM_S
+        : CRUISE_SPEED_CM_S * (segment.leftSpeed + segment.rightSpeed) / 2.0 / MOTOR_CRUISE_SPEED;
+    odometryCm += speedCmS * (now - lastOdometryTime) / 1000.0;
+    lastOdometryTime = now;
+
+    // Hold styr på drejet vinkel (fortegn: + = segmentets drejeretning)
+    float heading = imuPtr->getHeading();
+    float change = MowerMath::angleDifference(profileLastHeading, heading);
+    profileTurned += segment.direction == LEFT ? -change : change;
+    profileLastHeading = heading;
+
+    unsigned long elapsed = now - profileSegmentStart;
+    bool segmentDone;
+
+    if (segment.type == TURN_SEG_ARC) {
+        segmentDone = profileTurned >= segment.amount - HEADING_TOLERANCE;
+    } else {
+        segmentDone = elapsed >= segment.durationMs;
+        if (!segmentDone && !segment.reverse) {
+            driveSpeed = segment.leftSpeed;
+            correctDrift(heading, profileHeading);
+        }
+    }
+
+    // Glatte eller blokerede hjul - giv op i stedet for at køre rundt
+    if (!segmentDone && elapsed > 2 * segment.durationMs + 2000) {
+        Logger::warning("Movement: Profile " + String(profile.name) + " segment " +
+                        String(profileSegment) + " timed out");
+        profileActive = false;
+        turningActive = false;
+        return true;
+    }
+
+    if (!segmentDone) {
+        return false;
+    }
+
+    if (profileSegment + 1 < profile.count) {
+        startProfileSegment(profileSegment + 1);
+        return false;
+    }
+
+    LOGD(LOG_SUB_NAVIGATION, "Profile %s complete in %lu ms", profile.name, now - profileStart);
+    profileActive = false;
+    turningActive = false;
+    return true;
+}
+
+void Movement::cancelProfile() {
+    if (profileActive) {
+        profileActive = false;
+        turningActive = false;
+    }
+}
+
+bool Movement::isProfileReversing() {
+    return profileActive && profile.segments[profileSegment].reverse;
+}
+
+float Movement::consumeOdometry() {
+    float distance = odometryCm;
+    odometryCm = 0.0;
+    return distance;
+}
+
 void Movement::update() {
     if (!initialized) {
         return;
@@ -179,8 +306,8 @@ void Movement::update() {
 
     lastUpdate = millis();
 
-    // Opdater kun hvis vi kører lige fremad
-    if (movingForward && !turningActive) {
+    // Opdater kun hvis vi kører lige fremad (profiler styrer selv)
+    if (movingForward && !turningActive && !profileActive) {
         float currentHeading = imuPtr->getHeading();
         correctDrift(currentHeading, targetHeading);
     }
@@ -197,7 +324,7 @@ void Movement::correctDrift(float currentHeading, float targetHeading) {
     correction = constrain(correction, -100, 100);
 
     // Anvend korrektion til motor hastigheder
-    int baseSpeed = MOTOR_CRUISE_SPEED;
+    int baseSpeed = driveSpeed;
     int leftSpeed = baseSpeed - correction;
     int rightSpeed = baseSpeed + correction;
 
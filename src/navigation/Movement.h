@@ -7,6 +7,7 @@
 #include "../hardware/IMU.h"
 #include "../system/Logger.h"
 #include "../utils/Math.h"
+#include "TurnPlanner.h"
 
 /**
  * Movement klasse - Eksekverer bevægelseskommandoer
@@ -84,6 +85,37 @@ public:
      */
     float getTargetHeading();
 
+    /**
+     * Start kørsel af et vendings profil (buer og lige stykker)
+     * Motorerne stoppes ikke mellem segmenterne eller til sidst.
+     * @param profile Profil fra TurnPlanner (kopieres)
+     */
+    void startProfile(const TurnProfile& profile);
+
+    /**
+     * Kør aktivt profil - kaldes hvert loop
+     * @return true når sidste segment er færdigt (eller timeout)
+     */
+    bool updateProfile();
+
+    /**
+     * Afbryd aktivt profil uden at røre motorerne
+     */
+    void cancelProfile();
+
+    /**
+     * Kører profilet et baglæns segment lige nu?
+     * @return true hvis bakker
+     */
+    bool isProfileReversing();
+
+    /**
+     * Henter og nulstiller kørt distance siden sidste kald (dead reckoning)
+     * Estimeret ud fra kommanderet fart, da robotten ikke har hjul encodere
+     * @return Distance i cm (negativ ved bakning)
+     */
+    float consumeOdometry();
+
     /**
      * Opdater movement controller
      * Kalder denne regelmæssigt i loop()
@@ -111,6 +143,7 @@ private:
 
     // Movement state
     float targetHeading;
+    int driveSpeed;
     bool turningActive;
     bool movingForward;
     bool movingBackward;
@@ -119,6 +152,25 @@ private:
     float lastError;
     float integralError;
 
+    // Vendings profil
+    TurnProfile profile;
+    uint8_t profileSegment;
+    bool profileActive;
+    float profileLastHeading;
+    float profileTurned;                // Drejet i nuværende bue (grader, + = segmentets retning)
+    float profileHeading;               // Heading at holde på lige stykker
+    unsigned long profileSegmentStart;
+    unsigned long profileStart;
+
+    /**
+     * Start segment (sætter hjulhastigheder)
+     */
+    void startProfileSegment(uint8_t index);
+
+    // Odometri (estimeret)
+    float odometryCm;
+    unsigned long lastOdometryTime;
+
     // Timing
     unsigned long lastUpdate;
 
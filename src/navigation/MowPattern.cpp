@@ -0,0 +1,267 @@
+#include "MowPattern.h"
+
+static const ParallelPattern parallelPattern;
+static const SpiralPattern spiralInPattern(true);
+static const SpiralPattern spiralOutPattern(false);
+static const PerimeterOffsetPattern perimeterPattern;
+
+const MowPattern* MowPattern::forType(uint8_t type) {
+    switch (type) {
+        case ZONE_PATTERN_PARALLEL:     return &parallelPattern;
+        case ZONE_PATTERN_SPIRAL_IN:    return &spiralInPattern;
+        case ZONE_PATTERN_SPIRAL_OUT:   return &spiralOutPattern;
+        case ZONE_PATTERN_PERIMETER:    return &perimeterPattern;
+        default:                        return nullptr;
+    }
+}
+
+/**
+ * Tilføj segment til plan (afrundet til hele cm)
+ * @return false hvis planen er fuld (plan.truncated sættes)
+ */
+static bool addSegment(ZonePlan& plan, float x0, float y0, float x1, float y1) {
+    if (plan.rowCount >= ZONE_MAX_ROWS) {
+        plan.truncated = true;
+        return false;
+    }
+
+    ZonePlanRow& out = plan.rows[plan.rowCount++];
+    out.x0 = (int16_t)lround(x0);
+    out.y0 = (int16_t)lround(y0);
+    out.x1 = (int16_t)lround(x1);
+    out.y1 = (int16_t)lround(y1);
+    return true;
+}
+
+// ============================================================================
+// Parallelle rækker
+// ============================================================================
+
+bool ParallelPattern::buildPlan(const ZoneRecord& zone, ZonePlan& plan) const {
+    // Roter polygonen så rækkerne ligger langs v-aksen:
+    // v = langs kørselsretningen, u = vinkelret (positiv til højre)
+    float rad = zone.angle / 10.0 * DEG_TO_RAD;
+    float dirX = sin(rad);
+    float dirY = cos(rad);
+    float rightX = cos(rad);
+    float rightY = -sin(rad);
+
+    float u[ZONE_MAX_VERTICES];
+    float v[ZONE_MAX_VERTICES];
+    float uMin = INFINITY;
+    float uMax = -INFINITY;
+
+    for (int i = 0; i < zone.vertexCount; i++) {
+        float x = zone.vertices[i][0];
+        float y = zone.vertices[i][1];
+        u[i] = x * rightX + y * rightY;
+        v[i] = x * dirX + y * dirY;
+        uMin = min(uMin, u[i]);
+        uMax = max(uMax, u[i]);
+    }
+
+    // Rækker i midten af hvert bånd, fra venstre mod højre
+    for (float row = uMin + zone.rowWidth / 2.0; row < uMax; row += zone.rowWidth) {
+        // Skæringer mellem rækkens linje og polygonens kanter
+        float hits[ZONE_MAX_VERTICES];
+        int hitCount = 0;
+
+        for (int i = 0; i < zone.vertexCount; i++) {
+            int j = (i + 1) % zone.vertexCount;
+            if ((u[i] <= row && row < u[j]) || (u[j] <= row && row < u[i])) {
+                float t = (row - u[i]) / (u[j] - u[i]);
+                float hit = v[i] + t * (v[j] - v[i]);
+
+                // Indsættelses-sortering (få skæringer)
+                int k = hitCount - 1;
+                while (k >= 0 && hits[k] > hit) {
+                    hits[k + 1] = hits[k];
+                    k--;
+                }
+                hits[k + 1] = hit;
+                hitCount++;
+            }
+        }
+
+        // Konkave polygoner giver flere stykker - kør det længste
+        float start = 0.0;
+        float end = 0.0;
+        for (int k = 0; k + 1 < hitCount; k += 2) {
+            if (hits[k + 1] - hits[k] > end - start) {
+                start = hits[k];
+                end = hits[k + 1];
+            }
+        }
+
+        if (end - start < ZONE_MIN_ROW_LENGTH) {
+            continue;
+        }
+
+        // Hver anden række køres modsat (boustrophedon)
+        if (plan.rowCount % 2 == 1) {
+            float swap = start;
+            start = end;
+            end = swap;
+        }
+
+        if (!addSegment(plan,
+                        row * rightX + start * dirX, row * rightY + start * dirY,
+                        row * rightX + end * dirX, row * rightY + end * dirY)) {
+            break;
+        }
+    }
+
+    return plan.rowCount > 0;
+}
+
+// ============================================================================
+// Spiral
+// ============================================================================
+
+/**
+ * Beregn én omgang: polygonen forskudt indad med offset cm
+ * Hjørnerne er skæringen mellem de forskudte naboer kanter.
+ * @return false hvis en kant vender eller bliver for kort (omgangen passer ikke)
+ */
+static bool offsetPolygon(const ZoneRecord& zone, float inwardSign, float offset,
+                          float out[][2]) {
+    int n = zone.vertexCount;
+
+    for (int j = 0; j < n; j++) {
+        int i = (j + n - 1) % n;    // Forrige hjørne
+        int k = (j + 1) % n;        // Næste hjørne
+
+        // Retning af kant ind i og ud af hjørnet
+        float ax = zone.vertices[j][0] - zone.vertices[i][0];
+        float ay = zone.vertices[j][1] - zone.vertices[i][1];
+        float bx = zone.vertices[k][0] - zone.vertices[j][0];
+        float by = zone.vertices[k][1] - zone.vertices[j][1];
+        float aLen = sqrt(ax * ax + ay * ay);
+        float bLen = sqrt(bx * bx + by * by);
+        if (aLen < 1.0 || bLen < 1.0) {
+            return false;
+        }
+        ax /= aLen; ay /= aLen;
+        bx /= bLen; by /= bLen;
+
+        // Indadgående normaler (venstre for kanten ved mod uret polygon)
+        float anx = -ay * inwardSign, any = ax * inwardSign;
+        float bnx = -by * inwardSign, bny = bx * inwardSign;
+
+        // Punkter på de forskudte linjer
+        float pax = zone.vertices[i][0] + anx * offset;
+        float pay = zone.vertices[i][1] + any * offset;
+        float pbx = zone.vertices[j][0] + bnx * offset;
+        float pby = zone.vertices[j][1] + bny * offset;
+
+        float cross = ax * by - ay * bx;
+        if (fabs(cross) < 0.01) {
+            // Lige videre - hjørnet flyttes bare langs normalen
+            out[j][0] = pbx;
+            out[j][1] = pby;
+        } else {
+            float t = ((pbx - pax) * by - (pby - pay) * bx) / cross;
+            out[j][0] = pax + ax * t;
+            out[j][1] = pay + ay * t;
+        }
+    }
+
+    // Hver forskudt kant skal pege samme vej som originalen og være lang nok
+    for (int j = 0; j < n; j++) {
+        int k = (j + 1) % n;
+        float ox = zone.vertices[k][0] - zone.vertices[j][0];
+        float oy = zone.vertices[k][1] - zone.vertices[j][1];
+        float dx = out[k][0] - out[j][0];
+        float dy = out[k][1] - out[j][1];
+
+        if (dx * ox + dy * oy <= 0.0 || sqrt(dx * dx + dy * dy) < ZONE_MIN_ROW_LENGTH) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool SpiralPattern::buildPlan(const ZoneRecord& zone, ZonePlan& plan) const {
+    int n = zone.vertexCount;
+
+    // Orientering: positivt areal = mod uret (x mod øst, y mod nord)
+    float area2 = 0.0;
+    for (int i = 0; i < n; i++) {
+        int j = (i + 1) % n;
+        area2 += (float)zone.vertices[i][0] * zone.vertices[j][1] -
+                 (float)zone.vertices[j][0] * zone.vertices[i][1];
+    }
+    float inwardSign = area2 >= 0.0 ? 1.0 : -1.0;
+
+    float lap[ZONE_MAX_VERTICES][2];
+    float nextLap[ZONE_MAX_VERTICES][2];
+
+    // Første omgang en halv række bredde inde fra kanten
+    if (!offsetPolygon(zone, inwardSign, zone.rowWidth / 2.0, lap)) {
+        return false;
+    }
+
+    for (int lapIndex = 1; ; lapIndex++) {
+        bool hasNext = offsetPolygon(zone, inwardSign, zone.rowWidth * (lapIndex + 0.5), nextLap);
+
+        // Omgangens kanter - sidste kant går ind til næste omgangs start
+        for (int j = 0; j < n; j++) {
+            int k = (j + 1) % n;
+            float endX = lap[k][0];
+            float endY = lap[k][1];
+            if (k == 0 && hasNext) {
+                endX = nextLap[0][0];
+                endY = nextLap[0][1];
+            }
+
+            if (!addSegment(plan, lap[j][0], lap[j][1], endX, endY)) {
+                hasNext = false;
+                break;
+            }
+        }
+
+        if (!hasNext) {
+            break;
+        }
+        memcpy(lap, nextLap, sizeof(lap));
+    }
+
+    // Udadgående spiral er samme vej baglæns - en afkortet liste mangler
+    // de inderste omgange og ville starte midt på plænen
+    if (!inward) {
+        if (plan.truncated) {
+            plan.rowCount = 0;
+            return false;
+        }
+        for (int i = 0, j = plan.rowCount - 1; i <= j; i++, j--) {
+            ZonePlanRow a = plan.rows[i];
+            ZonePlanRow b = plan.rows[j];
+            plan.rows[i] = { b.x1, b.y1, b.x0, b.y0 };
+            plan.rows[j] = { a.x1, a.y1, a.x0, a.y0 };
+        }
+    }
+
+    return plan.rowCount > 0;
+}
+
+// ============================================================================
+// Perimeter omgange
+// ============================================================================
+
+bool PerimeterOffsetPattern::buildPlan(const ZoneRecord& zone, ZonePlan& plan) const {
+    int laps = zone.param > 0 ? zone.param : ZONE_MAX_ROWS;
+
+    // Afstanden måles via signalstyrken - længere væk end max er ikke til at holde
+    for (int lap = 0; lap < laps; lap++) {
+        float offset = zone.rowWidth * (lap + 0.5);
+        if (offset > PERIMETER_OFFSET_MAX_CM) {
+            break;
+        }
+        if (!addSegment(plan, offset, 0, 0, 0)) {
+            break;
+        }
+    }
+
+    return plan.rowCount > 0;
+}
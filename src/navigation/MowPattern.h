@@ -0,0 +1,100 @@
+#ifndef MOW_PATTERN_H
+#define MOW_PATTERN_H
+
+#include <Arduino.h>
+#include "../config/Config.h"
+#include "ZoneManager.h"
+
+/**
+ * MowPattern - Udskiftelige klipningsmønstre
+ *
+ * Et mønster omsætter en zone til en plan (liste af segmenter) som
+ * PathPlanner kører i rækkefølge. Geometriske mønstre (rækker, spiral)
+ * giver segmenter i zonens koordinater. Wire mønstre har ingen geometri
+ * - hvert plan segment er en omgang langs perimeter kablet, og
+ * segmentets x0 er afstanden til kablet.
+ *
+ * Nye mønstre tilføjes med en ZonePattern værdi, en klasse her og en
+ * linje i MowPattern::forType().
+ */
+class MowPattern {
+public:
+    virtual ~MowPattern() {}
+
+    /**
+     * Navn brugt i API og JSON
+     */
+    virtual const char* getName() const = 0;
+
+    /**
+     * Beregn plan for zone
+     * @param zone Zone (valideret)
+     * @param plan Modtager segmenterne - plan.truncated sættes hvis
+     *             zonen giver flere end ZONE_MAX_ROWS
+     * @return false hvis zonen ikke giver nogen segmenter
+     */
+    virtual bool buildPlan(const ZoneRecord& zone, ZonePlan& plan) const = 0;
+
+    /**
+     * Kræver mønsteret en polygon?
+     */
+    virtual bool needsPolygon() const { return true; }
+
+    /**
+     * Følger mønsteret perimeter kablet i stedet for segment headings?
+     */
+    virtual bool followsWire() const { return false; }
+
+    /**
+     * Find mønster for type
+     * @param type ZonePattern
+     * @return Mønster, eller nullptr hvis ukendt
+     */
+    static const MowPattern* forType(uint8_t type);
+};
+
+/**
+ * Parallelle rækker frem og tilbage (boustrophedon) i zonens vinkel
+ */
+class ParallelPattern : public MowPattern {
+public:
+    const char* getName() const override { return "parallel"; }
+    bool buildPlan(const ZoneRecord& zone, ZonePlan& plan) const override;
+};
+
+/**
+ * Spiral langs polygonens kant med række bredde mellem omgangene
+ * Hjørnerne drejes i fart - ingen 180° vendinger ved række ender.
+ * Omgangene er indadgående forskudte kopier af polygonen; spiralen
+ * stopper når en kant ville vende eller blive kortere end
+ * ZONE_MIN_ROW_LENGTH (konkave zoner stopper derfor tidligere).
+ */
+class SpiralPattern : public MowPattern {
+public:
+    /**
+     * @param inward true = udefra og ind, false = indefra og ud
+     */
+    explicit SpiralPattern(bool inward) : inward(inward) {}
+
+    const char* getName() const override { return inward ? "spiral-in" : "spiral-out"; }
+    bool buildPlan(const ZoneRecord& zone, ZonePlan& plan) const override;
+
+private:
+    bool inward;
+};
+
+/**
+ * Omgange langs perimeter kablet med stigende afstand
+ * Kanten klippes i én omgang. Afstanden estimeres fra signalstyrken,
+ * så omgangene er begrænset til PERIMETER_OFFSET_MAX_CM. Zonens param
+ * er antal omgange (0 = så mange der er plads til).
+ */
+class PerimeterOffsetPattern : public MowPattern {
+public:
+    const char* getName() const override { return "perimeter"; }
+    bool buildPlan(const ZoneRecord& zone, ZonePlan& plan) const override;
+    bool needsPolygon() const override { return false; }
+    bool followsWire() const override { return true; }
+};
+
+#endif // MOW_PATTERN_H
@@ -5,6 +5,8 @@ ObstacleAvoidance::ObstacleAvoidance() {
     criticalObstacle = false;
     avoidanceDirection = AVOID_LEFT;
     closestObstacleDistance = ULTRASONIC_MAX_DISTANCE;
+    minTimeToCollision = INFINITY;
+    lastSampleTime = 0;
     sensorsPtr = nullptr;
     lastDetectionTime = 0;
     initialized = false;
@@ -26,23 +28,25 @@ void ObstacleAvoidance::update(Sensors* sensors) {
 
     sensorsPtr = sensors;
 
-    // Hent sensor data
-    float leftDist = sensors->getLeftDistance();
-    float middleDist = sensors->getMiddleDistance();
-    float rightDist = sensors->getRightDistance();
+    // Fød kun filtrene når sensorerne har lavet en ny måling
+    unsigned long sampleTime = sensors->getLastUpdateTime();
+    if (sampleTime != lastSampleTime) {
+        lastSampleTime = sampleTime;
+        filters[OBSTACLE_SENSOR_LEFT].addSample(sensors->getLeftDistance(), sampleTime);
+        filters[OBSTACLE_SENSOR_MIDDLE].addSample(sensors->getMiddleDistance(), sampleTime);
+        filters[OBSTACLE_SENSOR_RIGHT].addSample(sensors->getRightDistance(), sampleTime);
+    }
 
     // Analyser forhindringer
-    analyzeObstacle(leftDist, middleDist, rightDist);
+    analyzeObstacle();
 
     if (obstacleDetected) {
         lastDetectionTime = millis();
 
-        #if DEBUG_NAVIGATION
-        Logger::warning("Obstacle detected - Direction: " +
-                       String(avoidanceDirection == AVOID_LEFT ? "LEFT" :
-                              avoidanceDirection == AVOID_RIGHT ? "RIGHT" : "BACK") +
-                       " | Distance: " + String(closestObstacleDistance) + " cm");
-        #endif
+        LOGD(LOG_SUB_NAVIGATION, "Obstacle detected - Direction: %s | Distance: %.1f cm | TTC: %.2f s",
+             avoidanceDirection == AVOID_LEFT ? "LEFT" :
+             avoidanceDirection == AVOID_RIGHT ? "RIGHT" : "BACK",
+             closestObstacleDistance, minTimeToCollision);
     }
 }
 
@@ -58,6 +62,14 @@ float ObstacleAvoidance::getSafeDistance() {
     return closestObstacleDistance;
 }
 
+float ObstacleAvoidance::getTimeToCollision() {
+    return minTimeToCollision;
+}
+
+RangeFilter& ObstacleAvoidance::getFilter(ObstacleSensor sensor) {
+    return filters[constrain((int)sensor, 0, OBSTACLE_SENSOR_COUNT - 1)];
+}
+
 bool ObstacleAvoidance::isCriticalObstacle() {
     return criticalObstacle;
 }
@@ -67,36 +79,65 @@ void ObstacleAvoidance::reset() {
     criticalObstacle = false;
     avoidanceDirection = AVOID_LEFT;
     closestObstacleDistance = ULTRASONIC_MAX_DISTANCE;
-}
+    minTimeToCollision = INFINITY;
 
-int ObstacleAvoidance::getRecommendedSpeed(int normalSpeed) {
-    if (!obstacleDetected) {
-        return normalSpeed;
+    for (int i = 0; i < OBSTACLE_SENSOR_COUNT; i++) {
+        filters[i].reset();
     }
+}
 
+int ObstacleAvoidance::getRecommendedSpeed(int normalSpeed) {
     // Reducer hastighed baseret på afstand til forhindring
     if (criticalObstacle) {
         return 0; // Stop øjeblikkeligt
     }
 
+    float speedFactor = 1.0;
+
+    // Jo kortere tid til kollision, jo langsommere
+    if (minTimeToCollision < OBSTACLE_TTC_SLOWDOWN) {
+        speedFactor = (minTimeToCollision - OBSTACLE_TTC_TRIGGER) /
+                      (OBSTACLE_TTC_SLOWDOWN - OBSTACLE_TTC_TRIGGER);
+    }
+
+    // Tæt på en stillestående forhindring - kør også langsomt
     if (closestObstacleDistance < OBSTACLE_THRESHOLD) {
-        // Jo tættere på, jo langsommere
-        float speedFactor = closestObstacleDistance / OBSTACLE_THRESHOLD;
-        speedFactor = constrain(speedFactor, 0.3, 1.0);
-        return (int)(normalSpeed * speedFactor);
+        speedFactor = min(speedFactor, closestObstacleDistance / OBSTACLE_THRESHOLD);
+    }
+
+    speedFactor = constrain(speedFactor, 0.3, 1.0);
+    return (int)(normalSpeed * speedFactor);
+}
+
+bool ObstacleAvoidance::isSensorBlocked(ObstacleSensor sensor) {
+    RangeFilter& filter = filters[sensor];
+    if (!filter.isValid()) {
+        return false;
     }
 
-    return normalSpeed;
+    // Farten sænkes inden trigger tiden, så den målte TTC når sjældent ned på
+    // OBSTACLE_TTC_TRIGGER - afstanden regnes derfor ud fra marchfarten.
+    // Den målte TTC fanger kun forhindringer der nærmer sig hurtigere.
+    return filter.getDistance() <= OBSTACLE_TRIGGER_DISTANCE ||
+           filter.getTimeToCollision() < OBSTACLE_TTC_TRIGGER;
 }
 
-void ObstacleAvoidance::analyzeObstacle(float left, float middle, float right) {
-    // Find minimum afstand
+void ObstacleAvoidance::analyzeObstacle() {
+    float left = filters[OBSTACLE_SENSOR_LEFT].getDistance();
+    float middle = filters[OBSTACLE_SENSOR_MIDDLE].getDistance();
+    float right = filters[OBSTACLE_SENSOR_RIGHT].getDistance();
+
+    // Find minimum afstand og korteste tid til kollision
     closestObstacleDistance = min(min(left, middle), right);
+    minTimeToCollision = INFINITY;
+    for (int i = 0; i < OBSTACLE_SENSOR_COUNT; i++) {
+        minTimeToCollision = min(minTimeToCollision, filters[i].getTimeToCollision());
+    }
 
     // Tjek for forhindringer
-    bool leftObstacle = (left < OBSTACLE_THRESHOLD && left > 0);
-    bool middleObstacle = (middle < OBSTACLE_THRESHOLD && middle > 0);
-    bool rightObstacle = (right < OBSTACLE_THRESHOLD && right > 0);
+    bool leftObstacle = isSensorBlocked(OBSTACLE_SENSOR_LEFT);
+    bool middleObstacle = isSensorBlocked(OBSTACLE_SENSOR_MIDDLE);
+    bool rightObstacle = isSensorBlocked(OBSTACLE_SENSOR_RIGHT);
 
     obstacleDetected = leftObstacle || middleObstacle || rightObstacle;
 
@@ -108,12 +149,21 @@ void ObstacleAvoidance::analyzeObstacle(float left, float middle, float right) {
     }
 
     // Bestem bedste undgåelses retning
-    avoidanceDirection = findBestDirection(left, middle, right);
+    avoidanceDirection = findBestDirection(left, right);
 }
 
-AvoidanceDirection ObstacleAvoidance::findBestDirection(float left, float middle, float right) {
+AvoidanceDirection ObstacleAvoidance::findBestDirection(float left, float right) {
+    bool leftBlocked = isSensorBlocked(OBSTACLE_SENSOR_LEFT);
+    bool middleBlocked = isSensorBlocked(OBSTACLE_SENSOR_MIDDLE);
+    bool rightBlocked = isSensorBlocked(OBSTACLE_SENSOR_RIGHT);
+
+    // Hvis alle sensorer ser forhindringer, bak
+    if (leftBlocked && middleBlocked && rightBlocked) {
+        return AVOID_BACK;
+    }
+
     // Hvis forhindring direkte foran
-    if (middle < OBSTACLE_THRESHOLD && middle > 0) {
+    if (middleBlocked) {
         // Vælg side med mest plads
         if (left > right) {
             return AVOID_LEFT;
@@ -123,9 +173,9 @@ AvoidanceDirection ObstacleAvoidance::findBestDirection(float left, float middle
     }
 
     // Hvis forhindring til venstre
-    if (left < OBSTACLE_THRESHOLD && left > 0) {
+    if (leftBlocked) {
         // Er højre fri?
-        if (right > OBSTACLE_THRESHOLD) {
+        if (!rightBlocked) {
             return AVOID_RIGHT;
         } else {
             return AVOID_BACK; // Begge sider blokeret
@@ -133,20 +183,15 @@ AvoidanceDirection ObstacleAvoidance::findBestDirection(float left, float middle
     }
 
     // Hvis forhindring til højre
-    if (right < OBSTACLE_THRESHOLD && right > 0) {
+    if (rightBlocked) {
         // Er venstre fri?
-        if (left > OBSTACLE_THRESHOLD) {
+        if (!leftBlocked) {
             return AVOID_LEFT;
         } else {
             return AVOID_BACK; // Begge sider blokeret
         }
     }
 
-    // Hvis alle sensorer ser forhindringer, bak
-    if (left < OBSTACLE_THRESHOLD && middle < OBSTACLE_THRESHOLD && right < OBSTACLE_THRESHOLD) {
-        return AVOID_BACK;
-    }
-
     // Default: drej venstre
     return AVOID_LEFT;
 }
@@ -5,12 +5,25 @@
 #include "../config/Config.h"
 #include "../hardware/Sensors.h"
 #include "../system/Logger.h"
+#include "../utils/RangeFilter.h"
+
+/**
+ * Sensor index i tracking filtrene
+ */
+enum ObstacleSensor {
+    OBSTACLE_SENSOR_LEFT,
+    OBSTACLE_SENSOR_MIDDLE,
+    OBSTACLE_SENSOR_RIGHT,
+    OBSTACLE_SENSOR_COUNT
+};
 
 /**
  * ObstacleAvoidance klasse - Detekterer og undgår forhindringer
  *
  * Denne klasse analyserer sensor data og beslutter hvordan
- * forhindringer skal undgås.
+ * forhindringer skal undgås. Hver sensor har et tracking filter
+ * (median + alpha-beta), og detektion sker på forudsagt tid til
+ * kollision i stedet for en fast afstand.
  */
 class ObstacleAvoidance {
 public:
@@ -49,6 +62,19 @@ public:
      */
     float getSafeDistance();
 
+    /**
+     * Hent korteste forudsagte tid til kollision
+     * @return Sekunder, eller INFINITY hvis vi ikke nærmer os noget
+     */
+    float getTimeToCollision();
+
+    /**
+     * Hent filter for en sensor (til debug og status)
+     * @param sensor Sensor index
+     * @return Reference til filteret
+     */
+    RangeFilter& getFilter(ObstacleSensor sensor);
+
     /**
      * Tjek om forhindring er kritisk (meget tæt på)
      * @return true hvis kritisk
@@ -62,6 +88,7 @@ public:
 
     /**
      * Hent anbefalet hastighed baseret på forhindringer
+     * Sænker farten gradvist når tid til kollision nærmer sig trigger
      * @param normalSpeed Normal hastighed
      * @return Justeret hastighed
      */
@@ -69,27 +96,35 @@ public:
 
 private:
     /**
-     * Analyserer sensor data og beslutter undgåelses strategi
-     * @param left Venstre sensor afstand
-     * @param middle Midter sensor afstand
-     * @param right Højre sensor afstand
+     * Analyserer filtreret sensor data og beslutter undgåelses strategi
      */
-    void analyzeObstacle(float left, float middle, float right);
+    void analyzeObstacle();
+
+    /**
+     * Tjek om en sensor ser en forhindring (tæt på eller kollision forudsagt)
+     * @param sensor Sensor index
+     * @return true hvis forhindring
+     */
+    bool isSensorBlocked(ObstacleSensor sensor);
 
     /**
      * Finder den mest åbne retning
      * @param left Venstre sensor afstand
-     * @param middle Midter sensor afstand
      * @param right Højre sensor afstand
      * @return Bedste retning at gå
      */
-    AvoidanceDirection findBestDirection(float left, float middle, float right);
+    AvoidanceDirection findBestDirection(float left, float right);
+
+    // Tracking filtre pr. sensor
+    RangeFilter filters[OBSTACLE_SENSOR_COUNT];
+    unsigned long lastSampleTime;
 
     // Obstacle detection state
     bool obstacleDetected;
     bool criticalObstacle;
     AvoidanceDirection avoidanceDirection;
     float closestObstacleDistance;
+    float minTimeToCollision;
 
     // Sensors pointer
     Sensors* sensorsPtr;
@@ -0,0 +1,237 @@
+#include "OccupancyGrid.h"
+
+OccupancyGrid::OccupancyGrid() {
+    reset();
+}
+
+void OccupancyGrid::reset() {
+    memset(cells, 0, sizeof(cells));
+    memoryCount = 0;
+    poseX = 0.0;
+    poseY = 0.0;
+    heading = 0.0;
+
+    // Robotten starter i midten af kortet
+    originX = -LOCAL_MAP_SIZE / 2;
+    originY = -LOCAL_MAP_SIZE / 2;
+}
+
+void OccupancyGrid::setPose(float x, float y, float headingDeg) {
+    reset();
+    poseX = x;
+    poseY = y;
+    heading = headingDeg;
+
+    // Kortet centreres om den nye position
+    originX = (int)floor(x / LOCAL_MAP_CELL_CM) - LOCAL_MAP_SIZE / 2;
+    originY = (int)floor(y / LOCAL_MAP_CELL_CM) - LOCAL_MAP_SIZE / 2;
+}
+
+void OccupancyGrid::updatePose(float headingDeg, float distanceCm) {
+    heading = headingDeg;
+
+    float rad = headingDeg * DEG_TO_RAD;
+    poseX += distanceCm * sin(rad);
+    poseY += distanceCm * cos(rad);
+
+    recenter();
+}
+
+void OccupancyGrid::integrateSonar(float relativeAngleDeg, float rangeCm) {
+    if (rangeCm <= 0.0) {
+        return; // Ugyldig måling
+    }
+
+    bool hit = rangeCm > 0.0 && rangeCm < SONAR_MAP_RANGE;
+    float freeRange = hit ? rangeCm - LOCAL_MAP_CELL_CM : SONAR_MAP_RANGE;
+
+    memset(scanVisited, 0, sizeof(scanVisited));
+
+    // Fej keglen med stråler 5 grader fra hinanden. Buen ved målt afstand
+    // markeres først, så fri-stråler ikke kan overskrive en ramt celle.
+    const float rayStep = 5.0;
+    for (int pass = hit ? 0 : 1; pass < 2; pass++) {
+        for (float offset = -SONAR_CONE_HALF_ANGLE; offset <= SONAR_CONE_HALF_ANGLE + 0.01; offset += rayStep) {
+            float rad = (heading + relativeAngleDeg + offset) * DEG_TO_RAD;
+            float dx = sin(rad);
+            float dy = cos(rad);
+
+            if (pass == 0) {
+                // Forhindring på buen ved målt afstand
+                updateCell(poseX + dx * rangeCm, poseY + dy * rangeCm, LOCAL_MAP_HIT);
+            } else {
+                // Fri bane op til målingen (halv celle skridt)
+                for (float r = LOCAL_MAP_CELL_CM / 2; r < freeRange; r += LOCAL_MAP_CELL_CM / 2) {
+                    updateCell(poseX + dx * r, poseY + dy * r, -LOCAL_MAP_MISS);
+                }
+            }
+        }
+    }
+}
+
+int8_t OccupancyGrid::getCell(int cx, int cy) const {
+    if (cx < 0 || cx >= LOCAL_MAP_SIZE || cy < 0 || cy >= LOCAL_MAP_SIZE) {
+        return 0;
+    }
+    return cells[cy][cx];
+}
+
+void OccupancyGrid::cellToWorld(int cx, int cy, float& x, float& y) const {
+    x = (originX + cx + 0.5) * LOCAL_MAP_CELL_CM;
+    y = (originY + cy + 0.5) * LOCAL_MAP_CELL_CM;
+}
+
+float OccupancyGrid::getX() const {
+    return poseX;
+}
+
+float OccupancyGrid::getY() const {
+    return poseY;
+}
+
+float OccupancyGrid::getHeading() const {
+    return heading;
+}
+
+bool OccupancyGrid::worldToCell(float x, float y, int& cx, int& cy) const {
+    cx = (int)floor(x / LOCAL_MAP_CELL_CM) - originX;
+    cy = (int)floor(y / LOCAL_MAP_CELL_CM) - originY;
+    return cx >= 0 && cx < LOCAL_MAP_SIZE && cy >= 0 && cy < LOCAL_MAP_SIZE;
+}
+
+void OccupancyGrid::updateCell(float x, float y, int delta) {
+    int cx, cy;
+    if (!worldToCell(x, y, cx, cy)) {
+        return;
+    }
+
+    // Hver celle opdateres højst én gang pr. scan, selvom flere stråler rammer den
+    int index = cy * LOCAL_MAP_SIZE + cx;
+    if (scanVisited[index / 8] & (1 << (index % 8))) {
+        return;
+    }
+    scanVisited[index / 8] |= (1 << (index % 8));
+
+    int value = cells[cy][cx] + delta;
+    cells[cy][cx] = (int8_t)constrain(value, -LOCAL_MAP_LOGODDS_MAX, LOCAL_MAP_LOGODDS_MAX);
+}
+
+void OccupancyGrid::recenter() {
+    int robotCellX = (int)floor(poseX / LOCAL_MAP_CELL_CM);
+    int robotCellY = (int)floor(poseY / LOCAL_MAP_CELL_CM);
+
+    int shiftX = robotCellX - (originX + LOCAL_MAP_SIZE / 2);
+    int shiftY = robotCellY - (originY + LOCAL_MAP_SIZE / 2);
+
+    if (abs(shiftX) < LOCAL_MAP_RECENTER_CELLS && abs(shiftY) < LOCAL_MAP_RECENTER_CELLS) {
+        return;
+    }
+
+    // Optagede celler der falder ud huskes til robotten kommer tilbage
+    for (int cy = 0; cy < LOCAL_MAP_SIZE; cy++) {
+        int dstY = cy - shiftY;
+        for (int cx = 0; cx < LOCAL_MAP_SIZE; cx++) {
+            int dstX = cx - shiftX;
+            bool inside = dstX >= 0 && dstX < LOCAL_MAP_SIZE && dstY >= 0 && dstY < LOCAL_MAP_SIZE;
+            if (!inside && cells[cy][cx] >= LOCAL_MAP_MEMORY_MIN) {
+                remember(originX + cx, originY + cy, cells[cy][cx]);
+            }
+        }
+    }
+
+    // Flyt indholdet - nye celler er ukendte
+    int8_t shifted[LOCAL_MAP_SIZE][LOCAL_MAP_SIZE];
+    memset(shifted, 0, sizeof(shifted));
+
+    for (int cy = 0; cy < LOCAL_MAP_SIZE; cy++) {
+        int srcY = cy + shiftY;
+        if (srcY < 0 || srcY >= LOCAL_MAP_SIZE) {
+            continue;
+        }
+        for (int cx = 0; cx < LOCAL_MAP_SIZE; cx++) {
+            int srcX = cx + shiftX;
+            if (srcX >= 0 && srcX < LOCAL_MAP_SIZE) {
+                shifted[cy][cx] = cells[srcY][srcX];
+            }
+        }
+    }
+
+    memcpy(cells, shifted, sizeof(cells));
+    originX += shiftX;
+    originY += shiftY;
+
+    restoreRemembered();
+
+    LOGD(LOG_SUB_NAVIGATION, "Local map recentered - origin (%d, %d), %d remembered",
+         originX, originY, memoryCount);
+}
+
+void OccupancyGrid::remember(int worldX, int worldY, int8_t value) {
+    if (memoryCount < LOCAL_MAP_MEMORY) {
+        memory[memoryCount].x = worldX;
+        memory[memoryCount].y = worldY;
+        memory[memoryCount].value = value;
+        memoryCount++;
+        return;
+    }
+
+    int weakest = 0;
+    for (int i = 1; i < memoryCount; i++) {
+        if (memory[i].value < memory[weakest].value) {
+            weakest = i;
+        }
+    }
+    if (value > memory[weakest].value) {
+        memory[weakest].x = worldX;
+        memory[weakest].y = worldY;
+        memory[weakest].value = value;
+    }
+}
+
+void OccupancyGrid::restoreRemembered() {
+    int i = 0;
+    while (i < memoryCount) {
+        int cx = memory[i].x - originX;
+        int cy = memory[i].y - originY;
+        if (cx < 0 || cx >= LOCAL_MAP_SIZE || cy < 0 || cy >= LOCAL_MAP_SIZE) {
+            i++;
+            continue;
+        }
+
+        // Cellen er ny på kortet (ukendt) - den huskede værdi gælder
+        cells[cy][cx] = memory[i].value;
+
+        // Fjern fra listen (rækkefølgen er ligegyldig)
+        memory[i] = memory[memoryCount - 1];
+        memoryCount--;
+    }
+}
+
+String OccupancyGrid::getJSON() {
+    String json;
+    json.reserve(LOCAL_MAP_SIZE * LOCAL_MAP_SIZE + 200);
+    json = "{\"size\":" + String(LOCAL_MAP_SIZE);
+    json += ",\"cellCm\":" + String(LOCAL_MAP_CELL_CM, 1);
+    json += ",\"originX\":" + String(originX);
+    json += ",\"originY\":" + String(originY);
+    json += ",\"robot\":{\"x\":" + String(poseX, 1);
+    json += ",\"y\":" + String(poseY, 1);
+    json += ",\"heading\":" + String(heading, 1) + "}";
+    json += ",\"remembered\":" + String(memoryCount);
+    json += ",\"cells\":\"";
+
+    // Række 0 er sydligst
+    for (int cy = 0; cy < LOCAL_MAP_SIZE; cy++) {
+        for (int cx = 0; cx < LOCAL_MAP_SIZE; cx++) {
+            int value = cells[cy][cx];
+            if (value <= 0) {
+                json += '.';
+            } else {
+                json += (char)('0' + constrain(value * 9 / LOCAL_MAP_LOGODDS_MAX, 1, 9));
+            }
+        }
+    }
+
+    json += "\"}";
+    return json;
+}
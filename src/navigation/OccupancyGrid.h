@@ -0,0 +1,137 @@
+#ifndef OCCUPANCY_GRID_H
+#define OCCUPANCY_GRID_H
+
+#include <Arduino.h>
+#include "../config/Config.h"
+#include "../system/Logger.h"
+
+/**
+ * OccupancyGrid klasse - Lokalt kort over forhindringer omkring robotten
+ *
+ * Kortet er forankret i et dead reckoning koordinatsystem (x mod øst,
+ * y mod nord, heading i kompas grader) og følger robotten ved at flytte
+ * indholdet når robotten nærmer sig kanten. Hver celle er log-odds
+ * (x10) i en int8, så sonar kegler kan akkumuleres over flere passager.
+ *
+ * Kortet dækker kun 4 x 4 m, så en række er typisk længere end kortet.
+ * Optagede celler der flyttes ud gemmes derfor i en lille liste i samme
+ * koordinatsystem og lægges tilbage når kortet igen dækker dem - et træ
+ * set i én række er stadig på kortet i den næste.
+ */
+class OccupancyGrid {
+public:
+    /**
+     * Constructor
+     */
+    OccupancyGrid();
+
+    /**
+     * Nulstil kort og position til (0, 0)
+     */
+    void reset();
+
+    /**
+     * Nulstil kort og sæt kendt position (genoptaget checkpoint)
+     * @param x Position (cm)
+     * @param y Position (cm)
+     * @param headingDeg Heading (0-360, kompas)
+     */
+    void setPose(float x, float y, float headingDeg);
+
+    /**
+     * Opdater robot position (dead reckoning)
+     * @param headingDeg Nuværende heading (0-360, kompas)
+     * @param distanceCm Kørt distance siden sidste kald (negativ = baglæns)
+     */
+    void updatePose(float headingDeg, float distanceCm);
+
+    /**
+     * Indfør én sonar måling i kortet
+     * Celler langs keglen markeres fri, buen ved målt afstand optaget
+     * @param relativeAngleDeg Sensorens vinkel i forhold til robotten (negativ = venstre)
+     * @param rangeCm Målt afstand (0 eller >= max = intet ekko)
+     */
+    void integrateSonar(float relativeAngleDeg, float rangeCm);
+
+    /**
+     * Hent log-odds for celle
+     * @param cx Celle kolonne (0 til LOCAL_MAP_SIZE-1)
+     * @param cy Celle række (0 til LOCAL_MAP_SIZE-1)
+     * @return Log-odds x10 (0 = ukendt, positiv = optaget)
+     */
+    int8_t getCell(int cx, int cy) const;
+
+    /**
+     * Konverter celle til verdens koordinater (cellens midte)
+     */
+    void cellToWorld(int cx, int cy, float& x, float& y) const;
+
+    /**
+     * Hent robot position og heading
+     */
+    float getX() const;
+    float getY() const;
+    float getHeading() const;
+
+    /**
+     * Opret JSON med kort og robot position
+     * Hver celle er ét tegn: '.' ukendt/fri, '1'-'9' sandsynlighed for forhindring
+     * @return JSON string
+     */
+    String getJSON();
+
+private:
+    /**
+     * Find celle for verdens koordinat
+     * @return false hvis udenfor kortet
+     */
+    bool worldToCell(float x, float y, int& cx, int& cy) const;
+
+    /**
+     * Opdater én celle (maks én gang pr. scan)
+     */
+    void updateCell(float x, float y, int delta);
+
+    /**
+     * Flyt kortet så robotten er tæt på midten
+     */
+    void recenter();
+
+    /**
+     * Gem optaget celle der falder ud af kortet
+     * Fuld liste: den svageste erstattes hvis den nye er stærkere.
+     * @param worldX Verdens celle index
+     * @param worldY Verdens celle index
+     * @param value Log-odds x10
+     */
+    void remember(int worldX, int worldY, int8_t value);
+
+    /**
+     * Læg huskede celler tilbage der nu er inden for kortet
+     */
+    void restoreRemembered();
+
+    /**
+     * Forhindring uden for kortet (verdens celle index)
+     */
+    struct RememberedCell {
+        int16_t x;
+        int16_t y;
+        int8_t value;
+    };
+
+    int8_t cells[LOCAL_MAP_SIZE][LOCAL_MAP_SIZE];           // [cy][cx]
+    uint8_t scanVisited[(LOCAL_MAP_SIZE * LOCAL_MAP_SIZE + 7) / 8];
+
+    int originX;        // Verdens celle index for cells[0][0]
+    int originY;
+
+    RememberedCell memory[LOCAL_MAP_MEMORY];
+    int memoryCount;
+
+    float poseX;        // cm
+    float poseY;        // cm
+    float heading;      // grader
+};
+
+#endif // OCCUPANCY_GRID_H
@@ -1,4 +1,7 @@
 #include "PathPlanner.h"
+#if ENABLE_ZONES
+#include "MowPattern.h"
+#endif
 
 PathPlanner::PathPlanner() {
     rowWidth = MOWING_PATTERN_WIDTH;
@@ -13,6 +16,13 @@ PathPlanner::PathPlanner() {
     patternActive = false;
     initialized = false;
     perimeterTriggered = false;
+    usePlan = false;
+    wireMode = false;
+    lapHeading = 0.0;
+    lapTurned = 0.0;
+    lapHeadingValid = false;
+    lapDistance = 0.0;
+    lapReported = 0.0;
 }
 
 bool PathPlanner::begin() {
@@ -24,6 +34,33 @@ bool PathPlanner::begin() {
     return true;
 }
 
+#if ENABLE_ZONES
+bool PathPlanner::loadPlan(ZoneManager& zones) {
+    ZoneRecord zone;
+    usePlan = zones.getActivePlan(plan) && zones.getActiveZone(zone);
+    wireMode = usePlan && MowPattern::forType(plan.pattern)->followsWire();
+
+    #if !ENABLE_PERIMETER
+    if (wireMode) {
+        Logger::warning("Zone " + String(zone.id) + " follows the wire but perimeter is disabled");
+        usePlan = false;
+        wireMode = false;
+    }
+    #endif
+
+    if (usePlan) {
+        totalRows = plan.rowCount;
+        rowWidth = zone.rowWidth;
+        Logger::info("Using plan for zone " + String(zone.id) + " (" + String(zone.name) + ")");
+    } else {
+        totalRows = MAX_ROWS;
+        rowWidth = MOWING_PATTERN_WIDTH;
+    }
+
+    return usePlan;
+}
+#endif
+
 void PathPlanner::startNewPattern() {
     if (!initialized) {
         return;
@@ -32,9 +69,41 @@ void PathPlanner::startNewPattern() {
     reset();
     patternActive = true;
     rowStartTime = millis();
+    calculateNextHeading();
+
+    #if ENABLE_ZONES
+    if (usePlan && !wireMode && totalRows > 1) {
+        nextTurnDir = planTurnDirection(0);
+        turningRight = nextTurnDir == RIGHT;
+    }
+    #endif
 
     Logger::info("Starting new mowing pattern");
-    Logger::info("Row width: " + String(rowWidth) + " cm");
+    Logger::info("Row width: " + String(rowWidth) + " cm, rows: " + String(totalRows));
+}
+
+bool PathPlanner::resumePattern(int row, Direction turnDir) {
+    if (!initialized || row < 0 || row >= totalRows) {
+        return false;
+    }
+
+    reset();
+    patternActive = true;
+    currentRow = row;
+    rowStartTime = millis();
+    nextTurnDir = turnDir;
+    turningRight = turnDir == RIGHT;
+    calculateNextHeading();
+
+    #if ENABLE_ZONES
+    if (usePlan && !wireMode && currentRow + 1 < totalRows) {
+        nextTurnDir = planTurnDirection(currentRow);
+        turningRight = nextTurnDir == RIGHT;
+    }
+    #endif
+
+    Logger::info("Resuming mowing pattern at row " + String(currentRow) + " of " + String(totalRows));
+    return true;
 }
 
 void PathPlanner::nextRow() {
@@ -46,9 +115,15 @@ void PathPlanner::nextRow() {
     distanceTraveled = 0.0;
     rowStartTime = millis();
 
-    // Alternér drejningsretning
+    // Alternér drejningsretning (planen bestemmer den når den bruges)
     turningRight = !turningRight;
     nextTurnDir = turningRight ? RIGHT : LEFT;
+    #if ENABLE_ZONES
+    if (usePlan && !wireMode && currentRow + 1 < totalRows) {
+        nextTurnDir = planTurnDirection(currentRow);
+        turningRight = nextTurnDir == RIGHT;
+    }
+    #endif
 
     // Beregn ny heading
     calculateNextHeading();
@@ -62,7 +137,8 @@ void PathPlanner::nextRow() {
 }
 
 bool PathPlanner::shouldTurn() {
-    if (!patternActive || turning) {
+    // Wire omgange skifter afstand uden at dreje (se updateWireLap)
+    if (!patternActive || turning || wireMode) {
         return false;
     }
 
@@ -72,17 +148,17 @@ bool PathPlanner::shouldTurn() {
         return true;
     }
 
-    // Tjek om vi har kørt langt nok i nuværende række
-    // Baseret på tid eller distance (her bruger vi tid som approksimation)
+    // Tjek om vi har kørt langt nok i nuværende række.
+    // distanceTraveled kommer fra odometrien (addDistance), så den følger
+    // farten når ObstacleAvoidance sænker den.
     unsigned long timeInRow = millis() - rowStartTime;
 
-    // Beregn estimeret distance baseret på tid og hastighed
-    // Antager MOTOR_CRUISE_SPEED giver ca. 20 cm/s (juster efter dit setup)
-    const float ESTIMATED_SPEED = 20.0; // cm/s
-    distanceTraveled = (timeInRow / 1000.0) * ESTIMATED_SPEED;
-
     // Drej når vi har kørt længde nok eller efter max tid
-    if (distanceTraveled >= ROW_LENGTH_MAX || timeInRow >= 30000) { // Max 30 sekunder per række
+    // (30 sekunder uden plan, ellers tiden ved laveste fart plus 50%)
+    float rowLength = getRowLength();
+    float slowestCmS = CRUISE_SPEED_CM_S * MOTOR_MIN_SPEED / MOTOR_CRUISE_SPEED;
+    unsigned long maxTime = usePlan ? (unsigned long)(rowLength / slowestCmS * 1500.0) : 30000;
+    if (distanceTraveled >= rowLength || timeInRow >= maxTime) {
         return true;
     }
 
@@ -93,6 +169,24 @@ Direction PathPlanner::getTurnDirection() {
     return nextTurnDir;
 }
 
+float PathPlanner::getTurnShift() {
+    #if ENABLE_ZONES
+    if (usePlan && !wireMode && currentRow + 1 < plan.rowCount) {
+        const ZonePlanRow& current = plan.rows[currentRow];
+        const ZonePlanRow& next = plan.rows[currentRow + 1];
+        float dirX = current.x1 - current.x0;
+        float dirY = current.y1 - current.y0;
+        float length = sqrt(dirX * dirX + dirY * dirY);
+        if (length > 0.0) {
+            float toNextX = next.x0 - current.x1;
+            float toNextY = next.y0 - current.y1;
+            return fabs(toNextX * dirY - toNextY * dirX) / length;
+        }
+    }
+    #endif
+    return rowWidth;
+}
+
 float PathPlanner::getTargetHeading() {
     return targetHeading;
 }
@@ -124,29 +218,26 @@ void PathPlanner::reset() {
     rowStartTime = 0;
     patternActive = false;
     perimeterTriggered = false;
+    lapHeadingValid = false;
+    lapTurned = 0.0;
+    lapDistance = 0.0;
+    lapReported = 0.0;
 
-    Logger::debug("PathPlanner reset");
-}
-
-void PathPlanner::update() {
-    if (!initialized || !patternActive) {
-        return;
-    }
-
-    // Opdater distance tracking baseret på tid
-    unsigned long timeInRow = millis() - rowStartTime;
-    const float ESTIMATED_SPEED = 20.0; // cm/s
-    distanceTraveled = (timeInRow / 1000.0) * ESTIMATED_SPEED;
+    LOGD(LOG_SUB_NAVIGATION, "PathPlanner reset");
 }
 
 void PathPlanner::startTurn() {
     turning = true;
-    Logger::debug("Turn started - Direction: " + String(nextTurnDir == RIGHT ? "RIGHT" : "LEFT"));
+    LOGD(LOG_SUB_NAVIGATION, "Turn started - Direction: %s", nextTurnDir == RIGHT ? "RIGHT" : "LEFT");
 }
 
 void PathPlanner::completeTurn() {
     turning = false;
-    Logger::debug("Turn completed");
+
+    // Rækken starter når vendingen er kørt færdig
+    distanceTraveled = 0.0;
+    rowStartTime = millis();
+    LOGD(LOG_SUB_NAVIGATION, "Turn completed");
 }
 
 bool PathPlanner::isTurning() {
@@ -154,6 +245,18 @@ bool PathPlanner::isTurning() {
 }
 
 void PathPlanner::calculateNextHeading() {
+    #if ENABLE_ZONES
+    // Med plan følges segmentets retning
+    if (usePlan) {
+        if (!wireMode && currentRow < plan.rowCount) {
+            const ZonePlanRow& row = plan.rows[currentRow];
+            targetHeading = MowerMath::normalizeAngle(
+                atan2((float)(row.x1 - row.x0), (float)(row.y1 - row.y0)) * RAD_TO_DEG);
+        }
+        return;
+    }
+    #endif
+
     // Beregn ny heading baseret på drejningsretning
     // Efter hver række drejer vi 180 grader (90° + fremad + 90°)
 
@@ -166,6 +269,122 @@ void PathPlanner::calculateNextHeading() {
     }
 }
 
+float PathPlanner::getRowLength() {
+    return getRowLengthCm(currentRow);
+}
+
+float PathPlanner::getRowLengthCm(int row) {
+    #if ENABLE_ZONES
+    if (usePlan && !wireMode && row >= 0 && row < plan.rowCount) {
+        const ZonePlanRow& segment = plan.rows[row];
+        float dx = segment.x1 - segment.x0;
+        float dy = segment.y1 - segment.y0;
+        return sqrt(dx * dx + dy * dy);
+    }
+    #endif
+    return ROW_LENGTH_MAX;
+}
+
+uint8_t PathPlanner::getZoneId() {
+    #if ENABLE_ZONES
+    if (usePlan) {
+        return plan.zoneId;
+    }
+    #endif
+    return 0;
+}
+
+bool PathPlanner::isWireMode() {
+    return wireMode;
+}
+
+#if ENABLE_ZONES
+Direction PathPlanner::planTurnDirection(int row) {
+    const ZonePlanRow& current = plan.rows[row];
+    const ZonePlanRow& next = plan.rows[row + 1];
+
+    // Krydsprodukt: positiv når næste segments slutning ligger til højre for
+    // kørselsretningen (virker både for rækker med sideskift og spiral hjørner)
+    float dirX = current.x1 - current.x0;
+    float dirY = current.y1 - current.y0;
+    float toNextX = next.x1 - current.x1;
+    float toNextY = next.y1 - current.y1;
+
+    return (toNextX * dirY - toNextY * dirX) >= 0.0 ? RIGHT : LEFT;
+}
+#endif
+
+bool PathPlanner::followsWire() {
+    return patternActive && wireMode;
+}
+
+float PathPlanner::getWireOffset() {
+    #if ENABLE_ZONES
+    if (wireMode && currentRow < plan.rowCount) {
+        return plan.rows[currentRow].x0;
+    }
+    #endif
+    return 0.0;
+}
+
+bool PathPlanner::updateWireLap(float heading) {
+    if (!followsWire()) {
+        return false;
+    }
+
+    // Ny omgang eller efter pause - drejning indtil nu tælles ikke
+    if (!lapHeadingValid) {
+        lapHeading = heading;
+        lapHeadingValid = true;
+        return false;
+    }
+
+    // Summér drejning - en lukket sløjfe rundt om plænen er 360 grader
+    float delta = heading - lapHeading;
+    if (delta > 180.0) {
+        delta -= 360.0;
+    } else if (delta < -180.0) {
+        delta += 360.0;
+    }
+    lapTurned += delta;
+    lapHeading = heading;
+
+    if (fabs(lapTurned) >= 360.0) {
+        Logger::info("Wire lap " + String(currentRow) + " complete");
+        lapHeadingValid = false;
+        lapTurned = 0.0;
+        lapDistance = 0.0;
+        lapReported = 0.0;
+        nextRow();
+        return true;
+    }
+
+    if (lapDistance - lapReported >= WIRE_LAP_PROGRESS_CM) {
+        lapReported = lapDistance;
+        return true;
+    }
+    return false;
+}
+
+void PathPlanner::addDistance(float distanceCm) {
+    if (!patternActive || turning) {
+        return;
+    }
+
+    if (wireMode) {
+        if (lapHeadingValid) {
+            lapDistance += fabs(distanceCm);
+        }
+        return;
+    }
+
+    distanceTraveled += distanceCm;
+}
+
+void PathPlanner::pauseWireLap() {
+    lapHeadingValid = false;
+}
+
 void PathPlanner::perimeterReached() {
     if (!patternActive) {
         return;
@@ -173,7 +392,7 @@ void PathPlanner::perimeterReached() {
 
     perimeterTriggered = true;
     Logger::info("Perimeter boundary reached - ending row " + String(currentRow));
-    Logger::debug("Distance traveled in row: " + String(distanceTraveled) + " cm");
+    LOGD(LOG_SUB_NAVIGATION, "Distance traveled in row: %.1f cm", distanceTraveled);
 }
 
 bool PathPlanner::wasPerimeterTriggered() {
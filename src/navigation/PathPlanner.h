@@ -4,12 +4,20 @@
 #include <Arduino.h>
 #include "../config/Config.h"
 #include "../system/Logger.h"
+#include "../utils/Math.h"
+#if ENABLE_ZONES
+#include "ZoneManager.h"
+#endif
 
 /**
  * PathPlanner klasse - Planlægger systematisk klipningsmønster
  *
  * Denne klasse implementerer et parallelt række-mønster for
- * systematisk plæneklipning.
+ * systematisk plæneklipning. Med en aktiv zone følges zonens cachede
+ * plan i stedet (se MowPattern): hvert segment giver rækkens heading og
+ * længde, og drejeretningen findes ud fra hvor næste segment går hen.
+ * Wire mønstre (perimeter omgange) styres af kablet - planneren giver
+ * kun ønsket afstand og tæller omgange.
  */
 class PathPlanner {
 public:
@@ -24,11 +32,28 @@ public:
      */
     bool begin();
 
+    #if ENABLE_ZONES
+    /**
+     * Hent aktiv zones plan (kaldes før startNewPattern)
+     * @param zones ZoneManager
+     * @return true hvis en zone plan bruges, false = standard mønster
+     */
+    bool loadPlan(ZoneManager& zones);
+    #endif
+
     /**
      * Starter nyt klipningsmønster
      */
     void startNewPattern();
 
+    /**
+     * Genoptager mønster fra checkpoint (kaldes efter loadPlan i stedet for startNewPattern)
+     * @param row Række der skal klippes (rækkerne før er klippet)
+     * @param turnDir Drejeretning for næste vending (bruges uden plan)
+     * @return false hvis rækken ikke findes i mønsteret
+     */
+    bool resumePattern(int row, Direction turnDir);
+
     /**
      * Går til næste række i mønsteret
      */
@@ -46,6 +71,14 @@ public:
      */
     Direction getTurnDirection();
 
+    /**
+     * Hent sideforskydning til næste række (til vendings planlægning)
+     * Kaldes før nextRow(). Med plan er det afstanden fra nuværende
+     * segments slutning til næste segments start vinkelret på kørselsretningen.
+     * @return cm (række bredden uden plan)
+     */
+    float getTurnShift();
+
     /**
      * Hent target heading for nuværende række
      * @return Heading i grader (0-360)
@@ -77,14 +110,28 @@ public:
     int getTotalRows();
 
     /**
-     * Nulstil path planner
+     * Hent længde af en række
+     * @param row Række nummer (0-baseret)
+     * @return cm (ROW_LENGTH_MAX uden plan)
      */
-    void reset();
+    float getRowLengthCm(int row);
 
     /**
-     * Opdater path planner state
+     * Hent zonen planen hører til
+     * @return Zone ID (0 = standard mønster uden plan)
      */
-    void update();
+    uint8_t getZoneId();
+
+    /**
+     * Tjek om mønsteret er perimeter omgange (længden styres af kablet)
+     * @return true hvis wire mønster er indlæst
+     */
+    bool isWireMode();
+
+    /**
+     * Nulstil path planner
+     */
+    void reset();
 
     /**
      * Marker at drejning er startet
@@ -102,6 +149,39 @@ public:
      */
     bool isTurning();
 
+    /**
+     * Tjek om mønsteret følger perimeter kablet i stedet for headings
+     * @return true hvis aktivt wire mønster
+     */
+    bool followsWire();
+
+    /**
+     * Hent ønsket afstand til kablet for nuværende omgang
+     * @return cm (0 uden wire mønster)
+     */
+    float getWireOffset();
+
+    /**
+     * Opdater omgangs tælling ud fra heading (wire mønstre)
+     * Når robotten har drejet 360 grader langs kablet skiftes til næste omgang
+     * @param heading Nuværende heading (0-360)
+     * @return true ved fremskridt (WIRE_LAP_PROGRESS_CM kørt eller omgang færdig)
+     */
+    bool updateWireLap(float heading);
+
+    /**
+     * Tilføj kørt distance fra odometrien (kun mens der klippes)
+     * Tæller i rækken, eller i omgangen når der klippes langs kablet
+     * @param distanceCm Distance i cm (negativ ved bakning)
+     */
+    void addDistance(float distanceCm);
+
+    /**
+     * Sæt omgangs tællingen på pause (undvigelse, signal søgning)
+     * Drejning uden for kablet tælles ikke - tællingen fortsætter ved næste update
+     */
+    void pauseWireLap();
+
     /**
      * Signalerer at perimeter grænse er nået
      * Afslutter nuværende række og forbereder drejning
@@ -125,6 +205,32 @@ private:
      */
     void calculateNextHeading();
 
+    /**
+     * Længde af nuværende række
+     * @return cm (ROW_LENGTH_MAX uden plan)
+     */
+    float getRowLength();
+
+    #if ENABLE_ZONES
+    /**
+     * Drejeretning fra slutningen af segment mod start af næste
+     * @param row Segment index
+     * @return RIGHT eller LEFT
+     */
+    Direction planTurnDirection(int row);
+
+    ZonePlan plan;            // Kopi af aktiv zones plan
+    #endif
+    bool usePlan;             // true hvis plan styrer rækkerne
+    bool wireMode;            // true hvis planen er omgange langs kablet
+
+    // Omgangs tælling (wire mønstre)
+    float lapHeading;         // Heading ved sidste updateWireLap
+    float lapTurned;          // Samlet drejning i nuværende omgang (grader)
+    bool lapHeadingValid;
+    float lapDistance;        // Kørt langs kablet i nuværende omgang (cm)
+    float lapReported;        // lapDistance ved seneste fremskridt
+
     // Mønster parametre
     float rowWidth;           // Afstand mellem rækker (cm)
     int currentRow;           // Nuværende række nummer
@@ -0,0 +1,260 @@
+#include "SignalSearch.h"
+#include "../hardware/Motors.h"
+#include "../hardware/IMU.h"
+#include "../hardware/PerimeterReceiver.h"
+#include "../utils/Math.h"
+
+SignalSearch::SignalSearch() {
+    motorsPtr = nullptr;
+    imuPtr = nullptr;
+    perimeterPtr = nullptr;
+    poseX = 0.0;
+    poseY = 0.0;
+    heading = 0.0;
+    lastTrack = 0;
+    trackHead = 0;
+    trackCount = 0;
+    memset(&lastKnown, 0, sizeof(lastKnown));
+    hasLastKnown = false;
+    phase = SEARCH_IDLE;
+    searchStart = 0;
+    phaseStart = 0;
+    lastUpdate = 0;
+    backtrackIndex = -1;
+    backtrackDistance = 0.0;
+    bestDistance = 0.0;
+    pointStart = 0;
+    spiralDistance = 0.0;
+    spiralRadius = 0.0;
+    spiralDirection = 1;
+    searches = 0;
+    recoveries = 0;
+    lastRecoveryMs = 0;
+    lastFoundIn = "";
+    initialized = false;
+}
+
+bool SignalSearch::begin(Motors* motors, IMU* imu, PerimeterReceiver* receiver) {
+    if (motors == nullptr || imu == nullptr || receiver == nullptr) {
+        Logger::error("SignalSearch: missing motors, IMU or perimeter receiver");
+        return false;
+    }
+
+    motorsPtr = motors;
+    imuPtr = imu;
+    perimeterPtr = receiver;
+    heading = imu->getHeading();
+    lastTrack = millis();
+    initialized = true;
+
+    Logger::info("SignalSearch initialized (track " + String(SEARCH_TRACK_SIZE) + " x " +
+                 String(SEARCH_TRACK_SPACING_CM) + " cm)");
+    return true;
+}
+
+void SignalSearch::track() {
+    if (!initialized) {
+        return;
+    }
+
+    unsigned long now = millis();
+    // Efter blokerende manøvrer står motorerne stille - brug ikke gammel fart over lang tid
+    unsigned long dt = min(now - lastTrack, (unsigned long)SEARCH_TRACK_MAX_DT_MS);
+    lastTrack = now;
+
+    // Ingen hjul encodere - fart estimeret fra kommanderet PWM som i Movement
+    float pwm = (motorsPtr->getLeftSpeed() + motorsPtr->getRightSpeed()) / 2.0;
+    float distance = CRUISE_SPEED_CM_S * pwm / MOTOR_CRUISE_SPEED * dt / 1000.0;
+
+    heading = imuPtr->getHeading();
+    float rad = heading * DEG_TO_RAD;
+    poseX += distance * sin(rad);
+    poseY += distance * cos(rad);
+
+    if (phase == SEARCH_BACKTRACK) {
+        backtrackDistance += fabs(distance);
+    } else if (phase == SEARCH_SPIRAL) {
+        spiralDistance += fabs(distance);
+    }
+
+    if (phase != SEARCH_IDLE || !perimeterPtr->hasSignal()) {
+        return;
+    }
+
+    lastKnown.x = poseX;
+    lastKnown.y = poseY;
+    lastKnown.heading = heading;
+    lastKnown.lateralOffset = perimeterPtr->getLateralOffset();
+    hasLastKnown = true;
+
+    if (trackCount > 0) {
+        const TrackPoint& newest = trackPoints[(trackHead - 1 + SEARCH_TRACK_SIZE) % SEARCH_TRACK_SIZE];
+        float dx = poseX - newest.x;
+        float dy = poseY - newest.y;
+        if (sqrt(dx * dx + dy * dy) < SEARCH_TRACK_SPACING_CM) {
+            return;
+        }
+    }
+
+    trackPoints[trackHead] = lastKnown;
+    trackHead = (trackHead + 1) % SEARCH_TRACK_SIZE;
+    if (trackCount < SEARCH_TRACK_SIZE) {
+        trackCount++;
+    }
+}
+
+void SignalSearch::start() {
+    if (!initialized) {
+        return;
+    }
+
+    searches++;
+    searchStart = millis();
+    backtrackIndex = -1;
+    backtrackDistance = 0.0;
+    spiralDistance = 0.0;
+    spiralRadius = 0.0;
+
+    if (hasLastKnown) {
+        Logger::info("Signal search: backtracking " + String(trackCount) + " track points");
+        setPhase(SEARCH_BACKTRACK);
+    } else {
+        Logger::info("Signal search: no track - starting spiral");
+        setPhase(SEARCH_SPIRAL);
+    }
+}
+
+SearchPhase SignalSearch::update() {
+    if (!initialized || phase == SEARCH_IDLE || phase == SEARCH_FAILED) {
+        return phase;
+    }
+
+    unsigned long now = millis();
+
+    if (now - searchStart >= SEARCH_TIMEOUT_MS) {
+        motorsPtr->stop();
+        Logger::error("Signal search timeout after " + String(SEARCH_TIMEOUT_MS / 1000) + " s");
+        setPhase(SEARCH_FAILED);
+        return phase;
+    }
+
+    if (now - lastUpdate < SEARCH_UPDATE_INTERVAL_MS) {
+        return phase;   // Motorerne holder forrige kommando
+    }
+    lastUpdate = now;
+
+    if (phase == SEARCH_BACKTRACK) {
+        updateBacktrack();
+    } else {
+        updateSpiral();
+    }
+
+    return phase;
+}
+
+void SignalSearch::stop(bool found) {
+    if (phase == SEARCH_BACKTRACK || phase == SEARCH_SPIRAL) {
+        motorsPtr->stop();
+
+        if (found) {
+            recoveries++;
+            lastRecoveryMs = millis() - searchStart;
+            lastFoundIn = getPhaseName();
+            Logger::info("Signal recovered in " + String(lastRecoveryMs) + " ms (" + lastFoundIn + ")");
+        }
+    }
+
+    setPhase(SEARCH_IDLE);
+}
+
+const char* SignalSearch::getPhaseName() const {
+    switch (phase) {
+        case SEARCH_IDLE:       return "IDLE";
+        case SEARCH_BACKTRACK:  return "BACKTRACK";
+        case SEARCH_SPIRAL:     return "SPIRAL";
+        case SEARCH_FAILED:     return "FAILED";
+        default:                return "UNKNOWN";
+    }
+}
+
+void SignalSearch::setPhase(SearchPhase newPhase) {
+    phase = newPhase;
+    phaseStart = millis();
+    lastUpdate = 0;
+    pointStart = phaseStart;
+    bestDistance = 1.0e9;
+
+    if (newPhase == SEARCH_SPIRAL) {
+        spiralDistance = 0.0;
+        spiralRadius = SEARCH_SPIRAL_START_CM;
+        // Kablet holdes til venstre ved kabel følgning - inden for = kablet til venstre
+        spiralDirection = (hasLastKnown && lastKnown.lateralOffset < 0.0) ? 1 : -1;
+    }
+}
+
+void SignalSearch::updateBacktrack() {
+    if (backtrackDistance >= SEARCH_BACKTRACK_MAX_CM || backtrackIndex >= trackCount) {
+        Logger::info("Signal search: backtrack done after " + String(backtrackDistance, 0) + " cm - starting spiral");
+        setPhase(SEARCH_SPIRAL);
+        return;
+    }
+
+    TrackPoint target = (backtrackIndex < 0)
+        ? lastKnown
+        : trackPoints[(trackHead - 1 - backtrackIndex + 2 * SEARCH_TRACK_SIZE) % SEARCH_TRACK_SIZE];
+
+    float dx = target.x - poseX;
+    float dy = target.y - poseY;
+    float distance = sqrt(dx * dx + dy * dy);
+    unsigned long now = millis();
+
+    // Nået, kørt forbi eller sidder fast - videre til næste (ældre) punkt
+    if (distance < SEARCH_POINT_TOLERANCE_CM ||
+        distance > bestDistance + SEARCH_POINT_TOLERANCE_CM ||
+        now - pointStart >= SEARCH_POINT_TIMEOUT_MS) {
+        backtrackIndex++;
+        bestDistance = 1.0e9;
+        pointStart = now;
+        return;
+    }
+    bestDistance = min(bestDistance, distance);
+
+    // Bakker - robottens bagende skal pege mod punktet
+    float bearing = atan2(dx, dy) * RAD_TO_DEG;
+    float desired = MowerMath::normalizeAngle(bearing + 180.0);
+    float error = MowerMath::angleDifference(heading, desired);
+
+    if (fabs(error) > SEARCH_PIVOT_ANGLE) {
+        // Positiv fejl = drej med uret
+        int turn = (error > 0) ? MOTOR_TURN_SPEED : -MOTOR_TURN_SPEED;
+        motorsPtr->setSpeed(turn, -turn);
+        return;
+    }
+
+    int correction = constrain((int)(error * SEARCH_STEER_GAIN), -SEARCH_STEER_MAX, SEARCH_STEER_MAX);
+    motorsPtr->setSpeed(-SEARCH_SPEED + correction, -SEARCH_SPEED - correction);
+}
+
+void SignalSearch::updateSpiral() {
+    // Arkimedisk spiral: radius vokser SEARCH_SPIRAL_GROWTH_CM pr. omgang (r² = r0² + g·s/π)
+    spiralRadius = sqrt(SEARCH_SPIRAL_START_CM * SEARCH_SPIRAL_START_CM +
+                        SEARCH_SPIRAL_GROWTH_CM * spiralDistance / PI);
+
+    if (spiralRadius > SEARCH_SPIRAL_MAX_CM) {
+        motorsPtr->stop();
+        Logger::error("Signal search: spiral reached " + String(SEARCH_SPIRAL_MAX_CM) + " cm without signal");
+        setPhase(SEARCH_FAILED);
+        return;
+    }
+
+    // Indre hjul skaleres så robotten følger radius
+    float halfTrack = WHEEL_TRACK_CM / 2.0;
+    int outer = SEARCH_SPEED;
+    int inner = (int)(SEARCH_SPEED * (spiralRadius - halfTrack) / (spiralRadius + halfTrack));
+
+    if (spiralDirection > 0) {
+        motorsPtr->setSpeed(outer, inner);
+    } else {
+        motorsPtr->setSpeed(inner, outer);
+    }
+}
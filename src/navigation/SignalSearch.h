@@ -0,0 +1,182 @@
+#ifndef SIGNAL_SEARCH_H
+#define SIGNAL_SEARCH_H
+
+#include <Arduino.h>
+#include "../config/Config.h"
+#include "../system/Logger.h"
+
+class Motors;
+class IMU;
+class PerimeterReceiver;
+
+/**
+ * Faser i signal søgningen
+ */
+enum SearchPhase {
+    SEARCH_IDLE,        // Ingen søgning
+    SEARCH_BACKTRACK,   // Bakker tilbage ad det kørte spor
+    SEARCH_SPIRAL,      // Udvidende spiral fra sidste kendte position
+    SEARCH_FAILED       // Opgivet (timeout eller max radius)
+};
+
+/**
+ * Punkt på det kørte spor (relativ pose, cm og grader)
+ */
+struct TrackPoint {
+    float x;
+    float y;
+    float heading;
+    float lateralOffset;    // Sideafstand til kablet (cm, positiv = inden for)
+};
+
+/**
+ * SignalSearch klasse - Finder perimeter signalet igen efter signal tab
+ *
+ * track() integrerer en relativ pose ud fra kommanderet hjulfart og IMU
+ * heading (også når WireFollower og DockingController styrer motorerne
+ * direkte) og gemmer et punkt hver SEARCH_TRACK_SPACING_CM i en ring
+ * buffer, så længe der er signal. Ved signal tab bakkes robotten tilbage
+ * gennem punkterne - nyeste først - op til SEARCH_BACKTRACK_MAX_CM.
+ * Ruten er netop kørt, så den er fri, og signalet var der i hvert punkt.
+ * Først derefter køres en udvidende spiral mod den side kablet sidst var.
+ * Alt styres fra update() uden delay().
+ */
+class SignalSearch {
+public:
+    /**
+     * Constructor
+     */
+    SignalSearch();
+
+    /**
+     * Initialiserer søgningen
+     * @param motors Motorerne der styres under søgning (og aflæses i track())
+     * @param imu IMU til heading
+     * @param receiver Perimeter modtager (signal og sideafstand)
+     * @return true hvis succesfuld
+     */
+    bool begin(Motors* motors, IMU* imu, PerimeterReceiver* receiver);
+
+    /**
+     * Opdater pose og spor (kaldes periodisk efter perimeter update, i alle tilstande)
+     */
+    void track();
+
+    /**
+     * Start søgning - signalet er lige mistet
+     */
+    void start();
+
+    /**
+     * Kør søgningen og sæt motorerne (kaldes hver loop i SEARCHING_SIGNAL)
+     * @return Fase efter opdateringen
+     */
+    SearchPhase update();
+
+    /**
+     * Afslut søgning og stop motorerne
+     * @param found true hvis signalet blev fundet (tæller med i statistik)
+     */
+    void stop(bool found);
+
+    /**
+     * Hent nuværende fase
+     */
+    SearchPhase getPhase() const { return phase; }
+
+    /**
+     * Hent fase som tekst
+     */
+    const char* getPhaseName() const;
+
+    /**
+     * Antal punkter i sporet
+     */
+    int getTrackCount() const { return trackCount; }
+
+    /**
+     * Bakket distance i nuværende/seneste søgning (cm)
+     */
+    float getBacktrackDistance() const { return backtrackDistance; }
+
+    /**
+     * Nuværende spiral radius (cm)
+     */
+    float getSpiralRadius() const { return spiralRadius; }
+
+    /**
+     * Antal startede søgninger
+     */
+    uint32_t getSearches() const { return searches; }
+
+    /**
+     * Antal søgninger der fandt signalet
+     */
+    uint32_t getRecoveries() const { return recoveries; }
+
+    /**
+     * Tid fra signal tab til signal fundet i seneste søgning (ms)
+     */
+    unsigned long getLastRecoveryMs() const { return lastRecoveryMs; }
+
+    /**
+     * Fase hvor signalet sidst blev fundet ("BACKTRACK" eller "SPIRAL")
+     */
+    const char* getLastFoundIn() const { return lastFoundIn; }
+
+private:
+    /**
+     * Skift fase og nulstil fase data
+     */
+    void setPhase(SearchPhase newPhase);
+
+    /**
+     * Bak mod næste punkt på sporet
+     */
+    void updateBacktrack();
+
+    /**
+     * Kør udvidende spiral
+     */
+    void updateSpiral();
+
+    Motors* motorsPtr;
+    IMU* imuPtr;
+    PerimeterReceiver* perimeterPtr;
+
+    // Relativ pose (integreret i track())
+    float poseX;
+    float poseY;
+    float heading;
+    unsigned long lastTrack;
+
+    // Spor med signal (ring buffer)
+    TrackPoint trackPoints[SEARCH_TRACK_SIZE];
+    int trackHead;                  // Næste plads der skrives
+    int trackCount;
+    TrackPoint lastKnown;           // Sidste pose med signal
+    bool hasLastKnown;
+
+    // Søgning
+    SearchPhase phase;
+    unsigned long searchStart;
+    unsigned long phaseStart;
+    unsigned long lastUpdate;
+    int backtrackIndex;             // Punkter tilbage fra nyeste (-1 = sidste pose med signal)
+    float backtrackDistance;        // Bakket distance i denne søgning (cm)
+    float bestDistance;             // Nærmeste afstand til nuværende punkt (cm)
+    unsigned long pointStart;
+    float spiralDistance;           // Kørt distance i spiralen (cm)
+    float spiralRadius;
+    int spiralDirection;            // 1 = højre (med uret), -1 = venstre
+
+    // Statistik
+    uint32_t searches;
+    uint32_t recoveries;
+    unsigned long lastRecoveryMs;
+    const char* lastFoundIn;
+
+    bool initialized;
+};
+
+#endif // SIGNAL_SEARCH_H
@@ -0,0 +1,95 @@
+#include "TurnPlanner.h"
+
+bool TurnPlanner::plan(float fromHeading, float toHeading, Direction direction,
+                       float shiftCm, TurnProfile& profile) {
+    profile.name = "arc";
+    profile.count = 0;
+    profile.lengthCm = 0.0;
+    profile.durationMs = 0;
+
+    // Vinkel der skal drejes i den ønskede retning (0-360)
+    float delta = direction == RIGHT ? toHeading - fromHeading : fromHeading - toHeading;
+    delta = MowerMath::normalizeAngle(delta);
+    if (delta < HEADING_TOLERANCE) {
+        return false;
+    }
+
+    const float r = MIN_TURNING_RADIUS;
+    Direction away = direction == RIGHT ? LEFT : RIGHT;
+
+    if (delta < TURN_UTURN_MIN_ANGLE) {
+        // Hjørne (spiral) - én bue
+        addArc(profile, direction, delta, r);
+    } else if (shiftCm >= 2 * r) {
+        // Rækkerne er langt nok fra hinanden til en U
+        profile.name = "u-turn";
+        addArc(profile, direction, delta / 2, r);
+        addStraight(profile, shiftCm - 2 * r, false);
+        addArc(profile, direction, delta / 2, r);
+    } else if (TURN_ALLOW_REVERSE) {
+        // Tættere rækker - bak det stykke buerne tager for meget (Reeds-Shepp)
+        profile.name = "y-turn";
+        addArc(profile, direction, delta / 2, r);
+        addStraight(profile, 2 * r - shiftCm, true);
+        addArc(profile, direction, delta / 2, r);
+    } else {
+        // Kun fremad: drej væk først, så en stor bue ind på næste række
+        // cos(α) = (d + 2r) / 4r giver sideforskydning d med tre buer af radius r
+        profile.name = "omega";
+        float alpha = acos(constrain((shiftCm + 2 * r) / (4 * r), -1.0, 1.0)) * RAD_TO_DEG;
+        addArc(profile, away, alpha, r);
+        addArc(profile, direction, delta + 2 * alpha, r);
+        addArc(profile, away, alpha, r);
+    }
+
+    return profile.count > 0;
+}
+
+void TurnPlanner::addArc(TurnProfile& profile, Direction direction, float angleDeg, float radiusCm) {
+    if (profile.count >= TURN_MAX_SEGMENTS || angleDeg < 1.0) {
+        return;
+    }
+
+    // Hjulene følger koncentriske buer: ydre (r + b/2), indre (r - b/2).
+    // Basis farten sænkes så det ydre hjul ikke overstiger MOTOR_MAX_SPEED.
+    float halfTrack = WHEEL_TRACK_CM / 2.0;
+    float base = min((float)TURN_ARC_SPEED, MOTOR_MAX_SPEED * radiusCm / (radiusCm + halfTrack));
+    int outer = (int)(base * (radiusCm + halfTrack) / radiusCm);
+    int inner = max((int)(base * (radiusCm - halfTrack) / radiusCm), MOTOR_MIN_SPEED);
+
+    TurnSegment& segment = profile.segments[profile.count++];
+    segment.type = TURN_SEG_ARC;
+    segment.direction = direction;
+    segment.reverse = false;
+    segment.amount = angleDeg;
+    segment.leftSpeed = direction == RIGHT ? outer : inner;
+    segment.rightSpeed = direction == RIGHT ? inner : outer;
+
+    float length = radiusCm * angleDeg * DEG_TO_RAD;
+    float speedCmS = CRUISE_SPEED_CM_S * base / MOTOR_CRUISE_SPEED;
+    segment.durationMs = (uint32_t)(length / speedCmS * 1000.0);
+
+    profile.lengthCm += length;
+    profile.durationMs += segment.durationMs;
+}
+
+void TurnPlanner::addStraight(TurnProfile& profile, float lengthCm, bool reverse) {
+    if (profile.count >= TURN_MAX_SEGMENTS || lengthCm < 1.0) {
+        return;
+    }
+
+    int speed = reverse ? -MOTOR_BACKUP_SPEED : MOTOR_CRUISE_SPEED;
+    float speedCmS = reverse ? BACKUP_SPEED_CM_S : CRUISE_SPEED_CM_S;
+
+    TurnSegment& segment = profile.segments[profile.count++];
+    segment.type = TURN_SEG_STRAIGHT;
+    segment.direction = reverse ? BACKWARD : FORWARD;
+    segment.reverse = reverse;
+    segment.amount = lengthCm;
+    segment.leftSpeed = speed;
+    segment.rightSpeed = speed;
+    segment.durationMs = (uint32_t)(lengthCm / speedCmS * 1000.0);
+
+    profile.lengthCm += lengthCm;
+    profile.durationMs += segment.durationMs;
+}
@@ -0,0 +1,78 @@
+#ifndef TURN_PLANNER_H
+#define TURN_PLANNER_H
+
+#include <Arduino.h>
+#include "../config/Config.h"
+#include "../utils/Math.h"
+
+/**
+ * TurnPlanner - Bløde vendinger mellem rækker
+ *
+ * I stedet for at dreje på stedet planlægges en række buer og lige
+ * stykker (Dubins / Reeds-Shepp familien) med radius MIN_TURNING_RADIUS.
+ * Begge hjul ruller fremad i buerne, så græsset ikke rives op og
+ * kniven kan køre videre. Valget afhænger af sideforskydningen d
+ * mellem rækkerne:
+ *
+ *   u-turn  (d >= 2r): bue 90° - lige (d - 2r) - bue 90°
+ *   y-turn  (d < 2r):  bue 90° - bak (2r - d) - bue 90°
+ *   omega   (d < 2r, TURN_ALLOW_REVERSE false): bue væk α - bue 180°+2α - bue væk α
+ *   arc     (drejning under TURN_UTURN_MIN_ANGLE, fx spiral hjørner): én bue
+ *
+ * Hvert segment har hjulhastigheder (PWM) og en slutbetingelse -
+ * drejet vinkel fra IMU for buer, tid for lige stykker - som Movement
+ * eksekverer uden at stoppe mellem segmenterne.
+ */
+
+#define TURN_MAX_SEGMENTS           3
+
+enum TurnSegmentType : uint8_t {
+    TURN_SEG_ARC,               // Bue - slutter når heading har drejet 'amount' grader
+    TURN_SEG_STRAIGHT           // Lige stykke - slutter efter durationMs
+};
+
+struct TurnSegment {
+    TurnSegmentType type;
+    Direction direction;        // Drejeretning for buer (LEFT/RIGHT)
+    bool reverse;               // true = baglæns
+    float amount;               // Grader (bue) eller cm (lige)
+    int16_t leftSpeed;          // PWM (-255..255)
+    int16_t rightSpeed;         // PWM (-255..255)
+    uint32_t durationMs;        // Forventet tid (lige: slutbetingelse, bue: timeout grundlag)
+};
+
+struct TurnProfile {
+    const char* name;           // "u-turn", "y-turn", "omega" eller "arc"
+    uint8_t count;              // Antal segmenter
+    TurnSegment segments[TURN_MAX_SEGMENTS];
+    float lengthCm;             // Samlet kørt distance
+    uint32_t durationMs;        // Samlet forventet tid
+};
+
+class TurnPlanner {
+public:
+    /**
+     * Planlæg vending fra nuværende til næste rækkes heading
+     * @param fromHeading Nuværende heading (0-360)
+     * @param toHeading Næste rækkes heading (0-360)
+     * @param direction Drejeretning (LEFT/RIGHT)
+     * @param shiftCm Sideforskydning mellem rækkerne (cm)
+     * @param profile Modtager segmenterne
+     * @return false hvis der ikke skal drejes
+     */
+    static bool plan(float fromHeading, float toHeading, Direction direction,
+                     float shiftCm, TurnProfile& profile);
+
+private:
+    /**
+     * Tilføj bue segment med hjulhastigheder for radius
+     */
+    static void addArc(TurnProfile& profile, Direction direction, float angleDeg, float radiusCm);
+
+    /**
+     * Tilføj lige segment (spring over hvis kortere end 1 cm)
+     */
+    static void addStraight(TurnProfile& profile, float lengthCm, bool reverse);
+};
+
+#endif // TURN_PLANNER_H
@@ -0,0 +1,83 @@
+#include "WireFollower.h"
+#include "../hardware/Motors.h"
+#include "../hardware/PerimeterReceiver.h"
+
+WireFollower::WireFollower() {
+    motorsPtr = nullptr;
+    perimeterPtr = nullptr;
+    initialized = false;
+    reset();
+}
+
+bool WireFollower::begin(Motors* motors, PerimeterReceiver* receiver) {
+    if (motors == nullptr || receiver == nullptr) {
+        Logger::error("WireFollower: missing motors or perimeter receiver");
+        return false;
+    }
+
+    motorsPtr = motors;
+    perimeterPtr = receiver;
+    reset();
+    initialized = true;
+
+    Logger::info("WireFollower initialized (offset " + String(WIRE_FOLLOW_OFFSET_CM, 0) + " cm)");
+    return true;
+}
+
+void WireFollower::reset() {
+    targetOffset = WIRE_FOLLOW_OFFSET_CM;
+    maxSpeed = WIRE_FOLLOW_SPEED_MAX;
+    offset = 0.0;
+    error = 0.0;
+    integral = 0.0;
+    derivative = 0.0;
+    lastOffset = 0.0;
+    hasLast = false;
+    steering = 0;
+    speed = 0;
+    lastUpdate = 0;
+}
+
+void WireFollower::setTarget(float offsetCm, int maxSpeed) {
+    targetOffset = offsetCm;
+    this->maxSpeed = maxSpeed;
+}
+
+void WireFollower::update() {
+    if (!initialized) {
+        return;
+    }
+
+    unsigned long now = millis();
+    if (hasLast && now - lastUpdate < WIRE_FOLLOW_INTERVAL_MS) {
+        return;     // Motorerne holder forrige kommando
+    }
+
+    float dt = hasLast ? (now - lastUpdate) / 1000.0 : WIRE_FOLLOW_INTERVAL_MS / 1000.0;
+    lastUpdate = now;
+
+    offset = perimeterPtr->getLateralOffset();
+    error = offset - targetOffset;
+
+    // Differential på målingen - ønsket afstand ændrer sig ikke, og første kald giver intet spring
+    if (hasLast) {
+        float rate = (offset - lastOffset) / dt;
+        derivative += (rate - derivative) * WIRE_FOLLOW_D_ALPHA;
+    }
+    lastOffset = offset;
+    hasLast = true;
+
+    integral = constrain(integral + WIRE_FOLLOW_KI * error * dt,
+                         -WIRE_FOLLOW_I_MAX, WIRE_FOLLOW_I_MAX);
+
+    // error = måling - ønske, så differentialet på målingen dæmper med samme fortegn som P
+    float output = WIRE_FOLLOW_KP * error + integral + WIRE_FOLLOW_KD * derivative;
+    steering = constrain((int)output, -WIRE_FOLLOW_STEER_MAX, WIRE_FOLLOW_STEER_MAX);
+
+    // Sving = stor styring - sænk farten så robotten ikke skærer svinget
+    speed = maxSpeed - (int)(abs(steering) * WIRE_FOLLOW_CURVE_SLOWDOWN);
+    speed = max(speed, min(WIRE_FOLLOW_SPEED_MIN, maxSpeed));
+
+    // Positiv styring drejer mod kablet (venstre)
+    motorsPtr->setSpeed(speed - steering, speed + steering);
+}
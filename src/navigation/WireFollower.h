@@ -0,0 +1,107 @@
+#ifndef WIRE_FOLLOWER_H
+#define WIRE_FOLLOWER_H
+
+#include <Arduino.h>
+#include "../config/Config.h"
+#include "../system/Logger.h"
+
+class Motors;
+class PerimeterReceiver;
+
+/**
+ * WireFollower klasse - Følger perimeter kablet
+ *
+ * Bruges til hjemkørsel og til perimeter omgange under klipning.
+ * Sideafstanden til kablet (fortegn fra inden for/uden for, størrelse fra
+ * glattet magnitude) reguleres mod ønsket afstand (WIRE_FOLLOW_OFFSET_CM
+ * eller setTarget()) med en PID hvert
+ * WIRE_FOLLOW_INTERVAL_MS. Udgangen er forskellen mellem hjulene, så
+ * robotten kører kontinuerligt uden at stoppe og dreje på stedet.
+ * Grundfarten sænkes med styringen, så skarpe sving køres langsommere
+ * end lige kabel.
+ */
+class WireFollower {
+public:
+    /**
+     * Constructor
+     */
+    WireFollower();
+
+    /**
+     * Initialiserer wire follower
+     * @param motors Motorerne der styres
+     * @param receiver Perimeter modtager (sideafstand)
+     * @return true hvis succesfuld
+     */
+    bool begin(Motors* motors, PerimeterReceiver* receiver);
+
+    /**
+     * Nulstil regulatoren (ved start af hjemkørsel og efter signal tab)
+     * Ønsket afstand og fart sættes tilbage til hjemkørslens værdier.
+     */
+    void reset();
+
+    /**
+     * Sæt ønsket afstand og højeste grundfart (perimeter omgange)
+     * Gælder til næste reset().
+     * @param offsetCm Ønsket afstand til kablet (cm)
+     * @param maxSpeed Grundfart på lige kabel (PWM)
+     */
+    void setTarget(float offsetCm, int maxSpeed);
+
+    /**
+     * Kør regulatoren og sæt motorerne (kaldes hver loop efter perimeter update)
+     */
+    void update();
+
+    /**
+     * Seneste sideafstand (cm, positiv = inden for)
+     */
+    float getOffset() const { return offset; }
+
+    /**
+     * Ønsket afstand til kablet (cm)
+     */
+    float getTargetOffset() const { return targetOffset; }
+
+    /**
+     * Seneste afvigelse fra ønsket afstand (cm, positiv = for langt fra kablet)
+     */
+    float getError() const { return error; }
+
+    /**
+     * Seneste styring (PWM, positiv = mod kablet/venstre)
+     */
+    int getSteering() const { return steering; }
+
+    /**
+     * Seneste grundfart (PWM)
+     */
+    int getSpeed() const { return speed; }
+
+    /**
+     * Integralets bidrag (PWM)
+     */
+    float getIntegral() const { return integral; }
+
+private:
+    Motors* motorsPtr;
+    PerimeterReceiver* perimeterPtr;
+
+    float targetOffset;
+    int maxSpeed;
+
+    float offset;
+    float error;
+    float integral;             // Bidrag i PWM (begrænset til WIRE_FOLLOW_I_MAX)
+    float derivative;           // Filtreret ændring af sideafstanden (cm/s)
+    float lastOffset;
+    bool hasLast;
+    int steering;
+    int speed;
+    unsigned long lastUpdate;
+
+    bool initialized;
+};
+
+#endif // WIRE_FOLLOWER_H
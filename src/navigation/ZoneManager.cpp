@@ -0,0 +1,464 @@
+#include "ZoneManager.h"
+#include "MowPattern.h"
+
+ZoneManager::ZoneManager()
+    : zoneCount(0),
+      activeId(0),
+      saveError(""),
+      initialized(false) {
+    mux = portMUX_INITIALIZER_UNLOCKED;
+    memset(zones, 0, sizeof(zones));
+    memset(planRows, 0, sizeof(planRows));
+    memset(&activePlan, 0, sizeof(activePlan));
+    memset(&scratchPlan, 0, sizeof(scratchPlan));
+}
+
+bool ZoneManager::begin() {
+    if (!LittleFS.begin(true)) {
+        Logger::error("Zones: LittleFS mount fejlede");
+        return false;
+    }
+
+    zoneCount = 0;
+    activeId = 0;
+
+    if (LittleFS.exists(ZONE_FILE)) {
+        File file = LittleFS.open(ZONE_FILE, "r");
+        ZoneFileHeader header;
+
+        bool valid = file && file.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+                     header.magic == ZONE_MAGIC && header.version == ZONE_FILE_VERSION &&
+                     header.count <= ZONE_MAX_COUNT;
+
+        if (valid) {
+            for (int i = 0; i < header.count; i++) {
+                if (file.read((uint8_t*)&zones[zoneCount], sizeof(ZoneRecord)) != sizeof(ZoneRecord)) {
+                    break;
+                }
+                if (isValid(zones[zoneCount])) {
+                    zoneCount++;
+                }
+            }
+            activeId = header.activeId;
+        } else {
+            Logger::warning("Zones: " + String(ZONE_FILE) + " ugyldig - starter uden zoner");
+        }
+        file.close();
+    }
+
+    // Planer beregnes kun igen hvis cachen mangler eller er fra en ældre revision
+    for (int i = 0; i < zoneCount; i++) {
+        if (!readPlan(zones[i], scratchPlan)) {
+            buildPlan(zones[i], scratchPlan);
+            writePlan(zones[i], scratchPlan);
+            LOGD(LOG_SUB_NAVIGATION, "Zone %d plan rebuilt (%d rows)", zones[i].id, scratchPlan.rowCount);
+        }
+        if (scratchPlan.truncated) {
+            Logger::warning("Zones: zone " + String(zones[i].id) + " har flere end " +
+                            String(ZONE_MAX_ROWS) + " segmenter - planen er afkortet");
+        }
+        planRows[i] = scratchPlan.rowCount;
+
+        if (zones[i].id == activeId) {
+            activePlan = scratchPlan;
+        }
+    }
+
+    if (findZone(activeId) < 0) {
+        activeId = 0;
+    }
+
+    initialized = true;
+
+    Logger::info("Zones loaded: " + String(zoneCount) + ", active: " + String(activeId));
+    return true;
+}
+
+uint8_t ZoneManager::saveZone(ZoneRecord& zone) {
+    saveError = "";
+    if (!initialized || !isValid(zone)) {
+        saveError = "invalid zone";
+        return 0;
+    }
+
+    int index = findZone(zone.id);
+    if (index >= 0) {
+        zone.revision = zones[index].revision + 1;
+    } else {
+        if (zoneCount >= ZONE_MAX_COUNT) {
+            Logger::warning("Zones: ingen plads til flere zoner");
+            saveError = "no room for more zones";
+            return 0;
+        }
+
+        // Første ledige id
+        uint8_t id = 1;
+        while (findZone(id) >= 0) {
+            id++;
+        }
+        zone.id = id;
+        zone.revision = 1;
+    }
+
+    // Navnet skrives direkte i JSON - tegn der kræver escaping erstattes
+    zone.name[ZONE_NAME_LEN - 1] = '\0';
+    for (char* c = zone.name; *c != '\0'; c++) {
+        if (*c == '"' || *c == '\\' || (uint8_t)*c < 0x20) {
+            *c = '_';
+        }
+    }
+    if (zone.name[0] == '\0') {
+        snprintf(zone.name, ZONE_NAME_LEN, "Zone %d", zone.id);
+    }
+
+    // Plan beregnes og gemmes før zonen - så er cachen aldrig ældre end zonen
+    if (!buildPlan(zone, scratchPlan)) {
+        Logger::warning("Zones: polygonen giver ingen rækker");
+        saveError = "zone gives no rows";
+        return 0;
+    }
+
+    // En afkortet plan klipper kun en del af zonen (spiral ud ville starte midt på plænen)
+    if (scratchPlan.truncated) {
+        Logger::warning("Zones: zonen giver flere end " + String(ZONE_MAX_ROWS) +
+                        " segmenter - brug bredere rækker eller del zonen");
+        saveError = "zone needs more than ZONE_MAX_ROWS segments - use wider rows or split the zone";
+        return 0;
+    }
+    writePlan(zone, scratchPlan);
+
+    bool first = zoneCount == 0;
+
+    portENTER_CRITICAL(&mux);
+    if (index < 0) {
+        index = zoneCount++;
+    }
+    zones[index] = zone;
+    planRows[index] = scratchPlan.rowCount;
+    if (first) {
+        activeId = zone.id;
+    }
+    if (zone.id == activeId) {
+        activePlan = scratchPlan;
+    }
+    portEXIT_CRITICAL(&mux);
+
+    writeZones();
+
+    Logger::info("Zone " + String(zone.id) + " (" + String(zone.name) + ") saved - " +
+                 String(scratchPlan.rowCount) + " rows");
+    return zone.id;
+}
+
+bool ZoneManager::deleteZone(uint8_t id) {
+    int index = findZone(id);
+    if (index < 0) {
+        return false;
+    }
+
+    LittleFS.remove(planPath(id));
+
+    portENTER_CRITICAL(&mux);
+    for (int i = index; i < zoneCount - 1; i++) {
+        zones[i] = zones[i + 1];
+        planRows[i] = planRows[i + 1];
+    }
+    zoneCount--;
+    if (activeId == id) {
+        activeId = 0;
+        activePlan.rowCount = 0;
+    }
+    portEXIT_CRITICAL(&mux);
+
+    writeZones();
+
+    Logger::info("Zone " + String(id) + " deleted");
+    return true;
+}
+
+bool ZoneManager::selectZone(uint8_t id) {
+    if (id == 0) {
+        portENTER_CRITICAL(&mux);
+        activeId = 0;
+        activePlan.rowCount = 0;
+        portEXIT_CRITICAL(&mux);
+
+        writeZones();
+        Logger::info("Zone deselected - using default pattern");
+        return true;
+    }
+
+    int index = findZone(id);
+    if (index < 0) {
+        return false;
+    }
+
+    if (!readPlan(zones[index], scratchPlan)) {
+        buildPlan(zones[index], scratchPlan);
+        writePlan(zones[index], scratchPlan);
+    }
+
+    portENTER_CRITICAL(&mux);
+    activeId = id;
+    activePlan = scratchPlan;
+    portEXIT_CRITICAL(&mux);
+
+    writeZones();
+
+    Logger::info("Zone " + String(id) + " (" + String(zones[index].name) + ") selected");
+    return true;
+}
+
+uint8_t ZoneManager::getActiveId() {
+    return activeId;
+}
+
+bool ZoneManager::getZone(uint8_t id, ZoneRecord& out) {
+    bool found = false;
+
+    portENTER_CRITICAL(&mux);
+    int index = findZone(id);
+    if (index >= 0) {
+        out = zones[index];
+        found = true;
+    }
+    portEXIT_CRITICAL(&mux);
+
+    return found;
+}
+
+bool ZoneManager::getActivePlan(ZonePlan& out) {
+    bool found = false;
+
+    portENTER_CRITICAL(&mux);
+    if (activeId != 0 && activePlan.rowCount > 0) {
+        out = activePlan;
+        found = true;
+    }
+    portEXIT_CRITICAL(&mux);
+
+    return found;
+}
+
+bool ZoneManager::getActiveZone(ZoneRecord& out) {
+    return activeId != 0 && getZone(activeId, out);
+}
+
+String ZoneManager::getZonesJSON() {
+    // Zoner ændres kun fra web task, så listen kan læses uden lås her
+    String json = "{\"active\":" + String(activeId);
+    json += ",\"maxZones\":" + String(ZONE_MAX_COUNT);
+    json += ",\"maxVertices\":" + String(ZONE_MAX_VERTICES);
+    json += ",\"zones\":[";
+
+    for (int i = 0; i < zoneCount; i++) {
+        const ZoneRecord& zone = zones[i];
+        if (i > 0) {
+            json += ",";
+        }
+        json += "{\"id\":" + String(zone.id);
+        json += ",\"name\":\"" + String(zone.name) + "\"";
+        json += ",\"pattern\":\"" + String(patternToString(zone.pattern)) + "\"";
+        json += ",\"angle\":" + String(zone.angle / 10.0, 1);
+        json += ",\"rowWidth\":" + String(zone.rowWidth);
+        json += ",\"laps\":" + String(zone.param);
+        json += ",\"revision\":" + String(zone.revision);
+        json += ",\"rows\":" + String(planRows[i]);
+        json += ",\"vertices\":[";
+        for (int v = 0; v < zone.vertexCount; v++) {
+            if (v > 0) {
+                json += ",";
+            }
+            json += "[" + String(zone.vertices[v][0]) + "," + String(zone.vertices[v][1]) + "]";
+        }
+        json += "]}";
+    }
+
+    json += "]}";
+    return json;
+}
+
+String ZoneManager::getPlanJSON(uint8_t id) {
+    int index = findZone(id);
+    if (index < 0 || !readPlan(zones[index], scratchPlan)) {
+        return "";
+    }
+
+    String json = "{\"zoneId\":" + String(id);
+    json += ",\"pattern\":\"" + String(patternToString(zones[index].pattern)) + "\"";
+    json += ",\"revision\":" + String(zones[index].revision);
+    json += ",\"maxRows\":" + String(ZONE_MAX_ROWS);
+    json += ",\"truncated\":" + String(scratchPlan.truncated ? "true" : "false");
+
+    // Wire mønstre har ingen geometri - kun afstand til kablet pr. omgang
+    if (MowPattern::forType(zones[index].pattern)->followsWire()) {
+        json += ",\"offsets\":[";
+        for (int i = 0; i < scratchPlan.rowCount; i++) {
+            if (i > 0) {
+                json += ",";
+            }
+            json += String(scratchPlan.rows[i].x0);
+        }
+        json += "]}";
+        return json;
+    }
+
+    float totalLength = 0.0;
+    json += ",\"rows\":[";
+
+    for (int i = 0; i < scratchPlan.rowCount; i++) {
+        const ZonePlanRow& row = scratchPlan.rows[i];
+        if (i > 0) {
+            json += ",";
+        }
+        json += "[" + String(row.x0) + "," + String(row.y0) + "," +
+                String(row.x1) + "," + String(row.y1) + "]";
+
+        float dx = row.x1 - row.x0;
+        float dy = row.y1 - row.y0;
+        totalLength += sqrt(dx * dx + dy * dy);
+    }
+
+    json += "],\"length\":" + String(totalLength, 0) + "}";
+    return json;
+}
+
+const char* ZoneManager::patternToString(uint8_t pattern) {
+    const MowPattern* impl = MowPattern::forType(pattern);
+    return impl != nullptr ? impl->getName() : "unknown";
+}
+
+bool ZoneManager::patternFromString(const String& name, uint8_t& pattern) {
+    for (int i = 0; i < ZONE_PATTERN_COUNT; i++) {
+        if (name.equalsIgnoreCase(MowPattern::forType(i)->getName())) {
+            pattern = (uint8_t)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ZoneManager::isValid(const ZoneRecord& zone) {
+    const MowPattern* impl = MowPattern::forType(zone.pattern);
+    if (impl == nullptr) {
+        return false;
+    }
+
+    bool polygonOk = impl->needsPolygon() ? zone.vertexCount >= 3 : true;
+    return polygonOk && zone.vertexCount <= ZONE_MAX_VERTICES &&
+           zone.rowWidth >= ZONE_MIN_ROW_WIDTH && zone.rowWidth <= ZONE_MAX_ROW_WIDTH &&
+           zone.angle >= 0 && zone.angle < 3600;
+}
+
+bool ZoneManager::buildPlan(const ZoneRecord& zone, ZonePlan& plan) {
+    plan.zoneId = zone.id;
+    plan.pattern = zone.pattern;
+    plan.rowCount = 0;
+    plan.truncated = false;
+
+    if (!isValid(zone)) {
+        return false;
+    }
+
+    return MowPattern::forType(zone.pattern)->buildPlan(zone, plan);
+}
+
+int ZoneManager::findZone(uint8_t id) {
+    if (id == 0) {
+        return -1;
+    }
+    for (int i = 0; i < zoneCount; i++) {
+        if (zones[i].id == id) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool ZoneManager::writeZones() {
+    // Skriv til temp fil og omdøb, så et strømsvigt ikke efterlader en halv fil
+    String tempPath = String(ZONE_FILE) + ".tmp";
+    File file = LittleFS.open(tempPath, "w");
+    if (!file) {
+        Logger::error("Zones: kunne ikke skrive " + tempPath);
+        return false;
+    }
+
+    ZoneFileHeader header;
+    header.magic = ZONE_MAGIC;
+    header.version = ZONE_FILE_VERSION;
+    header.count = zoneCount;
+    header.activeId = activeId;
+    header.reserved = 0;
+
+    size_t expected = sizeof(header) + zoneCount * sizeof(ZoneRecord);
+    size_t written = file.write((const uint8_t*)&header, sizeof(header));
+    written += file.write((const uint8_t*)zones, zoneCount * sizeof(ZoneRecord));
+    file.close();
+
+    if (written != expected) {
+        Logger::error("Zones: skrivning af " + String(ZONE_FILE) + " fejlede");
+        LittleFS.remove(tempPath);
+        return false;
+    }
+
+    LittleFS.remove(ZONE_FILE);
+    return LittleFS.rename(tempPath, ZONE_FILE);
+}
+
+bool ZoneManager::writePlan(const ZoneRecord& zone, const ZonePlan& plan) {
+    File file = LittleFS.open(planPath(zone.id), "w");
+    if (!file) {
+        Logger::error("Zones: kunne ikke skrive plan for zone " + String(zone.id));
+        return false;
+    }
+
+    ZonePlanHeader header;
+    header.magic = ZONE_PLAN_MAGIC;
+    header.version = ZONE_FILE_VERSION;
+    header.zoneId = zone.id;
+    header.revision = zone.revision;
+    header.rowCount = plan.rowCount;
+    header.flags = plan.truncated ? ZONE_PLAN_TRUNCATED : 0;
+
+    file.write((const uint8_t*)&header, sizeof(header));
+    file.write((const uint8_t*)plan.rows, plan.rowCount * sizeof(ZonePlanRow));
+    file.close();
+    return true;
+}
+
+bool ZoneManager::readPlan(const ZoneRecord& zone, ZonePlan& plan) {
+    plan.zoneId = zone.id;
+    plan.pattern = zone.pattern;
+    plan.rowCount = 0;
+    plan.truncated = false;
+
+    File file = LittleFS.open(planPath(zone.id), "r");
+    if (!file) {
+        return false;
+    }
+
+    ZonePlanHeader header;
+    bool valid = file.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+                 header.magic == ZONE_PLAN_MAGIC && header.version == ZONE_FILE_VERSION &&
+                 header.zoneId == zone.id && header.revision == zone.revision &&
+                 header.rowCount > 0 && header.rowCount <= ZONE_MAX_ROWS;
+
+    if (valid) {
+        size_t size = header.rowCount * sizeof(ZonePlanRow);
+        valid = file.read((uint8_t*)plan.rows, size) == size;
+    }
+    file.close();
+
+    if (!valid) {
+        return false;
+    }
+
+    plan.rowCount = header.rowCount;
+    plan.truncated = (header.flags & ZONE_PLAN_TRUNCATED) != 0;
+    return true;
+}
+
+String ZoneManager::planPath(uint8_t id) {
+    return String(ZONE_PLAN_PREFIX) + String(id) + ".bin";
+}
@@ -0,0 +1,250 @@
+#ifndef ZONE_MANAGER_H
+#define ZONE_MANAGER_H
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include "../config/Config.h"
+#include "../system/Logger.h"
+
+/**
+ * ZoneManager - Flere plæner (zoner) med eget klipningsmønster
+ *
+ * Hver zone er en polygon i robottens dead reckoning koordinater (cm,
+ * x mod øst, y mod nord, origo i zonens start hjørne) plus mønster
+ * parametre: kørselsvinkel, række bredde og mønster type.
+ *
+ * Zonerne gemmes som faste binære records i ZONE_FILE. For hver zone
+ * beregnes planen (liste af række segmenter) når zonen gemmes og
+ * caches i ZONE_PLAN_PREFIX<id>.bin, så start af klipning kun læser
+ * den aktive plan fra RAM. Planens header bærer zonens revision - ved opstart
+ * genberegnes kun planer der ikke passer til zonen.
+ *
+ * Filformat:
+ *   ZONE_FILE      = ZoneFileHeader + count x ZoneRecord
+ *   plan fil       = ZonePlanHeader + rowCount x ZonePlanRow
+ *
+ * Redigering sker fra web handlers (AsyncTCP task). Filer og plan
+ * beregning foregår udenfor låsen; kun kopiering til/fra RAM er
+ * beskyttet, så loop'et aldrig venter på flash.
+ */
+
+// Mønster typer (se MowPattern.h) - værdierne gemmes i flash
+enum ZonePattern : uint8_t {
+    ZONE_PATTERN_PARALLEL = 0,  // Parallelle rækker frem og tilbage
+    ZONE_PATTERN_SPIRAL_IN,     // Spiral fra kanten og ind
+    ZONE_PATTERN_SPIRAL_OUT,    // Spiral fra midten og ud
+    ZONE_PATTERN_PERIMETER,     // Omgange langs kablet med stigende afstand
+    ZONE_PATTERN_COUNT
+};
+
+#define ZONE_MAGIC                  0x454E4F5A  // "ZONE" little-endian
+#define ZONE_PLAN_MAGIC             0x4E414C50  // "PLAN" little-endian
+#define ZONE_FILE_VERSION           1
+#define ZONE_NAME_LEN               16
+#define ZONE_PLAN_TRUNCATED         0x0001      // Plan flag: zonen gav flere end ZONE_MAX_ROWS segmenter
+
+// Zone record (92 bytes, little-endian)
+struct __attribute__((packed)) ZoneRecord {
+    uint8_t id;                 // 1-255 (0 = tom)
+    uint8_t pattern;            // ZonePattern
+    uint8_t vertexCount;        // Antal hjørner i polygonen
+    uint8_t flags;              // Reserveret
+    uint16_t revision;          // Tælles op ved hver ændring (plan cache nøgle)
+    int16_t angle;              // Kørselsvinkel (0.1 grader, kompas)
+    uint16_t rowWidth;          // Afstand mellem rækker (cm)
+    uint16_t param;             // Mønster parameter (perimeter: antal omgange, 0 = max)
+    char name[ZONE_NAME_LEN];   // Nul-termineret navn
+    int16_t vertices[ZONE_MAX_VERTICES][2]; // Polygon hjørner (x, y i cm)
+};
+
+// Zone fil header (8 bytes)
+struct __attribute__((packed)) ZoneFileHeader {
+    uint32_t magic;             // ZONE_MAGIC
+    uint8_t version;            // ZONE_FILE_VERSION
+    uint8_t count;              // Antal zone records efter header
+    uint8_t activeId;           // Aktiv zone (0 = ingen)
+    uint8_t reserved;
+};
+
+// Række segment i en plan (8 bytes) - wire mønstre: x0 = afstand til kablet (cm)
+struct __attribute__((packed)) ZonePlanRow {
+    int16_t x0;                 // Start (cm)
+    int16_t y0;
+    int16_t x1;                 // Slut (cm)
+    int16_t y1;
+};
+
+// Plan fil header (12 bytes)
+struct __attribute__((packed)) ZonePlanHeader {
+    uint32_t magic;             // ZONE_PLAN_MAGIC
+    uint8_t version;            // ZONE_FILE_VERSION
+    uint8_t zoneId;             // Zonen planen hører til
+    uint16_t revision;          // Zonens revision ved beregning
+    uint16_t rowCount;          // Antal segmenter efter header
+    uint16_t flags;             // ZONE_PLAN_TRUNCATED
+};
+
+static_assert(sizeof(ZoneRecord) == 28 + ZONE_MAX_VERTICES * 4, "ZoneRecord layout ændret");
+static_assert(sizeof(ZoneFileHeader) == 8, "ZoneFileHeader skal være 8 bytes");
+static_assert(sizeof(ZonePlanRow) == 8, "ZonePlanRow skal være 8 bytes");
+static_assert(sizeof(ZonePlanHeader) == 12, "ZonePlanHeader skal være 12 bytes");
+
+/**
+ * Færdig plan for én zone - segmenter køres i rækkefølge
+ */
+struct ZonePlan {
+    uint8_t zoneId;
+    uint8_t pattern;            // ZonePattern
+    uint16_t rowCount;
+    bool truncated;             // Segmenter ud over ZONE_MAX_ROWS er udeladt
+    ZonePlanRow rows[ZONE_MAX_ROWS];
+};
+
+class ZoneManager {
+public:
+    /**
+     * Constructor
+     */
+    ZoneManager();
+
+    /**
+     * Indlæs zoner fra flash og genberegn planer der ikke er aktuelle
+     * @return true hvis succesfuld, false ved fejl
+     */
+    bool begin();
+
+    /**
+     * Gem zone (ny hvis id er 0 eller ukendt) og beregn dens plan
+     * @param zone Zone data - id, revision og navn udfyldes ved gem
+     * @return Zone id, eller 0 hvis zonen er ugyldig, ikke passer i en plan
+     *         eller der ikke er plads (årsag: getSaveError())
+     */
+    uint8_t saveZone(ZoneRecord& zone);
+
+    /**
+     * Årsag til at seneste saveZone() fejlede
+     * @return Kort tekst til API svar ("" hvis gemt)
+     */
+    const char* getSaveError() const { return saveError; }
+
+    /**
+     * Slet zone og dens plan
+     * @param id Zone id
+     * @return false hvis zonen ikke findes
+     */
+    bool deleteZone(uint8_t id);
+
+    /**
+     * Vælg aktiv zone (bruges ved næste start af klipning)
+     * @param id Zone id (0 = ingen zone, klassisk mønster)
+     * @return false hvis zonen ikke findes
+     */
+    bool selectZone(uint8_t id);
+
+    /**
+     * Hent aktiv zone id
+     * @return Zone id (0 = ingen)
+     */
+    uint8_t getActiveId();
+
+    /**
+     * Kopiér zone record
+     * @param id Zone id
+     * @param out Modtager zonen
+     * @return false hvis zonen ikke findes
+     */
+    bool getZone(uint8_t id, ZoneRecord& out);
+
+    /**
+     * Kopiér aktiv zones plan (kaldes ved start af klipning)
+     * @param out Modtager planen
+     * @return false hvis ingen zone er aktiv
+     */
+    bool getActivePlan(ZonePlan& out);
+
+    /**
+     * Kopiér aktiv zone record
+     * @param out Modtager zonen
+     * @return false hvis ingen zone er aktiv
+     */
+    bool getActiveZone(ZoneRecord& out);
+
+    /**
+     * Opret JSON med alle zoner
+     * @return JSON string
+     */
+    String getZonesJSON();
+
+    /**
+     * Opret JSON med en zones cachede plan
+     * @param id Zone id
+     * @return JSON string (tom hvis zonen ikke findes)
+     */
+    String getPlanJSON(uint8_t id);
+
+    /**
+     * Konverter mønster type til tekst
+     */
+    static const char* patternToString(uint8_t pattern);
+
+    /**
+     * Konverter tekst til mønster type
+     * @return false hvis ukendt
+     */
+    static bool patternFromString(const String& name, uint8_t& pattern);
+
+    /**
+     * Valider zone parametre (polygon hvis mønsteret kræver det, række bredde, mønster)
+     * @return true hvis zonen kan planlægges
+     */
+    static bool isValid(const ZoneRecord& zone);
+
+    /**
+     * Beregn plan for zone - ren funktion uden flash adgang
+     * @param zone Zone
+     * @param plan Modtager segmenterne
+     * @return false hvis polygonen ikke giver nogen rækker
+     */
+    static bool buildPlan(const ZoneRecord& zone, ZonePlan& plan);
+
+private:
+    /**
+     * Find zone index
+     * @return Index i zones, eller -1
+     */
+    int findZone(uint8_t id);
+
+    /**
+     * Skriv alle zoner til flash (via temp fil)
+     */
+    bool writeZones();
+
+    /**
+     * Skriv plan cache for zone
+     */
+    bool writePlan(const ZoneRecord& zone, const ZonePlan& plan);
+
+    /**
+     * Læs plan cache - fejler hvis den ikke passer til zonens revision
+     */
+    bool readPlan(const ZoneRecord& zone, ZonePlan& plan);
+
+    /**
+     * Filnavn for zonens plan
+     */
+    static String planPath(uint8_t id);
+
+    ZoneRecord zones[ZONE_MAX_COUNT];
+    uint16_t planRows[ZONE_MAX_COUNT];  // Segmenter i hver zones plan
+    uint8_t zoneCount;
+    uint8_t activeId;
+
+    ZonePlan activePlan;        // Aktiv zones plan i RAM
+    ZonePlan scratchPlan;       // Arbejdsbuffer til beregning (holder stakken lille)
+    const char* saveError;
+
+    portMUX_TYPE mux;
+    bool initialized;
+};
+
+#endif // ZONE_MANAGER_H
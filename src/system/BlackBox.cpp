@@ -0,0 +1,460 @@
+#include "BlackBox.h"
+#include <Preferences.h>
+
+BlackBox::BlackBox()
+    : _initialized(false),
+      _frozen(false),
+      _freezePending(false),
+      _freezeAt(0),
+      _fillPage(0),
+      _fillCount(0),
+      _writePage(0),
+      _mux(portMUX_INITIALIZER_UNLOCKED),
+      _pageSequence(0),
+      _segment(-1),
+      _segmentPages(0),
+      _bootCount(0),
+      _rotateRequested(false),
+      _clearRequested(false),
+      _sequence(0),
+      _recordCount(0),
+      _droppedCount(0),
+      _pagesWritten(0),
+      _task(nullptr) {
+    memset(_pages, 0, sizeof(_pages));
+    memset((void*)_pageReady, 0, sizeof(_pageReady));
+}
+
+bool BlackBox::begin() {
+    Logger::info("Initialiserer black box...");
+
+    if (!LittleFS.begin(true)) {
+        Logger::error("Black box: LittleFS mount fejlede");
+        return false;
+    }
+
+    // Boot tæller og freeze markør ligger i NVS
+    Preferences prefs;
+    prefs.begin("blackbox", false);
+    _bootCount = prefs.getUShort("boots", 0) + 1;
+    prefs.putUShort("boots", _bootCount);
+    bool wasFrozen = prefs.getBool("frozen", false);
+    prefs.end();
+
+    // Frossen ring fra sidste opstart gemmes før den overskrives
+    if (wasFrozen && LittleFS.exists(BLACKBOX_DIR)) {
+        rotateToErrorDump();
+        writeMarker(false);
+        Logger::warning("Black box: fejl-dump fra sidste opstart gemt i " +
+                        String(BLACKBOX_ERROR_DIR));
+    }
+
+    resumeRingPosition();
+
+    if (!openRing()) {
+        Logger::error("Black box: kunne ikke åbne " + String(BLACKBOX_DIR));
+        return false;
+    }
+
+    BaseType_t result = xTaskCreatePinnedToCore(
+        writerTask,
+        "blackbox",
+        4096,
+        this,
+        BLACKBOX_TASK_PRIORITY,
+        &_task,
+        BLACKBOX_TASK_CORE
+    );
+
+    if (result != pdPASS) {
+        Logger::error("Black box: writer task kunne ikke startes");
+        _file.close();
+        return false;
+    }
+
+    _initialized = true;
+
+    Logger::info("Black box klar (boot #" + String(_bootCount) + ", " +
+                 String(BLACKBOX_PAGES * BLACKBOX_PAGE_SIZE / 1024) + "KB ring)");
+    return true;
+}
+
+void BlackBox::update() {
+    if (!_initialized || !_freezePending) {
+        return;
+    }
+
+    if ((long)(millis() - _freezeAt) >= 0) {
+        // Skriv den delvist fyldte side så sidste records kommer med
+        portENTER_CRITICAL(&_mux);
+        _freezePending = false;
+        if (_fillCount > 0 && !_pageReady[_fillPage]) {
+            sealCurrentPage();
+        }
+        _frozen = true;
+        portEXIT_CRITICAL(&_mux);
+
+        xTaskNotifyGive(_task);
+        Logger::warning("Black box frosset");
+    }
+}
+
+void BlackBox::recordTelemetry(const BlackBoxTelemetry& t) {
+    BlackBoxRecord rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.type = BB_REC_TELEMETRY;
+    rec.state = t.state;
+
+    rec.telemetry.heading = (int16_t)(t.heading * 10.0f);
+    rec.telemetry.pitch = (int16_t)(t.pitch * 10.0f);
+    rec.telemetry.roll = (int16_t)(t.roll * 10.0f);
+    rec.telemetry.batteryMV = (uint16_t)constrain(t.batteryVoltage * 1000.0f, 0.0f, 65535.0f);
+    rec.telemetry.motorLeft = t.motorLeft;
+    rec.telemetry.motorRight = t.motorRight;
+    rec.telemetry.currentLeft = (uint16_t)constrain(t.currentLeft * 100.0f, 0.0f, 65535.0f);
+    rec.telemetry.currentRight = (uint16_t)constrain(t.currentRight * 100.0f, 0.0f, 65535.0f);
+    rec.telemetry.sonarLeft = (uint16_t)constrain(t.sonarLeft * 10.0f, 0.0f, 65535.0f);
+    rec.telemetry.sonarMiddle = (uint16_t)constrain(t.sonarMiddle * 10.0f, 0.0f, 65535.0f);
+    rec.telemetry.sonarRight = (uint16_t)constrain(t.sonarRight * 10.0f, 0.0f, 65535.0f);
+    rec.telemetry.perimeterStrength = t.perimeterStrength;
+    rec.telemetry.perimeterState = t.perimeterState;
+
+    appendRecord(rec);
+}
+
+void BlackBox::recordLog(LogLevel level, LogSubsystem sub, const char* message) {
+    BlackBoxRecord rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.type = BB_REC_LOG;
+    rec.state = 0xFF;  // Ukendt - Logger kender ikke robot state
+    rec.log.level = (uint8_t)level;
+    rec.log.subsystem = (uint8_t)sub;
+    copyText(rec.log.text, message);
+
+    appendRecord(rec);
+}
+
+void BlackBox::recordStateChange(uint8_t fromState, uint8_t toState, const char* message) {
+    BlackBoxRecord rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.type = BB_REC_STATE;
+    rec.state = toState;
+    rec.stateChange.fromState = fromState;
+    rec.stateChange.toState = toState;
+    copyText(rec.stateChange.text, message);
+
+    appendRecord(rec);
+}
+
+void BlackBox::freeze(const char* reason) {
+    if (!_initialized || _frozen || _freezePending) {
+        return;
+    }
+
+    _freezeAt = millis() + BLACKBOX_POST_TRIGGER_MS;
+    _freezePending = true;
+
+    Logger::warning("Black box freeze om " + String(BLACKBOX_POST_TRIGGER_MS) +
+                    "ms: " + String(reason));
+}
+
+void BlackBox::resume() {
+    if (!_initialized) {
+        return;
+    }
+
+    _freezePending = false;
+    if (!_frozen) {
+        return;
+    }
+
+    // Writer task flytter ringen til fejl-dump og starter en ny
+    _rotateRequested = true;
+    xTaskNotifyGive(_task);
+    Logger::info("Black box genoptaget - fejl-dump gemt");
+}
+
+void BlackBox::clear() {
+    if (!_initialized) {
+        return;
+    }
+
+    _clearRequested = true;
+    xTaskNotifyGive(_task);
+    Logger::info("Black box ryddet");
+}
+
+bool BlackBox::hasErrorDump() {
+    return LittleFS.exists(BLACKBOX_ERROR_DIR);
+}
+
+String BlackBox::getStatusJSON() {
+    String json = "{";
+    json += "\"enabled\":" + String(_initialized ? "true" : "false") + ",";
+    json += "\"recording\":" + String(isRecording() ? "true" : "false") + ",";
+    json += "\"frozen\":" + String(_frozen ? "true" : "false") + ",";
+    json += "\"freezePending\":" + String(_freezePending ? "true" : "false") + ",";
+    json += "\"bootCount\":" + String(_bootCount) + ",";
+    json += "\"records\":" + String(_recordCount) + ",";
+    json += "\"dropped\":" + String(_droppedCount) + ",";
+    json += "\"pagesWritten\":" + String(_pagesWritten) + ",";
+    json += "\"ringPages\":" + String(BLACKBOX_PAGES) + ",";
+    json += "\"segments\":" + String(BLACKBOX_SEGMENTS) + ",";
+    json += "\"segment\":" + String(_segment) + ",";
+    json += "\"pageSize\":" + String(BLACKBOX_PAGE_SIZE) + ",";
+    json += "\"errorDump\":" + String(hasErrorDump() ? "true" : "false");
+    json += "}";
+    return json;
+}
+
+size_t BlackBox::readRing(const char* dir, size_t offset, uint8_t* buffer, size_t maxLen) {
+    // Find segmentet offset ligger i - rækkefølgen er ligegyldig for dekoderen
+    for (int i = 0; i < BLACKBOX_SEGMENTS; i++) {
+        String path = segmentPath(dir, i);
+        if (!LittleFS.exists(path)) {
+            continue;
+        }
+
+        File segment = LittleFS.open(path, "r");
+        if (!segment) {
+            continue;
+        }
+
+        // Kun hele sider - det aktive segment kan vokse under download
+        size_t size = segment.size() - (segment.size() % BLACKBOX_PAGE_SIZE);
+        if (offset < size) {
+            segment.seek(offset);
+            size_t count = segment.read(buffer, min(maxLen, size - offset));
+            segment.close();
+            return count;
+        }
+
+        offset -= size;
+        segment.close();
+    }
+
+    return 0;
+}
+
+// ============================================================================
+// PRIVATE METODER
+// ============================================================================
+
+void BlackBox::appendRecord(BlackBoxRecord& rec) {
+    if (!_initialized) {
+        return;
+    }
+
+    bool pageSealed = false;
+
+    // Kan kaldes fra både loop og AsyncTCP task - kort kritisk sektion
+    portENTER_CRITICAL(&_mux);
+    if (_frozen) {
+        portEXIT_CRITICAL(&_mux);
+        return;
+    }
+
+    if (_pageReady[_fillPage]) {
+        // Writer task er bagud - siden er endnu ikke skrevet
+        _droppedCount++;
+        portEXIT_CRITICAL(&_mux);
+        return;
+    }
+
+    rec.timestamp = millis();
+    rec.sequence = _sequence++;
+
+    uint8_t* dest = _pages[_fillPage] + sizeof(BlackBoxPageHeader) +
+                    _fillCount * BLACKBOX_RECORD_SIZE;
+    memcpy(dest, &rec, BLACKBOX_RECORD_SIZE);
+    _fillCount++;
+    _recordCount++;
+
+    if (_fillCount >= BLACKBOX_RECORDS_PER_PAGE) {
+        sealCurrentPage();
+        pageSealed = true;
+    }
+    portEXIT_CRITICAL(&_mux);
+
+    if (pageSealed && _task != nullptr) {
+        xTaskNotifyGive(_task);
+    }
+}
+
+void BlackBox::sealCurrentPage() {
+    // Kaldes med _mux låst
+    BlackBoxPageHeader* header = (BlackBoxPageHeader*)_pages[_fillPage];
+    header->magic = BLACKBOX_MAGIC;
+    header->pageSequence = _pageSequence++;
+    header->bootCount = _bootCount;
+    header->recordCount = _fillCount;
+    header->version = BLACKBOX_VERSION;
+    header->reserved = 0;
+
+    // Nul resten så gamle records ikke læses som gyldige
+    size_t used = sizeof(BlackBoxPageHeader) + _fillCount * BLACKBOX_RECORD_SIZE;
+    memset(_pages[_fillPage] + used, 0, BLACKBOX_PAGE_SIZE - used);
+
+    _pageReady[_fillPage] = 1;
+    _fillPage = (_fillPage + 1) % RAM_PAGES;
+    _fillCount = 0;
+}
+
+bool BlackBox::openRing() {
+    if (!LittleFS.exists(BLACKBOX_DIR) && !LittleFS.mkdir(BLACKBOX_DIR)) {
+        return false;
+    }
+
+    // Altid et nyt segment - et delvist skrevet segment fortsættes ikke
+    return openNextSegment();
+}
+
+bool BlackBox::openNextSegment() {
+    if (_file) {
+        _file.close();
+    }
+
+    _segment = (_segment + 1) % BLACKBOX_SEGMENTS;
+    _segmentPages = 0;
+
+    // Ældste segment slettes helt - aldrig overskrevet på stedet
+    String path = segmentPath(BLACKBOX_DIR, _segment);
+    LittleFS.remove(path);
+    _file = LittleFS.open(path, "w");
+    return (bool)_file;
+}
+
+void BlackBox::rotateToErrorDump() {
+    if (_file) {
+        _file.close();
+    }
+
+    removeRing(BLACKBOX_ERROR_DIR);
+    LittleFS.rename(BLACKBOX_DIR, BLACKBOX_ERROR_DIR);
+}
+
+void BlackBox::writeMarker(bool frozen) {
+    Preferences prefs;
+    prefs.begin("blackbox", false);
+    prefs.putBool("frozen", frozen);
+    prefs.end();
+}
+
+void BlackBox::resumeRingPosition() {
+    // Fortsæt efter segmentet med højeste sidesekvens (sidste side i hver fil)
+    BlackBoxPageHeader header;
+    uint32_t bestSequence = 0;
+    bool found = false;
+    _segment = -1;
+
+    for (int i = 0; i < BLACKBOX_SEGMENTS; i++) {
+        File segment = LittleFS.open(segmentPath(BLACKBOX_DIR, i), "r");
+        if (!segment || segment.size() < BLACKBOX_PAGE_SIZE) {
+            continue;
+        }
+
+        size_t last = (segment.size() / BLACKBOX_PAGE_SIZE - 1) * BLACKBOX_PAGE_SIZE;
+        segment.seek(last);
+        if (segment.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+            header.magic == BLACKBOX_MAGIC &&
+            (!found || header.pageSequence > bestSequence)) {
+            bestSequence = header.pageSequence;
+            _segment = i;
+            found = true;
+        }
+        segment.close();
+    }
+
+    _pageSequence = found ? bestSequence + 1 : 0;
+}
+
+String BlackBox::segmentPath(const char* dir, int segment) {
+    return String(dir) + "/" + String(segment) + ".bin";
+}
+
+void BlackBox::removeRing(const char* dir) {
+    for (int i = 0; i < BLACKBOX_SEGMENTS; i++) {
+        LittleFS.remove(segmentPath(dir, i));
+    }
+    LittleFS.rmdir(dir);
+}
+
+void BlackBox::writerTask(void* arg) {
+    static_cast<BlackBox*>(arg)->writerLoop();
+}
+
+void BlackBox::writerLoop() {
+    bool markerWritten = false;
+
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000));
+
+        if (_clearRequested || _rotateRequested) {
+            bool rotate = _rotateRequested;
+
+            // Kassér sider der venter - de hører til den gamle ring
+            portENTER_CRITICAL(&_mux);
+            for (int i = 0; i < RAM_PAGES; i++) {
+                _pageReady[i] = 0;
+            }
+            _fillPage = 0;
+            _fillCount = 0;
+            _writePage = 0;
+            portEXIT_CRITICAL(&_mux);
+
+            if (rotate) {
+                rotateToErrorDump();
+            } else {
+                _file.close();
+                removeRing(BLACKBOX_DIR);
+                removeRing(BLACKBOX_ERROR_DIR);
+            }
+
+            _segment = -1;
+            if (!openRing()) {
+                Logger::error("Black box: kunne ikke genskabe ring");
+            }
+
+            writeMarker(false);
+            markerWritten = false;
+            _clearRequested = false;
+            _rotateRequested = false;
+            _frozen = false;
+        }
+
+        // Skriv færdige sider til flash
+        while (_pageReady[_writePage]) {
+            if (_segmentPages >= BLACKBOX_SEGMENT_PAGES) {
+                openNextSegment();
+            }
+
+            if (_file) {
+                // Kun append - LittleFS skal ikke kopiere eksisterende data
+                _file.write(_pages[_writePage], BLACKBOX_PAGE_SIZE);
+                _file.flush();
+                _segmentPages++;
+                _pagesWritten++;
+            }
+
+            portENTER_CRITICAL(&_mux);
+            _pageReady[_writePage] = 0;
+            portEXIT_CRITICAL(&_mux);
+            _writePage = (_writePage + 1) % RAM_PAGES;
+        }
+
+        // Marker frossen ring så den gemmes ved næste opstart
+        if (_frozen && !markerWritten) {
+            writeMarker(true);
+            markerWritten = true;
+        }
+    }
+}
+
+void BlackBox::copyText(char* dest, const char* src) {
+    if (src == nullptr) {
+        dest[0] = '\0';
+        return;
+    }
+    strncpy(dest, src, BLACKBOX_TEXT_LEN - 1);
+    dest[BLACKBOX_TEXT_LEN - 1] = '\0';
+}
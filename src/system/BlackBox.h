@@ -0,0 +1,270 @@
+#ifndef BLACKBOX_H
+#define BLACKBOX_H
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include "../config/Config.h"
+#include "Logger.h"
+
+/**
+ * BlackBox - Flash-baseret "flight recorder" til fejlanalyse
+ *
+ * Optager kompakte binære telemetri-, log- og state records i en
+ * cirkulær ring af segment filer på LittleFS. Records samles i RAM sider
+ * (512 bytes) og skrives af en separat lav-prioritets FreeRTOS task.
+ * Det holder filsystemet ude af loop, men ikke flash: mens en blok slettes
+ * eller skrives er cachen slået fra på begge kerner, så loop på core 1
+ * står stille indtil operationen er færdig (typisk 20-50 ms pr. 4KB sletning).
+ *
+ * Segmenterne skrives kun i forlængelse (append) - LittleFS er
+ * copy-on-write, så seek og overskrivning midt i en fil ville kopiere
+ * resten af filen og slette blokke ved hver side. Når et segment er fuldt
+ * slettes det ældste (unlink) og et nyt oprettes i dets plads.
+ *
+ * Ved STATE_ERROR optages der videre i BLACKBOX_POST_TRIGGER_MS og
+ * derefter fryses optagelsen. Ved næste opstart (eller recoverFromError)
+ * omdøbes den frosne ring til BLACKBOX_ERROR_DIR så den overlever.
+ *
+ * Filformat (se tools/blackbox_decode.py):
+ *   Ring = BLACKBOX_SEGMENTS filer "<dir>/<n>.bin" à op til BLACKBOX_SEGMENT_PAGES sider
+ *   Side = BlackBoxPageHeader + op til BLACKBOX_RECORDS_PER_PAGE records
+ *   Download sender segmenterne efter hinanden - dekoderen sorterer siderne
+ */
+
+// Record typer
+enum BlackBoxRecordType : uint8_t {
+    BB_REC_EMPTY = 0,
+    BB_REC_TELEMETRY = 1,   // Periodisk sensor/motor snapshot
+    BB_REC_LOG = 2,         // Log besked (trunkeret)
+    BB_REC_STATE = 3        // State skift (med fejlbesked ved ERROR)
+};
+
+#define BLACKBOX_PAGE_SIZE          512
+#define BLACKBOX_RECORD_SIZE        32
+#define BLACKBOX_MAGIC              0x5842424D  // "MBBX" little-endian
+#define BLACKBOX_VERSION            1
+#define BLACKBOX_TEXT_LEN           22
+
+/**
+ * Telemetri snapshot - fyldes af main.cpp og pakkes til en record
+ */
+struct BlackBoxTelemetry {
+    uint8_t state;              // RobotState
+    float heading;              // Grader
+    float pitch;                // Grader
+    float roll;                 // Grader
+    float batteryVoltage;       // Volt
+    int16_t motorLeft;          // PWM (-255..255)
+    int16_t motorRight;         // PWM (-255..255)
+    float currentLeft;          // Ampere
+    float currentRight;         // Ampere
+    float sonarLeft;            // cm
+    float sonarMiddle;          // cm
+    float sonarRight;           // cm
+    uint8_t perimeterStrength;  // 0-100%
+    uint8_t perimeterState;     // PerimeterState
+};
+
+// Binær record (32 bytes, little-endian)
+struct __attribute__((packed)) BlackBoxRecord {
+    uint32_t timestamp;         // millis()
+    uint8_t type;               // BlackBoxRecordType
+    uint8_t state;              // RobotState ved optagelse
+    uint16_t sequence;          // Løbenummer (wrap)
+    union {
+        struct __attribute__((packed)) {
+            int16_t heading;        // Grader * 10
+            int16_t pitch;          // Grader * 10
+            int16_t roll;           // Grader * 10
+            uint16_t batteryMV;     // Millivolt
+            int16_t motorLeft;
+            int16_t motorRight;
+            uint16_t currentLeft;   // Centi-ampere
+            uint16_t currentRight;  // Centi-ampere
+            uint16_t sonarLeft;     // Millimeter
+            uint16_t sonarMiddle;
+            uint16_t sonarRight;
+            uint8_t perimeterStrength;
+            uint8_t perimeterState;
+        } telemetry;
+        struct __attribute__((packed)) {
+            uint8_t level;          // LogLevel
+            uint8_t subsystem;      // LogSubsystem
+            char text[BLACKBOX_TEXT_LEN];
+        } log;
+        struct __attribute__((packed)) {
+            uint8_t fromState;
+            uint8_t toState;
+            char text[BLACKBOX_TEXT_LEN];
+        } stateChange;
+        uint8_t raw[24];
+    };
+};
+
+// Side header (16 bytes)
+struct __attribute__((packed)) BlackBoxPageHeader {
+    uint32_t magic;             // BLACKBOX_MAGIC
+    uint32_t pageSequence;      // Monotont stigende - bruges til at finde ældste side
+    uint16_t bootCount;         // Antal opstarter (fra NVS)
+    uint8_t recordCount;        // Gyldige records i siden
+    uint8_t version;            // BLACKBOX_VERSION
+    uint32_t reserved;
+};
+
+static_assert(sizeof(BlackBoxRecord) == BLACKBOX_RECORD_SIZE, "BlackBoxRecord skal være 32 bytes");
+static_assert(sizeof(BlackBoxPageHeader) == 16, "BlackBoxPageHeader skal være 16 bytes");
+
+#define BLACKBOX_RECORDS_PER_PAGE \
+    ((BLACKBOX_PAGE_SIZE - sizeof(BlackBoxPageHeader)) / BLACKBOX_RECORD_SIZE)
+
+class BlackBox {
+public:
+    BlackBox();
+
+    /**
+     * Initialiserer black box og starter writer task
+     * Flytter en frossen ring fra sidste opstart til fejl-dump filen
+     * @return true hvis initialisering lykkedes
+     */
+    bool begin();
+
+    /**
+     * Opdaterer freeze timing (kaldes i loop)
+     */
+    void update();
+
+    /**
+     * Optager telemetri snapshot
+     * @param t Telemetri data
+     */
+    void recordTelemetry(const BlackBoxTelemetry& t);
+
+    /**
+     * Optager log besked (kaldes fra Logger - også fra web tasks)
+     * @param level Log niveau
+     * @param sub Subsystem
+     * @param message Besked (trunkeres)
+     */
+    void recordLog(LogLevel level, LogSubsystem sub, const char* message);
+
+    /**
+     * Optager state skift
+     * @param fromState Forrige RobotState
+     * @param toState Ny RobotState
+     * @param message Ekstra tekst (f.eks. fejlbesked)
+     */
+    void recordStateChange(uint8_t fromState, uint8_t toState, const char* message);
+
+    /**
+     * Udløser freeze - optager BLACKBOX_POST_TRIGGER_MS mere og stopper så
+     * @param reason Årsag (logges)
+     */
+    void freeze(const char* reason);
+
+    /**
+     * Genoptager optagelse efter freeze
+     * Den frosne ring gemmes som fejl-dump
+     */
+    void resume();
+
+    /**
+     * Sletter begge black box filer og starter forfra
+     */
+    void clear();
+
+    /**
+     * Tjek om optagelsen er frosset
+     */
+    bool isFrozen() const { return _frozen; }
+
+    /**
+     * Tjek om black box kører
+     */
+    bool isRecording() const { return _initialized && !_frozen; }
+
+    /**
+     * Tjek om der findes et fejl-dump fra en tidligere fejl
+     */
+    bool hasErrorDump();
+
+    /**
+     * Antal records optaget siden opstart
+     */
+    uint32_t getRecordCount() const { return _recordCount; }
+
+    /**
+     * Antal records tabt fordi writer task ikke kunne følge med
+     */
+    uint32_t getDroppedCount() const { return _droppedCount; }
+
+    /**
+     * Antal sider skrevet til flash siden opstart
+     */
+    uint32_t getPagesWritten() const { return _pagesWritten; }
+
+    /**
+     * Opret status JSON
+     */
+    String getStatusJSON();
+
+    /**
+     * Læs ringens segmenter som én sammenhængende strøm (til download)
+     * @param dir BLACKBOX_DIR eller BLACKBOX_ERROR_DIR
+     * @param offset Byte position i strømmen
+     * @param buffer Destination
+     * @param maxLen Max antal bytes
+     * @return Antal bytes læst (0 = slut)
+     */
+    static size_t readRing(const char* dir, size_t offset, uint8_t* buffer, size_t maxLen);
+
+private:
+    // Antal RAM sider mellem loop og writer task
+    static const int RAM_PAGES = 4;
+
+    bool _initialized;
+    volatile bool _frozen;
+    volatile bool _freezePending;
+    unsigned long _freezeAt;
+
+    // RAM sider (producer: loop/web tasks, consumer: writer task)
+    uint8_t _pages[RAM_PAGES][BLACKBOX_PAGE_SIZE];
+    volatile uint8_t _pageReady[RAM_PAGES];
+    int _fillPage;
+    uint8_t _fillCount;
+    int _writePage;
+    portMUX_TYPE _mux;
+
+    // Flash ring
+    File _file;
+    uint32_t _pageSequence;
+    int _segment;               // Segment der skrives i
+    int _segmentPages;          // Sider skrevet i segmentet
+    uint16_t _bootCount;
+
+    // Kommandoer til writer task
+    volatile bool _rotateRequested;
+    volatile bool _clearRequested;
+
+    // Statistik
+    uint16_t _sequence;
+    uint32_t _recordCount;
+    volatile uint32_t _droppedCount;
+    volatile uint32_t _pagesWritten;
+
+    TaskHandle_t _task;
+
+    void appendRecord(BlackBoxRecord& rec);
+    void sealCurrentPage();
+    bool openRing();
+    bool openNextSegment();
+    void rotateToErrorDump();
+    void writeMarker(bool frozen);
+    void resumeRingPosition();
+    static String segmentPath(const char* dir, int segment);
+    static void removeRing(const char* dir);
+    void writerLoop();
+    static void writerTask(void* arg);
+    static void copyText(char* dest, const char* src);
+};
+
+#endif // BLACKBOX_H
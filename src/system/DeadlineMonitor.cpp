@@ -0,0 +1,297 @@
+#include "DeadlineMonitor.h"
+#include <esp_task_wdt.h>
+
+/**
+ * Starttidspunkt for en opgaves deadline - en varslet blokering
+ * (expectBlocking) skubber starten frem til blokeringens udløb.
+ */
+static unsigned long deadlineStart(unsigned long lastRunMs, unsigned long graceUntilMs, unsigned long now) {
+    if ((long)(graceUntilMs - lastRunMs) <= 0) {
+        return lastRunMs;
+    }
+    return ((long)(graceUntilMs - now) > 0) ? now : graceUntilMs;
+}
+
+DeadlineMonitor::DeadlineMonitor()
+    : motors(nullptr),
+      suspended(false),
+      graceUntilMs(0),
+      pendingLog(0),
+      safeStops(0),
+      initialized(false),
+      watchdogArmed(false),
+      loopTask(nullptr),
+      task(nullptr) {
+    mux = portMUX_INITIALIZER_UNLOCKED;
+    memset(tasks, 0, sizeof(tasks));
+    for (int i = 0; i < DEADLINE_TASK_COUNT; i++) {
+        tasks[i].name = "unknown";
+        tasks[i].lastOffender = PERF_LOOP;
+    }
+}
+
+bool DeadlineMonitor::begin(Motors* motors) {
+    this->motors = motors;
+    loopTask = xTaskGetCurrentTaskHandle();
+
+    watchdogArmed = armWatchdog();
+    if (!watchdogArmed) {
+        Logger::warning("Deadline monitor: task watchdog kunne ikke armeres");
+    }
+
+    BaseType_t result = xTaskCreatePinnedToCore(
+        supervisorTask,
+        "deadlines",
+        3072,
+        this,
+        DEADLINE_TASK_PRIORITY,
+        &task,
+        DEADLINE_TASK_CORE
+    );
+
+    if (result != pdPASS) {
+        Logger::error("Deadline monitor: supervisor task kunne ikke startes");
+        return false;
+    }
+
+    initialized = true;
+    Logger::info("Deadline monitor klar (watchdog " + String(WATCHDOG_TIMEOUT) + " s, motor deadline " +
+                 String(DEADLINE_MOTOR_MS) + " ms)");
+    return true;
+}
+
+bool DeadlineMonitor::armWatchdog() {
+    esp_task_wdt_config_t config = {};
+    config.timeout_ms = WATCHDOG_TIMEOUT * 1000;
+    config.idle_core_mask = (1 << 0);   // Som ESP-IDF standard: idle på core 0 (loop tilmeldes direkte)
+    config.trigger_panic = true;
+
+    // Arduino core har normalt allerede startet watchdog med standard timeout
+    esp_err_t err = esp_task_wdt_reconfigure(&config);
+    if (err == ESP_ERR_INVALID_STATE) {
+        err = esp_task_wdt_init(&config);
+    }
+    if (err != ESP_OK) {
+        return false;
+    }
+
+    if (esp_task_wdt_status(loopTask) == ESP_OK) {
+        return true;    // Allerede tilmeldt
+    }
+    return esp_task_wdt_add(loopTask) == ESP_OK;
+}
+
+void DeadlineMonitor::registerTask(DeadlineTask task, const char* name, uint32_t periodMs, uint32_t deadlineMs) {
+    if (task < 0 || task >= DEADLINE_TASK_COUNT) {
+        return;
+    }
+
+    portENTER_CRITICAL(&mux);
+    DeadlineStats& stats = tasks[task];
+    stats.name = name;
+    stats.periodMs = periodMs;
+    stats.deadlineMs = deadlineMs;
+    stats.lastRunMs = millis();
+    stats.missing = false;
+    stats.registered = true;
+    portEXIT_CRITICAL(&mux);
+}
+
+void DeadlineMonitor::taskRan(DeadlineTask task) {
+    if (task < 0 || task >= DEADLINE_TASK_COUNT) {
+        return;
+    }
+
+    unsigned long now = millis();
+
+    portENTER_CRITICAL(&mux);
+    DeadlineStats& stats = tasks[task];
+    if (stats.registered) {
+        uint32_t gap = now - deadlineStart(stats.lastRunMs, graceUntilMs, now);
+        if (stats.runs > 0 && gap > stats.worstGapMs) {
+            stats.worstGapMs = gap;
+        }
+        if (stats.missing) {
+            // Miss afsluttet - logges fra feed() med den samlede varighed
+            stats.missing = false;
+            stats.lastMissGapMs = gap;
+            pendingLog |= (1UL << task);
+        }
+        stats.lastRunMs = now;
+        stats.runs++;
+    }
+    portEXIT_CRITICAL(&mux);
+}
+
+void DeadlineMonitor::feed() {
+    if (!initialized) {
+        return;
+    }
+
+    if (watchdogArmed && !suspended) {
+        esp_task_wdt_reset();
+    }
+
+    if (pendingLog == 0) {
+        return;
+    }
+
+    for (int i = 0; i < DEADLINE_TASK_COUNT; i++) {
+        DeadlineStats copy;
+
+        portENTER_CRITICAL(&mux);
+        bool pending = (pendingLog & (1UL << i)) != 0;
+        pendingLog &= ~(1UL << i);
+        copy = tasks[i];
+        tasks[i].safeStopped = false;
+        portEXIT_CRITICAL(&mux);
+
+        if (!pending) {
+            continue;
+        }
+
+        Logger::warning("Deadline miss: " + String(copy.name) + " " + String(copy.lastMissGapMs) +
+                        " ms (deadline " + String(copy.deadlineMs) + " ms) under '" +
+                        String(LoopProfiler::getSectionName(copy.lastOffender)) + "'" +
+                        (copy.safeStopped ? " - motorer stoppet" : ""));
+    }
+}
+
+void DeadlineMonitor::expectBlocking(uint32_t durationMs) {
+    unsigned long until = millis() + durationMs;
+
+    portENTER_CRITICAL(&mux);
+    if ((long)(until - graceUntilMs) > 0) {
+        graceUntilMs = until;
+    }
+    portEXIT_CRITICAL(&mux);
+}
+
+void DeadlineMonitor::suspend(const char* reason) {
+    if (suspended) {
+        return;
+    }
+
+    suspended = true;
+    if (watchdogArmed) {
+        esp_task_wdt_delete(loopTask);
+    }
+
+    // Loop blokerer under pausen og ingen stopper en gammel kommando
+    if (motors != nullptr && motors->isMoving()) {
+        motors->stop();
+    }
+
+    Logger::info("Deadline monitor pause: " + String(reason));
+}
+
+void DeadlineMonitor::resume() {
+    if (!suspended) {
+        return;
+    }
+
+    unsigned long now = millis();
+
+    portENTER_CRITICAL(&mux);
+    for (int i = 0; i < DEADLINE_TASK_COUNT; i++) {
+        tasks[i].lastRunMs = now;
+        tasks[i].missing = false;
+    }
+    portEXIT_CRITICAL(&mux);
+
+    if (watchdogArmed) {
+        esp_task_wdt_add(loopTask);
+    }
+    suspended = false;
+
+    Logger::info("Deadline monitor genoptaget");
+}
+
+void DeadlineMonitor::supervisorTask(void* arg) {
+    static_cast<DeadlineMonitor*>(arg)->supervisorLoop();
+}
+
+void DeadlineMonitor::supervisorLoop() {
+    TickType_t lastWake = xTaskGetTickCount();
+
+    while (true) {
+        vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(DEADLINE_CHECK_INTERVAL));
+        checkDeadlines();
+    }
+}
+
+void DeadlineMonitor::checkDeadlines() {
+    if (suspended) {
+        return;
+    }
+
+    unsigned long now = millis();
+    bool motorLate = false;
+
+    portENTER_CRITICAL(&mux);
+    for (int i = 0; i < DEADLINE_TASK_COUNT; i++) {
+        DeadlineStats& stats = tasks[i];
+        if (!stats.registered || stats.missing) {
+            continue;
+        }
+
+        unsigned long start = deadlineStart(stats.lastRunMs, graceUntilMs, now);
+        if (now - start > stats.deadlineMs) {
+            stats.missing = true;
+            stats.misses++;
+            stats.lastOffender = LoopProfiler::getActiveSection();
+            if (i == DEADLINE_MOTOR) {
+                motorLate = true;
+            }
+        }
+    }
+    portEXIT_CRITICAL(&mux);
+
+    // Motorerne kører på en kommando loop ikke længere følger op på - stop dem.
+    // State machine sætter ny hastighed når loop kører igen. Motors låser
+    // PWM skrivningen, så stop fra denne core ikke blandes med setSpeed().
+    if (motorLate && motors != nullptr && motors->isMoving()) {
+        motors->stop();
+
+        portENTER_CRITICAL(&mux);
+        tasks[DEADLINE_MOTOR].safeStopped = true;
+        safeStops++;
+        portEXIT_CRITICAL(&mux);
+    }
+}
+
+String DeadlineMonitor::getJSON() {
+    String json = "{\"armed\":" + String(watchdogArmed ? "true" : "false");
+    json += ",\"watchdogS\":" + String(WATCHDOG_TIMEOUT);
+    json += ",\"suspended\":" + String(suspended ? "true" : "false");
+    json += ",\"safeStops\":" + String(safeStops);
+    json += ",\"tasks\":{";
+
+    bool first = true;
+    for (int i = 0; i < DEADLINE_TASK_COUNT; i++) {
+        // Kopiér én opgave ad gangen - låsen holdes kun under kopien
+        portENTER_CRITICAL(&mux);
+        DeadlineStats copy = tasks[i];
+        portEXIT_CRITICAL(&mux);
+
+        if (!copy.registered) {
+            continue;
+        }
+
+        json += first ? "" : ",";
+        first = false;
+        json += "\"" + String(copy.name) + "\":{";
+        json += "\"periodMs\":" + String(copy.periodMs);
+        json += ",\"deadlineMs\":" + String(copy.deadlineMs);
+        json += ",\"runs\":" + String(copy.runs);
+        json += ",\"misses\":" + String(copy.misses);
+        json += ",\"worstGapMs\":" + String(copy.worstGapMs);
+        json += ",\"lastMissGapMs\":" + String(copy.lastMissGapMs);
+        json += ",\"lastOffender\":\"" + String(LoopProfiler::getSectionName(copy.lastOffender)) + "\"";
+        json += ",\"late\":" + String(copy.missing ? "true" : "false");
+        json += "}";
+    }
+    json += "}}";
+
+    return json;
+}
@@ -0,0 +1,161 @@
+#ifndef DEADLINE_MONITOR_H
+#define DEADLINE_MONITOR_H
+
+#include <Arduino.h>
+#include "../config/Config.h"
+#include "Logger.h"
+#include "LoopProfiler.h"
+#include "../hardware/Motors.h"
+
+/**
+ * DeadlineTask enum - Kritiske opgaver i loop() med deadline
+ */
+enum DeadlineTask {
+    DEADLINE_MOTOR,         // State machine tick (motor kommandoer)
+    DEADLINE_SENSORS,       // updateSensors()
+    DEADLINE_IMU,           // updateIMU()
+    DEADLINE_PERIMETER,     // updatePerimeter()
+    DEADLINE_SAFETY,        // checkSafetyConditions()
+    DEADLINE_TASK_COUNT
+};
+
+/**
+ * Deadline statistik for én opgave
+ */
+struct DeadlineStats {
+    const char* name;
+    uint32_t periodMs;              // Forventet periode (0 = hvert loop)
+    uint32_t deadlineMs;            // Max tid mellem to kørsler
+    bool registered;
+    unsigned long lastRunMs;
+    uint32_t runs;
+    uint32_t misses;
+    uint32_t worstGapMs;            // Længste tid mellem to kørsler
+    uint32_t lastMissGapMs;         // Varighed af seneste miss
+    PerfSection lastOffender;       // Sektion der kørte da seneste miss blev opdaget
+    bool missing;                   // Deadline overskredet, opgaven har ikke kørt siden
+    bool safeStopped;               // Supervisor stoppede motorerne under dette miss
+};
+
+/**
+ * DeadlineMonitor klasse - Task watchdog og deadlines for loop()
+ *
+ * Kritiske opgaver registreres med periode og deadline og melder ind
+ * med taskRan() hver gang de har kørt. En supervisor task på core 0
+ * tjekker deadlines hvert DEADLINE_CHECK_INTERVAL ms - også mens loop
+ * blokerer - og stopper motorerne hvis motor opdateringen er forsinket,
+ * så robotten ikke kører videre på en gammel kommando. Loop tasken er
+ * desuden tilmeldt ESP-IDF task watchdog (WATCHDOG_TIMEOUT), som
+ * genstarter hvis loop hænger helt.
+ *
+ * Misses logges fra loop når opgaven kører igen, med varigheden og
+ * den loop sektion der kørte da deadline blev overskredet (kræver
+ * ENABLE_PROFILER, ellers "loop").
+ */
+class DeadlineMonitor {
+public:
+    /**
+     * Constructor
+     */
+    DeadlineMonitor();
+
+    /**
+     * Arm task watchdog for loop og start supervisor task
+     * Skal kaldes fra loop tasken (setup) efter blokerende init.
+     * @param motors Pointer til Motors (stoppes ved motor miss)
+     * @return true hvis succesfuld, false ved fejl
+     */
+    bool begin(Motors* motors);
+
+    /**
+     * Registrér en opgave
+     * @param task Opgave
+     * @param name Navn i log og JSON
+     * @param periodMs Forventet periode (0 = hvert loop)
+     * @param deadlineMs Max tid mellem to kørsler
+     */
+    void registerTask(DeadlineTask task, const char* name, uint32_t periodMs, uint32_t deadlineMs);
+
+    /**
+     * Opgaven har kørt - kaldes fra loop efter opgaven
+     * @param task Opgave
+     */
+    void taskRan(DeadlineTask task);
+
+    /**
+     * Kaldes sidst i loop() - fodrer watchdog og logger afsluttede misses
+     */
+    void feed();
+
+    /**
+     * Varsl en kendt blokerende sekvens (f.eks. bak + drej med delay)
+     * Deadlines tæller først fra udløbet af perioden.
+     * @param durationMs Forventet max varighed
+     */
+    void expectBlocking(uint32_t durationMs);
+
+    /**
+     * Sæt deadlines og watchdog på pause (f.eks. magnetometer kalibrering, OTA)
+     * Supervisor kan ikke stoppe motorerne under pausen, så de stoppes her.
+     * @param reason Årsag (logges)
+     */
+    void suspend(const char* reason);
+
+    /**
+     * Genoptag efter suspend() - alle opgaver starter forfra
+     */
+    void resume();
+
+    /**
+     * Er monitor sat på pause?
+     */
+    bool isSuspended() const { return suspended; }
+
+    /**
+     * Antal gange supervisor har stoppet motorerne
+     */
+    uint32_t getSafeStops() const { return safeStops; }
+
+    /**
+     * Opret JSON med deadlines og misses pr. opgave
+     * @return JSON string
+     */
+    String getJSON();
+
+private:
+    /**
+     * FreeRTOS entry point for supervisor tasken
+     */
+    static void supervisorTask(void* arg);
+
+    /**
+     * Supervisor løkke - tjekker deadlines periodisk
+     */
+    void supervisorLoop();
+
+    /**
+     * Tjek alle opgaver (kaldes fra supervisor)
+     */
+    void checkDeadlines();
+
+    /**
+     * Arm ESP-IDF task watchdog med WATCHDOG_TIMEOUT
+     */
+    bool armWatchdog();
+
+    Motors* motors;
+    DeadlineStats tasks[DEADLINE_TASK_COUNT];
+
+    volatile bool suspended;
+    volatile unsigned long graceUntilMs;
+    volatile uint32_t pendingLog;   // Bitmaske: afsluttede misses der skal logges fra loop
+    uint32_t safeStops;
+
+    bool initialized;
+    bool watchdogArmed;
+    TaskHandle_t loopTask;
+    TaskHandle_t task;
+    portMUX_TYPE mux;
+};
+
+#endif // DEADLINE_MONITOR_H
@@ -1,10 +1,13 @@
 #include "Logger.h"
+#include "BlackBox.h"
 
 // Static member initialization
 String Logger::logBuffer[LOG_BUFFER_SIZE];
 int Logger::logIndex = 0;
 int Logger::logCount = 0;
 bool Logger::initialized = false;
+BlackBox* Logger::blackBox = nullptr;
+uint8_t Logger::runtimeLevel[LOG_SUB_COUNT];
 
 void Logger::begin() {
     // Ryd buffer
@@ -14,6 +17,7 @@ void Logger::begin() {
 
     logIndex = 0;
     logCount = 0;
+    setAllLevels((LogLevel)LOG_RUNTIME_LEVEL_DEFAULT);
     initialized = true;
 
     info("Logger initialized");
@@ -21,22 +25,101 @@ void Logger::begin() {
 
 void Logger::debug(String message) {
     #if DEBUG_MODE
-    log(LOG_DEBUG, message);
+    if (isEnabled(LOG_SUB_CORE, LOG_DEBUG)) {
+        log(LOG_DEBUG, message);
+    }
     #endif
 }
 
 void Logger::info(String message) {
-    log(LOG_INFO, message);
+    if (isEnabled(LOG_SUB_CORE, LOG_INFO)) {
+        log(LOG_INFO, message);
+    }
 }
 
 void Logger::warning(String message) {
-    log(LOG_WARNING, message);
+    if (isEnabled(LOG_SUB_CORE, LOG_WARNING)) {
+        log(LOG_WARNING, message);
+    }
 }
 
 void Logger::error(String message) {
     log(LOG_ERROR, message);
 }
 
+void Logger::logf(LogSubsystem sub, LogLevel level, const char* format, ...) {
+    // Formatter i stak-buffer - ingen heap allokering før beskeden gemmes
+    char buffer[160];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+
+    log(level, String(buffer), sub);
+}
+
+void Logger::setLevel(LogSubsystem sub, LogLevel level) {
+    if (sub < 0 || sub >= LOG_SUB_COUNT) {
+        return;
+    }
+    runtimeLevel[sub] = (uint8_t)level;
+}
+
+void Logger::setAllLevels(LogLevel level) {
+    for (int i = 0; i < LOG_SUB_COUNT; i++) {
+        runtimeLevel[i] = (uint8_t)level;
+    }
+}
+
+LogLevel Logger::getLevel(LogSubsystem sub) {
+    if (sub < 0 || sub >= LOG_SUB_COUNT) {
+        return LOG_INFO;
+    }
+    return (LogLevel)runtimeLevel[sub];
+}
+
+const char* Logger::subsystemToString(LogSubsystem sub) {
+    switch (sub) {
+        case LOG_SUB_CORE:       return "core";
+        case LOG_SUB_NAVIGATION: return "navigation";
+        case LOG_SUB_MOTORS:     return "motors";
+        case LOG_SUB_SENSORS:    return "sensors";
+        case LOG_SUB_PERIMETER:  return "perimeter";
+        case LOG_SUB_WEB:        return "web";
+        case LOG_SUB_BATTERY:    return "battery";
+        default:                 return "unknown";
+    }
+}
+
+bool Logger::subsystemFromString(const String& name, LogSubsystem& sub) {
+    for (int i = 0; i < LOG_SUB_COUNT; i++) {
+        if (name.equalsIgnoreCase(subsystemToString((LogSubsystem)i))) {
+            sub = (LogSubsystem)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Logger::levelFromString(const String& name, LogLevel& level) {
+    if (name.equalsIgnoreCase("DEBUG")) {
+        level = LOG_DEBUG;
+    } else if (name.equalsIgnoreCase("INFO")) {
+        level = LOG_INFO;
+    } else if (name.equalsIgnoreCase("WARN") || name.equalsIgnoreCase("WARNING")) {
+        level = LOG_WARNING;
+    } else if (name.equalsIgnoreCase("ERROR")) {
+        level = LOG_ERROR;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void Logger::setBlackBox(BlackBox* box) {
+    blackBox = box;
+}
+
 void Logger::logSensorData(float left, float middle, float right) {
     char buffer[100];
     sprintf(buffer, "Sensors - L: %.1fcm, M: %.1fcm, R: %.1fcm", left, middle, right);
@@ -97,7 +180,19 @@ int Logger::getLogCount() {
     return logCount;
 }
 
-void Logger::log(LogLevel level, String message) {
+void Logger::log(LogLevel level, String message, LogSubsystem sub) {
+    // Optag i black box før prefix tilføjes (subsystem gemmes binært)
+    #if ENABLE_BLACKBOX
+    if (blackBox != nullptr && level >= BLACKBOX_LOG_LEVEL) {
+        blackBox->recordLog(level, sub, message.c_str());
+    }
+    #endif
+
+    // Tilføj subsystem prefix for alt andet end core
+    if (sub != LOG_SUB_CORE) {
+        message = "[" + String(subsystemToString(sub)) + "] " + message;
+    }
+
     // Formatter log entry
     String entry = formatLogEntry(level, message);
 
@@ -4,6 +4,8 @@
 #include <Arduino.h>
 #include "../config/Config.h"
 
+class BlackBox;
+
 /**
  * LogLevel enum - Definerer log niveauer
  */
@@ -14,6 +16,58 @@ enum LogLevel {
     LOG_ERROR
 };
 
+/**
+ * LogSubsystem enum - Definerer hvilket subsystem en besked kommer fra
+ * Hvert subsystem har sit eget compile-time og runtime log niveau
+ */
+enum LogSubsystem {
+    LOG_SUB_CORE,           // System, state machine, generelt
+    LOG_SUB_NAVIGATION,     // PathPlanner, Movement, ObstacleAvoidance
+    LOG_SUB_MOTORS,         // Drive motorer og strømmåling
+    LOG_SUB_SENSORS,        // Ultralyd sensorer og IMU
+    LOG_SUB_PERIMETER,      // Perimeter modtager og sender klient
+    LOG_SUB_WEB,            // Web server, API og WebSocket
+    LOG_SUB_BATTERY,        // Batteri overvågning
+    LOG_SUB_COUNT
+};
+
+/**
+ * Compile-time log niveau for et subsystem (fra Config.h)
+ * @param sub Subsystem
+ * @return Laveste niveau der kompileres med
+ */
+constexpr int logCompileLevel(LogSubsystem sub) {
+    return sub == LOG_SUB_NAVIGATION ? LOG_COMPILE_LEVEL_NAVIGATION :
+           sub == LOG_SUB_MOTORS     ? LOG_COMPILE_LEVEL_MOTORS :
+           sub == LOG_SUB_SENSORS    ? LOG_COMPILE_LEVEL_SENSORS :
+           sub == LOG_SUB_PERIMETER  ? LOG_COMPILE_LEVEL_PERIMETER :
+           sub == LOG_SUB_WEB        ? LOG_COMPILE_LEVEL_WEB :
+           sub == LOG_SUB_BATTERY    ? LOG_COMPILE_LEVEL_BATTERY :
+                                       LOG_COMPILE_LEVEL_CORE;
+}
+
+/**
+ * Filtrerede log makroer (printf format)
+ *
+ * Brug disse i hot paths. Hvis niveauet er under compile-time niveauet
+ * for subsystemet er hele kaldet død kode og fjernes af compileren -
+ * argumenterne evalueres aldrig. Ellers tjekkes runtime masken før
+ * beskeden formateres.
+ *
+ * Eksempel: LOGD(LOG_SUB_NAVIGATION, "Heading: %.1f", heading);
+ */
+#define LOG_FILTERED(sub, level, ...) \
+    do { \
+        if ((level) >= logCompileLevel(sub) && Logger::isEnabled((sub), (level))) { \
+            Logger::logf((sub), (level), __VA_ARGS__); \
+        } \
+    } while (0)
+
+#define LOGD(sub, ...) LOG_FILTERED(sub, LOG_DEBUG, __VA_ARGS__)
+#define LOGI(sub, ...) LOG_FILTERED(sub, LOG_INFO, __VA_ARGS__)
+#define LOGW(sub, ...) LOG_FILTERED(sub, LOG_WARNING, __VA_ARGS__)
+#define LOGE(sub, ...) LOG_FILTERED(sub, LOG_ERROR, __VA_ARGS__)
+
 /**
  * Logger klasse - Håndterer logging til Serial og web clients
  *
@@ -90,21 +144,67 @@ public:
      */
     static int getLogCount();
 
-private:
     /**
-     * Intern log funktion
+     * Logger formateret besked for et subsystem (bruges af LOGx makroerne)
+     * @param sub Subsystem
      * @param level Log niveau
-     * @param message Besked
+     * @param format printf format streng
      */
-    static void log(LogLevel level, String message);
+    static void logf(LogSubsystem sub, LogLevel level, const char* format, ...)
+        __attribute__((format(printf, 3, 4)));
 
     /**
-     * Formatter log entry
+     * Tjek om et niveau er aktivt for et subsystem (runtime maske)
+     * @param sub Subsystem
      * @param level Log niveau
-     * @param message Besked
-     * @return Formateret log entry
+     * @return true hvis beskeden skal logges
      */
-    static String formatLogEntry(LogLevel level, String message);
+    static inline bool isEnabled(LogSubsystem sub, LogLevel level) {
+        return level >= runtimeLevel[sub];
+    }
+
+    /**
+     * Sæt runtime log niveau for et subsystem
+     * @param sub Subsystem
+     * @param level Laveste niveau der logges
+     */
+    static void setLevel(LogSubsystem sub, LogLevel level);
+
+    /**
+     * Sæt runtime log niveau for alle subsystemer
+     * @param level Laveste niveau der logges
+     */
+    static void setAllLevels(LogLevel level);
+
+    /**
+     * Hent runtime log niveau for et subsystem
+     * @param sub Subsystem
+     * @return Nuværende niveau
+     */
+    static LogLevel getLevel(LogSubsystem sub);
+
+    /**
+     * Konverterer subsystem til string
+     * @param sub Subsystem
+     * @return Navn (f.eks. "navigation")
+     */
+    static const char* subsystemToString(LogSubsystem sub);
+
+    /**
+     * Finder subsystem ud fra navn
+     * @param name Navn (f.eks. "motors")
+     * @param sub Output parameter
+     * @return true hvis navnet er gyldigt
+     */
+    static bool subsystemFromString(const String& name, LogSubsystem& sub);
+
+    /**
+     * Finder log niveau ud fra navn
+     * @param name Navn ("DEBUG", "INFO", "WARN", "ERROR")
+     * @param level Output parameter
+     * @return true hvis navnet er gyldigt
+     */
+    static bool levelFromString(const String& name, LogLevel& level);
 
     /**
      * Konverterer log level til string
@@ -113,6 +213,29 @@ private:
      */
     static String levelToString(LogLevel level);
 
+    /**
+     * Sæt black box der modtager log beskeder (nullptr = ingen)
+     * @param box Pointer til BlackBox
+     */
+    static void setBlackBox(BlackBox* box);
+
+private:
+    /**
+     * Intern log funktion
+     * @param level Log niveau
+     * @param message Besked
+     * @param sub Subsystem (default LOG_SUB_CORE)
+     */
+    static void log(LogLevel level, String message, LogSubsystem sub = LOG_SUB_CORE);
+
+    /**
+     * Formatter log entry
+     * @param level Log niveau
+     * @param message Besked
+     * @return Formateret log entry
+     */
+    static String formatLogEntry(LogLevel level, String message);
+
     /**
      * Tilføjer log entry til cirkulær buffer
      * @param entry Log entry at tilføje
@@ -124,6 +247,12 @@ private:
     static int logIndex;
     static int logCount;
 
+    // Runtime log niveau pr. subsystem
+    static uint8_t runtimeLevel[LOG_SUB_COUNT];
+
+    // Black box optager (valgfri)
+    static BlackBox* blackBox;
+
     // Initialization flag
     static bool initialized;
 };
@@ -0,0 +1,169 @@
+#include "LoopProfiler.h"
+
+static const char* SECTION_NAMES[PERF_SECTION_COUNT] = {
+    "loop",
+    "sensors",
+    "imu",
+    "battery",
+    "webStatus",
+    "motorCurrent",
+    "perimeter",
+    "perimeterClient",
+    "blackbox",
+    "wifi",
+    "stateMachine",
+    "web",
+    "safety"
+};
+
+volatile PerfSection LoopProfiler::activeSection = PERF_LOOP;
+
+LoopProfiler::LoopProfiler()
+    : loopStartUs(0),
+      hasLastLoop(false),
+      resetTime(0) {
+    mux = portMUX_INITIALIZER_UNLOCKED;
+    memset(sections, 0, sizeof(sections));
+    memset(&period, 0, sizeof(period));
+}
+
+void LoopProfiler::beginLoop() {
+    int64_t nowUs = now();
+
+    if (hasLastLoop) {
+        portENTER_CRITICAL(&mux);
+        addSample(period, nowUs - loopStartUs);
+        portEXIT_CRITICAL(&mux);
+    }
+
+    loopStartUs = nowUs;
+    hasLastLoop = true;
+}
+
+void LoopProfiler::endLoop() {
+    int64_t us = now() - loopStartUs;
+
+    portENTER_CRITICAL(&mux);
+    addSample(sections[PERF_LOOP], us);
+    if (us > PERF_LOOP_BUDGET_US) {
+        sections[PERF_LOOP].overruns++;
+    }
+    portEXIT_CRITICAL(&mux);
+}
+
+void LoopProfiler::record(PerfSection section, int64_t us) {
+    if (section < 0 || section >= PERF_SECTION_COUNT) {
+        return;
+    }
+
+    portENTER_CRITICAL(&mux);
+    addSample(sections[section], us);
+    portEXIT_CRITICAL(&mux);
+}
+
+void LoopProfiler::reset() {
+    portENTER_CRITICAL(&mux);
+    memset(sections, 0, sizeof(sections));
+    memset(&period, 0, sizeof(period));
+    hasLastLoop = false;
+    portEXIT_CRITICAL(&mux);
+
+    resetTime = millis();
+}
+
+void LoopProfiler::addSample(PerfStats& stats, int64_t sampleUs) {
+    uint32_t us = (uint32_t)constrain(sampleUs, (int64_t)0, (int64_t)UINT32_MAX);
+
+    if (stats.count == 0 || us < stats.minUs) {
+        stats.minUs = us;
+    }
+    if (us > stats.maxUs) {
+        stats.maxUs = us;
+    }
+    stats.count++;
+    stats.totalUs += us;
+
+    // Log2 bucket: 0-1us -> 0, 2-3us -> 1, 4-7us -> 2, ...
+    int bucket = 0;
+    while ((us >> 1) > 0 && bucket < PERF_BUCKETS - 1) {
+        us >>= 1;
+        bucket++;
+    }
+    stats.histogram[bucket]++;
+}
+
+uint32_t LoopProfiler::percentile(const PerfStats& stats, uint32_t permille) {
+    if (stats.count == 0) {
+        return 0;
+    }
+
+    // Første bucket hvor den kumulative andel når percentilen
+    uint32_t target = (uint32_t)(((uint64_t)stats.count * permille + 999) / 1000);
+    uint32_t cumulative = 0;
+    for (int b = 0; b < PERF_BUCKETS; b++) {
+        cumulative += stats.histogram[b];
+        if (cumulative >= target) {
+            uint32_t upper = (1UL << (b + 1)) - 1;
+            return min(upper, stats.maxUs);
+        }
+    }
+    return stats.maxUs;
+}
+
+void LoopProfiler::appendStats(String& json, const PerfStats& stats) {
+    uint32_t avg = stats.count > 0 ? (uint32_t)(stats.totalUs / stats.count) : 0;
+
+    json += "{\"count\":" + String(stats.count);
+    json += ",\"minUs\":" + String(stats.minUs);
+    json += ",\"avgUs\":" + String(avg);
+    json += ",\"maxUs\":" + String(stats.maxUs);
+    json += ",\"p99Us\":" + String(percentile(stats, 990));
+    json += ",\"histogram\":[";
+    for (int b = 0; b < PERF_BUCKETS; b++) {
+        json += (b > 0 ? "," : "") + String(stats.histogram[b]);
+    }
+    json += "]}";
+}
+
+String LoopProfiler::getJSON() {
+    PerfStats copy;
+
+    String json = "{\"uptimeMs\":" + String(millis() - resetTime);
+    json += ",\"cpuMHz\":" + String(ESP.getCpuFreqMHz());
+    json += ",\"budgetUs\":" + String(PERF_LOOP_BUDGET_US);
+
+    portENTER_CRITICAL(&mux);
+    copy = sections[PERF_LOOP];
+    portEXIT_CRITICAL(&mux);
+    json += ",\"overruns\":" + String(copy.overruns);
+
+    portENTER_CRITICAL(&mux);
+    copy = period;
+    portEXIT_CRITICAL(&mux);
+    json += ",\"period\":";
+    appendStats(json, copy);
+
+    json += ",\"sections\":{";
+    for (int i = 0; i < PERF_SECTION_COUNT; i++) {
+        // Kopiér én sektion ad gangen - låsen holdes kun under kopien
+        portENTER_CRITICAL(&mux);
+        copy = sections[i];
+        portEXIT_CRITICAL(&mux);
+
+        if (i > 0) {
+            json += ",";
+        }
+        json += "\"" + String(SECTION_NAMES[i]) + "\":";
+        appendStats(json, copy);
+    }
+    json += "}}";
+
+    return json;
+}
+
+const char* LoopProfiler::getSectionName(PerfSection section) {
+    if (section < 0 || section >= PERF_SECTION_COUNT) {
+        return "unknown";
+    }
+    return SECTION_NAMES[section];
+}
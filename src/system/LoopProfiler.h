@@ -0,0 +1,175 @@
+#ifndef LOOP_PROFILER_H
+#define LOOP_PROFILER_H
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include "../config/Config.h"
+
+/**
+ * PerfSection enum - Målte sektioner af loop()
+ */
+enum PerfSection {
+    PERF_LOOP,              // Hele loop() kroppen
+    PERF_SENSORS,           // updateSensors()
+    PERF_IMU,               // updateIMU()
+    PERF_BATTERY,           // updateBattery()
+    PERF_WEB_STATUS,        // updateWebStatus()
+    PERF_MOTOR_CURRENT,     // updateMotorCurrent()
+    PERF_PERIMETER,         // updatePerimeter()
+    PERF_PERIMETER_CLIENT,  // perimeterClient.update() (asynkron HTTP)
+    PERF_BLACKBOX,          // Black box optagelse
+    PERF_WIFI,              // wifiManager.update()
+    PERF_STATE_MACHINE,     // stateManager.update() + tick()
+    PERF_WEB,               // webServer.update() + webSocket.update()
+    PERF_SAFETY,            // checkSafetyConditions()
+    PERF_SECTION_COUNT
+};
+
+// Log2 histogram: bucket i tæller værdier i [2^i, 2^(i+1)) us, sidste bucket tæller resten
+#define PERF_BUCKETS        20      // Op til ~1 sekund
+
+/**
+ * Aggregeret timing for én sektion (eller loop perioden)
+ */
+struct PerfStats {
+    uint32_t count;
+    uint32_t minUs;
+    uint32_t maxUs;
+    uint32_t overruns;              // Antal målinger over budget (kun loop)
+    uint64_t totalUs;
+    uint32_t histogram[PERF_BUCKETS];
+};
+
+/**
+ * LoopProfiler klasse - Letvægts timing af loop() sektioner
+ *
+ * Tidsstempler tages med esp_timer_get_time() (64 bit us - CPU cycle
+ * counteren løber rundt efter ~18 s ved 240 MHz og kan ikke måle lange
+ * blokeringer) og aggregeres i faste log2 histogrammer - ingen allokering i loop.
+ * p99 estimeres som øvre grænse af den bucket hvor 99% er nået.
+ * Skrives kun fra loop, læses fra web tasks under en kort portMUX lås.
+ */
+class LoopProfiler {
+public:
+    /**
+     * Constructor
+     */
+    LoopProfiler();
+
+    /**
+     * Kaldes først i loop() - måler perioden siden forrige loop
+     */
+    void beginLoop();
+
+    /**
+     * Kaldes sidst i loop() - måler loop kroppens varighed
+     */
+    void endLoop();
+
+    /**
+     * Registrerer en måling for en sektion
+     * @param section Sektion
+     * @param us Varighed i mikrosekunder
+     */
+    void record(PerfSection section, int64_t us);
+
+    /**
+     * Nulstil al statistik (trådsikker)
+     */
+    void reset();
+
+    /**
+     * Opret JSON med min/avg/max/p99 og histogrammer for alle sektioner
+     * @return JSON string
+     */
+    String getJSON();
+
+    /**
+     * Hent navn på sektion
+     * @param section Sektion
+     * @return Navn (f.eks. "sensors")
+     */
+    static const char* getSectionName(PerfSection section);
+
+    /**
+     * Aktuel tid siden opstart
+     * @return Mikrosekunder (64 bit - løber ikke rundt)
+     */
+    static inline int64_t now() {
+        return esp_timer_get_time();
+    }
+
+    /**
+     * Sektion loop() er i gang med lige nu (PERF_LOOP mellem sektioner)
+     * Læses af deadline supervisor for at udpege hvem der blokerer.
+     */
+    static PerfSection getActiveSection() {
+        return activeSection;
+    }
+
+private:
+    /**
+     * Tilføjer en måling til statistik (kaldes under lås)
+     * Varigheder over uint32_t (~71 min) mættes.
+     */
+    static void addSample(PerfStats& stats, int64_t us);
+
+    /**
+     * Estimerer percentil fra histogram
+     * @return Øvre grænse af bucket i us
+     */
+    static uint32_t percentile(const PerfStats& stats, uint32_t permille);
+
+    /**
+     * Tilføjer statistik som JSON objekt
+     */
+    static void appendStats(String& json, const PerfStats& stats);
+
+    PerfStats sections[PERF_SECTION_COUNT];
+    PerfStats period;               // Tid mellem loop starter (jitter)
+
+    int64_t loopStartUs;
+    bool hasLastLoop;
+
+    unsigned long resetTime;
+    portMUX_TYPE mux;
+
+    static volatile PerfSection activeSection;
+
+    friend class ProfileScope;
+};
+
+/**
+ * ProfileScope - Måler tiden fra konstruktion til scope slut
+ */
+class ProfileScope {
+public:
+    ProfileScope(LoopProfiler& profiler, PerfSection section)
+        : profiler(profiler), section(section), previous(LoopProfiler::activeSection),
+          start(LoopProfiler::now()) {
+        LoopProfiler::activeSection = section;
+    }
+
+    ~ProfileScope() {
+        profiler.record(section, LoopProfiler::now() - start);
+        LoopProfiler::activeSection = previous;
+    }
+
+private:
+    LoopProfiler& profiler;
+    PerfSection section;
+    PerfSection previous;
+    int64_t start;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if ENABLE_PROFILER
+#define PROFILE_SECTION(profiler, section) \
+    ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)((profiler), (section))
+#else
+#define PROFILE_SECTION(profiler, section) do {} while (0)
+#endif
+
+#endif // LOOP_PROFILER_H
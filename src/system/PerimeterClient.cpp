@@ -14,7 +14,33 @@ PerimeterClient::PerimeterClient()
     , _senderCurrent(0)
     , _senderRuntime(0)
     , _lastError("")
+    , _queueHead(0)
+    , _queueCount(0)
+    , _phase(PHASE_IDLE)
+    , _requestStart(0)
+    , _rxLength(0)
+    , _rxOverflow(false)
+    , _errorCode(0)
+    , _timedOut(false)
+    , _reused(false)
+    , _backoffMs(0)
+    , _nextAttempt(0)
+    , _lastStatusRequest(0)
+    , _udpStarted(false)
+    , _lastHeartbeat(0)
+    , _heartbeatSequence(0)
+    , _heartbeatCount(0)
+    , _linkError(PERIMETER_LINK_OK)
+    , _udpSequence(0)
+    , _udpPending(0)
+    , _udpAttempts(0)
+    , _udpSentAt(0)
 {
+    _mux = portMUX_INITIALIZER_UNLOCKED;
+    _active.command = PERIMETER_CMD_STATUS;
+    _active.callback = nullptr;
+    _rxBuffer[0] = '\0';
+    _txBuffer[0] = '\0';
 }
 
 // ============================================================================
@@ -24,112 +50,127 @@ PerimeterClient::PerimeterClient()
 bool PerimeterClient::begin(const char* ip, int port) {
     _senderIP = ip;
     _senderPort = port;
+
+    // AsyncTCP kalder tilbage fra sin egen task
+    _client.onConnect([](void* arg, AsyncClient*) {
+        static_cast<PerimeterClient*>(arg)->onConnect();
+    }, this);
+    _client.onData([](void* arg, AsyncClient*, void* data, size_t len) {
+        static_cast<PerimeterClient*>(arg)->onData(static_cast<const char*>(data), len);
+    }, this);
+    _client.onDisconnect([](void* arg, AsyncClient*) {
+        static_cast<PerimeterClient*>(arg)->onDisconnect();
+    }, this);
+    _client.onError([](void* arg, AsyncClient*, int8_t error) {
+        static_cast<PerimeterClient*>(arg)->onError(error);
+    }, this);
+
     _initialized = true;
 
     Serial.println("[PerimeterClient] Initialized");
     Serial.printf("[PerimeterClient] Sender: http://%s:%d\n", _senderIP.c_str(), _senderPort);
 
-    // Prøv at hente status for at verificere forbindelse
-    if (updateStatus()) {
-        Serial.println("[PerimeterClient] Connection verified");
-        return true;
-    } else {
-        Serial.println("[PerimeterClient] WARNING: Could not connect to sender");
-        Serial.println("[PerimeterClient] Check that sender is running and IP is correct");
-        return true;  // Returner true alligevel - vi prøver igen senere
-    }
+    // Første status hentes i update() - begin() må ikke vente på senderen
+    _lastStatusRequest = millis();
+    requestStatus();
+    return true;
 }
 
-bool PerimeterClient::startSignal() {
+void PerimeterClient::update() {
     if (!_initialized) {
-        _lastError = "Not initialized";
-        return false;
+        return;
     }
 
-    Serial.println("[PerimeterClient] Starting perimeter signal...");
+    // Heartbeats og acks først - de kan afslutte en UDP kommando
+    pollUdp();
 
-    String response;
-    int httpCode = httpPost("/api/start", response);
+    unsigned long now = millis();
 
-    if (httpCode == 200) {
-        Serial.println("[PerimeterClient] Signal started");
-        _connected = true;
-        updateStatus();
-        return true;
-    } else {
-        _lastError = "HTTP error: " + String(httpCode);
-        Serial.printf("[PerimeterClient] Failed to start signal: %s\n", _lastError.c_str());
-        return false;
+    // UDP kommando uden ack - gensend, og fald tilbage til HTTP til sidst
+    if (_phase == PHASE_UDP && now - _udpSentAt >= PERIMETER_UDP_RETRY_MS) {
+        if (_udpAttempts < PERIMETER_UDP_RETRIES) {
+            sendUdpCommand();
+        } else {
+            Serial.printf("[PerimeterClient] No UDP ack for %s - using HTTP\n", commandPath(_active.command));
+            startHttp();
+        }
     }
-}
 
-bool PerimeterClient::stopSignal() {
-    if (!_initialized) {
-        _lastError = "Not initialized";
-        return false;
+    // Timeout - luk forbindelsen, onDisconnect/finishRequest rydder op
+    Phase phase = _phase;
+    if ((phase == PHASE_CONNECTING || phase == PHASE_WAITING) &&
+        now - _requestStart > PERIMETER_API_TIMEOUT) {
+        _timedOut = true;
+        _client.close(true);
+        portENTER_CRITICAL(&_mux);
+        if (_phase == PHASE_CONNECTING || _phase == PHASE_WAITING) {
+            _phase = PHASE_FAILED;
+        }
+        portEXIT_CRITICAL(&_mux);
     }
 
-    Serial.println("[PerimeterClient] Stopping perimeter signal...");
-
-    String response;
-    int httpCode = httpPost("/api/stop", response);
+    if (_phase == PHASE_DONE || _phase == PHASE_FAILED) {
+        finishRequest();
+    }
 
-    if (httpCode == 200) {
-        Serial.println("[PerimeterClient] Signal stopped");
-        _connected = true;
-        updateStatus();
-        return true;
-    } else {
-        _lastError = "HTTP error: " + String(httpCode);
-        Serial.printf("[PerimeterClient] Failed to stop signal: %s\n", _lastError.c_str());
-        return false;
+    // Status kommer med heartbeat så længe UDP kanalen lever
+    if (now - _lastStatusRequest >= PERIMETER_STATUS_INTERVAL) {
+        _lastStatusRequest = now;
+        if (!isLinkAlive()) {
+            requestStatus();
+        }
     }
+
+    startNext();
 }
 
-bool PerimeterClient::resetSender() {
-    if (!_initialized) {
-        _lastError = "Not initialized";
-        return false;
-    }
+bool PerimeterClient::startSignal(PerimeterCallback callback) {
+    return enqueue(PERIMETER_CMD_START, callback);
+}
 
-    Serial.println("[PerimeterClient] Resetting perimeter sender...");
+bool PerimeterClient::stopSignal(PerimeterCallback callback) {
+    return enqueue(PERIMETER_CMD_STOP, callback);
+}
 
-    String response;
-    int httpCode = httpPost("/api/reset", response);
+bool PerimeterClient::resetSender(PerimeterCallback callback) {
+    return enqueue(PERIMETER_CMD_RESET, callback);
+}
 
-    if (httpCode == 200) {
-        Serial.println("[PerimeterClient] Sender reset");
-        _connected = true;
-        updateStatus();
+bool PerimeterClient::requestStatus(PerimeterCallback callback) {
+    // Én status request ad gangen er nok - også mens senderen er væk
+    portENTER_CRITICAL(&_mux);
+    bool pending = _phase != PHASE_IDLE && _active.command == PERIMETER_CMD_STATUS;
+    for (int i = 0; i < _queueCount && !pending; i++) {
+        pending = _queue[(_queueHead + i) % PERIMETER_QUEUE_SIZE].command == PERIMETER_CMD_STATUS;
+    }
+    portEXIT_CRITICAL(&_mux);
+
+    if (pending && callback == nullptr) {
         return true;
-    } else {
-        _lastError = "HTTP error: " + String(httpCode);
-        Serial.printf("[PerimeterClient] Failed to reset sender: %s\n", _lastError.c_str());
-        return false;
     }
+    return enqueue(PERIMETER_CMD_STATUS, callback);
 }
 
-bool PerimeterClient::updateStatus() {
-    if (!_initialized) {
-        return false;
-    }
+bool PerimeterClient::isLinkAlive() const {
+    return _heartbeatCount > 0 && millis() - _lastHeartbeat < PERIMETER_HEARTBEAT_TIMEOUT;
+}
 
-    String response;
-    int httpCode = httpGet("/api/status", response);
+unsigned long PerimeterClient::getHeartbeatAge() const {
+    return _heartbeatCount > 0 ? millis() - _lastHeartbeat : 0;
+}
 
-    if (httpCode == 200) {
-        _connected = true;
-        return parseStatusResponse(response);
-    } else {
-        _connected = false;
-        _senderState = "DISCONNECTED";
-        _lastError = "HTTP error: " + String(httpCode);
-        return false;
-    }
+int PerimeterClient::getQueueLength() const {
+    portENTER_CRITICAL(&_mux);
+    int length = _queueCount + (_phase != PHASE_IDLE ? 1 : 0);
+    portEXIT_CRITICAL(&_mux);
+    return length;
 }
 
 void PerimeterClient::setSenderIP(const char* ip) {
     _senderIP = ip;
+    _client.close(true);  // Næste request forbinder til den nye adresse
+    _backoffMs = 0;
+    _nextAttempt = 0;
     Serial.printf("[PerimeterClient] Sender IP changed to: %s\n", _senderIP.c_str());
 }
 
@@ -137,48 +178,322 @@ void PerimeterClient::setSenderIP(const char* ip) {
 // PRIVATE METHODS
 // ============================================================================
 
-int PerimeterClient::httpGet(const char* endpoint, String& response) {
-    HTTPClient http;
-    String url = buildURL(endpoint);
+bool PerimeterClient::enqueue(PerimeterCommand command, PerimeterCallback callback) {
+    if (!_initialized) {
+        return false;
+    }
+
+    // Kan kaldes fra web handlers (AsyncTCP task) - ingen allokering under låsen
+    portENTER_CRITICAL(&_mux);
+    bool queued = _queueCount < PERIMETER_QUEUE_SIZE;
+    if (queued) {
+        Request& request = _queue[(_queueHead + _queueCount) % PERIMETER_QUEUE_SIZE];
+        request.command = command;
+        request.callback = callback;
+        _queueCount++;
+    }
+    portEXIT_CRITICAL(&_mux);
 
-    http.begin(url);
-    http.setTimeout(PERIMETER_API_TIMEOUT);
+    return queued;
+}
 
-    int httpCode = http.GET();
+void PerimeterClient::startNext() {
+    if (_phase != PHASE_IDLE) {
+        return;
+    }
 
-    if (httpCode > 0) {
-        response = http.getString();
-    } else {
-        response = "";
-        _lastError = http.errorToString(httpCode);
+    // Back-off - senderen svarede ikke sidst (gælder kun HTTP)
+    unsigned long now = millis();
+    bool linkAlive = isLinkAlive();
+    if (!linkAlive && _nextAttempt != 0 && (long)(now - _nextAttempt) < 0) {
+        return;
+    }
+
+    portENTER_CRITICAL(&_mux);
+    bool hasRequest = _queueCount > 0;
+    if (hasRequest) {
+        _active = _queue[_queueHead];
+        _queueHead = (_queueHead + 1) % PERIMETER_QUEUE_SIZE;
+        _queueCount--;
+    }
+    portEXIT_CRITICAL(&_mux);
+
+    if (!hasRequest) {
+        return;
+    }
+
+    if (linkAlive) {
+        if (_active.command == PERIMETER_CMD_STATUS) {
+            // Seneste heartbeat er frisk status
+            completeRequest(true);
+        } else {
+            _udpAttempts = 0;
+            _udpPending = ++_udpSequence;
+            _phase = PHASE_UDP;
+            sendUdpCommand();
+        }
+        return;
+    }
+
+    startHttp();
+}
+
+void PerimeterClient::startHttp() {
+    unsigned long now = millis();
+
+    snprintf(_txBuffer, sizeof(_txBuffer),
+             "%s %s HTTP/1.1\r\nHost: %s\r\nConnection: keep-alive\r\nContent-Length: 0\r\n\r\n",
+             commandMethod(_active.command), commandPath(_active.command), _senderIP.c_str());
+
+    _rxLength = 0;
+    _rxOverflow = false;
+    _errorCode = 0;
+    _timedOut = false;
+    _requestStart = now;
+
+    // Genbrug åben forbindelse fra forrige request
+    _reused = _client.connected();
+    if (_reused) {
+        _phase = PHASE_WAITING;
+        sendRequest();
+        return;
+    }
+
+    _phase = PHASE_CONNECTING;
+    if (!_client.connect(_senderIP.c_str(), _senderPort)) {
+        portENTER_CRITICAL(&_mux);
+        if (_phase == PHASE_CONNECTING) {
+            _phase = PHASE_FAILED;
+        }
+        portEXIT_CRITICAL(&_mux);
+    }
+}
+
+void PerimeterClient::sendRequest() {
+    size_t length = strlen(_txBuffer);
+    if (_client.write(_txBuffer, length) != length) {
+        portENTER_CRITICAL(&_mux);
+        if (_phase == PHASE_WAITING) {
+            _phase = PHASE_FAILED;
+        }
+        portEXIT_CRITICAL(&_mux);
+    }
+}
+
+void PerimeterClient::pollUdp() {
+    if (!_udpStarted) {
+        // Socket kan først åbnes når netværket er oppe
+        if (WiFi.status() != WL_CONNECTED) {
+            return;
+        }
+        _udpStarted = _udp.begin(PERIMETER_UDP_MOWER_PORT);
+        if (_udpStarted) {
+            Serial.printf("[PerimeterClient] Listening for heartbeats on UDP %d\n", PERIMETER_UDP_MOWER_PORT);
+        }
+        return;
+    }
+
+    // Begrænset antal pakker pr. loop - parsePacket() blokerer ikke
+    uint8_t buffer[64];
+    for (int i = 0; i < 4; i++) {
+        int size = _udp.parsePacket();
+        if (size <= 0) {
+            return;
+        }
+
+        int length = _udp.read(buffer, sizeof(buffer));
+        if (length <= 0 || _udp.remoteIP().toString() != _senderIP) {
+            continue;
+        }
+
+        uint8_t type = perimeterPacketType(buffer, length);
+        if (type == PERIMETER_PKT_HEARTBEAT) {
+            PerimeterHeartbeat heartbeat;
+            memcpy(&heartbeat, buffer, sizeof(heartbeat));
+            handleHeartbeat(heartbeat);
+        } else if (type == PERIMETER_PKT_ACK) {
+            PerimeterAckPacket ack;
+            memcpy(&ack, buffer, sizeof(ack));
+            if (_phase == PHASE_UDP && ack.ackSequence == _udpPending) {
+                _senderState = linkStateName(ack.state);
+                _senderRunning = ack.state == PERIMETER_LINK_RUNNING;
+                if (ack.error != PERIMETER_LINK_OK) {
+                    _lastError = "Rejected: error " + String(ack.error);
+                }
+                completeRequest(ack.error == PERIMETER_LINK_OK);
+            }
+        }
+    }
+}
+
+void PerimeterClient::handleHeartbeat(const PerimeterHeartbeat& heartbeat) {
+    // Gamle/dublerede pakker ignoreres (senderen genstartet = sekvens forfra)
+    bool restarted = heartbeat.uptimeMs < 5000;
+    if (_heartbeatCount > 0 && !restarted &&
+        !perimeterSequenceNewer(heartbeat.header.sequence, _heartbeatSequence)) {
+        return;
+    }
+
+    if (!isLinkAlive()) {
+        Serial.println("[PerimeterClient] UDP heartbeat link up");
+    }
+    if (heartbeat.error != _linkError) {
+        Serial.printf("[PerimeterClient] Sender wire/error: %s -> %s\n",
+                      linkErrorName(_linkError), linkErrorName(heartbeat.error));
+    }
+
+    _heartbeatSequence = heartbeat.header.sequence;
+    _heartbeatCount++;
+    _lastHeartbeat = millis();
+    _linkError = heartbeat.error;
+
+    _connected = true;
+    _senderState = linkStateName(heartbeat.state);
+    _senderRunning = heartbeat.state == PERIMETER_LINK_RUNNING;
+    _senderCurrent = heartbeat.currentMA;
+    _senderRuntime = heartbeat.runtimeMs;
+
+    // Senderen er der - HTTP må prøve igen med det samme
+    _backoffMs = 0;
+    _nextAttempt = 0;
+}
+
+void PerimeterClient::sendUdpCommand() {
+    PerimeterCommandPacket packet;
+    perimeterInitHeader(packet.header, PERIMETER_PKT_COMMAND, _udpPending);
+    switch (_active.command) {
+        case PERIMETER_CMD_START:   packet.command = PERIMETER_LINK_START; break;
+        case PERIMETER_CMD_STOP:    packet.command = PERIMETER_LINK_STOP; break;
+        default:                    packet.command = PERIMETER_LINK_RESET; break;
+    }
+
+    _udp.beginPacket(_senderIP.c_str(), PERIMETER_UDP_SENDER_PORT);
+    _udp.write((const uint8_t*)&packet, sizeof(packet));
+    _udp.endPacket();
+
+    _udpAttempts++;
+    _udpSentAt = millis();
+}
+
+void PerimeterClient::completeRequest(bool success) {
+    Request finished = _active;
+
+    if (finished.command != PERIMETER_CMD_STATUS) {
+        Serial.printf("[PerimeterClient] %s %s (UDP)\n", commandPath(finished.command), success ? "OK" : "failed");
     }
 
-    http.end();
-    return httpCode;
+    _phase = PHASE_IDLE;
+
+    if (finished.callback != nullptr) {
+        finished.callback(finished.command, success);
+    }
 }
 
-int PerimeterClient::httpPost(const char* endpoint, String& response) {
-    HTTPClient http;
-    String url = buildURL(endpoint);
+void PerimeterClient::finishRequest() {
+    bool done = _phase == PHASE_DONE;
+
+    // Senderen lukkede keep-alive forbindelsen før requesten nåede frem - prøv én gang på ny forbindelse
+    if (!done && _reused && _rxLength == 0 && !_timedOut) {
+        _reused = false;
+        _requestStart = millis();
+        _phase = PHASE_CONNECTING;
+        if (!_client.connect(_senderIP.c_str(), _senderPort)) {
+            _phase = PHASE_FAILED;
+        }
+        return;
+    }
 
-    http.begin(url);
-    http.setTimeout(PERIMETER_API_TIMEOUT);
-    http.addHeader("Content-Type", "application/json");
+    int httpCode = -1;
+    const char* body = nullptr;
+    if (done) {
+        _rxBuffer[_rxLength] = '\0';
+        const char* space = strchr(_rxBuffer, ' ');
+        httpCode = space != nullptr ? atoi(space + 1) : -1;
+        const char* headerEnd = strstr(_rxBuffer, "\r\n\r\n");
+        body = headerEnd != nullptr ? headerEnd + 4 : "";
+    }
 
-    int httpCode = http.POST("");  // Tom body
+    bool success = httpCode == 200 && !_rxOverflow;
+    Request finished = _active;
 
-    if (httpCode > 0) {
-        response = http.getString();
+    if (success) {
+        _connected = true;
+        if (_backoffMs > 0) {
+            Serial.println("[PerimeterClient] Sender reachable again");
+        }
+        _backoffMs = 0;
+        _nextAttempt = 0;
+
+        if (finished.command == PERIMETER_CMD_STATUS) {
+            success = parseStatusResponse(body);
+        } else {
+            Serial.printf("[PerimeterClient] %s OK\n", commandPath(finished.command));
+            requestStatus();
+        }
+    } else if (httpCode > 0) {
+        // Senderen svarer, men afviste requesten
+        _connected = true;
+        _lastError = _rxOverflow ? "Response too large" : "HTTP error: " + String(httpCode);
+        Serial.printf("[PerimeterClient] %s failed: %s\n", commandPath(finished.command), _lastError.c_str());
     } else {
-        response = "";
-        _lastError = http.errorToString(httpCode);
+        // Ingen forbindelse - vent eksponentielt længere før næste forsøg
+        _connected = false;
+        _senderState = "DISCONNECTED";
+        if (_timedOut) {
+            _lastError = "Timeout";
+        } else if (_errorCode != 0) {
+            _lastError = "Connection error: " + String(_client.errorToString(_errorCode));
+        } else {
+            _lastError = "Connection failed";
+        }
+
+        if (_backoffMs == 0) {
+            _backoffMs = PERIMETER_BACKOFF_MIN_MS;
+            Serial.printf("[PerimeterClient] Sender unreachable (%s) - backing off\n", _lastError.c_str());
+        } else {
+            _backoffMs = min(_backoffMs * 2, (unsigned long)PERIMETER_BACKOFF_MAX_MS);
+        }
+        _nextAttempt = millis() + _backoffMs;
+        _client.close(true);
     }
 
-    http.end();
-    return httpCode;
+    portENTER_CRITICAL(&_mux);
+    _phase = PHASE_IDLE;
+    portEXIT_CRITICAL(&_mux);
+
+    if (finished.callback != nullptr) {
+        finished.callback(finished.command, success);
+    }
 }
 
-bool PerimeterClient::parseStatusResponse(const String& json) {
+bool PerimeterClient::isResponseComplete(bool closed) const {
+    if (_rxOverflow) {
+        return true;
+    }
+
+    const char* headerEnd = strstr(_rxBuffer, "\r\n\r\n");
+    if (headerEnd == nullptr) {
+        return false;
+    }
+    size_t headerLength = (headerEnd - _rxBuffer) + 4;
+
+    // Content-Length (header navne er case-insensitive)
+    for (const char* line = _rxBuffer; line != nullptr && line < headerEnd; ) {
+        if (strncasecmp(line, "Content-Length:", 15) == 0) {
+            size_t contentLength = strtoul(line + 15, nullptr, 10);
+            return _rxLength >= headerLength + contentLength;
+        }
+        line = strstr(line, "\r\n");
+        if (line != nullptr) {
+            line += 2;
+        }
+    }
+
+    // Uden længde slutter svaret når senderen lukker forbindelsen
+    return closed;
+}
+
+bool PerimeterClient::parseStatusResponse(const char* json) {
     JsonDocument doc;
     DeserializationError error = deserializeJson(doc, json);
 
@@ -197,6 +512,93 @@ bool PerimeterClient::parseStatusResponse(const String& json) {
     return true;
 }
 
-String PerimeterClient::buildURL(const char* endpoint) {
-    return "http://" + _senderIP + ":" + String(_senderPort) + endpoint;
+// ============================================================================
+// ASYNCTCP CALLBACKS (AsyncTCP task)
+// ============================================================================
+
+void PerimeterClient::onConnect() {
+    portENTER_CRITICAL(&_mux);
+    bool send = _phase == PHASE_CONNECTING;
+    if (send) {
+        _phase = PHASE_WAITING;
+    }
+    portEXIT_CRITICAL(&_mux);
+
+    if (send) {
+        sendRequest();
+    }
+}
+
+void PerimeterClient::onData(const char* data, size_t len) {
+    portENTER_CRITICAL(&_mux);
+    if (_phase == PHASE_WAITING) {
+        size_t space = PERIMETER_RESPONSE_MAX - _rxLength;
+        size_t copy = len < space ? len : space;
+        memcpy(_rxBuffer + _rxLength, data, copy);
+        _rxLength += copy;
+        _rxBuffer[_rxLength] = '\0';
+        if (copy < len) {
+            _rxOverflow = true;
+        }
+        if (isResponseComplete(false)) {
+            _phase = PHASE_DONE;
+        }
+    }
+    portEXIT_CRITICAL(&_mux);
+}
+
+void PerimeterClient::onDisconnect() {
+    portENTER_CRITICAL(&_mux);
+    if (_phase == PHASE_WAITING) {
+        _phase = isResponseComplete(true) ? PHASE_DONE : PHASE_FAILED;
+    } else if (_phase == PHASE_CONNECTING) {
+        _phase = PHASE_FAILED;
+    }
+    portEXIT_CRITICAL(&_mux);
+}
+
+void PerimeterClient::onError(int8_t error) {
+    portENTER_CRITICAL(&_mux);
+    _errorCode = error;
+    if (_phase == PHASE_CONNECTING || _phase == PHASE_WAITING) {
+        _phase = PHASE_FAILED;
+    }
+    portEXIT_CRITICAL(&_mux);
+}
+
+const char* PerimeterClient::commandPath(PerimeterCommand command) {
+    switch (command) {
+        case PERIMETER_CMD_START:   return "/api/start";
+        case PERIMETER_CMD_STOP:    return "/api/stop";
+        case PERIMETER_CMD_RESET:   return "/api/reset";
+        default:                    return "/api/status";
+    }
+}
+
+const char* PerimeterClient::linkStateName(uint8_t state) {
+    // Samme navne som senderens /api/status
+    switch (state) {
+        case PERIMETER_LINK_OFF:            return "OFF";
+        case PERIMETER_LINK_STARTING:       return "STARTING";
+        case PERIMETER_LINK_RUNNING:        return "RUNNING";
+        case PERIMETER_LINK_ERROR:          return "ERROR";
+        case PERIMETER_LINK_OVERCURRENT:    return "OVERCURRENT";
+        default:                            return "UNKNOWN";
+    }
+}
+
+const char* PerimeterClient::linkErrorName(uint8_t error) {
+    switch (error) {
+        case PERIMETER_LINK_OK:                 return "OK";
+        case PERIMETER_LINK_ERR_OVERCURRENT:    return "OVERCURRENT";
+        case PERIMETER_LINK_ERR_WIRE_BREAK:     return "WIRE_BREAK";
+        case PERIMETER_LINK_ERR_REJECTED:       return "REJECTED";
+        case PERIMETER_LINK_ERR_SHORT:          return "SHORT";
+        case PERIMETER_LINK_ERR_DEGRADED:       return "DEGRADED";
+        default:                                return "UNKNOWN";
+    }
+}
+
+const char* PerimeterClient::commandMethod(PerimeterCommand command) {
+    return command == PERIMETER_CMD_STATUS ? "GET" : "POST";
 }
@@ -2,51 +2,95 @@
 #define PERIMETER_CLIENT_H
 
 #include <Arduino.h>
-#include <HTTPClient.h>
+#include <AsyncTCP.h>
+#include <WiFi.h>
+#include <WiFiUdp.h>
 #include <ArduinoJson.h>
 #include "../config/Config.h"
+#include "PerimeterProtocol.h"
 
 /**
- * PerimeterClient - HTTP klient til perimeter wire sender
+ * PerimeterCommand enum - Requests til perimeter senderen
+ */
+enum PerimeterCommand {
+    PERIMETER_CMD_STATUS,   // GET  /api/status
+    PERIMETER_CMD_START,    // POST /api/start
+    PERIMETER_CMD_STOP,     // POST /api/stop
+    PERIMETER_CMD_RESET     // POST /api/reset
+};
+
+/**
+ * Callback når en request er færdig (kaldes fra loop via update())
+ * @param command Kommandoen der blev sendt
+ * @param success true hvis senderen svarede 200
+ */
+typedef void (*PerimeterCallback)(PerimeterCommand command, bool success);
+
+/**
+ * PerimeterClient - Asynkron HTTP klient til perimeter wire sender
  *
  * Kommunikerer med den separate ESP32 der styrer perimeterkablet.
  * Tillader robot mower at tænde/slukke kablet og overvåge status.
+ *
+ * Requests lægges i en lille kø og sendes én ad gangen over en
+ * AsyncTCP forbindelse der holdes åben (keep-alive) mellem requests.
+ * Forbindelse, afsendelse og modtagelse sker i AsyncTCP tasken - loop
+ * kalder kun update(), som starter næste request og behandler færdige
+ * svar, så control loop aldrig venter på senderen. Er senderen ikke
+ * tilgængelig, ventes der eksponentielt længere mellem forsøgene.
+ *
+ * Nyere sendere broadcaster desuden et binært UDP heartbeat (se
+ * PerimeterProtocol.h). Så længe heartbeats kommer, tages status fra
+ * dem i stedet for HTTP polling, og kommandoer sendes over UDP med ack
+ * (HTTP bruges hvis ack udebliver). Kabelbrud meldes dermed inden for
+ * et par hundrede ms i stedet for op til 5 sek.
  */
 class PerimeterClient {
 public:
     PerimeterClient();
 
     /**
-     * Initialiserer klienten
+     * Initialiserer klienten (blokerer ikke - første status hentes i update())
      * @param ip IP adresse på perimeter sender
      * @param port HTTP port (default 80)
      * @return true hvis initialisering lykkedes
      */
     bool begin(const char* ip = PERIMETER_SENDER_IP, int port = PERIMETER_SENDER_PORT);
 
+    /**
+     * Driver køen - kaldes hvert loop (blokerer ikke)
+     * Henter status hvert PERIMETER_STATUS_INTERVAL ms og kalder
+     * callbacks for færdige requests.
+     */
+    void update();
+
     /**
      * Starter perimeter wire signalet
-     * @return true hvis kommandoen lykkedes
+     * @param callback Kaldes når senderen har svaret (eller nullptr)
+     * @return true hvis kommandoen blev lagt i kø
      */
-    bool startSignal();
+    bool startSignal(PerimeterCallback callback = nullptr);
 
     /**
      * Stopper perimeter wire signalet
-     * @return true hvis kommandoen lykkedes
+     * @param callback Kaldes når senderen har svaret (eller nullptr)
+     * @return true hvis kommandoen blev lagt i kø
      */
-    bool stopSignal();
+    bool stopSignal(PerimeterCallback callback = nullptr);
 
     /**
      * Nulstiller perimeter sender efter fejl
-     * @return true hvis kommandoen lykkedes
+     * @param callback Kaldes når senderen har svaret (eller nullptr)
+     * @return true hvis kommandoen blev lagt i kø
      */
-    bool resetSender();
+    bool resetSender(PerimeterCallback callback = nullptr);
 
     /**
-     * Henter status fra perimeter sender
-     * @return true hvis status blev hentet
+     * Beder om ny status fra perimeter sender
+     * @param callback Kaldes når senderen har svaret (eller nullptr)
+     * @return true hvis requesten blev lagt i kø
      */
-    bool updateStatus();
+    bool requestStatus(PerimeterCallback callback = nullptr);
 
     /**
      * Tjekker om senderen kører
@@ -79,7 +123,50 @@ public:
     String getLastError() const { return _lastError; }
 
     /**
-     * Sætter sender IP adresse
+     * Antal requests i kø (inkl. den der er i gang)
+     */
+    int getQueueLength() const;
+
+    /**
+     * Aktuel ventetid mellem forsøg (0 = senderen svarer)
+     */
+    unsigned long getBackoffMs() const { return _backoffMs; }
+
+    /**
+     * Modtages UDP heartbeats fra senderen?
+     */
+    bool isLinkAlive() const;
+
+    /**
+     * Melder senderen fejl (kabelbrud, kortslutning, overstrøm) i sit heartbeat?
+     * DEGRADED er kun en advarsel - signalet kører stadig.
+     */
+    bool hasSenderFault() const {
+        return isLinkAlive() && _linkError != PERIMETER_LINK_OK && _linkError != PERIMETER_LINK_ERR_DEGRADED;
+    }
+
+    /**
+     * Fejlkode fra seneste heartbeat (PerimeterLinkError)
+     */
+    uint8_t getLinkError() const { return _linkError; }
+
+    /**
+     * Fejlkode fra seneste heartbeat som tekst
+     */
+    const char* getLinkErrorName() const { return linkErrorName(_linkError); }
+
+    /**
+     * Alder af seneste heartbeat (ms, 0 = aldrig modtaget)
+     */
+    unsigned long getHeartbeatAge() const;
+
+    /**
+     * Antal modtagne heartbeats
+     */
+    uint32_t getHeartbeatCount() const { return _heartbeatCount; }
+
+    /**
+     * Sætter sender IP adresse (åben forbindelse lukkes)
      */
     void setSenderIP(const char* ip);
 
@@ -89,6 +176,23 @@ public:
     String getSenderIP() const { return _senderIP; }
 
 private:
+    /**
+     * Fase for requesten i gang - skrives af både loop og AsyncTCP task
+     */
+    enum Phase {
+        PHASE_IDLE,         // Ingen request i gang
+        PHASE_CONNECTING,   // Venter på TCP forbindelse
+        PHASE_WAITING,      // Request sendt, venter på svar
+        PHASE_DONE,         // Svar modtaget - behandles i update()
+        PHASE_FAILED,       // Forbindelse/timeout fejl - behandles i update()
+        PHASE_UDP           // Kommando sendt over UDP, venter på ack (kun loop)
+    };
+
+    struct Request {
+        PerimeterCommand command;
+        PerimeterCallback callback;
+    };
+
     String _senderIP;
     int _senderPort;
     bool _initialized;
@@ -99,31 +203,109 @@ private:
     unsigned long _senderRuntime;
     String _lastError;
 
+    // Kø (web handlers lægger i kø fra AsyncTCP tasken, loop tømmer)
+    Request _queue[PERIMETER_QUEUE_SIZE];
+    int _queueHead;
+    int _queueCount;
+    mutable portMUX_TYPE _mux;
+
+    // Request i gang
+    AsyncClient _client;
+    volatile Phase _phase;
+    Request _active;
+    unsigned long _requestStart;
+    char _txBuffer[160];
+    char _rxBuffer[PERIMETER_RESPONSE_MAX + 1];
+    volatile size_t _rxLength;
+    volatile bool _rxOverflow;
+    volatile int8_t _errorCode;     // AsyncTCP fejlkode (0 = ingen)
+    bool _timedOut;
+    bool _reused;                   // Requesten blev sendt på en genbrugt forbindelse
+
+    // Back-off og status polling
+    unsigned long _backoffMs;
+    unsigned long _nextAttempt;
+    unsigned long _lastStatusRequest;
+
+    // UDP kanal (kun brugt fra loop)
+    WiFiUDP _udp;
+    bool _udpStarted;
+    unsigned long _lastHeartbeat;
+    uint16_t _heartbeatSequence;
+    uint32_t _heartbeatCount;
+    uint8_t _linkError;
+    uint16_t _udpSequence;          // Vores kommando sekvens
+    uint16_t _udpPending;           // Sekvens for kommandoen der venter på ack
+    uint8_t _udpAttempts;
+    unsigned long _udpSentAt;
+
     /**
-     * Sender HTTP GET request
-     * @param endpoint API endpoint (f.eks. "/api/status")
-     * @param response Output parameter for response body
-     * @return HTTP status kode eller -1 ved fejl
+     * Lægger request i kø
+     * @return false hvis køen er fuld eller klienten ikke er initialiseret
      */
-    int httpGet(const char* endpoint, String& response);
+    bool enqueue(PerimeterCommand command, PerimeterCallback callback);
 
     /**
-     * Sender HTTP POST request
-     * @param endpoint API endpoint (f.eks. "/api/start")
-     * @param response Output parameter for response body
-     * @return HTTP status kode eller -1 ved fejl
+     * Starter næste request fra køen
      */
-    int httpPost(const char* endpoint, String& response);
+    void startNext();
 
     /**
-     * Parser status JSON fra sender
+     * Starter den aktive request over HTTP
+     */
+    void startHttp();
+
+    /**
+     * Skriver HTTP request på den åbne forbindelse (AsyncTCP task eller loop)
+     */
+    void sendRequest();
+
+    /**
+     * Læser ventende UDP pakker (heartbeat og ack) - blokerer ikke
+     */
+    void pollUdp();
+
+    /**
+     * Sender (eller gensender) den aktive kommando over UDP
+     */
+    void sendUdpCommand();
+
+    /**
+     * Afslutter den aktive request uden HTTP (UDP ack eller heartbeat status)
      */
-    bool parseStatusResponse(const String& json);
+    void completeRequest(bool success);
 
     /**
-     * Bygger fuld URL fra endpoint
+     * Opdaterer sender status fra heartbeat
      */
-    String buildURL(const char* endpoint);
+    void handleHeartbeat(const PerimeterHeartbeat& heartbeat);
+
+    /**
+     * Behandler færdig/fejlet request i loop
+     */
+    void finishRequest();
+
+    /**
+     * Er svaret i _rxBuffer komplet? (headers + Content-Length bytes)
+     * @param closed true hvis forbindelsen er lukket (svar uden længde)
+     */
+    bool isResponseComplete(bool closed) const;
+
+    /**
+     * Parser status JSON fra sender
+     */
+    bool parseStatusResponse(const char* json);
+
+    // AsyncTCP callbacks
+    void onConnect();
+    void onData(const char* data, size_t len);
+    void onDisconnect();
+    void onError(int8_t error);
+
+    static const char* commandPath(PerimeterCommand command);
+    static const char* linkStateName(uint8_t state);
+    static const char* linkErrorName(uint8_t error);
+    static const char* commandMethod(PerimeterCommand command);
 };
 
 #endif // PERIMETER_CLIENT_H
@@ -0,0 +1,199 @@
+#include "SafetyMonitor.h"
+
+SafetyMonitor::SafetyMonitor() {
+    stateManagerPtr = nullptr;
+    motorsPtr = nullptr;
+    cuttingPtr = nullptr;
+    batteryPtr = nullptr;
+    imuPtr = nullptr;
+    obstacleAvoidPtr = nullptr;
+    sensorsPtr = nullptr;
+    #if ENABLE_PERIMETER
+    perimeterPtr = nullptr;
+    #endif
+    lastImuOk = 0;
+    signalSeen = false;
+    signalMissing = false;
+    signalLostSince = 0;
+    dockApproach = false;
+    initialized = false;
+}
+
+bool SafetyMonitor::begin(StateManager* stateManager, Motors* motors, CuttingMechanism* cutting) {
+    if (stateManager == nullptr || motors == nullptr || cutting == nullptr) {
+        Logger::error("SafetyMonitor: Invalid pointers");
+        return false;
+    }
+
+    stateManagerPtr = stateManager;
+    motorsPtr = motors;
+    cuttingPtr = cutting;
+    initialized = true;
+
+    Logger::info("Safety monitor initialized");
+
+    return true;
+}
+
+void SafetyMonitor::setDockApproach(bool approaching) {
+    dockApproach = approaching;
+}
+
+void SafetyMonitor::setBattery(Battery* battery) {
+    batteryPtr = battery;
+}
+
+void SafetyMonitor::setIMU(IMU* imu) {
+    imuPtr = imu;
+}
+
+void SafetyMonitor::setObstacleAvoidance(ObstacleAvoidance* obstacleAvoid, Sensors* sensors) {
+    obstacleAvoidPtr = obstacleAvoid;
+    sensorsPtr = sensors;
+}
+
+#if ENABLE_PERIMETER
+void SafetyMonitor::setPerimeterReceiver(PerimeterReceiver* receiver) {
+    perimeterPtr = receiver;
+}
+#endif
+
+void SafetyMonitor::checkBattery() {
+    if (!initialized || batteryPtr == nullptr) {
+        return;
+    }
+
+    // Mættet eller død ADC giver en spænding batteriet ikke kan have
+    float voltage = batteryPtr->getVoltage();
+    if (stateManagerPtr->isActive() &&
+        (voltage < SAFETY_BATTERY_SENSE_MIN || voltage > SAFETY_BATTERY_SENSE_MAX)) {
+        Logger::error("Battery reading implausible: " + String(voltage, 2) + "V");
+        stateManagerPtr->handleError("Battery sensor fault");
+        return;
+    }
+
+    // Tjek batteri niveau
+    if (batteryPtr->isCritical()) {
+        Logger::error("Critical battery level!");
+        stateManagerPtr->handleError("Critical battery");
+    } else if (batteryPtr->isLow() && stateManagerPtr->isActive()) {
+        Logger::warning("Low battery - returning to base");
+        stateManagerPtr->dispatch(EVENT_RETURN_HOME);
+    }
+}
+
+void SafetyMonitor::checkIMU(bool readOk) {
+    if (!initialized || imuPtr == nullptr) {
+        return;
+    }
+
+    // Hængt I2C bus giver ingen nye målinger - uden dem ser vi ikke om robotten vælter
+    unsigned long now = millis();
+    if (readOk) {
+        lastImuOk = now;
+    } else if (lastImuOk != 0 && stateManagerPtr->isActive() &&
+               now - lastImuOk > SAFETY_IMU_STALE_MS) {
+        Logger::error("IMU not responding for " + String(now - lastImuOk) + " ms");
+        stateManagerPtr->handleError("IMU not responding");
+        return;
+    }
+
+    // Tjek for væltet robot
+    if (imuPtr->isTilted() && stateManagerPtr->isActive()) {
+        Logger::error("Robot tilted - emergency stop!");
+        stateManagerPtr->handleError("Robot tilted");
+    }
+}
+
+void SafetyMonitor::check() {
+    if (!initialized) {
+        return;
+    }
+
+    // Kritiske sikkerhedstjek
+
+    // 1. Batteri kritisk
+    if (batteryPtr != nullptr && batteryPtr->isCritical() && !stateManagerPtr->hasError()) {
+        stateManagerPtr->handleError("Critical battery voltage");
+        return;
+    }
+
+    // 2. Robot væltet
+    #if ENABLE_IMU && AUTO_STOP_ON_TILT
+    if (imuPtr != nullptr && imuPtr->isTilted() && stateManagerPtr->isActive()) {
+        stateManagerPtr->handleError("Robot tilted/flipped");
+        return;
+    }
+    #endif
+
+    // 3. Kritisk forhindring direkte foran (undtagen docken under slutindkørsel)
+    if (obstacleAvoidPtr != nullptr && sensorsPtr != nullptr) {
+        obstacleAvoidPtr->update(sensorsPtr);
+        if (obstacleAvoidPtr->isCriticalObstacle() && stateManagerPtr->isActive() && !dockApproach) {
+            motorsPtr->stop();
+            Logger::warning("Critical obstacle - stopped");
+        }
+    }
+
+    // 4. Perimeter grænse
+    #if ENABLE_PERIMETER
+    if (perimeterPtr == nullptr) {
+        return;
+    }
+
+    if (!stateManagerPtr->isActive() || stateManagerPtr->isInState(STATE_SEARCHING_SIGNAL)) {
+        // Signal søgning håndterer selv et manglende signal
+        signalSeen = false;
+        signalMissing = false;
+    } else if (perimeterPtr->hasSignal()) {
+        signalSeen = true;
+        signalMissing = false;
+
+        if (perimeterPtr->isOutside()) {
+            motorsPtr->stop();
+            Logger::warning("Outside perimeter - stopped!");
+        }
+    } else if (signalSeen) {
+        // Signalet var der og er væk (kabelbrud, sender nede) - grænsen er usynlig
+        unsigned long now = millis();
+        if (!signalMissing) {
+            signalMissing = true;
+            signalLostSince = now;
+        } else if (now - signalLostSince >= SAFETY_SIGNAL_LOST_MS) {
+            motorsPtr->stop();
+            Logger::warning("Perimeter signal lost - stopped!");
+            signalSeen = false;
+            signalMissing = false;
+            stateManagerPtr->dispatch(EVENT_SIGNAL_LOST);
+        }
+    }
+    #endif
+}
+
+#if ENABLE_PERIMETER
+void SafetyMonitor::reportSenderFault(const char* reason) {
+    if (!initialized) {
+        return;
+    }
+
+    // Kun under kørsel - signal søgning håndterer selv et manglende signal
+    if (!stateManagerPtr->isActive() || stateManagerPtr->isInState(STATE_SEARCHING_SIGNAL)) {
+        return;
+    }
+
+    motorsPtr->stop();
+    Logger::warning("Perimeter sender fault (" + String(reason) + ") - stopped!");
+    signalSeen = false;
+    signalMissing = false;
+    stateManagerPtr->dispatch(EVENT_SIGNAL_LOST);
+}
+#endif
+
+void SafetyMonitor::emergencyStop() {
+    if (!initialized) {
+        return;
+    }
+
+    motorsPtr->emergencyStop();
+    cuttingPtr->emergencyStop();
+}
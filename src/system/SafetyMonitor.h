@@ -0,0 +1,130 @@
+#ifndef SAFETY_MONITOR_H
+#define SAFETY_MONITOR_H
+
+#include <Arduino.h>
+#include "../config/Config.h"
+#include "StateManager.h"
+#include "Logger.h"
+#include "../hardware/Motors.h"
+#include "../hardware/CuttingMechanism.h"
+#include "../hardware/Battery.h"
+#include "../hardware/IMU.h"
+#include "../hardware/Sensors.h"
+#include "../navigation/ObstacleAvoidance.h"
+#if ENABLE_PERIMETER
+#include "../hardware/PerimeterReceiver.h"
+#endif
+
+/**
+ * SafetyMonitor klasse - Sikkerhedstjek samlet ét sted
+ *
+ * Indeholder de tjek loop() tidligere lavede direkte i main.cpp
+ * (kritisk batteri, væltet robot, kritisk forhindring, uden for
+ * perimeter) samt tjek af selve målingerne: IMU der holder op med at
+ * svare (I2C hang), batteri ADC der er mættet eller død, og perimeter
+ * signal der forsvinder under klipning.
+ *
+ * Klassen kender kun hardware klasserne og StateManager, så den kan
+ * køres på host med simulerede drivere (se tools/fault_harness).
+ */
+class SafetyMonitor {
+public:
+    /**
+     * Constructor
+     */
+    SafetyMonitor();
+
+    /**
+     * Initialiserer monitor
+     * @param stateManager Pointer til StateManager
+     * @param motors Pointer til Motors
+     * @param cutting Pointer til CuttingMechanism
+     * @return true hvis succesfuld, false ved fejl
+     */
+    bool begin(StateManager* stateManager, Motors* motors, CuttingMechanism* cutting);
+
+    /**
+     * Sæt batteri (påkrævet for batteri tjek)
+     */
+    void setBattery(Battery* battery);
+
+    /**
+     * Sæt IMU (påkrævet for vælte og I2C tjek)
+     */
+    void setIMU(IMU* imu);
+
+    /**
+     * Sæt forhindrings detektion (påkrævet for kritisk forhindring)
+     */
+    void setObstacleAvoidance(ObstacleAvoidance* obstacleAvoid, Sensors* sensors);
+
+    #if ENABLE_PERIMETER
+    /**
+     * Sæt perimeter modtager (påkrævet for perimeter tjek)
+     */
+    void setPerimeterReceiver(PerimeterReceiver* receiver);
+    #endif
+
+    /**
+     * Tjek efter ny batteri måling (kaldes efter battery.update())
+     */
+    void checkBattery();
+
+    /**
+     * Tjek efter IMU opdatering (kaldes efter imu.update())
+     * @param readOk Resultat af imu.update()
+     */
+    void checkIMU(bool readOk);
+
+    /**
+     * Kritiske tjek - kaldes hvert loop
+     */
+    void check();
+
+    #if ENABLE_PERIMETER
+    /**
+     * Senderen melder fejl (kabelbrud, overstrøm) - behandles som tabt
+     * signal med det samme i stedet for at vente på modtageren
+     * @param reason Årsag (logges)
+     */
+    void reportSenderFault(const char* reason);
+    #endif
+
+    /**
+     * Slutindkørsel til docken i gang - docken selv er tættere end
+     * OBSTACLE_CRITICAL_DISTANCE, så kritisk forhindring stopper ikke motorerne
+     * @param approaching true mens DockingController kører ind mod docken
+     */
+    void setDockApproach(bool approaching);
+
+    /**
+     * Stop motorer og kniv øjeblikkeligt (fra ERROR tilstandens onEnter)
+     */
+    void emergencyStop();
+
+private:
+    StateManager* stateManagerPtr;
+    Motors* motorsPtr;
+    CuttingMechanism* cuttingPtr;
+    Battery* batteryPtr;
+    IMU* imuPtr;
+    ObstacleAvoidance* obstacleAvoidPtr;
+    Sensors* sensorsPtr;
+    #if ENABLE_PERIMETER
+    PerimeterReceiver* perimeterPtr;
+    #endif
+
+    // IMU overvågning
+    unsigned long lastImuOk;        // Sidste gyldige IMU måling (0 = ingen endnu)
+
+    // Perimeter overvågning
+    bool signalSeen;                // Signal set siden robotten blev aktiv
+    bool signalMissing;             // Signal væk lige nu
+    unsigned long signalLostSince;  // Start på sammenhængende signal tab
+
+    bool dockApproach;              // Slutindkørsel til docken i gang
+
+    bool initialized;
+};
+
+#endif // SAFETY_MONITOR_H
@@ -0,0 +1,168 @@
+#include "SessionCheckpoint.h"
+#include <Preferences.h>
+#include <esp_system.h>
+
+static const char* NVS_NAMESPACE = "session";
+static const char* NVS_KEY = "ckpt";
+
+SessionCheckpoint* SessionCheckpoint::instance = nullptr;
+
+SessionCheckpoint::SessionCheckpoint() {
+    memset(&current, 0, sizeof(current));
+    memset(&stored, 0, sizeof(stored));
+    valid = false;
+    rowDirty = false;
+    poseDirty = false;
+    lastWrite = 0;
+    writes = 0;
+    records = 0;
+    initialized = false;
+}
+
+bool SessionCheckpoint::begin() {
+    Preferences prefs;
+
+    if (prefs.begin(NVS_NAMESPACE, true)) { // true = read-only
+        MowCheckpoint loaded;
+        size_t length = prefs.getBytes(NVS_KEY, &loaded, sizeof(loaded));
+        prefs.end();
+
+        if (length == sizeof(loaded) && loaded.magic == CHECKPOINT_MAGIC &&
+            loaded.version == CHECKPOINT_VERSION) {
+            current = loaded;
+            stored = loaded;
+            valid = true;
+            Logger::info("Checkpoint found: zone " + String(loaded.zoneId) + ", row " +
+                         String(loaded.row) + "/" + String(loaded.totalRows));
+        }
+    }
+
+    instance = this;
+    esp_register_shutdown_handler(shutdownHandler);
+
+    initialized = true;
+    return true;
+}
+
+void SessionCheckpoint::record(const MowCheckpoint& checkpoint) {
+    if (!initialized) {
+        return;
+    }
+
+    records++;
+
+    bool progressChanged = !valid ||
+                           checkpoint.zoneId != stored.zoneId ||
+                           checkpoint.row != stored.row ||
+                           checkpoint.totalRows != stored.totalRows ||
+                           checkpoint.turnDir != stored.turnDir ||
+                           checkpoint.inField != stored.inField;
+
+    MowCheckpoint previous = current;
+    current = checkpoint;
+    current.magic = CHECKPOINT_MAGIC;
+    current.version = CHECKPOINT_VERSION;
+    current.sequence = previous.sequence;
+    valid = true;
+
+    if (progressChanged) {
+        rowDirty = true;
+        return;
+    }
+
+    float dx = current.poseX - stored.poseX;
+    float dy = current.poseY - stored.poseY;
+    if (sqrt(dx * dx + dy * dy) >= CHECKPOINT_POSE_MIN_CM) {
+        poseDirty = true;
+    }
+}
+
+void SessionCheckpoint::update() {
+    if (!initialized) {
+        return;
+    }
+
+    unsigned long sinceWrite = millis() - lastWrite;
+    if ((rowDirty && sinceWrite >= CHECKPOINT_MIN_INTERVAL) ||
+        (poseDirty && sinceWrite >= CHECKPOINT_POSE_INTERVAL)) {
+        write();
+    }
+}
+
+bool SessionCheckpoint::flush() {
+    if (!initialized || (!rowDirty && !poseDirty)) {
+        return false;
+    }
+    return write();
+}
+
+void SessionCheckpoint::clear() {
+    Preferences prefs;
+
+    valid = false;
+    rowDirty = false;
+    poseDirty = false;
+    memset(&stored, 0, sizeof(stored));
+
+    if (prefs.begin(NVS_NAMESPACE, false)) {
+        prefs.remove(NVS_KEY);
+        prefs.end();
+    }
+
+    Logger::info("Checkpoint cleared - next mowing starts from row 0");
+}
+
+String SessionCheckpoint::getJSON() {
+    String json = "{\"valid\":" + String(valid ? "true" : "false");
+    if (valid) {
+        json += ",\"zoneId\":" + String(current.zoneId);
+        json += ",\"row\":" + String(current.row);
+        json += ",\"totalRows\":" + String(current.totalRows);
+        json += ",\"inField\":" + String(current.inField ? "true" : "false");
+        json += ",\"x\":" + String(current.poseX, 0);
+        json += ",\"y\":" + String(current.poseY, 0);
+        json += ",\"heading\":" + String(current.heading, 1);
+        json += ",\"storedRow\":" + String(stored.row);
+        json += ",\"sequence\":" + String(stored.sequence);
+    }
+    json += ",\"pending\":" + String((rowDirty || poseDirty) ? "true" : "false");
+    json += ",\"writes\":" + String(writes);
+    json += ",\"records\":" + String(records);
+    json += "}";
+    return json;
+}
+
+bool SessionCheckpoint::write() {
+    Preferences prefs;
+    lastWrite = millis();
+
+    if (!prefs.begin(NVS_NAMESPACE, false)) {
+        Logger::error("Checkpoint: failed to open NVS");
+        return false;
+    }
+
+    current.sequence++;
+    size_t written = prefs.putBytes(NVS_KEY, &current, sizeof(current));
+    prefs.end();
+
+    if (written != sizeof(current)) {
+        Logger::error("Checkpoint: write failed");
+        return false;
+    }
+
+    stored = current;
+    rowDirty = false;
+    poseDirty = false;
+    writes++;
+
+    LOGD(LOG_SUB_CORE, "Checkpoint saved: row %d/%d (#%lu)",
+         current.row, current.totalRows, (unsigned long)current.sequence);
+    return true;
+}
+
+void SessionCheckpoint::shutdownHandler() {
+    // Kører i esp_restart() lige før genstart - kun ventende ændringer
+    if (instance != nullptr && (instance->rowDirty || instance->poseDirty)) {
+        instance->write();
+    }
+}
@@ -0,0 +1,116 @@
+#ifndef SESSION_CHECKPOINT_H
+#define SESSION_CHECKPOINT_H
+
+#include <Arduino.h>
+#include "../config/Config.h"
+#include "Logger.h"
+
+/**
+ * SessionCheckpoint - Gemmer klipnings fremskridt så det overlever genstart
+ *
+ * main registrerer planner fremskridt, position og zone hvert
+ * CHECKPOINT_UPDATE_INTERVAL mens der klippes. Skrivning til NVS samles:
+ * en ny række skrives højst hvert CHECKPOINT_MIN_INTERVAL, en flyttet
+ * position kun hvert CHECKPOINT_POSE_INTERVAL og kun hvis robotten har
+ * flyttet sig mindst CHECKPOINT_POSE_MIN_CM. Uændret tilstand skrives
+ * aldrig. Når klipningen stopper skrives med det samme, og en shutdown
+ * handler skriver ventende ændringer før ESP.restart() (OTA, WiFi opsætning).
+ * Ved brownout mistes højst det der er registreret siden sidste skrivning.
+ *
+ * Checkpointet er en lille struct der gemmes som én NVS blob - NVS står
+ * for wear-levelling.
+ */
+
+#define CHECKPOINT_MAGIC            0x4B43  // "CK"
+#define CHECKPOINT_VERSION          1
+
+struct MowCheckpoint {
+    uint16_t magic;
+    uint8_t version;
+    uint8_t zoneId;             // Zonen planen hører til (0 = standard mønster)
+    int16_t row;                // Række i gang - rækkerne før er klippet
+    int16_t totalRows;          // Mønstrets rækker (genoptag kun samme plan)
+    uint8_t turnDir;            // Direction for næste vending
+    uint8_t inField;            // 1 = robotten stod på plænen (position gælder)
+    uint16_t reserved;
+    float poseX;                // Position i forhold til mønstrets start (cm)
+    float poseY;
+    float heading;              // Grader (0-360)
+    uint32_t sequence;          // Stigende pr. skrivning
+};
+
+class SessionCheckpoint {
+public:
+    /**
+     * Constructor
+     */
+    SessionCheckpoint();
+
+    /**
+     * Indlæser gemt checkpoint og registrerer shutdown handler
+     * @return true hvis succesfuld (også uden gemt checkpoint)
+     */
+    bool begin();
+
+    /**
+     * Registrér nuværende tilstand (skrives senere, se update())
+     * @param checkpoint Ny tilstand (magic, version og sequence udfyldes her)
+     */
+    void record(const MowCheckpoint& checkpoint);
+
+    /**
+     * Skriver registreret tilstand hvis det er tid (kaldes periodisk)
+     */
+    void update();
+
+    /**
+     * Skriver ventende ændringer med det samme
+     * @return true hvis der blev skrevet
+     */
+    bool flush();
+
+    /**
+     * Sletter checkpoint - næste klipning starter forfra
+     */
+    void clear();
+
+    /**
+     * Findes der et checkpoint at genoptage fra?
+     */
+    bool hasCheckpoint() const { return valid; }
+
+    /**
+     * Hent seneste checkpoint (registreret eller indlæst)
+     */
+    const MowCheckpoint& getCheckpoint() const { return current; }
+
+    /**
+     * Hent status som JSON (/api/checkpoint)
+     */
+    String getJSON();
+
+private:
+    /**
+     * Skriver current til NVS
+     */
+    bool write();
+
+    /**
+     * Kaldes af esp_restart() - skriver ventende ændringer
+     */
+    static void shutdownHandler();
+
+    static SessionCheckpoint* instance;
+
+    MowCheckpoint current;      // Seneste registrerede tilstand
+    MowCheckpoint stored;       // Det der ligger i NVS
+    bool valid;
+    bool rowDirty;              // Række/zone ændret siden sidste skrivning
+    bool poseDirty;             // Kun position ændret
+    unsigned long lastWrite;
+    uint32_t writes;            // Skrivninger siden opstart
+    uint32_t records;           // Registreringer siden opstart
+    bool initialized;
+};
+
+#endif // SESSION_CHECKPOINT_H
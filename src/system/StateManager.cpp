@@ -1,17 +1,95 @@
 #include "StateManager.h"
+#include "BlackBox.h"
+
+// ============================================================================
+// TABELLER
+// ============================================================================
+
+// Hierarki - TURNING og AVOIDING er under-tilstande af MOWING.
+// Overgange mellem dem forlader ikke MOWING (ingen onExit/onEnter for MOWING).
+static const RobotState STATE_PARENTS[STATE_COUNT] = {
+    STATE_NONE,     // IDLE
+    STATE_NONE,     // MANUAL
+    STATE_NONE,     // CALIBRATING
+    STATE_NONE,     // MOWING
+    STATE_MOWING,   // TURNING
+    STATE_MOWING,   // AVOIDING
+    STATE_NONE,     // RETURNING
+    STATE_NONE,     // SEARCHING_SIGNAL
+    STATE_NONE,     // CHARGING
+    STATE_NONE      // ERROR
+};
+
+// Transition tabel - første match vinder.
+// STATE_ANY matcher ikke ERROR; fra ERROR kommer man kun via RECOVER eller MANUAL.
+// Til = STATE_NONE blokerer hændelsen før en senere STATE_ANY række.
+static const StateTransition TRANSITIONS[] = {
+    // Fra                      Hændelse                  Til
+    { STATE_ERROR,              EVENT_RECOVER,            STATE_IDLE },
+    { STATE_ERROR,              EVENT_MANUAL,             STATE_MANUAL },
+    { STATE_ANY,                EVENT_ERROR,              STATE_ERROR },
+
+    { STATE_ANY,                EVENT_START,              STATE_MOWING },
+    { STATE_MOWING,             EVENT_PAUSE,              STATE_IDLE },
+    { STATE_ANY,                EVENT_STOP,               STATE_IDLE },
+    { STATE_ANY,                EVENT_MANUAL,             STATE_MANUAL },
+
+    { STATE_ANY,                EVENT_CALIBRATE,          STATE_CALIBRATING },
+    { STATE_CALIBRATING,        EVENT_CALIBRATION_DONE,   STATE_IDLE },
+
+    { STATE_MOWING,             EVENT_OBSTACLE,           STATE_AVOIDING },
+    { STATE_AVOIDING,           EVENT_PATH_CLEAR,         STATE_MOWING },
+    { STATE_MOWING,             EVENT_ROW_END,            STATE_TURNING },
+    { STATE_TURNING,            EVENT_TURN_DONE,          STATE_MOWING },
+    { STATE_MOWING,             EVENT_PATTERN_DONE,       STATE_IDLE },
+
+    { STATE_CHARGING,           EVENT_RETURN_HOME,        STATE_NONE },
+    { STATE_ANY,                EVENT_RETURN_HOME,        STATE_RETURNING },
+    { STATE_ANY,                EVENT_SIGNAL_LOST,        STATE_SEARCHING_SIGNAL },
+    { STATE_SEARCHING_SIGNAL,   EVENT_SIGNAL_FOUND,       STATE_HISTORY },
+
+    { STATE_RETURNING,          EVENT_DOCKED,             STATE_CHARGING },
+    { STATE_IDLE,               EVENT_DOCKED,             STATE_CHARGING },
+    { STATE_CHARGING,           EVENT_UNDOCKED,           STATE_IDLE },
+};
+
+static const int TRANSITION_COUNT = sizeof(TRANSITIONS) / sizeof(TRANSITIONS[0]);
+
+// Histogram grænser (øvre grænse for hver bucket, sidste bucket er resten)
+static const uint32_t DWELL_LIMITS_MS[STATE_DWELL_BUCKETS - 1] = { 100, 1000, 10000, 60000, 600000 };
+static const uint32_t TICK_LIMITS_US[STATE_TICK_BUCKETS - 1] = { 100, 500, 2000, 10000, 50000 };
+
+// ============================================================================
+// OFFENTLIGE METODER
+// ============================================================================
 
 StateManager::StateManager() {
     currentState = STATE_IDLE;
     previousState = STATE_IDLE;
     stateStartTime = 0;
+    progressTime = 0;
     lastError = "";
+    blackBox = nullptr;
+    queueHead = 0;
+    queueCount = 0;
+    droppedEvents = 0;
+    queueMux = portMUX_INITIALIZER_UNLOCKED;
     initialized = false;
+
+    for (int i = 0; i < STATE_COUNT; i++) {
+        hooks[i].onEnter = nullptr;
+        hooks[i].onTick = nullptr;
+        hooks[i].onExit = nullptr;
+    }
+    resetStats();
 }
 
 bool StateManager::begin() {
     currentState = STATE_IDLE;
     previousState = STATE_IDLE;
     stateStartTime = millis();
+    progressTime = stateStartTime;
+    stats[STATE_IDLE].entries = 1;
     initialized = true;
 
     Logger::info("StateManager initialized - State: IDLE");
@@ -24,40 +102,100 @@ void StateManager::update() {
         return;
     }
 
+    // Behandl hændelser fra web handlers
+    processEvents();
+
     // Tjek for timeout i nuværende state
     checkStateTimeout();
-
-    // State-specifik logik kan tilføjes her hvis nødvendigt
 }
 
-void StateManager::setState(RobotState newState) {
+void StateManager::tick() {
     if (!initialized) {
         return;
     }
 
-    if (currentState == newState) {
-        return; // Ingen ændring
+    RobotState state = currentState;
+    StateHook onTick = hooks[state].onTick;
+    if (onTick == nullptr) {
+        return;
     }
 
-    // Gem forrige state
-    previousState = currentState;
+    unsigned long start = micros();
+    onTick();
+    uint32_t elapsed = micros() - start;
 
-    // Exit handler for gammel state
-    onStateExit(currentState);
+    // Tick tid tilskrives den tilstand der kørte, også hvis den skiftede
+    StateStats& s = stats[state];
+    s.ticks++;
+    if (elapsed > s.maxTickUs) {
+        s.maxTickUs = elapsed;
+    }
+    s.tickHistogram[bucketFor(elapsed, TICK_LIMITS_US, STATE_TICK_BUCKETS)]++;
+}
 
-    // Skift til ny state
-    currentState = newState;
-    stateStartTime = millis();
+void StateManager::setStateHooks(RobotState state, StateHook onEnter, StateHook onTick, StateHook onExit) {
+    if (state < 0 || state >= STATE_COUNT) {
+        return;
+    }
 
-    // Enter handler for ny state
-    onStateEnter(previousState, currentState);
+    hooks[state].onEnter = onEnter;
+    hooks[state].onTick = onTick;
+    hooks[state].onExit = onExit;
+}
 
-    // Log state change
-    String logMsg = "State changed: ";
-    logMsg += getStateName(previousState);
-    logMsg += " -> ";
-    logMsg += getStateName(currentState);
-    Logger::info(logMsg);
+bool StateManager::postEvent(StateEvent event) {
+    bool queued = false;
+
+    portENTER_CRITICAL(&queueMux);
+    if (queueCount < STATE_EVENT_QUEUE_SIZE) {
+        eventQueue[(queueHead + queueCount) % STATE_EVENT_QUEUE_SIZE] = event;
+        queueCount++;
+        queued = true;
+    } else {
+        droppedEvents++;
+    }
+    portEXIT_CRITICAL(&queueMux);
+
+    if (!queued) {
+        Logger::warning("State event queue full - dropped " + String(getEventName(event)));
+    }
+    return queued;
+}
+
+bool StateManager::dispatch(StateEvent event) {
+    if (!initialized) {
+        return false;
+    }
+
+    RobotState target = findTransition(currentState, event, previousState);
+
+    if (target == STATE_NONE) {
+        if (currentState == STATE_ERROR) {
+            Logger::warning("Event " + String(getEventName(event)) + " ignored - Robot in ERROR state");
+        } else {
+            LOGD(LOG_SUB_CORE, "Event %s ignored in %s",
+                 getEventName(event), getStateName().c_str());
+        }
+        return false;
+    }
+
+    LOGD(LOG_SUB_CORE, "Event %s: %s -> %s", getEventName(event),
+         getStateName().c_str(), getStateName(target).c_str());
+
+    if (target == currentState) {
+        return false;
+    }
+
+    transitionTo(target);
+    return true;
+}
+
+void StateManager::setState(RobotState newState) {
+    if (!initialized) {
+        return;
+    }
+
+    transitionTo(newState);
 }
 
 RobotState StateManager::getState() {
@@ -68,6 +206,10 @@ RobotState StateManager::getPreviousState() {
     return previousState;
 }
 
+bool StateManager::isInState(RobotState state) {
+    return isAncestorOrSelf(state, currentState);
+}
+
 String StateManager::getStateName() {
     return getStateName(currentState);
 }
@@ -88,69 +230,106 @@ String StateManager::getStateName(RobotState state) {
     }
 }
 
-void StateManager::startMowing() {
-    if (currentState == STATE_ERROR) {
-        Logger::warning("Cannot start mowing - Robot in ERROR state");
-        return;
+const char* StateManager::getEventName(StateEvent event) {
+    switch (event) {
+        case EVENT_START:            return "START";
+        case EVENT_PAUSE:            return "PAUSE";
+        case EVENT_STOP:             return "STOP";
+        case EVENT_MANUAL:           return "MANUAL";
+        case EVENT_CALIBRATE:        return "CALIBRATE";
+        case EVENT_CALIBRATION_DONE: return "CALIBRATION_DONE";
+        case EVENT_OBSTACLE:         return "OBSTACLE";
+        case EVENT_PATH_CLEAR:       return "PATH_CLEAR";
+        case EVENT_ROW_END:          return "ROW_END";
+        case EVENT_TURN_DONE:        return "TURN_DONE";
+        case EVENT_PATTERN_DONE:     return "PATTERN_DONE";
+        case EVENT_RETURN_HOME:      return "RETURN_HOME";
+        case EVENT_SIGNAL_LOST:      return "SIGNAL_LOST";
+        case EVENT_SIGNAL_FOUND:     return "SIGNAL_FOUND";
+        case EVENT_ERROR:            return "ERROR";
+        case EVENT_RECOVER:          return "RECOVER";
+        case EVENT_DOCKED:           return "DOCKED";
+        case EVENT_UNDOCKED:         return "UNDOCKED";
+        default:                     return "UNKNOWN";
     }
+}
 
-    setState(STATE_MOWING);
+RobotState StateManager::getParent(RobotState state) {
+    if (state < 0 || state >= STATE_COUNT) {
+        return STATE_NONE;
+    }
+    return STATE_PARENTS[state];
 }
 
-void StateManager::pauseMowing() {
-    if (currentState == STATE_MOWING ||
-        currentState == STATE_TURNING ||
-        currentState == STATE_AVOIDING) {
-        setState(STATE_IDLE);
-        Logger::info("Mowing paused");
+RobotState StateManager::findTransition(RobotState from, StateEvent event, RobotState previous) {
+    for (int i = 0; i < TRANSITION_COUNT; i++) {
+        const StateTransition& t = TRANSITIONS[i];
+        if (t.event != event) {
+            continue;
+        }
+
+        bool matches = (t.from == STATE_ANY) ? (from != STATE_ERROR)
+                                             : isAncestorOrSelf(t.from, from);
+        if (!matches) {
+            continue;
+        }
+
+        if (t.to != STATE_HISTORY) {
+            return t.to;
+        }
+
+        // Historik: tilbage til den autonome tilstand vi kom fra, ellers IDLE
+        RobotState root = previous;
+        while (getParent(root) != STATE_NONE) {
+            root = getParent(root);
+        }
+        return (root == STATE_MOWING || root == STATE_RETURNING) ? root : STATE_IDLE;
     }
+
+    return STATE_NONE;
+}
+
+void StateManager::startMowing() {
+    postEvent(EVENT_START);
+}
+
+void StateManager::pauseMowing() {
+    postEvent(EVENT_PAUSE);
 }
 
 void StateManager::stopMowing() {
-    if (currentState != STATE_IDLE && currentState != STATE_ERROR) {
-        setState(STATE_IDLE);
-        Logger::info("Mowing stopped");
-    }
+    postEvent(EVENT_STOP);
 }
 
-void StateManager::returnToBase() {
-    if (currentState == STATE_ERROR) {
-        Logger::warning("Cannot return to base - Robot in ERROR state");
+void StateManager::enterManualMode() {
+    // Allerede i manuel - undgå at fylde køen ved gentagne kommandoer
+    if (currentState == STATE_MANUAL) {
         return;
     }
+    postEvent(EVENT_MANUAL);
+}
 
-    setState(STATE_RETURNING);
-    Logger::info("Starting return to base - following perimeter");
+void StateManager::returnToBase() {
+    postEvent(EVENT_RETURN_HOME);
 }
 
 void StateManager::searchForSignal() {
-    if (currentState == STATE_ERROR) {
-        Logger::warning("Cannot search for signal - Robot in ERROR state");
-        return;
-    }
-
-    setState(STATE_SEARCHING_SIGNAL);
-    Logger::info("Starting signal search pattern");
+    postEvent(EVENT_SIGNAL_LOST);
 }
 
 void StateManager::handleError(String errorMessage) {
+    // Fejl håndteres med det samme - sikkerhed kan ikke vente på køen
     lastError = errorMessage;
-    setState(STATE_ERROR);
     Logger::error("Robot error: " + errorMessage);
+    dispatch(EVENT_ERROR);
 }
 
 void StateManager::recoverFromError() {
-    if (currentState == STATE_ERROR) {
-        lastError = "";
-        setState(STATE_IDLE);
-        Logger::info("Recovered from error state");
-    }
+    postEvent(EVENT_RECOVER);
 }
 
 bool StateManager::isActive() {
-    return (currentState == STATE_MOWING ||
-            currentState == STATE_TURNING ||
-            currentState == STATE_AVOIDING ||
+    return (isInState(STATE_MOWING) ||
             currentState == STATE_RETURNING ||
             currentState == STATE_SEARCHING_SIGNAL);
 }
@@ -167,10 +346,132 @@ unsigned long StateManager::getTimeInState() {
     return millis() - stateStartTime;
 }
 
-void StateManager::onStateEnter(RobotState oldState, RobotState newState) {
+void StateManager::reportProgress() {
+    progressTime = millis();
+}
+
+const StateStats& StateManager::getStats(RobotState state) {
+    if (state < 0 || state >= STATE_COUNT) {
+        state = STATE_IDLE;
+    }
+    return stats[state];
+}
+
+String StateManager::getStatsJSON() {
+    String json = "{\"current\":\"" + getStateName() + "\",";
+    json += "\"timeInState\":" + String(getTimeInState()) + ",";
+    json += "\"droppedEvents\":" + String(droppedEvents) + ",";
+
+    json += "\"dwellBucketsMs\":[";
+    for (int b = 0; b < STATE_DWELL_BUCKETS - 1; b++) {
+        json += (b > 0 ? "," : "") + String(DWELL_LIMITS_MS[b]);
+    }
+    json += "],\"tickBucketsUs\":[";
+    for (int b = 0; b < STATE_TICK_BUCKETS - 1; b++) {
+        json += (b > 0 ? "," : "") + String(TICK_LIMITS_US[b]);
+    }
+    json += "],\"states\":{";
+
+    for (int i = 0; i < STATE_COUNT; i++) {
+        const StateStats& s = stats[i];
+        if (i > 0) {
+            json += ",";
+        }
+        json += "\"" + getStateName((RobotState)i) + "\":{";
+        json += "\"entries\":" + String(s.entries) + ",";
+        json += "\"ticks\":" + String(s.ticks) + ",";
+        json += "\"dwellMs\":" + String(s.totalDwellMs) + ",";
+        json += "\"maxTickUs\":" + String(s.maxTickUs) + ",";
+        json += "\"dwell\":[";
+        for (int b = 0; b < STATE_DWELL_BUCKETS; b++) {
+            json += (b > 0 ? "," : "") + String(s.dwellHistogram[b]);
+        }
+        json += "],\"tick\":[";
+        for (int b = 0; b < STATE_TICK_BUCKETS; b++) {
+            json += (b > 0 ? "," : "") + String(s.tickHistogram[b]);
+        }
+        json += "]}";
+    }
+
+    json += "}}";
+    return json;
+}
+
+void StateManager::resetStats() {
+    memset(stats, 0, sizeof(stats));
+}
+
+void StateManager::setBlackBox(BlackBox* box) {
+    blackBox = box;
+}
+
+// ============================================================================
+// PRIVATE METODER
+// ============================================================================
+
+void StateManager::transitionTo(RobotState newState) {
+    if (newState < 0 || newState >= STATE_COUNT || newState == currentState) {
+        return;
+    }
+
+    // Registrér opholdstid for den tilstand vi forlader
+    uint32_t dwell = millis() - stateStartTime;
+    StateStats& old = stats[currentState];
+    old.totalDwellMs += dwell;
+    old.dwellHistogram[bucketFor(dwell, DWELL_LIMITS_MS, STATE_DWELL_BUCKETS)]++;
+
+    // Gem forrige state
+    previousState = currentState;
+
+    // Forlad tilstande op til fælles forælder (blad først)
+    RobotState common = currentState;
+    while (common != STATE_NONE && !isAncestorOrSelf(common, newState)) {
+        onStateExit(common);
+        common = getParent(common);
+    }
+
+    // Skift til ny state
+    currentState = newState;
+    stateStartTime = millis();
+    progressTime = stateStartTime;
+    stats[newState].entries++;
+
+    // Gå ind i tilstande fra fælles forælder ned til ny state (rod først)
+    RobotState path[STATE_COUNT];
+    int depth = 0;
+    for (RobotState s = newState; s != common && s != STATE_NONE; s = getParent(s)) {
+        path[depth++] = s;
+    }
+    while (depth > 0) {
+        onStateEnter(path[--depth]);
+    }
+
+    // Log state change
+    String logMsg = "State changed: ";
+    logMsg += getStateName(previousState);
+    logMsg += " -> ";
+    logMsg += getStateName(currentState);
+    Logger::info(logMsg);
+
+    #if ENABLE_BLACKBOX
+    if (blackBox != nullptr) {
+        blackBox->recordStateChange(previousState, currentState,
+                                    currentState == STATE_ERROR ? lastError.c_str() : "");
+
+        // Frys ved fejl, genoptag når fejlen er håndteret
+        if (currentState == STATE_ERROR) {
+            blackBox->freeze(lastError.c_str());
+        } else if (previousState == STATE_ERROR) {
+            blackBox->resume();
+        }
+    }
+    #endif
+}
+
+void StateManager::onStateEnter(RobotState state) {
     // Handling når der skiftes til ny state
 
-    switch (newState) {
+    switch (state) {
         case STATE_IDLE:
             // Robot går i idle - stop alle aktioner
             break;
@@ -188,7 +489,7 @@ void StateManager::onStateEnter(RobotState oldState, RobotState newState) {
             break;
 
         case STATE_TURNING:
-            Logger::debug("Executing turn maneuver");
+            LOGD(LOG_SUB_CORE, "Executing turn maneuver");
             break;
 
         case STATE_AVOIDING:
@@ -214,11 +515,19 @@ void StateManager::onStateEnter(RobotState oldState, RobotState newState) {
         default:
             break;
     }
+
+    if (hooks[state].onEnter != nullptr) {
+        hooks[state].onEnter();
+    }
 }
 
 void StateManager::onStateExit(RobotState state) {
     // Handling når der forlades en state
 
+    if (hooks[state].onExit != nullptr) {
+        hooks[state].onExit();
+    }
+
     switch (state) {
         case STATE_MOWING:
             Logger::info("Exiting mowing state");
@@ -228,11 +537,43 @@ void StateManager::onStateExit(RobotState state) {
             Logger::info("Calibration complete");
             break;
 
+        case STATE_ERROR:
+            lastError = "";
+            Logger::info("Recovered from error state");
+            break;
+
         default:
             break;
     }
 }
 
+bool StateManager::isAncestorOrSelf(RobotState ancestor, RobotState state) {
+    for (RobotState s = state; s != STATE_NONE; s = getParent(s)) {
+        if (s == ancestor) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void StateManager::processEvents() {
+    while (true) {
+        StateEvent event;
+
+        portENTER_CRITICAL(&queueMux);
+        if (queueCount == 0) {
+            portEXIT_CRITICAL(&queueMux);
+            break;
+        }
+        event = eventQueue[queueHead];
+        queueHead = (queueHead + 1) % STATE_EVENT_QUEUE_SIZE;
+        queueCount--;
+        portEXIT_CRITICAL(&queueMux);
+
+        dispatch(event);
+    }
+}
+
 void StateManager::checkStateTimeout() {
     unsigned long timeInState = getTimeInState();
 
@@ -246,8 +587,18 @@ void StateManager::checkStateTimeout() {
         currentState != STATE_CHARGING &&
         currentState != STATE_ERROR) {
 
-        if (timeInState > STATE_TIMEOUT) {
+        // Lange tilstande melder fremskridt - kun stilstand tæller
+        if (millis() - progressTime > STATE_TIMEOUT) {
             handleError("State timeout - stuck in " + getStateName());
         }
     }
 }
+
+int StateManager::bucketFor(uint32_t value, const uint32_t* limits, int count) {
+    for (int i = 0; i < count - 1; i++) {
+        if (value < limits[i]) {
+            return i;
+        }
+    }
+    return count - 1;
+}
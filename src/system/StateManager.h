@@ -5,6 +5,8 @@
 #include "../config/Config.h"
 #include "Logger.h"
 
+class BlackBox;
+
 /**
  * RobotState enum - Definerer alle robot tilstande
  */
@@ -13,18 +15,94 @@ enum RobotState {
     STATE_MANUAL,           // Manuel kontrol
     STATE_CALIBRATING,      // Kalibrerer sensorer
     STATE_MOWING,           // Klipper aktivt
-    STATE_TURNING,          // Drejer
-    STATE_AVOIDING,         // Undgår forhindring
+    STATE_TURNING,          // Drejer (under-tilstand af MOWING)
+    STATE_AVOIDING,         // Undgår forhindring (under-tilstand af MOWING)
     STATE_RETURNING,        // Vender tilbage til base (følger perimeter)
     STATE_SEARCHING_SIGNAL, // Søger efter perimeter signal
     STATE_CHARGING,         // Lader batteri
-    STATE_ERROR             // Fejltilstand
+    STATE_ERROR,            // Fejltilstand
+    STATE_COUNT
+};
+
+// Pseudo-tilstande - bruges kun i transition og parent tabellerne
+#define STATE_NONE      ((RobotState)0xFD)  // Ingen forælder / ingen overgang
+#define STATE_ANY       ((RobotState)0xFE)  // Matcher alle tilstande undtagen ERROR
+#define STATE_HISTORY   ((RobotState)0xFF)  // Tilbage til forrige autonome tilstand
+
+/**
+ * StateEvent enum - Hændelser der driver state machine
+ * Overgangene er defineret i transition tabellen i StateManager.cpp
+ */
+enum StateEvent {
+    EVENT_START,            // Start klipning
+    EVENT_PAUSE,            // Pause klipning
+    EVENT_STOP,             // Stop alt
+    EVENT_MANUAL,           // Manuel kommando modtaget
+    EVENT_CALIBRATE,        // Start kalibrering
+    EVENT_CALIBRATION_DONE, // Kalibrering færdig
+    EVENT_OBSTACLE,         // Forhindring detekteret
+    EVENT_PATH_CLEAR,       // Vejen er fri igen
+    EVENT_ROW_END,          // Række færdig eller perimeter nået - drej
+    EVENT_TURN_DONE,        // Drejning færdig
+    EVENT_PATTERN_DONE,     // Klipningsmønster færdigt
+    EVENT_RETURN_HOME,      // Kør hjem til base
+    EVENT_SIGNAL_LOST,      // Perimeter signal mistet
+    EVENT_SIGNAL_FOUND,     // Perimeter signal fundet igen
+    EVENT_ERROR,            // Fejl
+    EVENT_RECOVER,          // Fejl håndteret
+    EVENT_DOCKED,           // Ladekontakt lukket
+    EVENT_UNDOCKED,         // Ladekontakt åbnet under opladning
+    EVENT_COUNT
+};
+
+/**
+ * Række i transition tabellen
+ * "from" matcher også under-tilstande (f.eks. matcher MOWING også TURNING)
+ */
+struct StateTransition {
+    RobotState from;
+    StateEvent event;
+    RobotState to;
+};
+
+/**
+ * Hook funktion for en tilstand (onEnter, onTick eller onExit)
+ */
+typedef void (*StateHook)();
+
+/**
+ * Hooks for en tilstand - nullptr = ingen handling
+ */
+struct StateHooks {
+    StateHook onEnter;      // Kaldes én gang når tilstanden aktiveres
+    StateHook onTick;       // Kaldes hver loop mens tilstanden er den aktive blad-tilstand
+    StateHook onExit;       // Kaldes én gang når tilstanden forlades
+};
+
+// Histogram grænser - se StateManager.cpp
+#define STATE_DWELL_BUCKETS  6      // <100ms, <1s, <10s, <1min, <10min, resten
+#define STATE_TICK_BUCKETS   6      // <100us, <500us, <2ms, <10ms, <50ms, resten
+
+/**
+ * Statistik pr. tilstand
+ */
+struct StateStats {
+    uint32_t entries;                           // Antal gange tilstanden er aktiveret
+    uint32_t ticks;                             // Antal onTick kald
+    uint32_t totalDwellMs;                      // Samlet tid i tilstanden
+    uint32_t maxTickUs;                         // Længste onTick
+    uint32_t dwellHistogram[STATE_DWELL_BUCKETS];
+    uint32_t tickHistogram[STATE_TICK_BUCKETS];
 };
 
 /**
  * StateManager klasse - Håndterer robot state machine
  *
- * Denne klasse kontrollerer robot tilstande og overgange mellem dem.
+ * Tabel-drevet hierarkisk state machine. Hændelser sendes med
+ * postEvent() (trådsikker - bruges fra web handlers) eller dispatch()
+ * (øjeblikkelig - kun fra loop). Overgange slås op i transition tabellen,
+ * og onExit/onEnter hooks kaldes langs stien mellem tilstandene, så en
+ * overgang MOWING -> TURNING ikke forlader MOWING.
  */
 class StateManager {
 public:
@@ -40,13 +118,43 @@ public:
     bool begin();
 
     /**
-     * Opdaterer state machine
+     * Behandler ventende hændelser og tjekker timeouts
      * Kalder denne regelmæssigt i loop()
      */
     void update();
 
     /**
-     * Sætter ny robot tilstand
+     * Kører onTick hook for den aktive tilstand og måler tick tid
+     * Kalder denne regelmæssigt i loop() efter update()
+     */
+    void tick();
+
+    /**
+     * Registrerer hooks for en tilstand
+     * @param state Tilstand
+     * @param onEnter Kaldes ved indgang (eller nullptr)
+     * @param onTick Kaldes hver loop (eller nullptr)
+     * @param onExit Kaldes ved udgang (eller nullptr)
+     */
+    void setStateHooks(RobotState state, StateHook onEnter, StateHook onTick, StateHook onExit);
+
+    /**
+     * Lægger hændelse i kø - behandles i næste update()
+     * Trådsikker, kan kaldes fra AsyncTCP handlers
+     * @param event Hændelse
+     * @return false hvis køen er fuld
+     */
+    bool postEvent(StateEvent event);
+
+    /**
+     * Behandler hændelse med det samme (kun fra loop)
+     * @param event Hændelse
+     * @return true hvis hændelsen gav en overgang
+     */
+    bool dispatch(StateEvent event);
+
+    /**
+     * Sætter ny robot tilstand direkte uden om transition tabellen
      * @param newState Ny tilstand
      */
     void setState(RobotState newState);
@@ -63,6 +171,13 @@ public:
      */
     RobotState getPreviousState();
 
+    /**
+     * Tjek om tilstanden er aktiv - enten som blad eller som forælder
+     * @param state Tilstand
+     * @return true hvis state eller en af dens under-tilstande er aktiv
+     */
+    bool isInState(RobotState state);
+
     /**
      * Hent tilstands navn som string
      * @return String navn
@@ -76,6 +191,29 @@ public:
      */
     String getStateName(RobotState state);
 
+    /**
+     * Hent hændelses navn
+     * @param event Hændelse
+     * @return Navn (f.eks. "START")
+     */
+    static const char* getEventName(StateEvent event);
+
+    /**
+     * Hent forælder til en tilstand
+     * @param state Tilstand
+     * @return Forælder eller STATE_NONE
+     */
+    static RobotState getParent(RobotState state);
+
+    /**
+     * Slår en overgang op i transition tabellen (ingen sideeffekter)
+     * @param from Nuværende tilstand
+     * @param event Hændelse
+     * @param previous Forrige tilstand (til STATE_HISTORY)
+     * @return Ny tilstand eller STATE_NONE hvis hændelsen ignoreres
+     */
+    static RobotState findTransition(RobotState from, StateEvent event, RobotState previous);
+
     /**
      * Starter klipning
      */
@@ -91,6 +229,11 @@ public:
      */
     void stopMowing();
 
+    /**
+     * Skifter til manuel kontrol
+     */
+    void enterManualMode();
+
     /**
      * Starter return til base (følger perimeter)
      */
@@ -102,7 +245,7 @@ public:
     void searchForSignal();
 
     /**
-     * Håndterer fejl
+     * Håndterer fejl (øjeblikkelig overgang til ERROR)
      * @param errorMessage Fejlbesked
      */
     void handleError(String errorMessage);
@@ -136,35 +279,102 @@ public:
      */
     unsigned long getTimeInState();
 
+    /**
+     * Meld fremskridt i en lang tilstand (f.eks. en omgang langs kablet)
+     * Genstarter STATE_TIMEOUT uden at påvirke opholdstid og statistik
+     */
+    void reportProgress();
+
+    /**
+     * Hent statistik for en tilstand
+     * @param state Tilstand
+     * @return Statistik (dwell og tick histogrammer)
+     */
+    const StateStats& getStats(RobotState state);
+
+    /**
+     * Opret statistik JSON for alle tilstande
+     */
+    String getStatsJSON();
+
+    /**
+     * Nulstil statistik
+     */
+    void resetStats();
+
+    /**
+     * Sæt black box der optager state skift (nullptr = ingen)
+     * Ved STATE_ERROR fryses optagelsen, ved recovery genoptages den
+     * @param box Pointer til BlackBox
+     */
+    void setBlackBox(BlackBox* box);
+
 private:
     /**
-     * Kaldes når state ændres
-     * @param oldState Gammel tilstand
+     * Udfører overgang - kalder onExit/onEnter langs stien i hierarkiet
      * @param newState Ny tilstand
      */
-    void onStateEnter(RobotState oldState, RobotState newState);
+    void transitionTo(RobotState newState);
 
     /**
-     * Kaldes når state forlades
+     * Indbygget håndtering når en tilstand aktiveres
+     * @param state Tilstand
+     */
+    void onStateEnter(RobotState state);
+
+    /**
+     * Indbygget håndtering når en tilstand forlades
      * @param state Tilstand der forlades
      */
     void onStateExit(RobotState state);
 
+    /**
+     * Tjek om ancestor er state eller en forælder til state
+     */
+    static bool isAncestorOrSelf(RobotState ancestor, RobotState state);
+
+    /**
+     * Behandler alle hændelser i køen
+     */
+    void processEvents();
+
     /**
      * Tjek for state timeout
      */
     void checkStateTimeout();
 
+    /**
+     * Finder histogram bucket for en værdi
+     */
+    static int bucketFor(uint32_t value, const uint32_t* limits, int count);
+
     // Tilstande
     RobotState currentState;
     RobotState previousState;
 
+    // Hooks pr. tilstand
+    StateHooks hooks[STATE_COUNT];
+
+    // Hændelseskø (producer: web tasks, consumer: loop)
+    StateEvent eventQueue[STATE_EVENT_QUEUE_SIZE];
+    uint8_t queueHead;
+    uint8_t queueCount;
+    uint32_t droppedEvents;
+    portMUX_TYPE queueMux;
+
+    // Statistik
+    StateStats stats[STATE_COUNT];
+
     // Timing
     unsigned long stateStartTime;
+    unsigned long progressTime;     // Seneste fremskridt (state skift eller reportProgress)
 
     // Fejl info
     String lastError;
 
+    // Black box optager (valgfri)
+    BlackBox* blackBox;
+
     // Initialization flag
     bool initialized;
 };
@@ -0,0 +1,421 @@
+#include "StatsStore.h"
+#include "../hardware/Battery.h"
+#include "../hardware/Motors.h"
+#include <WiFi.h>
+#include <time.h>
+
+StatsStore::StatsStore() {
+    batteryPtr = nullptr;
+    stateManagerPtr = nullptr;
+    motorsPtr = nullptr;
+    memset(&data, 0, sizeof(data));
+    memset(&session, 0, sizeof(session));
+    sessionOpen = false;
+    sessionStart = 0;
+    distanceRemainder = 0.0;
+    mowedRemainder = 0.0;
+    lastUpdate = 0;
+    pendingMs = 0;
+    ntpStarted = false;
+    dirty = false;
+    saveDue = false;
+    lastSave = 0;
+    saves = 0;
+    initialized = false;
+}
+
+bool StatsStore::begin(Battery* battery, StateManager* stateManager) {
+    if (stateManager == nullptr) {
+        Logger::error("Stats: missing state manager");
+        return false;
+    }
+
+    batteryPtr = battery;
+    stateManagerPtr = stateManager;
+
+    if (!LittleFS.begin(true)) {
+        Logger::error("Stats: LittleFS mount fejlede");
+        return false;
+    }
+
+    bool loaded = false;
+    if (LittleFS.exists(STATS_FILE)) {
+        File file = LittleFS.open(STATS_FILE, "r");
+        loaded = file && file.read((uint8_t*)&data, sizeof(data)) == sizeof(data) &&
+                 data.magic == STATS_MAGIC && data.version == STATS_VERSION &&
+                 data.dayHead < STATS_DAYS && data.dayCount <= STATS_DAYS &&
+                 data.sessionHead < STATS_SESSIONS && data.sessionCount <= STATS_SESSIONS;
+        file.close();
+
+        if (!loaded) {
+            Logger::warning("Stats: " + String(STATS_FILE) + " ugyldig - starter forfra");
+        }
+    }
+
+    if (!loaded) {
+        memset(&data, 0, sizeof(data));
+        data.magic = STATS_MAGIC;
+        data.version = STATS_VERSION;
+        data.dayCount = 1;
+    }
+
+    lastUpdate = millis();
+    lastSave = lastUpdate;
+    initialized = true;
+
+    Logger::info("Stats loaded: " + String(data.totalSessions) + " sessions, " +
+                 String(data.dayCount) + " days");
+    return true;
+}
+
+void StatsStore::setMotors(Motors* motors) {
+    motorsPtr = motors;
+}
+
+void StatsStore::update(uint8_t zoneId) {
+    if (!initialized) {
+        return;
+    }
+
+    // Uret bruges kun til dags inddeling - SNTP startes første gang WiFi er oppe
+    if (!ntpStarted && WiFi.status() == WL_CONNECTED) {
+        configTzTime(STATS_TIMEZONE, STATS_NTP_SERVER);
+        ntpStarted = true;
+    }
+
+    unsigned long now = millis();
+    unsigned long dt = now - lastUpdate;
+    lastUpdate = now;
+
+    rollDay(currentDate());
+
+    // En session er sammenhængende selvstændig kørsel (klipning, hjemkørsel, søgning).
+    // Den slutter først når robotten er færdig - ikke ved signal søgning eller hjemkørsel.
+    RobotState state = stateManagerPtr->getState();
+
+    if (stateManagerPtr->isActive() && !sessionOpen) {
+        openSession(zoneId);
+    } else if (sessionOpen &&
+               (state == STATE_IDLE || state == STATE_CHARGING || state == STATE_ERROR)) {
+        closeSession(state);
+    }
+
+    // Hele sekunder pr. tilstand - resten tælles med næste gang
+    pendingMs += dt;
+    uint32_t seconds = pendingMs / 1000;
+    pendingMs %= 1000;
+
+    if (state < STATE_COUNT) {
+        today().stateSeconds[state] += seconds;
+    }
+
+    float energy = 0.0;
+    if (batteryPtr != nullptr && !batteryPtr->isCharging()) {
+        // Styringens batteri plus motor batteriet (5S måles ikke - talt strøm ved nominel spænding)
+        float power = batteryPtr->getVoltage() * batteryPtr->getCurrent();
+        #if !BATTERY_COUNT_MOTOR_CURRENT
+        power += batteryPtr->getMotorPackCurrent() * MOTOR_BATTERY_NOMINAL;
+        #endif
+        energy = power * dt / 3600000.0;
+    }
+    today().energyWh += energy;
+    data.totalEnergyWh += energy;
+
+    if (sessionOpen) {
+        session.energyWh += energy;
+        data.totalActiveSeconds += seconds;
+
+        ZoneStats* zone = zoneSlot(session.zoneId);
+        if (zone != nullptr) {
+            zone->energyWh += energy;
+            zone->activeSeconds += seconds;
+        }
+    }
+
+    dirty = true;
+
+    // Flash skrives kun mens robotten holder stille
+    if (!sessionOpen && isStationary() &&
+        (saveDue || now - lastSave >= STATS_SAVE_INTERVAL)) {
+        save();
+    }
+}
+
+void StatsStore::addDistance(float distanceCm, bool mowing) {
+    if (!initialized) {
+        return;
+    }
+
+    distanceRemainder += fabs(distanceCm);
+    uint32_t whole = (uint32_t)distanceRemainder;
+    distanceRemainder -= whole;
+
+    today().distanceCm += whole;
+    data.totalDistanceCm += whole;
+    if (sessionOpen) {
+        session.distanceCm += whole;
+    }
+
+    if (!mowing) {
+        return;
+    }
+
+    mowedRemainder += fabs(distanceCm);
+    uint32_t mowed = (uint32_t)mowedRemainder;
+    mowedRemainder -= mowed;
+
+    today().mowedCm += mowed;
+    data.totalMowedCm += mowed;
+    if (sessionOpen) {
+        session.mowedCm += mowed;
+
+        ZoneStats* zone = zoneSlot(session.zoneId);
+        if (zone != nullptr) {
+            zone->mowedCm += mowed;
+        }
+    }
+}
+
+void StatsStore::countAvoidance() {
+    if (!initialized) {
+        return;
+    }
+
+    today().avoidances++;
+    if (sessionOpen) {
+        session.avoidances++;
+    }
+}
+
+void StatsStore::countPerimeterHit() {
+    if (!initialized) {
+        return;
+    }
+
+    today().perimeterHits++;
+    if (sessionOpen) {
+        session.perimeterHits++;
+    }
+}
+
+bool StatsStore::save() {
+    if (!initialized) {
+        return false;
+    }
+
+    lastSave = millis();
+
+    // Skriv til temp fil og omdøb, så et strømsvigt ikke efterlader en halv fil
+    String tempPath = String(STATS_FILE) + ".tmp";
+    File file = LittleFS.open(tempPath, "w");
+    if (!file) {
+        Logger::error("Stats: kunne ikke skrive " + tempPath);
+        return false;
+    }
+
+    size_t written = file.write((const uint8_t*)&data, sizeof(data));
+    file.close();
+
+    if (written != sizeof(data)) {
+        Logger::error("Stats: skrivning af " + String(STATS_FILE) + " fejlede");
+        LittleFS.remove(tempPath);
+        return false;
+    }
+
+    LittleFS.remove(STATS_FILE);
+    if (!LittleFS.rename(tempPath, STATS_FILE)) {
+        return false;
+    }
+
+    dirty = false;
+    saveDue = false;
+    saves++;
+    LOGD(LOG_SUB_CORE, "Stats saved (#%lu)", (unsigned long)saves);
+    return true;
+}
+
+String StatsStore::getJSON() {
+    String json = "{\"clockSet\":" + String(currentDate() != 0 ? "true" : "false");
+    json += ",\"rowWidthCm\":" + String(MOWING_PATTERN_WIDTH);
+
+    json += ",\"totals\":{\"sessions\":" + String(data.totalSessions);
+    json += ",\"distanceM\":" + String(data.totalDistanceCm / 100.0, 1);
+    json += ",\"areaM2\":" + String(areaM2(data.totalMowedCm), 1);
+    json += ",\"energyWh\":" + String(data.totalEnergyWh, 1);
+    json += ",\"activeS\":" + String(data.totalActiveSeconds);
+    json += "}";
+
+    json += ",\"current\":";
+    if (sessionOpen) {
+        json += "{\"zoneId\":" + String(session.zoneId);
+        json += ",\"durationS\":" + String((millis() - sessionStart) / 1000);
+        json += ",\"distanceM\":" + String(session.distanceCm / 100.0, 1);
+        json += ",\"areaM2\":" + String(areaM2(session.mowedCm), 1);
+        json += ",\"energyWh\":" + String(session.energyWh, 2);
+        json += "}";
+    } else {
+        json += "null";
+    }
+
+    // Nyeste først
+    json += ",\"days\":[";
+    for (int i = 0; i < data.dayCount; i++) {
+        const DayStats& day = data.days[(data.dayHead - i + STATS_DAYS) % STATS_DAYS];
+        if (i > 0) json += ",";
+        json += "{\"date\":" + String(day.date);
+        json += ",\"sessions\":" + String(day.sessions);
+        json += ",\"distanceM\":" + String(day.distanceCm / 100.0, 1);
+        json += ",\"areaM2\":" + String(areaM2(day.mowedCm), 1);
+        json += ",\"energyWh\":" + String(day.energyWh, 1);
+        json += ",\"avoidances\":" + String(day.avoidances);
+        json += ",\"perimeterHits\":" + String(day.perimeterHits);
+        json += ",\"stateS\":{";
+        bool first = true;
+        for (int s = 0; s < STATE_COUNT; s++) {
+            if (day.stateSeconds[s] == 0) continue;
+            if (!first) json += ",";
+            json += "\"" + String(stateManagerPtr->getStateName((RobotState)s)) + "\":" + String(day.stateSeconds[s]);
+            first = false;
+        }
+        json += "}}";
+    }
+    json += "]";
+
+    json += ",\"sessions\":[";
+    for (int i = 0; i < data.sessionCount; i++) {
+        const SessionStats& s = data.sessions[(data.sessionHead - 1 - i + STATS_SESSIONS) % STATS_SESSIONS];
+        if (i > 0) json += ",";
+        json += "{\"start\":" + String(s.startTime);
+        json += ",\"zoneId\":" + String(s.zoneId);
+        json += ",\"durationS\":" + String(s.durationS);
+        json += ",\"distanceM\":" + String(s.distanceCm / 100.0, 1);
+        json += ",\"areaM2\":" + String(areaM2(s.mowedCm), 1);
+        json += ",\"energyWh\":" + String(s.energyWh, 2);
+        json += ",\"avoidances\":" + String(s.avoidances);
+        json += ",\"perimeterHits\":" + String(s.perimeterHits);
+        json += ",\"endState\":\"" + String(stateManagerPtr->getStateName((RobotState)s.endState)) + "\"";
+        json += "}";
+    }
+    json += "]";
+
+    json += ",\"zones\":[";
+    bool first = true;
+    for (int i = 0; i < STATS_ZONE_SLOTS; i++) {
+        const ZoneStats& zone = data.zones[i];
+        if (!zone.used) continue;
+        if (!first) json += ",";
+        float area = areaM2(zone.mowedCm);
+        json += "{\"zoneId\":" + String(zone.zoneId);
+        json += ",\"sessions\":" + String(zone.sessions);
+        json += ",\"activeS\":" + String(zone.activeSeconds);
+        json += ",\"areaM2\":" + String(area, 1);
+        json += ",\"energyWh\":" + String(zone.energyWh, 1);
+        json += ",\"whPerM2\":" + String(area > 0.0 ? zone.energyWh / area : 0.0, 3);
+        json += "}";
+        first = false;
+    }
+    json += "]";
+
+    json += ",\"pending\":" + String(dirty ? "true" : "false");
+    json += ",\"saves\":" + String(saves);
+    json += "}";
+    return json;
+}
+
+uint32_t StatsStore::currentDate() {
+    time_t now = time(nullptr);
+    if (now < 1600000000) {
+        return 0;   // SNTP har ikke sat uret endnu
+    }
+
+    struct tm local;
+    localtime_r(&now, &local);
+    return (local.tm_year + 1900) * 10000 + (local.tm_mon + 1) * 100 + local.tm_mday;
+}
+
+void StatsStore::rollDay(uint32_t date) {
+    if (date == 0 || date == today().date) {
+        return;
+    }
+
+    // Uret er lige sat - dagen uden dato er i dag
+    if (today().date == 0) {
+        today().date = date;
+        return;
+    }
+
+    data.dayHead = (data.dayHead + 1) % STATS_DAYS;
+    if (data.dayCount < STATS_DAYS) {
+        data.dayCount++;
+    }
+    memset(&today(), 0, sizeof(DayStats));
+    today().date = date;
+    saveDue = true;
+}
+
+bool StatsStore::isStationary() {
+    if (stateManagerPtr->isActive()) {
+        return false;
+    }
+    return (motorsPtr == nullptr || !motorsPtr->isMoving());
+}
+
+void StatsStore::openSession(uint8_t zoneId) {
+    memset(&session, 0, sizeof(session));
+    session.zoneId = zoneId;
+    time_t now = time(nullptr);
+    session.startTime = (now >= 1600000000) ? (uint32_t)now : 0;
+    sessionStart = millis();
+    sessionOpen = true;
+
+    data.totalSessions++;
+    today().sessions++;
+
+    ZoneStats* zone = zoneSlot(zoneId);
+    if (zone != nullptr) {
+        zone->sessions++;
+    }
+
+    LOGD(LOG_SUB_CORE, "Stats: session started (zone %d)", zoneId);
+}
+
+void StatsStore::closeSession(RobotState state) {
+    session.durationS = (millis() - sessionStart) / 1000;
+    session.endState = (uint8_t)state;
+    sessionOpen = false;
+
+    data.sessions[data.sessionHead] = session;
+    data.sessionHead = (data.sessionHead + 1) % STATS_SESSIONS;
+    if (data.sessionCount < STATS_SESSIONS) {
+        data.sessionCount++;
+    }
+
+    Logger::info("Session done: " + String(session.durationS / 60) + " min, " +
+                 String(areaM2(session.mowedCm), 0) + " m2, " +
+                 String(session.energyWh, 1) + " Wh");
+    saveDue = true;
+}
+
+ZoneStats* StatsStore::zoneSlot(uint8_t zoneId) {
+    ZoneStats* freeSlot = nullptr;
+
+    for (int i = 0; i < STATS_ZONE_SLOTS; i++) {
+        if (data.zones[i].used && data.zones[i].zoneId == zoneId) {
+            return &data.zones[i];
+        }
+        if (!data.zones[i].used && freeSlot == nullptr) {
+            freeSlot = &data.zones[i];
+        }
+    }
+
+    if (freeSlot != nullptr) {
+        memset(freeSlot, 0, sizeof(ZoneStats));
+        freeSlot->zoneId = zoneId;
+        freeSlot->used = 1;
+    }
+    return freeSlot;
+}
+
+float StatsStore::areaM2(uint32_t mowedCm) {
+    return mowedCm * (float)MOWING_PATTERN_WIDTH / 10000.0;
+}
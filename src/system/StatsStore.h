@@ -0,0 +1,217 @@
+#ifndef STATS_STORE_H
+#define STATS_STORE_H
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include "../config/Config.h"
+#include "Logger.h"
+#include "StateManager.h"
+
+class Battery;
+class Motors;
+
+/**
+ * StatsStore - Klippetid, distance og energi pr. session, dag og zone
+ *
+ * main kalder update() hvert STATS_UPDATE_INTERVAL med nuværende zone.
+ * Tid pr. tilstand og energi (begge batterier, ikke under opladning)
+ * lægges til dagen, og mens robotten er aktiv også til sessionen og zonen. Distance, forhindringer og perimeter ramt tælles af
+ * main. En session løber fra robotten bliver aktiv til den holder stille.
+ *
+ * Historikken er faste ringe: STATS_DAYS dage og STATS_SESSIONS sessioner,
+ * ældste overskrives. Dagen kommer fra SNTP når WiFi er forbundet - før
+ * uret er sat tælles der på en dag uden dato, som får datoen når uret sættes.
+ *
+ * Alt ligger i én struct i STATS_FILE på LittleFS. Den skrives når en
+ * session slutter, ved dagsskift og ellers højst hvert STATS_SAVE_INTERVAL
+ * mens robotten holder stille - aldrig midt i klipningen.
+ */
+
+#define STATS_MAGIC                 0x5453  // "ST"
+#define STATS_VERSION               1
+
+/**
+ * Statistik for én dag
+ */
+struct DayStats {
+    uint32_t date;                      // yyyymmdd (0 = uret ikke sat)
+    uint16_t sessions;
+    uint16_t avoidances;
+    uint16_t perimeterHits;
+    uint16_t reserved;
+    uint32_t distanceCm;                // Kørt i alt
+    uint32_t mowedCm;                   // Kørt med kniven (klippet areal = mowedCm x rækkebredde)
+    float energyWh;                     // Forbrugt (ikke opladning)
+    uint32_t stateSeconds[STATE_COUNT]; // Tid i hver tilstand
+};
+
+/**
+ * Statistik for én session
+ */
+struct SessionStats {
+    uint32_t startTime;                 // Unix tid (0 = uret ikke sat)
+    uint32_t durationS;
+    uint32_t distanceCm;
+    uint32_t mowedCm;
+    float energyWh;
+    uint16_t avoidances;
+    uint16_t perimeterHits;
+    uint8_t zoneId;
+    uint8_t endState;                   // Tilstand der afsluttede sessionen
+    uint16_t reserved;
+};
+
+/**
+ * Samlet statistik for én zone
+ */
+struct ZoneStats {
+    uint8_t zoneId;
+    uint8_t used;
+    uint16_t sessions;
+    uint32_t activeSeconds;
+    uint32_t mowedCm;
+    float energyWh;
+};
+
+/**
+ * Hele statistik filen
+ */
+struct StatsData {
+    uint16_t magic;
+    uint8_t version;
+    uint8_t reserved;
+    uint16_t dayHead;                   // Indeks for dagen i dag
+    uint16_t dayCount;
+    uint16_t sessionHead;               // Næste plads der skrives
+    uint16_t sessionCount;
+    uint32_t totalSessions;
+    uint32_t totalDistanceCm;
+    uint32_t totalMowedCm;
+    float totalEnergyWh;
+    uint32_t totalActiveSeconds;
+    DayStats days[STATS_DAYS];
+    SessionStats sessions[STATS_SESSIONS];
+    ZoneStats zones[STATS_ZONE_SLOTS];
+};
+
+class StatsStore {
+public:
+    /**
+     * Constructor
+     */
+    StatsStore();
+
+    /**
+     * Indlæser gemt statistik fra LittleFS
+     * @param battery Batteri (spænding og strøm til energi)
+     * @param stateManager State manager (tilstand og aktiv)
+     * @return true hvis succesfuld (også uden gemt statistik)
+     */
+    bool begin(Battery* battery, StateManager* stateManager);
+
+    /**
+     * Sætter motorer der afgør om robotten holder stille (flash skrivning)
+     * @param motors Pointer til Motors (nullptr = kun tilstanden bruges)
+     */
+    void setMotors(Motors* motors);
+
+    /**
+     * Integrér tid og energi, åbn/luk session og skriv til flash
+     * @param zoneId Zonen der klippes (0 = standard mønster)
+     */
+    void update(uint8_t zoneId);
+
+    /**
+     * Tilføj kørt distance (fra dead reckoning)
+     * @param distanceCm Distance i cm (negativ ved bakning)
+     * @param mowing true hvis kniven kører (tæller som klippet)
+     */
+    void addDistance(float distanceCm, bool mowing);
+
+    /**
+     * Tæl en forhindring der blev undgået
+     */
+    void countAvoidance();
+
+    /**
+     * Tæl en gang perimeter kablet blev nået
+     */
+    void countPerimeterHit();
+
+    /**
+     * Skriv statistik til LittleFS med det samme
+     * @return true hvis succesfuld
+     */
+    bool save();
+
+    /**
+     * Hent statistik som JSON (/api/stats)
+     */
+    String getJSON();
+
+private:
+    /**
+     * Dagens dato som yyyymmdd (0 hvis uret ikke er sat)
+     */
+    uint32_t currentDate();
+
+    /**
+     * Skift til ny dag hvis datoen er ændret
+     */
+    void rollDay(uint32_t date);
+
+    /**
+     * Robotten holder stille - flash kan skrives uden at forsinke motorerne
+     */
+    bool isStationary();
+
+    /**
+     * Start ny session
+     */
+    void openSession(uint8_t zoneId);
+
+    /**
+     * Afslut session og læg den i historikken
+     */
+    void closeSession(RobotState state);
+
+    /**
+     * Find (eller opret) zonens plads
+     * @return Pointer til zonens statistik, nullptr hvis alle pladser er brugt
+     */
+    ZoneStats* zoneSlot(uint8_t zoneId);
+
+    /**
+     * Dagen i dag
+     */
+    DayStats& today() { return data.days[data.dayHead]; }
+
+    /**
+     * Areal i m² ud fra klippet distance og rækkebredde
+     */
+    static float areaM2(uint32_t mowedCm);
+
+    Battery* batteryPtr;
+    StateManager* stateManagerPtr;
+    Motors* motorsPtr;
+
+    StatsData data;
+    SessionStats session;           // Igangværende session
+    bool sessionOpen;
+    unsigned long sessionStart;
+
+    float distanceRemainder;        // Brøkdel af cm der ikke er talt endnu
+    float mowedRemainder;
+    unsigned long lastUpdate;
+    unsigned long pendingMs;        // Tid der ikke er talt som hele sekunder endnu
+
+    bool ntpStarted;
+    bool dirty;
+    bool saveDue;                   // Session slut eller dagsskift - skriv når robotten holder stille
+    unsigned long lastSave;
+    uint32_t saves;
+
+    bool initialized;
+};
+
+#endif // STATS_STORE_H
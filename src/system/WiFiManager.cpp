@@ -1,79 +1,153 @@
 #include "WiFiManager.h"
+#include <esp_wifi.h>
+
+WiFiManager* WiFiManager::instance = nullptr;
 
 WiFiManager::WiFiManager() {
     dnsServer = nullptr;
     apMode = false;
     hasCredentials = false;
     failedAttempts = 0;
-    lastReconnectAttempt = 0;
+    linkState = WIFI_LINK_IDLE;
+    stateSince = 0;
+    backoffMs = WIFI_BACKOFF_MIN_MS;
+    roamScan = false;
+    lastRoamCheck = 0;
+    memset(targetBssid, 0, sizeof(targetBssid));
+    targetChannel = 0;
+    hasTarget = false;
+    roamPending = false;
+    memset(failedBssid, 0, sizeof(failedBssid));
+    hasFailedBssid = false;
+    gotIP = false;
+    disconnected = false;
+    disconnectReason = 0;
+    reconnects = 0;
+    roams = 0;
+    lastDisconnectReason = 0;
+    lastConnectMs = 0;
 }
 
 bool WiFiManager::begin() {
     Logger::info("Starting WiFi Manager...");
 
     // Prøv at indlæse gemte credentials
-    if (loadCredentials()) {
-        Logger::info("Found stored credentials for: " + storedSSID);
-
-        // Prøv at forbinde med gemte credentials
-        if (connectWiFi(storedSSID, storedPassword)) {
-            Logger::info("Connected to WiFi: " + storedSSID);
-            Logger::info("IP Address: " + WiFi.localIP().toString());
-            apMode = false;
-            failedAttempts = 0;
-            return true;
-        } else {
-            Logger::warning("Failed to connect with stored credentials");
-            failedAttempts++;
-
-            // Hvis for mange fejl, fallback til AP mode
-            if (failedAttempts >= MAX_FAILED_ATTEMPTS) {
-                Logger::error("Too many failed attempts - starting AP mode");
-                startCaptivePortal();
-                return false;
-            }
-        }
-    } else {
+    if (!loadCredentials()) {
         Logger::info("No stored credentials - starting captive portal");
         startCaptivePortal();
         return false;
     }
 
-    return false;
+    Logger::info("Found stored credentials for: " + storedSSID);
+
+    instance = this;
+    WiFi.onEvent(onWiFiEvent);
+
+    // Manageren styrer reconnect - driverens egen reconnect ville køre i kapløb med den
+    WiFi.persistent(false);
+    WiFi.setAutoReconnect(false);
+    WiFi.mode(WIFI_STA);
+
+    // Forbindelsen kommer senere via events - opstarten venter ikke
+    startScan();
+    return true;
 }
 
 void WiFiManager::update() {
     // Hvis i AP mode, håndter DNS server
-    if (apMode && dnsServer != nullptr) {
-        dnsServer->processNextRequest();
+    if (apMode) {
+        if (dnsServer != nullptr) {
+            dnsServer->processNextRequest();
+        }
         return;
     }
 
-    // Tjek WiFi forbindelse periodisk
-    unsigned long currentTime = millis();
-    if (currentTime - lastReconnectAttempt > RECONNECT_INTERVAL) {
-        lastReconnectAttempt = currentTime;
-
-        if (WiFi.status() != WL_CONNECTED) {
-            Logger::warning("WiFi disconnected - attempting reconnect...");
-            failedAttempts++;
-
-            if (hasCredentials) {
-                if (connectWiFi(storedSSID, storedPassword)) {
-                    Logger::info("Reconnected to WiFi");
-                    failedAttempts = 0;
-                } else if (failedAttempts >= MAX_FAILED_ATTEMPTS) {
-                    Logger::error("Too many reconnect failures - starting AP mode");
-                    startCaptivePortal();
-                }
+    if (!hasCredentials) {
+        return;
+    }
+
+    unsigned long now = millis();
+
+    if (gotIP) {
+        gotIP = false;
+
+        if (linkState != WIFI_LINK_CONNECTED) {
+            lastConnectMs = now - stateSince;
+            Logger::info("WiFi connected to " + WiFi.SSID() + " (" + WiFi.BSSIDstr() + ", " +
+                         String(WiFi.RSSI()) + " dBm) in " + String(lastConnectMs) + " ms");
+            Logger::info("IP Address: " + WiFi.localIP().toString());
+
+            failedAttempts = 0;
+            backoffMs = WIFI_BACKOFF_MIN_MS;
+            hasFailedBssid = false;
+            lastRoamCheck = now;
+            setLinkState(WIFI_LINK_CONNECTED);
+        }
+    }
+
+    if (disconnected) {
+        disconnected = false;
+        lastDisconnectReason = disconnectReason;
+
+        if (linkState == WIFI_LINK_CONNECTED) {
+            if (roamPending) {
+                // Vi afbrød selv - forbind direkte til det bedre access point
+                startConnect(targetBssid, targetChannel);
+            } else {
+                reconnects++;
+                Logger::warning("WiFi disconnected (reason " + String(lastDisconnectReason) + ") - reconnecting");
+                startScan();
             }
-        } else {
-            // Forbindelse OK - reset counter
-            if (failedAttempts > 0) {
-                Logger::info("WiFi connection restored");
-                failedAttempts = 0;
+        } else if (linkState == WIFI_LINK_CONNECTING) {
+            connectFailed();
+        }
+    }
+
+    switch (linkState) {
+        case WIFI_LINK_SCANNING: {
+            int16_t result = WiFi.scanComplete();
+            if (result == WIFI_SCAN_RUNNING && now - stateSince < WIFI_SCAN_TIMEOUT_MS) {
+                break;
             }
+
+            uint8_t bssid[6];
+            int32_t channel = 0;
+            int32_t rssi = 0;
+            bool found = (result >= 0) && chooseAccessPoint(bssid, channel, rssi);
+            WiFi.scanDelete();
+
+            if (found) {
+                LOGD(LOG_SUB_WEB, "WiFi: best AP on channel %ld (%ld dBm)", (long)channel, (long)rssi);
+                startConnect(bssid, channel);
+            } else {
+                // SSID ikke set (skjult netværk eller scanning fejlet) - lad driveren lede
+                startConnect(nullptr, 0);
+            }
+            break;
         }
+
+        case WIFI_LINK_CONNECTING:
+            if (now - stateSince >= WIFI_CONNECT_TIMEOUT_MS) {
+                // Afbryd forsøget - det sene disconnect event ignoreres i BACKOFF
+                esp_wifi_disconnect();
+                lastDisconnectReason = 0;
+                connectFailed();
+            }
+            break;
+
+        case WIFI_LINK_BACKOFF:
+            if (now - stateSince >= backoffMs) {
+                backoffMs = min(backoffMs * 2, (unsigned long)WIFI_BACKOFF_MAX_MS);
+                startScan();
+            }
+            break;
+
+        case WIFI_LINK_CONNECTED:
+            checkRoaming(now);
+            break;
+
+        default:
+            break;
     }
 }
 
@@ -119,9 +193,9 @@ bool WiFiManager::hasStoredCredentials() {
 void WiFiManager::startCaptivePortal() {
     Logger::info("Starting Captive Portal...");
 
-    // Stop eksisterende WiFi forbindelse
+    // Stop eksisterende WiFi forbindelse og ventende scanning
+    WiFi.scanDelete();
     WiFi.disconnect();
-    delay(100);
 
     // Start Access Point
     WiFi.mode(WIFI_AP);
@@ -130,6 +204,7 @@ void WiFiManager::startCaptivePortal() {
 
     if (success) {
         apMode = true;
+        setLinkState(WIFI_LINK_AP);
         IPAddress IP = WiFi.softAPIP();
         Logger::info("AP started: " + apSSID);
         Logger::info("AP IP: " + IP.toString());
@@ -182,10 +257,43 @@ String WiFiManager::getSSID() {
 
 void WiFiManager::forceAPMode() {
     Logger::info("Forcing AP mode");
-    failedAttempts = MAX_FAILED_ATTEMPTS;
+    failedAttempts = WIFI_MAX_RETRY;
     startCaptivePortal();
 }
 
+const char* WiFiManager::getLinkStateName() const {
+    switch (linkState) {
+        case WIFI_LINK_IDLE:        return "IDLE";
+        case WIFI_LINK_SCANNING:    return "SCANNING";
+        case WIFI_LINK_CONNECTING:  return "CONNECTING";
+        case WIFI_LINK_CONNECTED:   return "CONNECTED";
+        case WIFI_LINK_BACKOFF:     return "BACKOFF";
+        case WIFI_LINK_AP:          return "AP";
+        default:                    return "UNKNOWN";
+    }
+}
+
+String WiFiManager::getStatusJSON() {
+    bool connected = isConnected();
+
+    String json = "{\"state\":\"" + String(getLinkStateName()) + "\"";
+    json += ",\"ssid\":\"" + getSSID() + "\"";
+    json += ",\"ip\":\"" + getIPAddress() + "\"";
+    if (connected) {
+        json += ",\"bssid\":\"" + WiFi.BSSIDstr() + "\"";
+        json += ",\"channel\":" + String(WiFi.channel());
+        json += ",\"rssi\":" + String(WiFi.RSSI());
+    }
+    json += ",\"failedAttempts\":" + String(failedAttempts);
+    json += ",\"backoffMs\":" + String(backoffMs);
+    json += ",\"reconnects\":" + String(reconnects);
+    json += ",\"roams\":" + String(roams);
+    json += ",\"lastDisconnectReason\":" + String(lastDisconnectReason);
+    json += ",\"lastConnectMs\":" + String(lastConnectMs);
+    json += "}";
+    return json;
+}
+
 String WiFiManager::getCaptivePortalHTML() {
     String html = R"rawliteral(
 <!DOCTYPE html>
@@ -464,28 +572,147 @@ String WiFiManager::getCaptivePortalHTML() {
     return html;
 }
 
-bool WiFiManager::connectWiFi(const String& ssid, const String& password) {
-    Logger::info("Attempting to connect to: " + ssid);
+void WiFiManager::onWiFiEvent(arduino_event_id_t event, arduino_event_info_t info) {
+    if (instance == nullptr) {
+        return;
+    }
 
-    WiFi.mode(WIFI_STA);
-    WiFi.begin(ssid.c_str(), password.c_str());
+    switch (event) {
+        case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+            instance->gotIP = true;
+            break;
 
-    unsigned long startAttempt = millis();
-    const unsigned long timeout = 15000; // 15 sekunder
+        case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+            instance->disconnectReason = info.wifi_sta_disconnected.reason;
+            instance->disconnected = true;
+            break;
 
-    while (WiFi.status() != WL_CONNECTED && millis() - startAttempt < timeout) {
-        delay(500);
-        Serial.print(".");
+        default:
+            break;
     }
-    Serial.println();
+}
 
-    if (WiFi.status() == WL_CONNECTED) {
-        Logger::info("WiFi connected successfully");
-        return true;
-    } else {
-        Logger::error("WiFi connection failed");
+void WiFiManager::setLinkState(WiFiLinkState state) {
+    linkState = state;
+    stateSince = millis();
+}
+
+void WiFiManager::startScan() {
+    // Asynkron - resultatet hentes med scanComplete() i update()
+    WiFi.scanDelete();
+    if (WiFi.scanNetworks(true) != WIFI_SCAN_RUNNING) {
+        startConnect(nullptr, 0);
+        return;
+    }
+    setLinkState(WIFI_LINK_SCANNING);
+}
+
+bool WiFiManager::chooseAccessPoint(uint8_t* bssid, int32_t& channel, int32_t& rssi) {
+    int16_t count = WiFi.scanComplete();
+    int best = -1;
+    int fallback = -1;
+
+    for (int i = 0; i < count; i++) {
+        if (WiFi.SSID(i) != storedSSID) {
+            continue;
+        }
+        if (fallback < 0 || WiFi.RSSI(i) > WiFi.RSSI(fallback)) {
+            fallback = i;
+        }
+        if (hasFailedBssid && memcmp(WiFi.BSSID(i), failedBssid, sizeof(failedBssid)) == 0) {
+            continue;
+        }
+        if (best < 0 || WiFi.RSSI(i) > WiFi.RSSI(best)) {
+            best = i;
+        }
+    }
+
+    // Kun det fejlede access point er i nærheden - prøv det igen
+    if (best < 0) {
+        best = fallback;
+    }
+    if (best < 0) {
         return false;
     }
+
+    memcpy(bssid, WiFi.BSSID(best), 6);
+    channel = WiFi.channel(best);
+    rssi = WiFi.RSSI(best);
+    return true;
+}
+
+void WiFiManager::startConnect(const uint8_t* bssid, int32_t channel) {
+    if (bssid != nullptr && bssid != targetBssid) {
+        memcpy(targetBssid, bssid, sizeof(targetBssid));
+    }
+    hasTarget = (bssid != nullptr);
+    targetChannel = channel;
+    roamPending = false;
+
+    Logger::info("Attempting to connect to: " + storedSSID);
+
+    // Returnerer med det samme - resultatet kommer som GOT_IP eller DISCONNECTED event
+    WiFi.begin(storedSSID.c_str(), storedPassword.c_str(), channel, hasTarget ? targetBssid : nullptr);
+    setLinkState(WIFI_LINK_CONNECTING);
+}
+
+void WiFiManager::connectFailed() {
+    failedAttempts++;
+
+    if (hasTarget) {
+        memcpy(failedBssid, targetBssid, sizeof(failedBssid));
+        hasFailedBssid = true;
+    }
+
+    if (failedAttempts >= WIFI_MAX_RETRY) {
+        Logger::error("Too many reconnect failures - starting AP mode");
+        startCaptivePortal();
+        return;
+    }
+
+    Logger::warning("WiFi connection failed (attempt " + String(failedAttempts) + ", reason " +
+                    String(lastDisconnectReason) + ") - retry in " + String(backoffMs / 1000.0, 1) + " s");
+    setLinkState(WIFI_LINK_BACKOFF);
+}
+
+void WiFiManager::checkRoaming(unsigned long now) {
+    if (roamScan) {
+        int16_t result = WiFi.scanComplete();
+        if (result == WIFI_SCAN_RUNNING && now - lastRoamCheck < WIFI_SCAN_TIMEOUT_MS) {
+            return;
+        }
+        roamScan = false;
+
+        uint8_t bssid[6];
+        int32_t channel = 0;
+        int32_t rssi = 0;
+        const uint8_t* current = WiFi.BSSID();
+        int32_t currentRssi = WiFi.RSSI();
+        bool better = (result >= 0) && chooseAccessPoint(bssid, channel, rssi) &&
+                      current != nullptr && memcmp(bssid, current, sizeof(bssid)) != 0 &&
+                      rssi >= currentRssi + WIFI_ROAM_HYSTERESIS;
+        WiFi.scanDelete();
+
+        if (better) {
+            Logger::info("WiFi roaming: " + String(currentRssi) + " dBm -> " + String(rssi) + " dBm");
+            memcpy(targetBssid, bssid, sizeof(targetBssid));
+            targetChannel = channel;
+            roamPending = true;
+            roams++;
+            // Disconnect event'et starter forbindelsen til det nye access point
+            esp_wifi_disconnect();
+        }
+        return;
+    }
+
+    if (now - lastRoamCheck < WIFI_ROAM_CHECK_MS) {
+        return;
+    }
+    lastRoamCheck = now;
+
+    if (WiFi.RSSI() < WIFI_ROAM_RSSI && WiFi.scanNetworks(true) == WIFI_SCAN_RUNNING) {
+        roamScan = true;
+    }
 }
 
 bool WiFiManager::loadCredentials() {
@@ -8,6 +8,18 @@
 #include "../config/Config.h"
 #include "Logger.h"
 
+/**
+ * Tilstande i WiFi forbindelsen
+ */
+enum WiFiLinkState {
+    WIFI_LINK_IDLE,         // Ingen credentials
+    WIFI_LINK_SCANNING,     // Asynkron scanning efter bedste access point
+    WIFI_LINK_CONNECTING,   // Venter på IP
+    WIFI_LINK_CONNECTED,    // Forbundet
+    WIFI_LINK_BACKOFF,      // Pause før næste forsøg
+    WIFI_LINK_AP            // Captive portal
+};
+
 /**
  * WiFiManager klasse - Håndterer WiFi forbindelse med captive portal
  *
@@ -16,6 +28,15 @@
  * - Captive portal ved første opstart
  * - Automatisk retry med fallback til AP mode
  * - Credentials overlever firmware updates
+ *
+ * Forbindelsen drives af WiFi.onEvent: event task'en sætter kun flag, og
+ * update() flytter en tilstandsmaskine videre uden at vente. Før hvert
+ * forsøg scannes asynkront, og det access point med SSID'et og stærkest
+ * signal vælges (et access point der lige har fejlet springes over, hvis
+ * der er andre). Mislykkede forsøg giver en pause der fordobles fra
+ * WIFI_BACKOFF_MIN_MS til WIFI_BACKOFF_MAX_MS. Er signalet under
+ * WIFI_ROAM_RSSI mens robotten er forbundet, scannes der i baggrunden, og
+ * et access point der er WIFI_ROAM_HYSTERESIS bedre tages i brug.
  */
 class WiFiManager {
 public:
@@ -25,13 +46,13 @@ public:
     WiFiManager();
 
     /**
-     * Initialiserer WiFi Manager
-     * @return true hvis WiFi forbindelse lykkedes
+     * Initialiserer WiFi Manager og starter første forbindelse (venter ikke)
+     * @return true hvis forbindelse er startet med gemte credentials
      */
     bool begin();
 
     /**
-     * Tjek WiFi status og reconnect hvis nødvendigt
+     * Behandl WiFi events og kør reconnect tilstandsmaskinen (blokerer aldrig)
      * Kalder denne i loop()
      */
     void update();
@@ -94,6 +115,21 @@ public:
      */
     void forceAPMode();
 
+    /**
+     * Hent forbindelsens tilstand
+     */
+    WiFiLinkState getLinkState() const { return linkState; }
+
+    /**
+     * Hent tilstand som tekst
+     */
+    const char* getLinkStateName() const;
+
+    /**
+     * Hent status som JSON (/wifi/status)
+     */
+    String getStatusJSON();
+
     /**
      * Håndter captive portal web requests
      * Skal kaldes fra WebServer
@@ -102,12 +138,46 @@ public:
 
 private:
     /**
-     * Prøv at forbinde til WiFi
-     * @param ssid WiFi SSID
-     * @param password WiFi password
-     * @return true hvis forbundet
+     * WiFi event callback (kører i WiFi event task - sætter kun flag)
+     */
+    static void onWiFiEvent(arduino_event_id_t event, arduino_event_info_t info);
+
+    /**
+     * Skift tilstand og nulstil tilstandens timer
+     */
+    void setLinkState(WiFiLinkState state);
+
+    /**
+     * Start asynkron scanning efter access points
+     */
+    void startScan();
+
+    /**
+     * Vælg bedste access point fra færdig scanning
+     * @param bssid Udfyldes med valgt BSSID
+     * @param channel Udfyldes med valgt kanal
+     * @param rssi Udfyldes med valgt signal
+     * @return true hvis SSID'et blev fundet
+     */
+    bool chooseAccessPoint(uint8_t* bssid, int32_t& channel, int32_t& rssi);
+
+    /**
+     * Start forbindelse (WiFi.begin returnerer med det samme)
+     * @param bssid Access point der ønskes (nullptr = lad driveren vælge)
+     * @param channel Kanal (0 = alle)
+     */
+    void startConnect(const uint8_t* bssid, int32_t channel);
+
+    /**
+     * Mislykket forsøg - pause med fordoblet ventetid eller AP mode
+     */
+    void connectFailed();
+
+    /**
+     * Led efter bedre access point mens forbundet (roaming)
+     * @param now Nuværende tid (ms)
      */
-    bool connectWiFi(const String& ssid, const String& password);
+    void checkRoaming(unsigned long now);
 
     /**
      * Indlæs credentials fra NVS
@@ -130,15 +200,36 @@ private:
     bool apMode;
     bool hasCredentials;
     int failedAttempts;
-    unsigned long lastReconnectAttempt;
+    WiFiLinkState linkState;
+    unsigned long stateSince;
+    unsigned long backoffMs;        // Nuværende pause efter mislykket forsøg
+    bool roamScan;                  // Baggrunds scanning mens forbundet
+    unsigned long lastRoamCheck;
+
+    // Valgt og senest fejlet access point
+    uint8_t targetBssid[6];
+    int32_t targetChannel;
+    bool hasTarget;
+    bool roamPending;               // Afbrudt for at skifte til targetBssid
+    uint8_t failedBssid[6];
+    bool hasFailedBssid;
+
+    // Sat af event task'en, læses i update()
+    volatile bool gotIP;
+    volatile bool disconnected;
+    volatile uint8_t disconnectReason;
+
+    // Statistik
+    uint32_t reconnects;
+    uint32_t roams;
+    uint8_t lastDisconnectReason;
+    unsigned long lastConnectMs;    // Tid fra start af forsøg til IP
 
     // Stored credentials
     String storedSSID;
     String storedPassword;
 
-    // Constants
-    static const int MAX_FAILED_ATTEMPTS = 10;
-    static const int RECONNECT_INTERVAL = 30000; // 30 sekunder
+    static WiFiManager* instance;
 };
 
 #endif // WIFIMANAGER_H
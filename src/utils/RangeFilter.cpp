@@ -0,0 +1,96 @@
+#include "RangeFilter.h"
+
+RangeFilter::RangeFilter() {
+    reset();
+}
+
+void RangeFilter::reset() {
+    for (int i = 0; i < OBSTACLE_MEDIAN_WINDOW; i++) {
+        window[i] = ULTRASONIC_MAX_DISTANCE;
+    }
+    windowCount = 0;
+    windowIndex = 0;
+    distance = ULTRASONIC_MAX_DISTANCE;
+    velocity = 0.0;
+    lastTime = 0;
+    tracking = false;
+}
+
+void RangeFilter::addSample(float measured, unsigned long timeMs) {
+    // Intet ekko (timeout eller ugyldig) betyder fri bane
+    if (measured <= 0.0 || measured > ULTRASONIC_MAX_DISTANCE) {
+        measured = ULTRASONIC_MAX_DISTANCE;
+    }
+
+    window[windowIndex] = measured;
+    windowIndex = (windowIndex + 1) % OBSTACLE_MEDIAN_WINDOW;
+    if (windowCount < OBSTACLE_MEDIAN_WINDOW) {
+        windowCount++;
+    }
+
+    float z = median();
+
+    if (!tracking) {
+        distance = z;
+        velocity = 0.0;
+        lastTime = timeMs;
+        tracking = true;
+        return;
+    }
+
+    float dt = (timeMs - lastTime) / 1000.0;
+    lastTime = timeMs;
+    if (dt <= 0.0) {
+        return;
+    }
+
+    // Forudsig og korriger
+    float predicted = distance + velocity * dt;
+    float residual = z - predicted;
+
+    if (fabs(residual) > OBSTACLE_FILTER_GATE_CM || z >= ULTRASONIC_MAX_DISTANCE) {
+        // Nyt mål (eller intet mål) - start forfra uden hastighed
+        distance = z;
+        velocity = 0.0;
+        return;
+    }
+
+    distance = predicted + OBSTACLE_FILTER_ALPHA * residual;
+    velocity += (OBSTACLE_FILTER_BETA / dt) * residual;
+    distance = constrain(distance, 0.0, (float)ULTRASONIC_MAX_DISTANCE);
+}
+
+float RangeFilter::getDistance() {
+    return distance;
+}
+
+float RangeFilter::getClosingSpeed() {
+    return -velocity;
+}
+
+float RangeFilter::getTimeToCollision() {
+    float closing = getClosingSpeed();
+    if (!isValid() || closing < OBSTACLE_MIN_CLOSING_SPEED) {
+        return INFINITY;
+    }
+    return distance / closing;
+}
+
+bool RangeFilter::isValid() {
+    return tracking && windowCount >= OBSTACLE_MEDIAN_WINDOW;
+}
+
+float RangeFilter::median() {
+    // Indsættelses-sortering af en lille kopi (N er 3-5)
+    float sorted[OBSTACLE_MEDIAN_WINDOW];
+    for (int i = 0; i < windowCount; i++) {
+        float value = window[i];
+        int j = i - 1;
+        while (j >= 0 && sorted[j] > value) {
+            sorted[j + 1] = sorted[j];
+            j--;
+        }
+        sorted[j + 1] = value;
+    }
+    return sorted[windowCount / 2];
+}
@@ -0,0 +1,76 @@
+#ifndef RANGE_FILTER_H
+#define RANGE_FILTER_H
+
+#include <Arduino.h>
+#include "../config/Config.h"
+
+/**
+ * RangeFilter klasse - Tracking filter for én afstandssensor
+ *
+ * Median-of-N fjerner enkeltstående falske ekkoer, og et alpha-beta
+ * filter estimerer afstand og hastighed mod forhindringen. Spring større
+ * end OBSTACLE_FILTER_GATE_CM opfattes som et nyt mål, så filteret
+ * starter forfra i stedet for at se en kæmpe hastighed.
+ */
+class RangeFilter {
+public:
+    /**
+     * Constructor
+     */
+    RangeFilter();
+
+    /**
+     * Nulstil filter
+     */
+    void reset();
+
+    /**
+     * Tilføj ny måling
+     * @param distance Målt afstand i cm (0 eller over max = intet ekko)
+     * @param timeMs Tidspunkt for målingen (millis)
+     */
+    void addSample(float distance, unsigned long timeMs);
+
+    /**
+     * Hent filtreret afstand
+     * @return Afstand i cm (ULTRASONIC_MAX_DISTANCE hvis intet mål)
+     */
+    float getDistance();
+
+    /**
+     * Hent lukkehastighed mod forhindringen
+     * @return cm/s, positiv når afstanden bliver mindre
+     */
+    float getClosingSpeed();
+
+    /**
+     * Hent forudsagt tid til kollision
+     * @return Sekunder, eller INFINITY hvis vi ikke nærmer os
+     */
+    float getTimeToCollision();
+
+    /**
+     * Tjek om filteret har nok målinger til et estimat
+     * @return true hvis gyldigt
+     */
+    bool isValid();
+
+private:
+    /**
+     * Median af de seneste målinger
+     */
+    float median();
+
+    // Median vindue (ring buffer)
+    float window[OBSTACLE_MEDIAN_WINDOW];
+    uint8_t windowCount;
+    uint8_t windowIndex;
+
+    // Alpha-beta tilstand
+    float distance;             // cm
+    float velocity;             // cm/s (negativ = nærmer sig)
+    unsigned long lastTime;
+    bool tracking;
+};
+
+#endif // RANGE_FILTER_H
@@ -1,5 +1,15 @@
 #include "WebAPI.h"
 #include "../system/StateManager.h"
+#include "../system/BlackBox.h"
+#include "../system/LoopProfiler.h"
+#include "../system/DeadlineMonitor.h"
+#include "../navigation/OccupancyGrid.h"
+#include "../navigation/LocalPlanner.h"
+#include "../navigation/ZoneManager.h"
+#include "../navigation/MissionPlanner.h"
+#include "../system/SessionCheckpoint.h"
+#include "../navigation/DockingController.h"
+#include "../system/StatsStore.h"
 #include "../hardware/Battery.h"
 #include "../hardware/Sensors.h"
 #include "../hardware/IMU.h"
@@ -8,11 +18,16 @@
 #if ENABLE_PERIMETER
 #include "../hardware/PerimeterReceiver.h"
 #include "../system/PerimeterClient.h"
+#include "../navigation/WireFollower.h"
+#include "../navigation/SignalSearch.h"
 #endif
 
 // External kalibrerings funktioner fra main.cpp
 extern void requestGyroCalibration();
 extern void requestMagCalibration();
+#if ENABLE_CHECKPOINT
+extern void requestCheckpointClear();
+#endif
 
 WebAPI::WebAPI() {
     webServerPtr = nullptr;
@@ -25,6 +40,34 @@ WebAPI::WebAPI() {
     #if ENABLE_PERIMETER
     perimeterReceiverPtr = nullptr;
     perimeterClientPtr = nullptr;
+    wireFollowerPtr = nullptr;
+    signalSearchPtr = nullptr;
+    #endif
+    #if ENABLE_BLACKBOX
+    blackBoxPtr = nullptr;
+    #endif
+    #if ENABLE_PROFILER
+    profilerPtr = nullptr;
+    #endif
+    #if ENABLE_WATCHDOG
+    deadlineMonitorPtr = nullptr;
+    #endif
+    localMapPtr = nullptr;
+    localPlannerPtr = nullptr;
+    #if ENABLE_ZONES
+    zoneManagerPtr = nullptr;
+    #endif
+    #if ENABLE_MISSION_PLANNER
+    missionPlannerPtr = nullptr;
+    #endif
+    #if ENABLE_CHECKPOINT
+    checkpointPtr = nullptr;
+    #endif
+    #if ENABLE_DOCKING
+    dockingPtr = nullptr;
+    #endif
+    #if ENABLE_STATS
+    statsPtr = nullptr;
     #endif
     initialized = false;
 }
@@ -71,6 +114,16 @@ void WebAPI::setupRoutes() {
         handleGetStatus(request);
     });
 
+    // GET /api/state/stats
+    server->on("/api/state/stats", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        handleGetStateStats(request);
+    });
+
+    // GET /api/map
+    server->on("/api/map", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        handleGetMap(request);
+    });
+
     // POST /api/start
     server->on("/api/start", HTTP_POST, [this](AsyncWebServerRequest *request) {
         handleStart(request);
@@ -96,11 +149,117 @@ void WebAPI::setupRoutes() {
         handleCalibrateMag(request);
     });
 
+    // GET /api/logs/levels (skal registreres før /api/logs)
+    server->on("/api/logs/levels", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        handleGetLogLevels(request);
+    });
+
+    // POST /api/logs/levels
+    server->on("/api/logs/levels", HTTP_POST, [this](AsyncWebServerRequest *request) {
+        handleSetLogLevel(request);
+    });
+
     // GET /api/logs
     server->on("/api/logs", HTTP_GET, [this](AsyncWebServerRequest *request) {
         handleGetLogs(request);
     });
 
+    #if ENABLE_BLACKBOX
+    // GET /api/blackbox/download (skal registreres før /api/blackbox)
+    server->on("/api/blackbox/download", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        handleBlackBoxDownload(request);
+    });
+
+    // POST /api/blackbox/clear
+    server->on("/api/blackbox/clear", HTTP_POST, [this](AsyncWebServerRequest *request) {
+        handleBlackBoxClear(request);
+    });
+
+    // GET /api/blackbox
+    server->on("/api/blackbox", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        handleBlackBoxStatus(request);
+    });
+    #endif
+
+    #if ENABLE_PROFILER
+    // POST /api/perf/reset (skal registreres før /api/perf)
+    server->on("/api/perf/reset", HTTP_POST, [this](AsyncWebServerRequest *request) {
+        handleResetPerf(request);
+    });
+
+    // GET /api/perf
+    server->on("/api/perf", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        handleGetPerf(request);
+    });
+    #endif
+
+    #if ENABLE_WATCHDOG
+    // GET /api/deadlines
+    server->on("/api/deadlines", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        handleGetDeadlines(request);
+    });
+    #endif
+
+    #if ENABLE_ZONES
+    // GET /api/zones/plan (underruter skal registreres før /api/zones)
+    server->on("/api/zones/plan", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        handleGetZonePlan(request);
+    });
+
+    // POST /api/zones/delete
+    server->on("/api/zones/delete", HTTP_POST, [this](AsyncWebServerRequest *request) {
+        handleDeleteZone(request);
+    });
+
+    // POST /api/zones/select
+    server->on("/api/zones/select", HTTP_POST, [this](AsyncWebServerRequest *request) {
+        handleSelectZone(request);
+    });
+
+    // GET /api/zones
+    server->on("/api/zones", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        handleGetZones(request);
+    });
+
+    // POST /api/zones (opret eller opdater)
+    server->on("/api/zones", HTTP_POST, [this](AsyncWebServerRequest *request) {
+        handleSaveZone(request);
+    });
+    #endif
+
+    #if ENABLE_MISSION_PLANNER
+    // GET /api/mission
+    server->on("/api/mission", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        handleGetMission(request);
+    });
+    #endif
+
+    #if ENABLE_CHECKPOINT
+    // POST /api/checkpoint/clear
+    server->on("/api/checkpoint/clear", HTTP_POST, [this](AsyncWebServerRequest *request) {
+        handleClearCheckpoint(request);
+    });
+
+    // GET /api/checkpoint
+    server->on("/api/checkpoint", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        handleGetCheckpoint(request);
+    });
+    #endif
+
+    #if ENABLE_DOCKING
+    // GET /api/dock
+    server->on("/api/dock", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        handleGetDock(request);
+    });
+    #endif
+
+    #if ENABLE_STATS
+    // GET /api/stats
+    server->on("/api/stats", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        handleGetStats(request);
+    });
+    #endif
+
     // GET /api/settings
     server->on("/api/settings", HTTP_GET, [this](AsyncWebServerRequest *request) {
         handleGetSettings(request);
@@ -253,6 +412,369 @@ void WebAPI::handleGetLogs(AsyncWebServerRequest *request) {
     request->send(200, "application/json", json);
 }
 
+void WebAPI::handleGetLogLevels(AsyncWebServerRequest *request) {
+    StaticJsonDocument<512> doc;
+
+    JsonObject runtime = doc.createNestedObject("levels");
+    JsonObject compiled = doc.createNestedObject("compiled");
+    for (int i = 0; i < LOG_SUB_COUNT; i++) {
+        LogSubsystem sub = (LogSubsystem)i;
+        runtime[Logger::subsystemToString(sub)] = Logger::levelToString(Logger::getLevel(sub));
+        compiled[Logger::subsystemToString(sub)] =
+            Logger::levelToString((LogLevel)logCompileLevel(sub));
+    }
+
+    String output;
+    serializeJson(doc, output);
+    request->send(200, "application/json", output);
+}
+
+void WebAPI::handleSetLogLevel(AsyncWebServerRequest *request) {
+    if (!request->hasParam("level", true)) {
+        request->send(400, "application/json", "{\"error\":\"Missing level parameter\"}");
+        return;
+    }
+
+    LogLevel level;
+    if (!Logger::levelFromString(request->getParam("level", true)->value(), level)) {
+        request->send(400, "application/json", "{\"error\":\"Invalid level\"}");
+        return;
+    }
+
+    // Uden subsystem (eller "all") sættes niveauet for alle subsystemer
+    String subName = "all";
+    if (request->hasParam("subsystem", true)) {
+        subName = request->getParam("subsystem", true)->value();
+    }
+
+    if (subName.equalsIgnoreCase("all")) {
+        Logger::setAllLevels(level);
+    } else {
+        LogSubsystem sub;
+        if (!Logger::subsystemFromString(subName, sub)) {
+            request->send(400, "application/json", "{\"error\":\"Unknown subsystem\"}");
+            return;
+        }
+        Logger::setLevel(sub, level);
+    }
+
+    Logger::info("API: Log level for " + subName + " set to " + Logger::levelToString(level));
+    handleGetLogLevels(request);
+}
+
+void WebAPI::handleGetStateStats(AsyncWebServerRequest *request) {
+    if (stateManagerPtr == nullptr) {
+        request->send(500, "application/json", "{\"error\":\"State manager not initialized\"}");
+        return;
+    }
+
+    request->send(200, "application/json", stateManagerPtr->getStatsJSON());
+}
+
+void WebAPI::handleGetMap(AsyncWebServerRequest *request) {
+    if (localMapPtr == nullptr || localPlannerPtr == nullptr) {
+        request->send(500, "application/json", "{\"error\":\"Local map not initialized\"}");
+        return;
+    }
+
+    String json = "{\"steerHeading\":" + String(localPlannerPtr->getSteerHeading(), 1);
+    json += ",\"crossTrack\":" + String(localPlannerPtr->getCrossTrackError(*localMapPtr), 1);
+    json += ",\"blocked\":" + String(localPlannerPtr->isBlocked() ? "true" : "false");
+    json += ",\"map\":" + localMapPtr->getJSON() + "}";
+
+    request->send(200, "application/json", json);
+}
+
+#if ENABLE_BLACKBOX
+void WebAPI::handleBlackBoxStatus(AsyncWebServerRequest *request) {
+    if (blackBoxPtr == nullptr) {
+        request->send(503, "application/json", "{\"error\":\"Black box not available\"}");
+        return;
+    }
+
+    request->send(200, "application/json", blackBoxPtr->getStatusJSON());
+}
+
+void WebAPI::handleBlackBoxDownload(AsyncWebServerRequest *request) {
+    // ?file=error henter det frosne dump, ellers den aktuelle ring
+    const char* dir = BLACKBOX_DIR;
+    if (request->hasParam("file") && request->getParam("file")->value() == "error") {
+        dir = BLACKBOX_ERROR_DIR;
+    }
+
+    if (!LittleFS.exists(dir)) {
+        request->send(404, "application/json", "{\"error\":\"No black box file\"}");
+        return;
+    }
+
+    Logger::info("API: Black box download " + String(dir));
+
+    // Segmenterne sendes efter hinanden som én fil
+    AsyncWebServerResponse *response = request->beginChunkedResponse("application/octet-stream",
+        [dir](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+            return BlackBox::readRing(dir, index, buffer, maxLen);
+        });
+    response->addHeader("Content-Disposition", "attachment; filename=blackbox.bin");
+    request->send(response);
+}
+
+void WebAPI::handleBlackBoxClear(AsyncWebServerRequest *request) {
+    if (blackBoxPtr == nullptr) {
+        request->send(503, "application/json", "{\"error\":\"Black box not available\"}");
+        return;
+    }
+
+    blackBoxPtr->clear();
+    request->send(200, "application/json", "{\"status\":\"cleared\"}");
+}
+#endif
+
+#if ENABLE_PROFILER
+void WebAPI::handleGetPerf(AsyncWebServerRequest *request) {
+    if (profilerPtr == nullptr) {
+        request->send(503, "application/json", "{\"error\":\"Profiler not available\"}");
+        return;
+    }
+
+    request->send(200, "application/json", profilerPtr->getJSON());
+}
+
+void WebAPI::handleResetPerf(AsyncWebServerRequest *request) {
+    if (profilerPtr == nullptr) {
+        request->send(503, "application/json", "{\"error\":\"Profiler not available\"}");
+        return;
+    }
+
+    profilerPtr->reset();
+    request->send(200, "application/json", "{\"status\":\"reset\"}");
+    Logger::info("API: Profiler reset");
+}
+#endif
+
+#if ENABLE_WATCHDOG
+void WebAPI::handleGetDeadlines(AsyncWebServerRequest *request) {
+    if (deadlineMonitorPtr == nullptr) {
+        request->send(503, "application/json", "{\"error\":\"Deadline monitor not available\"}");
+        return;
+    }
+
+    request->send(200, "application/json", deadlineMonitorPtr->getJSON());
+}
+#endif
+
+#if ENABLE_MISSION_PLANNER
+void WebAPI::handleGetMission(AsyncWebServerRequest *request) {
+    if (missionPlannerPtr == nullptr) {
+        request->send(503, "application/json", "{\"error\":\"Mission planner not available\"}");
+        return;
+    }
+
+    request->send(200, "application/json", missionPlannerPtr->getJSON());
+}
+#endif
+
+#if ENABLE_CHECKPOINT
+void WebAPI::handleGetCheckpoint(AsyncWebServerRequest *request) {
+    if (checkpointPtr == nullptr) {
+        request->send(503, "application/json", "{\"error\":\"Checkpoint not available\"}");
+        return;
+    }
+
+    request->send(200, "application/json", checkpointPtr->getJSON());
+}
+
+void WebAPI::handleClearCheckpoint(AsyncWebServerRequest *request) {
+    if (checkpointPtr == nullptr) {
+        request->send(503, "application/json", "{\"error\":\"Checkpoint not available\"}");
+        return;
+    }
+
+    // Slettes i main loop - NVS og planneren ejes af main
+    Logger::info("API: Checkpoint clear requested");
+    requestCheckpointClear();
+    request->send(200, "application/json", "{\"status\":\"clearing\"}");
+}
+#endif
+
+#if ENABLE_DOCKING
+void WebAPI::handleGetDock(AsyncWebServerRequest *request) {
+    if (dockingPtr == nullptr) {
+        request->send(503, "application/json", "{\"error\":\"Docking not available\"}");
+        return;
+    }
+
+    request->send(200, "application/json", dockingPtr->getJSON());
+}
+#endif
+
+#if ENABLE_STATS
+void WebAPI::handleGetStats(AsyncWebServerRequest *request) {
+    if (statsPtr == nullptr) {
+        request->send(503, "application/json", "{\"error\":\"Stats not available\"}");
+        return;
+    }
+
+    request->send(200, "application/json", statsPtr->getJSON());
+}
+#endif
+
+#if ENABLE_ZONES
+void WebAPI::handleGetZones(AsyncWebServerRequest *request) {
+    if (zoneManagerPtr == nullptr) {
+        request->send(503, "application/json", "{\"error\":\"Zones not available\"}");
+        return;
+    }
+
+    request->send(200, "application/json", zoneManagerPtr->getZonesJSON());
+}
+
+void WebAPI::handleSaveZone(AsyncWebServerRequest *request) {
+    if (zoneManagerPtr == nullptr) {
+        request->send(503, "application/json", "{\"error\":\"Zones not available\"}");
+        return;
+    }
+
+    // Opdatering tager udgangspunkt i eksisterende zone - kun sendte felter ændres
+    ZoneRecord zone;
+    memset(&zone, 0, sizeof(zone));
+    zone.rowWidth = MOWING_PATTERN_WIDTH;
+    zone.pattern = ZONE_PATTERN_PARALLEL;
+
+    if (request->hasParam("id", true)) {
+        uint8_t id = (uint8_t)request->getParam("id", true)->value().toInt();
+        if (!zoneManagerPtr->getZone(id, zone)) {
+            request->send(404, "application/json", "{\"error\":\"Unknown zone\"}");
+            return;
+        }
+    }
+
+    if (request->hasParam("name", true)) {
+        strlcpy(zone.name, request->getParam("name", true)->value().c_str(), ZONE_NAME_LEN);
+    }
+
+    if (request->hasParam("pattern", true)) {
+        if (!ZoneManager::patternFromString(request->getParam("pattern", true)->value(), zone.pattern)) {
+            request->send(400, "application/json", "{\"error\":\"Unknown pattern\"}");
+            return;
+        }
+    }
+
+    if (request->hasParam("angle", true)) {
+        float angle = MowerMath::normalizeAngle(request->getParam("angle", true)->value().toFloat());
+        zone.angle = (int16_t)lround(angle * 10.0) % 3600;
+    }
+
+    if (request->hasParam("rowWidth", true)) {
+        zone.rowWidth = (uint16_t)request->getParam("rowWidth", true)->value().toInt();
+    }
+
+    if (request->hasParam("laps", true)) {
+        zone.param = (uint16_t)constrain(request->getParam("laps", true)->value().toInt(), 0, ZONE_MAX_ROWS);
+    }
+
+    if (request->hasParam("vertices", true)) {
+        // Format: "x,y;x,y;..." i cm
+        String list = request->getParam("vertices", true)->value();
+        zone.vertexCount = 0;
+        int start = 0;
+        while (start < (int)list.length()) {
+            int end = list.indexOf(';', start);
+            if (end < 0) {
+                end = list.length();
+            }
+            String pair = list.substring(start, end);
+            int comma = pair.indexOf(',');
+            if (comma < 0 || zone.vertexCount >= ZONE_MAX_VERTICES) {
+                request->send(400, "application/json", "{\"error\":\"Invalid vertices\"}");
+                return;
+            }
+            zone.vertices[zone.vertexCount][0] = (int16_t)pair.substring(0, comma).toInt();
+            zone.vertices[zone.vertexCount][1] = (int16_t)pair.substring(comma + 1).toInt();
+            zone.vertexCount++;
+            start = end + 1;
+        }
+    }
+
+    if (!ZoneManager::isValid(zone)) {
+        request->send(400, "application/json", "{\"error\":\"Invalid zone (vertices 3-" +
+                      String(ZONE_MAX_VERTICES) + ", rowWidth " + String(ZONE_MIN_ROW_WIDTH) +
+                      "-" + String(ZONE_MAX_ROW_WIDTH) + ")\"}");
+        return;
+    }
+
+    uint8_t id = zoneManagerPtr->saveZone(zone);
+    if (id == 0) {
+        request->send(507, "application/json", "{\"error\":\"Zone could not be saved: " +
+                      String(zoneManagerPtr->getSaveError()) + "\"}");
+        return;
+    }
+
+    Logger::info("API: Zone " + String(id) + " saved");
+    request->send(200, "application/json", "{\"status\":\"saved\",\"id\":" + String(id) + "}");
+}
+
+void WebAPI::handleDeleteZone(AsyncWebServerRequest *request) {
+    if (zoneManagerPtr == nullptr) {
+        request->send(503, "application/json", "{\"error\":\"Zones not available\"}");
+        return;
+    }
+
+    if (!request->hasParam("id", true)) {
+        request->send(400, "application/json", "{\"error\":\"Missing id parameter\"}");
+        return;
+    }
+
+    uint8_t id = (uint8_t)request->getParam("id", true)->value().toInt();
+    if (!zoneManagerPtr->deleteZone(id)) {
+        request->send(404, "application/json", "{\"error\":\"Unknown zone\"}");
+        return;
+    }
+
+    request->send(200, "application/json", "{\"status\":\"deleted\"}");
+}
+
+void WebAPI::handleSelectZone(AsyncWebServerRequest *request) {
+    if (zoneManagerPtr == nullptr) {
+        request->send(503, "application/json", "{\"error\":\"Zones not available\"}");
+        return;
+    }
+
+    if (!request->hasParam("id", true)) {
+        request->send(400, "application/json", "{\"error\":\"Missing id parameter\"}");
+        return;
+    }
+
+    // id=0 vælger standard mønsteret uden zone
+    uint8_t id = (uint8_t)request->getParam("id", true)->value().toInt();
+    if (!zoneManagerPtr->selectZone(id)) {
+        request->send(404, "application/json", "{\"error\":\"Unknown zone\"}");
+        return;
+    }
+
+    request->send(200, "application/json", "{\"status\":\"selected\",\"active\":" + String(id) + "}");
+}
+
+void WebAPI::handleGetZonePlan(AsyncWebServerRequest *request) {
+    if (zoneManagerPtr == nullptr) {
+        request->send(503, "application/json", "{\"error\":\"Zones not available\"}");
+        return;
+    }
+
+    uint8_t id = zoneManagerPtr->getActiveId();
+    if (request->hasParam("id")) {
+        id = (uint8_t)request->getParam("id")->value().toInt();
+    }
+
+    String json = zoneManagerPtr->getPlanJSON(id);
+    if (json.length() == 0) {
+        request->send(404, "application/json", "{\"error\":\"No plan for zone\"}");
+        return;
+    }
+
+    request->send(200, "application/json", json);
+}
+#endif
+
 void WebAPI::handleGetSettings(AsyncWebServerRequest *request) {
     String json = createSettingsJSON();
     request->send(200, "application/json", json);
@@ -264,8 +786,8 @@ void WebAPI::handleUpdateSettings(AsyncWebServerRequest *request) {
 }
 
 String WebAPI::createStatusJSON() {
-    // Opret JSON status objekt - øget størrelse for strømdata
-    StaticJsonDocument<768> doc;
+    // Opret JSON status objekt - øget størrelse for strøm- og SoC data
+    StaticJsonDocument<1280> doc;
 
     // State
     if (stateManagerPtr != nullptr) {
@@ -282,6 +804,13 @@ String WebAPI::createStatusJSON() {
         battery["percentage"] = batteryPtr->getPercentage();
         battery["isLow"] = batteryPtr->isLow();
         battery["isCritical"] = batteryPtr->isCritical();
+        battery["soc"] = batteryPtr->getStateOfCharge();
+        battery["current"] = batteryPtr->getCurrent();
+        battery["remainingWh"] = batteryPtr->getRemainingWh();
+        battery["minutesRemaining"] = batteryPtr->getEstimatedTimeRemaining();
+        battery["internalResistance"] = batteryPtr->getInternalResistance();
+        battery["resting"] = batteryPtr->isResting();
+        battery["charging"] = batteryPtr->isCharging();
     }
 
     // IMU
@@ -388,7 +917,7 @@ void WebAPI::handleManualForward(AsyncWebServerRequest *request) {
 
     // Skift til manuel kontrol tilstand
     if (stateManagerPtr != nullptr) {
-        stateManagerPtr->setState(STATE_MANUAL);
+        stateManagerPtr->enterManualMode();
     }
 
     int speed = MOTOR_CRUISE_SPEED;
@@ -409,7 +938,7 @@ void WebAPI::handleManualBackward(AsyncWebServerRequest *request) {
 
     // Skift til manuel kontrol tilstand
     if (stateManagerPtr != nullptr) {
-        stateManagerPtr->setState(STATE_MANUAL);
+        stateManagerPtr->enterManualMode();
     }
 
     int speed = MOTOR_CRUISE_SPEED;
@@ -430,7 +959,7 @@ void WebAPI::handleManualLeft(AsyncWebServerRequest *request) {
 
     // Skift til manuel kontrol tilstand
     if (stateManagerPtr != nullptr) {
-        stateManagerPtr->setState(STATE_MANUAL);
+        stateManagerPtr->enterManualMode();
     }
 
     int speed = MOTOR_TURN_SPEED;
@@ -451,7 +980,7 @@ void WebAPI::handleManualRight(AsyncWebServerRequest *request) {
 
     // Skift til manuel kontrol tilstand
     if (stateManagerPtr != nullptr) {
-        stateManagerPtr->setState(STATE_MANUAL);
+        stateManagerPtr->enterManualMode();
     }
 
     int speed = MOTOR_TURN_SPEED;
@@ -474,8 +1003,8 @@ void WebAPI::handleManualStop(AsyncWebServerRequest *request) {
 
     // Bliv i manuel tilstand - lad brugeren bestemme når de vil forlade manuel mode
     // De kan bruge "Stop" knappen i hovedkontrollen for at gå tilbage til IDLE
-    if (stateManagerPtr != nullptr && stateManagerPtr->getState() != STATE_MANUAL) {
-        stateManagerPtr->setState(STATE_MANUAL);
+    if (stateManagerPtr != nullptr) {
+        stateManagerPtr->enterManualMode();
     }
 
     request->send(200, "application/json", "{\"status\":\"stopped\"}");
@@ -495,7 +1024,7 @@ void WebAPI::handleManualSetSpeed(AsyncWebServerRequest *request) {
 
     // Skift til manuel kontrol tilstand
     if (stateManagerPtr != nullptr) {
-        stateManagerPtr->setState(STATE_MANUAL);
+        stateManagerPtr->enterManualMode();
     }
 
     int leftSpeed = request->getParam("left", true)->value().toInt();
@@ -554,14 +1083,35 @@ void WebAPI::handleGetCurrent(AsyncWebServerRequest *request) {
 // ============================================================================
 
 #if ENABLE_PERIMETER
+/**
+ * Logger resultatet af start/stop kommandoer fra web interfacet
+ * (kaldes fra loop når senderen har svaret)
+ */
+static void onPerimeterCommandDone(PerimeterCommand command, bool success) {
+    const char* action = command == PERIMETER_CMD_START ? "start" : "stop";
+    if (success) {
+        Logger::info("API: Perimeter signal " + String(action) + " OK");
+    } else {
+        Logger::error("API: Perimeter signal " + String(action) + " failed");
+    }
+}
+
 void WebAPI::setPerimeterReferences(PerimeterReceiver* receiver, PerimeterClient* client) {
     perimeterReceiverPtr = receiver;
     perimeterClientPtr = client;
     Logger::info("WebAPI perimeter references set");
 }
 
+void WebAPI::setWireFollower(WireFollower* follower) {
+    wireFollowerPtr = follower;
+}
+
+void WebAPI::setSignalSearch(SignalSearch* search) {
+    signalSearchPtr = search;
+}
+
 void WebAPI::handlePerimeterStatus(AsyncWebServerRequest *request) {
-    StaticJsonDocument<512> doc;
+    StaticJsonDocument<1280> doc;
 
     // Receiver status
     if (perimeterReceiverPtr != nullptr) {
@@ -574,6 +1124,39 @@ void WebAPI::handlePerimeterStatus(AsyncWebServerRequest *request) {
         receiver["signalMagnitude"] = perimeterReceiverPtr->getSignalMagnitude();
         receiver["direction"] = perimeterReceiverPtr->getDirectionString();
         receiver["distanceToCable"] = perimeterReceiverPtr->getDistanceToCable();
+        receiver["lateralOffset"] = perimeterReceiverPtr->getLateralOffset();
+        receiver["loop"] = perimeterReceiverPtr->getNearestLoop();
+        receiver["nearKeepOut"] = perimeterReceiverPtr->isNearKeepOut();
+        if (PERIMETER_LOOP_COUNT > 1) {
+            JsonArray levels = receiver.createNestedArray("loopLevels");
+            for (uint8_t i = 0; i < PERIMETER_LOOP_COUNT; i++) {
+                levels.add(perimeterReceiverPtr->getLoopLevel(i));
+            }
+        }
+    }
+
+    // Kabel følgning (hjemkørsel og perimeter omgange)
+    if (wireFollowerPtr != nullptr) {
+        JsonObject follower = doc.createNestedObject("follower");
+        follower["target"] = wireFollowerPtr->getTargetOffset();
+        follower["offset"] = wireFollowerPtr->getOffset();
+        follower["error"] = wireFollowerPtr->getError();
+        follower["integral"] = wireFollowerPtr->getIntegral();
+        follower["steering"] = wireFollowerPtr->getSteering();
+        follower["speed"] = wireFollowerPtr->getSpeed();
+    }
+
+    // Signal søgning (spor og seneste genfinding)
+    if (signalSearchPtr != nullptr) {
+        JsonObject search = doc.createNestedObject("search");
+        search["phase"] = signalSearchPtr->getPhaseName();
+        search["trackPoints"] = signalSearchPtr->getTrackCount();
+        search["backtrackCm"] = signalSearchPtr->getBacktrackDistance();
+        search["spiralRadius"] = signalSearchPtr->getSpiralRadius();
+        search["searches"] = signalSearchPtr->getSearches();
+        search["recoveries"] = signalSearchPtr->getRecoveries();
+        search["lastRecoveryMs"] = signalSearchPtr->getLastRecoveryMs();
+        search["lastFoundIn"] = signalSearchPtr->getLastFoundIn();
     }
 
     // Sender status
@@ -585,6 +1168,14 @@ void WebAPI::handlePerimeterStatus(AsyncWebServerRequest *request) {
         sender["current_mA"] = perimeterClientPtr->getSenderCurrent();
         sender["runtime_ms"] = perimeterClientPtr->getSenderRuntime();
         sender["ip"] = perimeterClientPtr->getSenderIP();
+        sender["queued"] = perimeterClientPtr->getQueueLength();
+        sender["backoffMs"] = perimeterClientPtr->getBackoffMs();
+        sender["link"] = perimeterClientPtr->isLinkAlive() ? "udp" : "http";
+        sender["heartbeatAgeMs"] = perimeterClientPtr->getHeartbeatAge();
+        sender["linkError"] = perimeterClientPtr->getLinkErrorName();
+        if (!perimeterClientPtr->isConnected()) {
+            sender["error"] = perimeterClientPtr->getLastError();
+        }
     }
 
     String output;
@@ -598,14 +1189,12 @@ void WebAPI::handlePerimeterStart(AsyncWebServerRequest *request) {
         return;
     }
 
-    bool success = perimeterClientPtr->startSignal();
-    if (success) {
-        request->send(200, "application/json", "{\"status\":\"started\",\"message\":\"Perimeter signal started\"}");
-        Logger::info("API: Perimeter signal started");
+    // Svaret fra senderen kommer asynkront - resultatet logges i callback
+    if (perimeterClientPtr->startSignal(onPerimeterCommandDone)) {
+        request->send(202, "application/json", "{\"status\":\"queued\",\"message\":\"Perimeter signal start queued\"}");
     } else {
-        String error = perimeterClientPtr->getLastError();
-        request->send(500, "application/json", "{\"error\":\"" + error + "\"}");
-        Logger::error("API: Failed to start perimeter signal: " + error);
+        request->send(503, "application/json", "{\"error\":\"Perimeter sender queue full\"}");
+        Logger::error("API: Failed to queue perimeter start");
     }
 }
 
@@ -615,14 +1204,11 @@ void WebAPI::handlePerimeterStop(AsyncWebServerRequest *request) {
         return;
     }
 
-    bool success = perimeterClientPtr->stopSignal();
-    if (success) {
-        request->send(200, "application/json", "{\"status\":\"stopped\",\"message\":\"Perimeter signal stopped\"}");
-        Logger::info("API: Perimeter signal stopped");
+    if (perimeterClientPtr->stopSignal(onPerimeterCommandDone)) {
+        request->send(202, "application/json", "{\"status\":\"queued\",\"message\":\"Perimeter signal stop queued\"}");
     } else {
-        String error = perimeterClientPtr->getLastError();
-        request->send(500, "application/json", "{\"error\":\"" + error + "\"}");
-        Logger::error("API: Failed to stop perimeter signal: " + error);
+        request->send(503, "application/json", "{\"error\":\"Perimeter sender queue full\"}");
+        Logger::error("API: Failed to queue perimeter stop");
     }
 }
 
@@ -656,3 +1242,56 @@ void WebAPI::handleReturnToBase(AsyncWebServerRequest *request) {
     Logger::info("API: Return to base requested");
 }
 #endif
+
+#if ENABLE_BLACKBOX
+void WebAPI::setBlackBox(BlackBox* box) {
+    blackBoxPtr = box;
+}
+#endif
+
+void WebAPI::setNavigationReferences(OccupancyGrid* map, LocalPlanner* planner) {
+    localMapPtr = map;
+    localPlannerPtr = planner;
+}
+
+#if ENABLE_PROFILER
+void WebAPI::setProfiler(LoopProfiler* profiler) {
+    profilerPtr = profiler;
+}
+#endif
+
+#if ENABLE_WATCHDOG
+void WebAPI::setDeadlineMonitor(DeadlineMonitor* monitor) {
+    deadlineMonitorPtr = monitor;
+}
+#endif
+
+#if ENABLE_ZONES
+void WebAPI::setZoneManager(ZoneManager* zones) {
+    zoneManagerPtr = zones;
+}
+#endif
+
+#if ENABLE_MISSION_PLANNER
+void WebAPI::setMissionPlanner(MissionPlanner* planner) {
+    missionPlannerPtr = planner;
+}
+#endif
+
+#if ENABLE_CHECKPOINT
+void WebAPI::setSessionCheckpoint(SessionCheckpoint* checkpoint) {
+    checkpointPtr = checkpoint;
+}
+#endif
+
+#if ENABLE_DOCKING
+void WebAPI::setDockingController(DockingController* docking) {
+    dockingPtr = docking;
+}
+#endif
+
+#if ENABLE_STATS
+void WebAPI::setStatsStore(StatsStore* store) {
+    statsPtr = store;
+}
+#endif
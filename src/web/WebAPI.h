@@ -15,9 +15,21 @@ class Sensors;
 class IMU;
 class Motors;
 class CuttingMechanism;
+class BlackBox;
+class LoopProfiler;
+class DeadlineMonitor;
+class OccupancyGrid;
+class LocalPlanner;
+class ZoneManager;
+class MissionPlanner;
+class SessionCheckpoint;
+class DockingController;
+class StatsStore;
 #if ENABLE_PERIMETER
 class PerimeterReceiver;
 class PerimeterClient;
+class WireFollower;
+class SignalSearch;
 #endif
 
 /**
@@ -79,15 +91,67 @@ public:
 private:
     // HTTP request handlers
     void handleGetStatus(AsyncWebServerRequest *request);
+    void handleGetStateStats(AsyncWebServerRequest *request);
+    void handleGetMap(AsyncWebServerRequest *request);
     void handleStart(AsyncWebServerRequest *request);
     void handleStop(AsyncWebServerRequest *request);
     void handlePause(AsyncWebServerRequest *request);
     void handleCalibrate(AsyncWebServerRequest *request);
     void handleCalibrateMag(AsyncWebServerRequest *request);
     void handleGetLogs(AsyncWebServerRequest *request);
+    void handleGetLogLevels(AsyncWebServerRequest *request);
+    void handleSetLogLevel(AsyncWebServerRequest *request);
     void handleGetSettings(AsyncWebServerRequest *request);
     void handleUpdateSettings(AsyncWebServerRequest *request);
 
+    #if ENABLE_BLACKBOX
+    // Black box handlers
+    void handleBlackBoxStatus(AsyncWebServerRequest *request);
+    void handleBlackBoxDownload(AsyncWebServerRequest *request);
+    void handleBlackBoxClear(AsyncWebServerRequest *request);
+    #endif
+
+    #if ENABLE_PROFILER
+    // Profiler handlers
+    void handleGetPerf(AsyncWebServerRequest *request);
+    void handleResetPerf(AsyncWebServerRequest *request);
+    #endif
+
+    #if ENABLE_WATCHDOG
+    // Deadline handlers
+    void handleGetDeadlines(AsyncWebServerRequest *request);
+    #endif
+
+    #if ENABLE_ZONES
+    // Zone handlers
+    void handleGetZones(AsyncWebServerRequest *request);
+    void handleSaveZone(AsyncWebServerRequest *request);
+    void handleDeleteZone(AsyncWebServerRequest *request);
+    void handleSelectZone(AsyncWebServerRequest *request);
+    void handleGetZonePlan(AsyncWebServerRequest *request);
+    #endif
+
+    #if ENABLE_MISSION_PLANNER
+    // Mission handler
+    void handleGetMission(AsyncWebServerRequest *request);
+    #endif
+
+    #if ENABLE_CHECKPOINT
+    // Checkpoint handlers
+    void handleGetCheckpoint(AsyncWebServerRequest *request);
+    void handleClearCheckpoint(AsyncWebServerRequest *request);
+    #endif
+
+    #if ENABLE_DOCKING
+    // Ladestation handler
+    void handleGetDock(AsyncWebServerRequest *request);
+    #endif
+
+    #if ENABLE_STATS
+    // Statistik handler
+    void handleGetStats(AsyncWebServerRequest *request);
+    #endif
+
     // Manuel kontrol handlers
     void handleManualForward(AsyncWebServerRequest *request);
     void handleManualBackward(AsyncWebServerRequest *request);
@@ -119,6 +183,34 @@ private:
     #if ENABLE_PERIMETER
     PerimeterReceiver* perimeterReceiverPtr;
     PerimeterClient* perimeterClientPtr;
+    WireFollower* wireFollowerPtr;
+    SignalSearch* signalSearchPtr;
+    #endif
+    #if ENABLE_BLACKBOX
+    BlackBox* blackBoxPtr;
+    #endif
+    #if ENABLE_PROFILER
+    LoopProfiler* profilerPtr;
+    #endif
+    #if ENABLE_WATCHDOG
+    DeadlineMonitor* deadlineMonitorPtr;
+    #endif
+    OccupancyGrid* localMapPtr;
+    LocalPlanner* localPlannerPtr;
+    #if ENABLE_ZONES
+    ZoneManager* zoneManagerPtr;
+    #endif
+    #if ENABLE_MISSION_PLANNER
+    MissionPlanner* missionPlannerPtr;
+    #endif
+    #if ENABLE_CHECKPOINT
+    SessionCheckpoint* checkpointPtr;
+    #endif
+    #if ENABLE_DOCKING
+    DockingController* dockingPtr;
+    #endif
+    #if ENABLE_STATS
+    StatsStore* statsPtr;
     #endif
 
     // State
@@ -130,6 +222,77 @@ public:
      * Sætter perimeter references (kaldes fra main)
      */
     void setPerimeterReferences(PerimeterReceiver* receiver, PerimeterClient* client);
+
+    /**
+     * Sætter wire follower reference (kaldes fra main)
+     */
+    void setWireFollower(WireFollower* follower);
+
+    /**
+     * Sætter signal søgning reference (kaldes fra main)
+     */
+    void setSignalSearch(SignalSearch* search);
+    #endif
+
+    #if ENABLE_BLACKBOX
+    /**
+     * Sætter black box reference (kaldes fra main)
+     */
+    void setBlackBox(BlackBox* box);
+    #endif
+
+    /**
+     * Sætter lokalt kort og planner references (kaldes fra main)
+     */
+    void setNavigationReferences(OccupancyGrid* map, LocalPlanner* planner);
+
+    #if ENABLE_PROFILER
+    /**
+     * Sætter loop profiler reference (kaldes fra main)
+     */
+    void setProfiler(LoopProfiler* profiler);
+    #endif
+
+    #if ENABLE_WATCHDOG
+    /**
+     * Sætter deadline monitor reference (kaldes fra main)
+     */
+    void setDeadlineMonitor(DeadlineMonitor* monitor);
+    #endif
+
+    #if ENABLE_ZONES
+    /**
+     * Sætter zone manager reference (kaldes fra main)
+     */
+    void setZoneManager(ZoneManager* zones);
+    #endif
+
+    #if ENABLE_MISSION_PLANNER
+    /**
+     * Sætter mission planner reference (kaldes fra main)
+     */
+    void setMissionPlanner(MissionPlanner* planner);
+    #endif
+
+    #if ENABLE_CHECKPOINT
+    /**
+     * Sætter session checkpoint reference (kaldes fra main)
+     */
+    void setSessionCheckpoint(SessionCheckpoint* checkpoint);
+    #endif
+
+    #if ENABLE_DOCKING
+    /**
+     * Sætter docking controller reference (kaldes fra main)
+     */
+    void setDockingController(DockingController* docking);
+    #endif
+
+    #if ENABLE_STATS
+    /**
+     * Sætter statistik reference (kaldes fra main)
+     */
+    void setStatsStore(StatsStore* store);
     #endif
 };
 
@@ -1,5 +1,19 @@
 #include "WebServer.h"
 #include <LittleFS.h>
+#include "../system/DeadlineMonitor.h"
+#if WEB_ASSETS_PROGMEM
+#include "WebAssets.h"
+#endif
+
+// Statiske web filer - minificeres og gzippes af tools/build_web_assets.py
+static const struct {
+    const char* path;
+    const char* contentType;
+} STATIC_ASSETS[] = {
+    {"/index.html", "text/html"},
+    {"/style.css",  "text/css"},
+    {"/app.js",     "application/javascript"},
+};
 
 MowerWebServer::MowerWebServer() {
     server = nullptr;
@@ -10,6 +24,12 @@ MowerWebServer::MowerWebServer() {
     initialized = false;
     wifiManager = nullptr;
     updateManager = nullptr;
+    deadlineMonitor = nullptr;
+
+    for (int i = 0; i < STATIC_ASSET_COUNT; i++) {
+        assetETag[i] = "";
+        assetAvailable[i] = false;
+    }
 }
 
 bool MowerWebServer::begin() {
@@ -22,6 +42,8 @@ bool MowerWebServer::begin() {
         Logger::info("LittleFS mounted successfully");
     }
 
+    loadStaticAssets();
+
     // Opret server objekt
     server = new AsyncWebServer(WEB_SERVER_PORT);
 
@@ -87,6 +109,16 @@ void MowerWebServer::update() {
     handleOTA();
     #endif
 
+    #if ENABLE_WIFI_MANAGER
+    // WiFiManager reconnecter selv uden at blokere - spejl blot status
+    if (wifiManager != nullptr) {
+        wifiConnected = wifiManager->isConnected();
+        apMode = wifiManager->isAPMode();
+        ipAddress = wifiManager->getIPAddress();
+        return;
+    }
+    #endif
+
     // Tjek WiFi status periodisk
     unsigned long currentTime = millis();
     if (currentTime - lastWiFiCheck > 30000) { // Hver 30 sekund
@@ -109,19 +141,15 @@ void MowerWebServer::setupRoutes() {
     // Note: Root handler "/" is defined in WiFi Manager section below
 
     // Serve CSS file
-    server->on("/style.css", HTTP_GET, [](AsyncWebServerRequest *request) {
-        if (LittleFS.exists("/style.css")) {
-            request->send(LittleFS, "/style.css", "text/css");
-        } else {
+    server->on("/style.css", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        if (!sendStaticAsset(request, "/style.css")) {
             request->send(404, "text/plain", "File not found");
         }
     });
 
     // Serve JavaScript file
-    server->on("/app.js", HTTP_GET, [](AsyncWebServerRequest *request) {
-        if (LittleFS.exists("/app.js")) {
-            request->send(LittleFS, "/app.js", "application/javascript");
-        } else {
+    server->on("/app.js", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        if (!sendStaticAsset(request, "/app.js")) {
             request->send(404, "text/plain", "File not found");
         }
     });
@@ -191,9 +219,7 @@ void MowerWebServer::setupRoutes() {
             request->send(200, "text/html", WiFiManager::getCaptivePortalHTML());
         } else {
             // Normal root handling
-            if (LittleFS.exists("/index.html")) {
-                request->send(LittleFS, "/index.html", "text/html");
-            } else {
+            if (!sendStaticAsset(request, "/index.html")) {
                 String html = "<!DOCTYPE html><html><head><title>Robot Mower</title>";
                 html += "<meta name='viewport' content='width=device-width, initial-scale=1'>";
                 html += "</head><body>";
@@ -251,6 +277,15 @@ void MowerWebServer::setupRoutes() {
         }
     });
 
+    // WiFi forbindelses status
+    server->on("/wifi/status", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        if (wifiManager == nullptr) {
+            request->send(500, "application/json", "{\"error\":\"WiFiManager not available\"}");
+            return;
+        }
+        request->send(200, "application/json", wifiManager->getStatusJSON());
+    });
+
     // WiFi reset (force AP mode)
     server->on("/wifi/reset", HTTP_POST, [this](AsyncWebServerRequest *request) {
         if (wifiManager != nullptr) {
@@ -409,6 +444,117 @@ void MowerWebServer::setupMDNS() {
 }
 
 
+void MowerWebServer::loadStaticAssets() {
+    for (int i = 0; i < STATIC_ASSET_COUNT; i++) {
+        assetAvailable[i] = false;
+        assetETag[i] = "";
+
+        #if WEB_ASSETS_PROGMEM
+        // Indlejret i firmware - ETag er beregnet af build scriptet
+        for (int j = 0; j < WEB_ASSET_COUNT; j++) {
+            if (strcmp(WEB_ASSETS[j].path, STATIC_ASSETS[i].path) == 0) {
+                assetETag[i] = WEB_ASSETS[j].etag;
+                assetAvailable[i] = true;
+            }
+        }
+        #else
+        String gzPath = String(STATIC_ASSETS[i].path) + ".gz";
+        if (LittleFS.exists(gzPath)) {
+            assetETag[i] = computeFileETag(gzPath.c_str());
+            assetAvailable[i] = assetETag[i].length() > 0;
+        }
+        #endif
+
+        if (assetAvailable[i]) {
+            Logger::info("Static asset " + String(STATIC_ASSETS[i].path) +
+                         " (gzip, ETag " + assetETag[i] + ")");
+        }
+    }
+}
+
+bool MowerWebServer::sendStaticAsset(AsyncWebServerRequest *request, const char* path) {
+    int index = -1;
+    for (int i = 0; i < STATIC_ASSET_COUNT; i++) {
+        if (strcmp(STATIC_ASSETS[i].path, path) == 0) {
+            index = i;
+            break;
+        }
+    }
+    if (index < 0) {
+        return false;
+    }
+
+    const char* contentType = STATIC_ASSETS[index].contentType;
+
+    // Ingen gzip version - fald tilbage til ukomprimeret fil uden caching
+    if (!assetAvailable[index]) {
+        if (LittleFS.exists(path)) {
+            request->send(LittleFS, path, contentType);
+            return true;
+        }
+        return false;
+    }
+
+    // Versionerede URLs (?v=<etag>) ændrer sig aldrig - cache længe.
+    // Ellers skal browseren revalidere hver gang (billigt med 304).
+    String cacheControl = request->hasParam("v") ?
+        "public, max-age=" + String(WEB_CACHE_MAX_AGE) + ", immutable" :
+        String("no-cache");
+
+    if (request->hasHeader("If-None-Match") &&
+        request->header("If-None-Match") == assetETag[index]) {
+        AsyncWebServerResponse *response = request->beginResponse(304);
+        response->addHeader("ETag", assetETag[index]);
+        response->addHeader("Cache-Control", cacheControl);
+        request->send(response);
+        return true;
+    }
+
+    #if WEB_ASSETS_PROGMEM
+    const WebAsset* asset = nullptr;
+    for (int j = 0; j < WEB_ASSET_COUNT; j++) {
+        if (strcmp(WEB_ASSETS[j].path, path) == 0) {
+            asset = &WEB_ASSETS[j];
+            break;
+        }
+    }
+    AsyncWebServerResponse *response =
+        request->beginResponse(200, contentType, asset->data, asset->length);
+    #else
+    AsyncWebServerResponse *response =
+        request->beginResponse(LittleFS, String(path) + ".gz", contentType);
+    #endif
+
+    response->addHeader("Content-Encoding", "gzip");
+    response->addHeader("ETag", assetETag[index]);
+    response->addHeader("Cache-Control", cacheControl);
+    request->send(response);
+    return true;
+}
+
+String MowerWebServer::computeFileETag(const char* path) {
+    File file = LittleFS.open(path, "r");
+    if (!file) {
+        return "";
+    }
+
+    // 32-bit FNV-1a - samme algoritme som tools/build_web_assets.py
+    uint32_t hash = 0x811C9DC5;
+    uint8_t buffer[256];
+    while (file.available()) {
+        size_t count = file.read(buffer, sizeof(buffer));
+        for (size_t i = 0; i < count; i++) {
+            hash ^= buffer[i];
+            hash *= 0x01000193;
+        }
+    }
+    file.close();
+
+    char etag[12];
+    snprintf(etag, sizeof(etag), "\"%08lx\"", (unsigned long)hash);
+    return String(etag);
+}
+
 void MowerWebServer::handleNotFound(AsyncWebServerRequest *request) {
     // Hvis i AP mode (captive portal), omdiriger alle anmodninger til captive portal siden
     // Dette gør at smartphones og computere automatisk åbner captive portal
@@ -433,7 +579,13 @@ void MowerWebServer::setupOTA() {
     ArduinoOTA.setPassword(OTA_PASSWORD);
     ArduinoOTA.setPort(OTA_PORT);
 
-    ArduinoOTA.onStart([]() {
+    // handle() modtager hele billedet før den returnerer - uden pause
+    // ville task watchdog genstarte midt i overførslen
+    ArduinoOTA.onStart([this]() {
+        if (deadlineMonitor != nullptr) {
+            deadlineMonitor->suspend("OTA");
+        }
+
         String type;
         if (ArduinoOTA.getCommand() == U_FLASH) {
             type = "sketch";
@@ -443,8 +595,11 @@ void MowerWebServer::setupOTA() {
         Logger::info("OTA: Start updating " + type);
     });
 
-    ArduinoOTA.onEnd([]() {
+    ArduinoOTA.onEnd([this]() {
         Logger::info("OTA: Update complete");
+        if (deadlineMonitor != nullptr) {
+            deadlineMonitor->resume();
+        }
     });
 
     ArduinoOTA.onProgress([](unsigned int progress, unsigned int total) {
@@ -456,7 +611,7 @@ void MowerWebServer::setupOTA() {
         }
     });
 
-    ArduinoOTA.onError([](ota_error_t error) {
+    ArduinoOTA.onError([this](ota_error_t error) {
         String errorMsg = "OTA Error[" + String(error) + "]: ";
         if (error == OTA_AUTH_ERROR) errorMsg += "Auth Failed";
         else if (error == OTA_BEGIN_ERROR) errorMsg += "Begin Failed";
@@ -464,6 +619,9 @@ void MowerWebServer::setupOTA() {
         else if (error == OTA_RECEIVE_ERROR) errorMsg += "Receive Failed";
         else if (error == OTA_END_ERROR) errorMsg += "End Failed";
         Logger::error(errorMsg);
+        if (deadlineMonitor != nullptr) {
+            deadlineMonitor->resume();
+        }
     });
 
     ArduinoOTA.begin();
@@ -486,3 +644,7 @@ void MowerWebServer::setUpdateManager(UpdateManager* updateMgr) {
     updateManager = updateMgr;
     Logger::info("UpdateManager reference set");
 }
+
+void MowerWebServer::setDeadlineMonitor(DeadlineMonitor* monitor) {
+    deadlineMonitor = monitor;
+}
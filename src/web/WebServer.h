@@ -28,6 +28,8 @@
 #include "../system/WiFiManager.h"
 #include "../system/UpdateManager.h"
 
+class DeadlineMonitor;
+
 /**
  * MowerWebServer klasse - Håndterer HTTP web server
  *
@@ -106,6 +108,14 @@ public:
      */
     void setUpdateManager(UpdateManager* updateMgr);
 
+    /**
+     * Sætter DeadlineMonitor reference
+     * ArduinoOTA blokerer loop under hele overførslen, så deadlines og
+     * task watchdog sættes på pause mens den kører.
+     * @param monitor Pointer til DeadlineMonitor
+     */
+    void setDeadlineMonitor(DeadlineMonitor* monitor);
+
 private:
     /**
      * Forbinder til WiFi netværk
@@ -133,6 +143,28 @@ private:
      */
     void handleNotFound(AsyncWebServerRequest *request);
 
+    /**
+     * Finder gzippede statiske filer og beregner deres ETags
+     * Kaldes én gang efter LittleFS er mountet
+     */
+    void loadStaticAssets();
+
+    /**
+     * Sender statisk fil gzippet med ETag og Cache-Control
+     * Svarer 304 hvis browserens If-None-Match matcher
+     * @param request HTTP request
+     * @param path URL sti (f.eks. "/app.js")
+     * @return false hvis filen ikke findes
+     */
+    bool sendStaticAsset(AsyncWebServerRequest *request, const char* path);
+
+    /**
+     * Beregner 32-bit FNV-1a hash af en fil (bruges som ETag)
+     * @param path Sti på LittleFS
+     * @return Hash som hex string i anførselstegn
+     */
+    static String computeFileETag(const char* path);
+
     // Server objekt
     AsyncWebServer* server;
 
@@ -147,9 +179,15 @@ private:
     // State
     bool initialized;
 
+    // Statiske filer (LittleFS: "<sti>.gz" med ETag beregnet ved opstart)
+    static const int STATIC_ASSET_COUNT = 3;
+    String assetETag[STATIC_ASSET_COUNT];
+    bool assetAvailable[STATIC_ASSET_COUNT];
+
     // Manager references
     WiFiManager* wifiManager;
     UpdateManager* updateManager;
+    DeadlineMonitor* deadlineMonitor;
 };
 
 #endif // WEBSERVER_H
@@ -170,9 +170,7 @@ void WebSocketHandler::handleWebSocketMessage(void *arg, uint8_t *data, size_t l
         // Håndter kommandoer
         String command = doc["command"];
 
-        #if DEBUG_WEBSOCKET
-        Logger::debug("WebSocket command: " + command);
-        #endif
+        LOGD(LOG_SUB_WEB, "WebSocket command: %s", command.c_str());
 
         // Håndter automatisk kontrol kommandoer
         if (command == "start" && stateManagerPtr != nullptr) {
@@ -194,28 +192,28 @@ void WebSocketHandler::handleWebSocketMessage(void *arg, uint8_t *data, size_t l
         // Håndter manuel kontrol kommandoer
         else if (command == "forward" && motorsPtr != nullptr) {
             if (stateManagerPtr != nullptr) {
-                stateManagerPtr->setState(STATE_MANUAL);
+                stateManagerPtr->enterManualMode();
             }
             motorsPtr->forward(MOTOR_CRUISE_SPEED);
             Logger::info("WS: Manual forward");
         }
         else if (command == "backward" && motorsPtr != nullptr) {
             if (stateManagerPtr != nullptr) {
-                stateManagerPtr->setState(STATE_MANUAL);
+                stateManagerPtr->enterManualMode();
             }
             motorsPtr->backward(MOTOR_CRUISE_SPEED);
             Logger::info("WS: Manual backward");
         }
         else if (command == "left" && motorsPtr != nullptr) {
             if (stateManagerPtr != nullptr) {
-                stateManagerPtr->setState(STATE_MANUAL);
+                stateManagerPtr->enterManualMode();
             }
             motorsPtr->turnLeft(MOTOR_TURN_SPEED);
             Logger::info("WS: Manual left");
         }
         else if (command == "right" && motorsPtr != nullptr) {
             if (stateManagerPtr != nullptr) {
-                stateManagerPtr->setState(STATE_MANUAL);
+                stateManagerPtr->enterManualMode();
             }
             motorsPtr->turnRight(MOTOR_TURN_SPEED);
             Logger::info("WS: Manual right");
@@ -7,6 +7,7 @@ let autoScroll = true;
 let updateInterval = null;
 let calibrationInProgress = false;
 let calibrationTimer = null;
+let perfInterval = null;
 
 // Canvas contexts
 let sensorCanvas = null;
@@ -72,6 +73,9 @@ function initializeEventListeners() {
         autoScroll = e.target.checked;
     });
 
+    // Performance
+    document.getElementById('btnResetPerf').addEventListener('click', handleResetPerf);
+
     // Settings
     document.getElementById('btnSaveSettings').addEventListener('click', handleSaveSettings);
     document.getElementById('motorSpeed').addEventListener('input', function(e) {
@@ -158,6 +162,7 @@ function updateConnectionStatus(connected) {
 // Start periodic status updates via HTTP
 function startStatusUpdates() {
     updateInterval = setInterval(fetchStatus, 1000); // Every 1 second
+    perfInterval = setInterval(fetchPerf, 2000);     // Every 2 seconds
 }
 
 // Fetch status from API
@@ -173,6 +178,57 @@ async function fetchStatus() {
     }
 }
 
+// Fetch loop profiler data
+async function fetchPerf() {
+    try {
+        const response = await fetch('/api/perf');
+        if (response.ok) {
+            const data = await response.json();
+            updatePerf(data);
+        }
+    } catch(e) {
+        console.error('Error fetching perf:', e);
+    }
+}
+
+// Format microseconds as us/ms
+function formatMicros(us) {
+    return us >= 1000 ? (us / 1000).toFixed(1) + ' ms' : us + ' us';
+}
+
+// Update performance panel
+function updatePerf(data) {
+    document.getElementById('perfPeriod').textContent =
+        `${formatMicros(data.period.avgUs)} / ${formatMicros(data.period.p99Us)}`;
+    document.getElementById('perfOverruns').textContent = data.overruns;
+
+    const tbody = document.getElementById('perfSections');
+    tbody.innerHTML = '';
+    for (const [name, s] of Object.entries(data.sections)) {
+        if (s.count === 0) continue;
+        const row = document.createElement('tr');
+        if (s.p99Us > data.budgetUs) {
+            row.className = 'over-budget';
+        }
+        row.innerHTML = `<td>${name}</td><td>${s.count}</td><td>${formatMicros(s.minUs)}</td>` +
+            `<td>${formatMicros(s.avgUs)}</td><td>${formatMicros(s.p99Us)}</td><td>${formatMicros(s.maxUs)}</td>`;
+        tbody.appendChild(row);
+    }
+}
+
+// Reset loop profiler
+async function handleResetPerf() {
+    try {
+        const response = await fetch('/api/perf/reset', { method: 'POST' });
+        if (response.ok) {
+            addLog('info', 'Profiler nulstillet');
+            fetchPerf();
+        }
+    } catch(e) {
+        addLog('error', 'Fejl ved nulstilling af profiler: ' + e.message);
+    }
+}
+
 // Update dashboard with status data
 function updateDashboard(data) {
     // State
@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+"""
+Black box dekoder - konverterer en downloadet black box ring (/bb eller /bb_error) til CSV
+
+Hent filen fra robotten:
+    curl -o blackbox.bin "http://<robot-ip>/api/blackbox/download?file=error"
+
+Dekod:
+    python3 tools/blackbox_decode.py blackbox.bin > blackbox.csv
+
+Formatet er beskrevet i src/system/BlackBox.h.
+"""
+
+import csv
+import struct
+import sys
+
+PAGE_SIZE = 512
+RECORD_SIZE = 32
+MAGIC = 0x5842424D
+PAGE_HEADER = struct.Struct("<IIHBBI")
+RECORD_HEADER = struct.Struct("<IBBH")
+TELEMETRY = struct.Struct("<hhhHhhHHHHHBB")
+
+STATES = ["IDLE", "MANUAL", "CALIBRATING", "MOWING", "TURNING", "AVOIDING",
+          "RETURNING", "SEARCHING_SIGNAL", "CHARGING", "ERROR"]
+LEVELS = ["DEBUG", "INFO", "WARN", "ERROR"]
+SUBSYSTEMS = ["core", "navigation", "motors", "sensors", "perimeter", "web", "battery"]
+
+
+def name(table, index):
+    return table[index] if index < len(table) else str(index)
+
+
+def text(raw):
+    return raw.split(b"\0", 1)[0].decode("utf-8", "replace")
+
+
+def read_pages(data):
+    pages = []
+    for offset in range(0, len(data) - PAGE_SIZE + 1, PAGE_SIZE):
+        magic, seq, boot, count, version, _ = PAGE_HEADER.unpack_from(data, offset)
+        if magic == MAGIC:
+            pages.append((boot, seq, count, offset))
+    # Ringen er cirkulær - sortér efter boot og sidesekvens
+    pages.sort()
+    return pages
+
+
+def decode(data, out):
+    writer = csv.writer(out)
+    writer.writerow(["boot", "time_ms", "seq", "type", "state",
+                     "heading", "pitch", "roll", "battery_v",
+                     "motor_l", "motor_r", "current_l", "current_r",
+                     "sonar_l_cm", "sonar_m_cm", "sonar_r_cm",
+                     "perim_strength", "perim_state", "text"])
+
+    for boot, _, count, offset in read_pages(data):
+        for i in range(count):
+            pos = offset + PAGE_HEADER.size + i * RECORD_SIZE
+            ts, rtype, state, seq = RECORD_HEADER.unpack_from(data, pos)
+            payload = data[pos + RECORD_HEADER.size:pos + RECORD_SIZE]
+            state_name = "" if state == 0xFF else name(STATES, state)
+
+            if rtype == 1:
+                t = TELEMETRY.unpack_from(payload)
+                writer.writerow([boot, ts, seq, "TELEMETRY", state_name,
+                                 t[0] / 10, t[1] / 10, t[2] / 10, t[3] / 1000,
+                                 t[4], t[5], t[6] / 100, t[7] / 100,
+                                 t[8] / 10, t[9] / 10, t[10] / 10,
+                                 t[11], t[12], ""])
+            elif rtype == 2:
+                message = "[%s] [%s] %s" % (name(LEVELS, payload[0]),
+                                            name(SUBSYSTEMS, payload[1]),
+                                            text(payload[2:]))
+                writer.writerow([boot, ts, seq, "LOG", state_name] + [""] * 13 + [message])
+            elif rtype == 3:
+                message = "%s -> %s %s" % (name(STATES, payload[0]),
+                                           name(STATES, payload[1]),
+                                           text(payload[2:]))
+                writer.writerow([boot, ts, seq, "STATE", state_name] + [""] * 13 + [message.strip()])
+
+
+def main():
+    if len(sys.argv) != 2:
+        print("Brug: blackbox_decode.py <blackbox.bin>", file=sys.stderr)
+        return 1
+
+    with open(sys.argv[1], "rb") as f:
+        data = f.read()
+
+    decode(data, sys.stdout)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,155 @@
+#!/usr/bin/env python3
+"""
+Web asset pipeline - minificerer og gzipper web UI filerne
+
+Læser src/web/data/{index.html,style.css,app.js} og skriver:
+  data/*.gz             - gzippede filer til LittleFS image (pio run -t uploadfs)
+  src/web/WebAssets.h   - samme filer som PROGMEM arrays (WEB_ASSETS_PROGMEM)
+
+index.html omskrives så style.css og app.js hentes med ?v=<etag>. Derved kan
+browseren cache dem "for evigt", mens index.html altid revalideres (304).
+
+Køres automatisk af PlatformIO (extra_scripts i platformio.ini) eller manuelt:
+    python3 tools/build_web_assets.py
+"""
+
+import gzip
+import os
+import re
+
+ASSETS = [
+    # (filnavn, content type) - index.html sidst så versionerne kendes
+    ("style.css", "text/css"),
+    ("app.js", "application/javascript"),
+    ("index.html", "text/html"),
+]
+
+
+def fnv1a(data):
+    """32-bit FNV-1a - samme algoritme som MowerWebServer bruger til LittleFS filer"""
+    h = 0x811C9DC5
+    for b in data:
+        h ^= b
+        h = (h * 0x01000193) & 0xFFFFFFFF
+    return "%08x" % h
+
+
+def minify_css(text):
+    text = re.sub(r"/\*.*?\*/", "", text, flags=re.S)
+    lines = [line.strip() for line in text.splitlines()]
+    text = "".join(line for line in lines if line)
+    text = re.sub(r"\s*([{}:;,>])\s*", r"\1", text)
+    return text.replace(";}", "}")
+
+
+def minify_js(text):
+    # Konservativ: fjern indrykning, tomme linjer og hel-linje kommentarer.
+    # Linjer inde i template strings (`...`) bevares uændret.
+    out = []
+    in_template = False
+    for line in text.splitlines():
+        stripped = line.strip()
+        if in_template:
+            out.append(line)
+        elif stripped and not stripped.startswith("//"):
+            out.append(stripped)
+        if line.count("`") % 2 == 1:
+            in_template = not in_template
+    return "\n".join(out)
+
+
+def minify_html(text):
+    text = re.sub(r"<!--.*?-->", "", text, flags=re.S)
+    lines = [line.strip() for line in text.splitlines()]
+    return "\n".join(line for line in lines if line)
+
+
+MINIFIERS = {
+    "text/css": minify_css,
+    "application/javascript": minify_js,
+    "text/html": minify_html,
+}
+
+
+def c_identifier(name):
+    return "WEB_ASSET_" + re.sub(r"[^A-Za-z0-9]", "_", name).upper()
+
+
+def build(project_dir):
+    source_dir = os.path.join(project_dir, "src", "web", "data")
+    fs_dir = os.path.join(project_dir, "data")
+    header_path = os.path.join(project_dir, "src", "web", "WebAssets.h")
+
+    versions = {}
+    built = []
+
+    for name, content_type in ASSETS:
+        with open(os.path.join(source_dir, name), "r", encoding="utf-8") as f:
+            text = f.read()
+
+        if name == "index.html":
+            for dep, version in versions.items():
+                text = re.sub(r'(["\'])/?%s\1' % re.escape(dep),
+                              r'\1/%s?v=%s\1' % (dep, version), text)
+
+        raw = MINIFIERS[content_type](text).encode("utf-8")
+        # mtime=0 giver reproducerbar output (samme input = samme ETag)
+        packed = gzip.compress(raw, compresslevel=9, mtime=0)
+        etag = fnv1a(packed)
+        versions[name] = etag
+        built.append((name, content_type, packed, etag, len(text.encode("utf-8"))))
+
+        os.makedirs(fs_dir, exist_ok=True)
+        with open(os.path.join(fs_dir, name + ".gz"), "wb") as f:
+            f.write(packed)
+
+    lines = [
+        "// AUTO-GENERERET af tools/build_web_assets.py - rediger ikke manuelt",
+        "#ifndef WEB_ASSETS_H",
+        "#define WEB_ASSETS_H",
+        "",
+        "#include <Arduino.h>",
+        "",
+        "struct WebAsset {",
+        "    const char* path;           // URL sti",
+        "    const char* contentType;",
+        "    const uint8_t* data;        // Gzippet indhold",
+        "    size_t length;",
+        "    const char* etag;           // FNV-1a af gzippet indhold",
+        "};",
+        "",
+    ]
+    for name, _, packed, _, _ in built:
+        lines.append("static const uint8_t %s[] PROGMEM = {" % c_identifier(name))
+        for i in range(0, len(packed), 16):
+            lines.append("    " + ", ".join("0x%02x" % b for b in packed[i:i + 16]) + ",")
+        lines.append("};")
+        lines.append("")
+    lines.append("static const WebAsset WEB_ASSETS[] = {")
+    for name, content_type, packed, etag, _ in built:
+        lines.append('    {"/%s", "%s", %s, %d, "\\"%s\\""},' %
+                     (name, content_type, c_identifier(name), len(packed), etag))
+    lines.append("};")
+    lines.append("")
+    lines.append("static const int WEB_ASSET_COUNT = sizeof(WEB_ASSETS) / sizeof(WEB_ASSETS[0]);")
+    lines.append("")
+    lines.append("#endif // WEB_ASSETS_H")
+    lines.append("")
+
+    header = "\n".join(lines)
+    # Skriv kun hvis ændret - undgår unødvendig rekompilering
+    if not os.path.exists(header_path) or open(header_path).read() != header:
+        with open(header_path, "w") as f:
+            f.write(header)
+
+    for name, _, packed, etag, original in built:
+        print("web asset %-10s %6d -> %5d bytes gzip (etag %s)" %
+              (name, original, len(packed), etag))
+
+
+try:
+    Import("env")  # noqa: F821 - defineret når scriptet køres af PlatformIO
+    build(env["PROJECT_DIR"])  # noqa: F821
+except NameError:
+    if __name__ == "__main__":
+        build(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
@@ -0,0 +1,319 @@
+#include "Plant.h"
+#include <Wire.h>
+#include "config/Config.h"
+
+PlantState plant;
+HarnessSerial Serial;
+TwoWire Wire;
+
+// MPU-9250 registre driverne læser
+static const uint8_t MPU_ADDRESS = 0x68;
+static const uint8_t MPU_WHO_AM_I = 0x75;
+static const uint8_t MPU_ACCEL_XOUT_H = 0x3B;
+static const float ACCEL_LSB_PER_G = 16384.0;
+
+static const int MOTOR_PWM_PINS[] = { MOTOR_LEFT_RPWM, MOTOR_LEFT_LPWM, MOTOR_RIGHT_RPWM, MOTOR_RIGHT_LPWM };
+static const int MOTOR_ENABLE_PINS[] = { MOTOR_LEFT_R_EN, MOTOR_LEFT_L_EN, MOTOR_RIGHT_R_EN, MOTOR_RIGHT_L_EN };
+
+void plantReset() {
+    bool verbose = plant.verbose;
+    plant = PlantState();
+    plant.verbose = verbose;
+
+    plant.nowUs = 0;
+    plant.batteryVolts = 11.8;
+    for (int i = 0; i < PLANT_PIN_COUNT; i++) {
+        plant.adcOverride[i] = -1;
+        plant.pinLevel[i] = LOW;
+        plant.pwmDuty[i] = 0;
+    }
+    for (int i = 0; i < SONAR_COUNT; i++) {
+        plant.sonarCm[i] = 150.0;
+        plant.sonarDead[i] = false;
+        plant.sonarGlitchCm[i] = -1.0;
+        plant.sonarApproach[i] = false;
+    }
+    plant.i2cHang = false;
+    plant.rollDeg = 0.0;
+    plant.perimeter = SIGNAL_NONE;
+    plant.perimeterScale = 1.0;
+    plant.perimeterPhase = 0;
+    plant.motorsStopped = true;
+    plant.motorsDisabled = true;
+}
+
+float plantForwardSpeedCmS() {
+    if (plant.motorsDisabled) {
+        return 0.0;
+    }
+
+    int left = (int)plant.pwmDuty[MOTOR_LEFT_RPWM] - (int)plant.pwmDuty[MOTOR_LEFT_LPWM];
+    int right = (int)plant.pwmDuty[MOTOR_RIGHT_RPWM] - (int)plant.pwmDuty[MOTOR_RIGHT_LPWM];
+    return (left + right) / 2.0 / MOTOR_CRUISE_SPEED * CRUISE_SPEED_CM_S;
+}
+
+void plantAdvanceUs(uint64_t us) {
+    plant.nowUs += us;
+
+    // Stillestående forhindringer kommer nærmere med robottens fart
+    float moved = plantForwardSpeedCmS() * us / 1000000.0;
+    for (int i = 0; i < SONAR_COUNT; i++) {
+        if (plant.sonarApproach[i]) {
+            plant.sonarCm[i] = max(plant.sonarCm[i] - moved, 0.0f);
+        }
+    }
+}
+
+// ============================================================================
+// TID
+// ============================================================================
+
+unsigned long millis() {
+    return (unsigned long)(plant.nowUs / 1000);
+}
+
+unsigned long micros() {
+    return (unsigned long)plant.nowUs;
+}
+
+void delay(unsigned long ms) {
+    plantAdvanceUs((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us) {
+    plantAdvanceUs(us);
+}
+
+void yield() {
+}
+
+// ============================================================================
+// SERIAL
+// ============================================================================
+
+void HarnessSerial::print(const String& text) {
+    if (plant.verbose) {
+        fputs(text.c_str(), stdout);
+    }
+}
+
+void HarnessSerial::println(const String& text) {
+    if (plant.verbose) {
+        puts(text.c_str());
+    }
+}
+
+int HarnessSerial::printf(const char* format, ...) {
+    if (!plant.verbose) {
+        return 0;
+    }
+    va_list args;
+    va_start(args, format);
+    int written = vprintf(format, args);
+    va_end(args);
+    return written;
+}
+
+// ============================================================================
+// PINS
+// ============================================================================
+
+static void recordMotorEvent(MotorEventType type) {
+    MotorEvent event = { type, plant.nowUs };
+    plant.motorEvents.push_back(event);
+}
+
+void pinMode(int, int) {
+}
+
+void digitalWrite(int pin, int value) {
+    if (pin < 0 || pin >= PLANT_PIN_COUNT) {
+        return;
+    }
+    plant.pinLevel[pin] = value;
+
+    // Nødstop = alle driver enable pins LOW
+    bool disabled = true;
+    for (int enablePin : MOTOR_ENABLE_PINS) {
+        disabled = disabled && plant.pinLevel[enablePin] == LOW;
+    }
+    if (disabled && !plant.motorsDisabled) {
+        recordMotorEvent(MOTOR_EVENT_ESTOP);
+    }
+    plant.motorsDisabled = disabled;
+}
+
+int digitalRead(int pin) {
+    return (pin >= 0 && pin < PLANT_PIN_COUNT) ? plant.pinLevel[pin] : LOW;
+}
+
+bool ledcAttach(int, uint32_t, uint8_t) {
+    return true;
+}
+
+void ledcWrite(int pin, uint32_t duty) {
+    if (pin < 0 || pin >= PLANT_PIN_COUNT) {
+        return;
+    }
+    plant.pwmDuty[pin] = duty;
+
+    // Stop = alle fire PWM udgange 0 (setSpeed skriver venstre og højre hver for sig)
+    bool stopped = true;
+    for (int pwmPin : MOTOR_PWM_PINS) {
+        stopped = stopped && plant.pwmDuty[pwmPin] == 0;
+    }
+    if (stopped && !plant.motorsStopped) {
+        recordMotorEvent(MOTOR_EVENT_STOP);
+    }
+    plant.motorsStopped = stopped;
+}
+
+void analogReadResolution(int) {
+}
+
+void analogSetAttenuation(int) {
+}
+
+int analogRead(int pin) {
+    plantAdvanceUs(10);
+
+    if (pin >= 0 && pin < PLANT_PIN_COUNT && plant.adcOverride[pin] >= 0) {
+        return plant.adcOverride[pin];
+    }
+
+    if (pin == BATTERY_PIN) {
+        // Spændingsdeler som Battery::readVoltage() regner baglæns
+        float adcVolts = plant.batteryVolts * BATTERY_R2 / (BATTERY_R1 + BATTERY_R2);
+        return constrain((int)lroundf(adcVolts / BATTERY_ADC_VREF * BATTERY_ADC_MAX), 0, 4095);
+    }
+
+    if (pin == PERIMETER_SIGNAL_PIN) {
+        // Firkant signal omkring midten - fortegnet af middelværdien angiver inde/ude
+        plant.perimeterPhase++;
+        int swing = (plant.perimeterPhase & 1) ? 100 : -100;
+        int level;
+        switch (plant.perimeter) {
+            case SIGNAL_INSIDE:     level = 40 + swing; break;
+            case SIGNAL_OUTSIDE:    level = -40 + swing; break;
+            default:                return 2048;
+        }
+        return constrain(2048 + (int)lroundf(level * plant.perimeterScale), 0, 4095);
+    }
+
+    return 0;
+}
+
+unsigned long pulseIn(int pin, int, unsigned long timeoutUs) {
+    int index;
+    if (pin == SENSOR_LEFT_ECHO) {
+        index = SONAR_LEFT;
+    } else if (pin == SENSOR_MIDDLE_ECHO) {
+        index = SONAR_MIDDLE;
+    } else if (pin == SENSOR_RIGHT_ECHO) {
+        index = SONAR_RIGHT;
+    } else {
+        plantAdvanceUs(timeoutUs);
+        return 0;
+    }
+
+    if (plant.sonarDead[index]) {
+        plantAdvanceUs(timeoutUs);
+        return 0;
+    }
+
+    float cm = plant.sonarCm[index];
+    if (plant.sonarGlitchCm[index] >= 0.0) {
+        cm = plant.sonarGlitchCm[index];
+        plant.sonarGlitchCm[index] = -1.0;
+    }
+
+    // Ekko tid tur/retur ved 0.0343 cm/us - pulseIn blokerer lige så længe
+    unsigned long duration = (unsigned long)(cm * 2.0 / 0.0343);
+    if (duration > timeoutUs) {
+        plantAdvanceUs(timeoutUs);
+        return 0;
+    }
+    plantAdvanceUs(duration);
+    return duration;
+}
+
+// ============================================================================
+// I2C
+// ============================================================================
+
+bool TwoWire::begin(int, int) {
+    return true;
+}
+
+void TwoWire::setClock(uint32_t) {
+}
+
+void TwoWire::beginTransmission(uint8_t addr) {
+    address = addr;
+    txCount = 0;
+}
+
+size_t TwoWire::write(uint8_t data) {
+    if (txCount >= sizeof(txBuffer)) {
+        return 0;
+    }
+    txBuffer[txCount++] = data;
+    return 1;
+}
+
+uint8_t TwoWire::endTransmission(bool) {
+    if (plant.i2cHang) {
+        // SDA holdt lav - driveren venter til timeout
+        plantAdvanceUs((uint64_t)PLANT_I2C_TIMEOUT_MS * 1000);
+        return 5;
+    }
+
+    plantAdvanceUs((uint64_t)(txCount + 1) * PLANT_I2C_BYTE_US);
+
+    // Kun MPU'en svarer - magnetometer adressen giver NACK
+    return address == MPU_ADDRESS ? 0 : 2;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t addr, uint8_t count) {
+    rxCount = 0;
+    rxIndex = 0;
+
+    if (plant.i2cHang) {
+        plantAdvanceUs((uint64_t)PLANT_I2C_TIMEOUT_MS * 1000);
+        return 0;
+    }
+    if (addr != MPU_ADDRESS || txCount == 0 || count > sizeof(rxBuffer)) {
+        return 0;
+    }
+
+    // Register billede: accelerometer fra hældning, temperatur og gyro i ro
+    uint8_t regs[256] = {};
+    regs[MPU_WHO_AM_I] = 0x71;
+    float roll = plant.rollDeg * DEG_TO_RAD;
+    int16_t accel[3] = {
+        0,
+        (int16_t)lroundf(sinf(roll) * ACCEL_LSB_PER_G),
+        (int16_t)lroundf(cosf(roll) * ACCEL_LSB_PER_G)
+    };
+    for (int i = 0; i < 3; i++) {
+        regs[MPU_ACCEL_XOUT_H + i * 2] = (uint8_t)((uint16_t)accel[i] >> 8);
+        regs[MPU_ACCEL_XOUT_H + i * 2 + 1] = (uint8_t)(accel[i] & 0xFF);
+    }
+
+    uint8_t reg = txBuffer[0];
+    for (uint8_t i = 0; i < count; i++) {
+        rxBuffer[i] = regs[(uint8_t)(reg + i)];
+    }
+    rxCount = count;
+
+    plantAdvanceUs((uint64_t)(count + 1) * PLANT_I2C_BYTE_US);
+    return count;
+}
+
+int TwoWire::available() {
+    return rxCount - rxIndex;
+}
+
+int TwoWire::read() {
+    return rxIndex < rxCount ? rxBuffer[rxIndex++] : -1;
+}
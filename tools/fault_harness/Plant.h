@@ -0,0 +1,93 @@
+#ifndef HARNESS_PLANT_H
+#define HARNESS_PLANT_H
+
+#include <Arduino.h>
+#include <vector>
+
+/**
+ * Plant - Simuleret robot bag Arduino shim'et
+ *
+ * Holder det virtuelle ur og de fysiske størrelser driverne måler
+ * (batterispænding, sonar afstande, hældning, perimeter signal) samt
+ * de fejl scenarierne injicerer. Motor pins overvåges, så harness kan
+ * se præcis hvornår motorerne blev stoppet eller nødstoppet.
+ */
+
+enum SonarIndex {
+    SONAR_LEFT,
+    SONAR_MIDDLE,
+    SONAR_RIGHT,
+    SONAR_COUNT
+};
+
+enum PerimeterSignal {
+    SIGNAL_NONE,        // Sender slukket / kabelbrud
+    SIGNAL_INSIDE,      // Inden for kablet
+    SIGNAL_OUTSIDE      // Uden for kablet
+};
+
+enum MotorEventType {
+    MOTOR_EVENT_STOP,   // Alle PWM udgange gik til 0
+    MOTOR_EVENT_ESTOP   // Alle driver enable pins gik LOW (emergencyStop)
+};
+
+struct MotorEvent {
+    MotorEventType type;
+    uint64_t timeUs;
+};
+
+#define PLANT_PIN_COUNT         40
+#define PLANT_PERIMETER_RMS     107.7   // Perimeter RMS ved perimeterScale 1.0 (ADC enheder)
+#define PLANT_I2C_TIMEOUT_MS    50      // ESP32 Wire standard timeout
+#define PLANT_I2C_BYTE_US       25      // Ca. 9 bit ved 400 kHz
+
+struct PlantState {
+    uint64_t nowUs;
+
+    // Batteri
+    float batteryVolts;
+    int adcOverride[PLANT_PIN_COUNT];           // -1 = ingen (ellers rå ADC værdi)
+
+    // Sonar
+    float sonarCm[SONAR_COUNT];
+    bool sonarDead[SONAR_COUNT];                // Intet ekko (timeout)
+    float sonarGlitchCm[SONAR_COUNT];           // Enkelt falsk måling (<0 = ingen)
+    bool sonarApproach[SONAR_COUNT];            // Forhindring står stille - afstanden følger robottens fart
+
+    // IMU
+    bool i2cHang;
+    float rollDeg;
+
+    // Perimeter
+    PerimeterSignal perimeter;
+    float perimeterScale;                       // Signal amplitude (1.0 = PLANT_PERIMETER_RMS)
+    uint32_t perimeterPhase;
+
+    // Pins
+    int pinLevel[PLANT_PIN_COUNT];
+    uint32_t pwmDuty[PLANT_PIN_COUNT];
+    bool motorsStopped;
+    bool motorsDisabled;
+    std::vector<MotorEvent> motorEvents;
+
+    bool verbose;
+};
+
+extern PlantState plant;
+
+/**
+ * Nulstil plant til standard: fuldt batteri, frit foran, vandret, intet signal
+ */
+void plantReset();
+
+/**
+ * Robottens fart fremad ud fra motor PWM (CRUISE_SPEED_CM_S ved MOTOR_CRUISE_SPEED)
+ */
+float plantForwardSpeedCmS();
+
+/**
+ * Flyt det virtuelle ur frem
+ */
+void plantAdvanceUs(uint64_t us);
+
+#endif // HARNESS_PLANT_H
@@ -0,0 +1,537 @@
+/**
+ * Fault harness - afspiller fejl scenarier gennem robottens sikkerhedskode
+ *
+ * De rigtige drivere (Battery, Sensors, IMU, Motors, PerimeterReceiver),
+ * ObstacleAvoidance, StateManager og SafetyMonitor køres mod en simuleret
+ * robot (Plant) på virtuel tid. Loopet nedenfor har samme timere og
+ * rækkefølge som loop() i main.cpp for de sektioner sikkerheden afhænger
+ * af; web, WiFi og black box er erstattet af 'load'/'block' i scenariet.
+ *
+ * Hvert scenarie angiver fejl og forventet reaktion, og harness måler
+ * tiden fra fejlen til reaktionen i virtuelle millisekunder.
+ *
+ * Byg og kør alle scenarier:
+ *     python3 tools/fault_harness/run.py
+ *
+ * Scenarie format (én kommando pr. linje, # er kommentar):
+ *     name <tekst>                Navn i rapporten
+ *     start                       Start klipning (EVENT_START) før t=0
+ *     duration <ms>               Simuleret tid (standard 10000)
+ *     load <ms>                   Ekstra blokering pr. loop (større loop)
+ *     at <ms> [fault] <handling>  Ændring på tidspunkt; 'fault' markerer fejlen
+ *     expect <reaktion> within <ms>
+ *     expect <reaktion> never
+ *     expect avoid between <cm> <cm>  Undvigelse startet med forhindringen i dette interval
+ *
+ * Handlinger:
+ *     battery <V>                         Batterispænding
+ *     adc <battery|perimeter|pin> <raw|off>  Tving rå ADC værdi (mætning)
+ *     sonar <left|middle|right|all> <cm|dead>
+ *     approach <left|middle|right|all> <cm>  Stillestående forhindring - kommer nærmere med robottens fart
+ *     glitch <left|middle|right> <cm>     Én falsk sonar måling
+ *     i2c <hang|ok>                       Hængt I2C bus (timeout pr. transaktion)
+ *     tilt <grader>                       Hældning (roll)
+ *     perimeter <inside|outside|none>     Perimeter signal
+ *     block <ms>                          Ét blokerende kald i loopet
+ *
+ * Reaktioner:
+ *     estop                   motors.emergencyStop() (driver enable pins LOW)
+ *     stop                    Motorerne stoppet (alle PWM 0)
+ *     state <NAVN>            StateManager i tilstand (fx ERROR, SEARCHING_SIGNAL)
+ *     avoid                   MOWING sendte EVENT_OBSTACLE (kun med 'between')
+ */
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+
+#include "Plant.h"
+#include "config/Config.h"
+#include "system/Logger.h"
+#include "system/StateManager.h"
+#include "system/SafetyMonitor.h"
+#include "hardware/Motors.h"
+#include "hardware/Sensors.h"
+#include "hardware/IMU.h"
+#include "hardware/CuttingMechanism.h"
+#include "hardware/Battery.h"
+#include "hardware/PerimeterReceiver.h"
+#include "navigation/ObstacleAvoidance.h"
+#include "utils/Timer.h"
+
+// ============================================================================
+// SCENARIE
+// ============================================================================
+
+struct Action {
+    uint64_t atMs;
+    bool fault;
+    std::vector<std::string> args;
+    int line;
+};
+
+enum ReactionType {
+    REACTION_ESTOP,
+    REACTION_STOP,
+    REACTION_STATE,
+    REACTION_AVOID
+};
+
+struct Expectation {
+    ReactionType type;
+    RobotState state;
+    bool never;
+    uint64_t withinMs;
+    float minCm;
+    float maxCm;
+    std::string text;
+};
+
+struct Scenario {
+    std::string file;
+    std::string name;
+    bool start = false;
+    uint64_t durationMs = 10000;
+    uint64_t loadMs = 0;
+    std::vector<Action> actions;
+    std::vector<Expectation> expectations;
+};
+
+struct StateRecord {
+    RobotState state;
+    uint64_t timeUs;
+};
+
+// ============================================================================
+// ROBOT (samme objekter som main.cpp)
+// ============================================================================
+
+struct Robot {
+    StateManager stateManager;
+    SafetyMonitor safetyMonitor;
+    Motors motors;
+    Sensors sensors;
+    IMU imu;
+    CuttingMechanism cuttingMech;
+    Battery battery;
+    PerimeterReceiver perimeterReceiver;
+    ObstacleAvoidance obstacleAvoid;
+};
+
+static Robot* robot = nullptr;
+
+// Første undvigelse: tid og nærmeste forhindring (plant sandhed)
+static bool avoidSeen = false;
+static uint64_t avoidUs = 0;
+static float avoidCm = 0.0;
+
+// Hooks svarende til main.cpp: klipning driver motorerne, fejl nødstopper
+static void enterErrorState() {
+    robot->safetyMonitor.emergencyStop();
+}
+
+static void handleMowingState() {
+    robot->obstacleAvoid.update(&robot->sensors);
+    if (robot->obstacleAvoid.hasObstacle()) {
+        if (!avoidSeen) {
+            avoidSeen = true;
+            avoidUs = plant.nowUs;
+            avoidCm = min(min(plant.sonarCm[SONAR_LEFT], plant.sonarCm[SONAR_MIDDLE]),
+                          plant.sonarCm[SONAR_RIGHT]);
+        }
+        robot->stateManager.dispatch(EVENT_OBSTACLE);
+        return;
+    }
+
+    // Fart fra ObstacleAvoidance - Movement holder mindst MOTOR_MIN_SPEED
+    int speed = robot->obstacleAvoid.getRecommendedSpeed(MOTOR_CRUISE_SPEED);
+    robot->motors.forward(max(speed, MOTOR_MIN_SPEED));
+}
+
+// ============================================================================
+// PARSER
+// ============================================================================
+
+static bool parseFail(const Scenario& scenario, int line, const std::string& message) {
+    fprintf(stderr, "%s:%d: %s\n", scenario.file.c_str(), line, message.c_str());
+    return false;
+}
+
+static bool stateFromName(const std::string& name, RobotState& state) {
+    StateManager names;
+    for (int i = 0; i < STATE_COUNT; i++) {
+        if (name == names.getStateName((RobotState)i).c_str()) {
+            state = (RobotState)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool loadScenario(const char* path, Scenario& scenario) {
+    std::ifstream in(path);
+    if (!in) {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return false;
+    }
+
+    scenario.file = path;
+    scenario.name = path;
+
+    std::string text;
+    int line = 0;
+    while (std::getline(in, text)) {
+        line++;
+        size_t hash = text.find('#');
+        if (hash != std::string::npos) {
+            text.erase(hash);
+        }
+
+        std::istringstream words(text);
+        std::vector<std::string> args;
+        std::string word;
+        while (words >> word) {
+            args.push_back(word);
+        }
+        if (args.empty()) {
+            continue;
+        }
+
+        const std::string& cmd = args[0];
+        if (cmd == "name" && args.size() >= 2) {
+            scenario.name = text.substr(text.find(args[1]));
+            while (!scenario.name.empty() && isspace((unsigned char)scenario.name.back())) {
+                scenario.name.pop_back();
+            }
+        } else if (cmd == "start") {
+            scenario.start = true;
+        } else if (cmd == "duration" && args.size() == 2) {
+            scenario.durationMs = strtoull(args[1].c_str(), nullptr, 10);
+        } else if (cmd == "load" && args.size() == 2) {
+            scenario.loadMs = strtoull(args[1].c_str(), nullptr, 10);
+        } else if (cmd == "at" && args.size() >= 3) {
+            Action action;
+            action.atMs = strtoull(args[1].c_str(), nullptr, 10);
+            action.fault = args[2] == "fault";
+            action.args.assign(args.begin() + (action.fault ? 3 : 2), args.end());
+            action.line = line;
+            if (action.args.empty()) {
+                return parseFail(scenario, line, "missing action");
+            }
+            scenario.actions.push_back(action);
+        } else if (cmd == "expect" && args.size() >= 3) {
+            Expectation expect;
+            size_t next = 2;
+            if (args[1] == "estop") {
+                expect.type = REACTION_ESTOP;
+            } else if (args[1] == "stop") {
+                expect.type = REACTION_STOP;
+            } else if (args[1] == "avoid" && args.size() == 5 && args[2] == "between") {
+                expect.type = REACTION_AVOID;
+                expect.never = false;
+                expect.withinMs = 0;
+                expect.minCm = atof(args[3].c_str());
+                expect.maxCm = atof(args[4].c_str());
+                expect.text = "avoid";
+                scenario.expectations.push_back(expect);
+                continue;
+            } else if (args[1] == "state" && args.size() >= 4) {
+                expect.type = REACTION_STATE;
+                if (!stateFromName(args[2], expect.state)) {
+                    return parseFail(scenario, line, "unknown state " + args[2]);
+                }
+                next = 3;
+            } else {
+                return parseFail(scenario, line, "unknown reaction " + args[1]);
+            }
+
+            if (args[next] == "never" && args.size() == next + 1) {
+                expect.never = true;
+                expect.withinMs = 0;
+            } else if (args[next] == "within" && args.size() == next + 2) {
+                expect.never = false;
+                expect.withinMs = strtoull(args[next + 1].c_str(), nullptr, 10);
+            } else {
+                return parseFail(scenario, line, "expected 'within <ms>' or 'never'");
+            }
+
+            expect.text.clear();
+            for (size_t i = 1; i < next; i++) {
+                expect.text += (i > 1 ? " " : "") + args[i];
+            }
+            scenario.expectations.push_back(expect);
+        } else {
+            return parseFail(scenario, line, "unknown command '" + cmd + "'");
+        }
+    }
+
+    if (scenario.expectations.empty()) {
+        return parseFail(scenario, line, "no expectations");
+    }
+    return true;
+}
+
+// ============================================================================
+// HANDLINGER
+// ============================================================================
+
+static bool sonarIndex(const std::string& name, int& first, int& last) {
+    if (name == "left")   { first = last = SONAR_LEFT;   return true; }
+    if (name == "middle") { first = last = SONAR_MIDDLE; return true; }
+    if (name == "right")  { first = last = SONAR_RIGHT;  return true; }
+    if (name == "all")    { first = SONAR_LEFT; last = SONAR_RIGHT; return true; }
+    return false;
+}
+
+static bool applyAction(const Scenario& scenario, const Action& action) {
+    const std::vector<std::string>& a = action.args;
+    const std::string& what = a[0];
+    int first, last;
+
+    if (what == "battery" && a.size() == 2) {
+        plant.batteryVolts = atof(a[1].c_str());
+    } else if (what == "adc" && a.size() == 3) {
+        int pin = a[1] == "battery" ? BATTERY_PIN
+                : a[1] == "perimeter" ? PERIMETER_SIGNAL_PIN
+                : atoi(a[1].c_str());
+        if (pin < 0 || pin >= PLANT_PIN_COUNT) {
+            return parseFail(scenario, action.line, "bad pin");
+        }
+        plant.adcOverride[pin] = a[2] == "off" ? -1 : constrain(atoi(a[2].c_str()), 0, 4095);
+    } else if (what == "sonar" && a.size() == 3 && sonarIndex(a[1], first, last)) {
+        for (int i = first; i <= last; i++) {
+            plant.sonarDead[i] = a[2] == "dead";
+            if (!plant.sonarDead[i]) {
+                plant.sonarCm[i] = atof(a[2].c_str());
+            }
+        }
+    } else if (what == "approach" && a.size() == 3 && sonarIndex(a[1], first, last)) {
+        for (int i = first; i <= last; i++) {
+            plant.sonarDead[i] = false;
+            plant.sonarCm[i] = atof(a[2].c_str());
+            plant.sonarApproach[i] = true;
+        }
+    } else if (what == "glitch" && a.size() == 3 && sonarIndex(a[1], first, last) && first == last) {
+        plant.sonarGlitchCm[first] = atof(a[2].c_str());
+    } else if (what == "i2c" && a.size() == 2 && (a[1] == "hang" || a[1] == "ok")) {
+        plant.i2cHang = a[1] == "hang";
+    } else if (what == "tilt" && a.size() == 2) {
+        plant.rollDeg = atof(a[1].c_str());
+    } else if (what == "perimeter" && a.size() == 2) {
+        if (a[1] == "inside") {
+            plant.perimeter = SIGNAL_INSIDE;
+        } else if (a[1] == "outside") {
+            plant.perimeter = SIGNAL_OUTSIDE;
+        } else if (a[1] == "none") {
+            plant.perimeter = SIGNAL_NONE;
+        } else {
+            return parseFail(scenario, action.line, "perimeter must be inside, outside or none");
+        }
+    } else if (what == "block" && a.size() == 2) {
+        delay(strtoul(a[1].c_str(), nullptr, 10));
+    } else {
+        return parseFail(scenario, action.line, "bad action '" + what + "'");
+    }
+    return true;
+}
+
+// ============================================================================
+// KØRSEL
+// ============================================================================
+
+static bool runScenario(const Scenario& scenario) {
+    plantReset();
+
+    Robot rig;
+    robot = &rig;
+    avoidSeen = false;
+
+    // Opstart som setup() i main.cpp
+    rig.stateManager.begin();
+    rig.stateManager.setStateHooks(STATE_MOWING, nullptr, handleMowingState, nullptr);
+    rig.stateManager.setStateHooks(STATE_ERROR, enterErrorState, nullptr, nullptr);
+
+    rig.safetyMonitor.begin(&rig.stateManager, &rig.motors, &rig.cuttingMech);
+    rig.safetyMonitor.setBattery(&rig.battery);
+    rig.safetyMonitor.setIMU(&rig.imu);
+    rig.safetyMonitor.setObstacleAvoidance(&rig.obstacleAvoid, &rig.sensors);
+    #if ENABLE_PERIMETER
+    rig.safetyMonitor.setPerimeterReceiver(&rig.perimeterReceiver);
+    #endif
+
+    rig.motors.begin();
+    rig.sensors.begin();
+    rig.imu.begin();
+    rig.cuttingMech.begin();
+    rig.battery.setMotors(&rig.motors);
+    rig.battery.begin();
+    rig.perimeterReceiver.begin();
+    rig.obstacleAvoid.begin();
+
+    // Timere som main.cpp
+    Timer sensorUpdateTimer(SENSOR_UPDATE_INTERVAL, true);
+    Timer imuUpdateTimer(IMU_UPDATE_INTERVAL, true);
+    Timer batteryCheckTimer(BATTERY_CHECK_INTERVAL, true);
+    Timer perimeterUpdateTimer(50, true);
+
+    if (scenario.start) {
+        rig.stateManager.dispatch(EVENT_START);
+    }
+
+    uint64_t startUs = plant.nowUs;
+    uint64_t faultUs = startUs;
+    uint64_t endUs = startUs + scenario.durationMs * 1000;
+    size_t nextAction = 0;
+
+    std::vector<StateRecord> states;
+    states.push_back({ rig.stateManager.getState(), startUs });
+    size_t firstMotorEvent = plant.motorEvents.size();
+
+    while (plant.nowUs < endUs) {
+        // Handlinger der er forfaldne
+        while (nextAction < scenario.actions.size() &&
+               startUs + scenario.actions[nextAction].atMs * 1000 <= plant.nowUs) {
+            const Action& action = scenario.actions[nextAction++];
+            if (action.fault) {
+                faultUs = plant.nowUs;
+            }
+            if (!applyAction(scenario, action)) {
+                return false;
+            }
+        }
+
+        // Samme sektioner og rækkefølge som loop()
+        if (sensorUpdateTimer.isExpired()) {
+            rig.sensors.update();
+            sensorUpdateTimer.reset();
+        }
+
+        if (imuUpdateTimer.isExpired()) {
+            bool readOk = rig.imu.update();
+            rig.safetyMonitor.checkIMU(readOk);
+            imuUpdateTimer.reset();
+        }
+
+        if (batteryCheckTimer.isExpired()) {
+            rig.battery.update();
+            rig.safetyMonitor.checkBattery();
+            batteryCheckTimer.reset();
+        }
+
+        #if ENABLE_PERIMETER
+        if (perimeterUpdateTimer.isExpired()) {
+            rig.perimeterReceiver.update();
+            perimeterUpdateTimer.reset();
+        }
+        #endif
+
+        rig.stateManager.update();
+        rig.stateManager.tick();
+
+        // Web, WiFi, black box m.m.
+        delay(scenario.loadMs);
+
+        rig.safetyMonitor.check();
+
+        delay(1);
+
+        if (rig.stateManager.getState() != states.back().state) {
+            states.push_back({ rig.stateManager.getState(), plant.nowUs });
+        }
+    }
+
+    // Evaluer forventninger fra fejl tidspunktet
+    bool pass = true;
+    printf("%s\n", scenario.name.c_str());
+
+    for (const Expectation& expect : scenario.expectations) {
+        bool seen = false;
+        uint64_t seenUs = 0;
+
+        if (expect.type == REACTION_STATE) {
+            for (const StateRecord& record : states) {
+                if (record.timeUs >= faultUs && record.state == expect.state) {
+                    seen = true;
+                    seenUs = record.timeUs;
+                    break;
+                }
+            }
+        } else {
+            MotorEventType type = expect.type == REACTION_ESTOP ? MOTOR_EVENT_ESTOP : MOTOR_EVENT_STOP;
+            for (size_t i = firstMotorEvent; i < plant.motorEvents.size(); i++) {
+                const MotorEvent& event = plant.motorEvents[i];
+                if (event.timeUs >= faultUs && event.type == type) {
+                    seen = true;
+                    seenUs = event.timeUs;
+                    break;
+                }
+            }
+        }
+
+        bool ok;
+        char result[64];
+        if (expect.type == REACTION_AVOID) {
+            ok = avoidSeen && avoidUs >= faultUs && avoidCm >= expect.minCm && avoidCm <= expect.maxCm;
+            if (avoidSeen) {
+                snprintf(result, sizeof(result), "at %.1f cm (bound %.0f-%.0f cm)",
+                         avoidCm, expect.minCm, expect.maxCm);
+            } else {
+                snprintf(result, sizeof(result), "not seen (bound %.0f-%.0f cm)",
+                         expect.minCm, expect.maxCm);
+            }
+        } else if (expect.never) {
+            ok = !seen;
+            if (seen) {
+                snprintf(result, sizeof(result), "after %llu ms (expected never)",
+                         (unsigned long long)((seenUs - faultUs) / 1000));
+            } else {
+                snprintf(result, sizeof(result), "never");
+            }
+        } else if (seen) {
+            uint64_t latencyMs = (seenUs - faultUs) / 1000;
+            ok = latencyMs <= expect.withinMs;
+            snprintf(result, sizeof(result), "after %llu ms (bound %llu ms)",
+                     (unsigned long long)latencyMs, (unsigned long long)expect.withinMs);
+        } else {
+            ok = false;
+            snprintf(result, sizeof(result), "not seen (bound %llu ms)",
+                     (unsigned long long)expect.withinMs);
+        }
+
+        printf("  %s  %-24s %s\n", ok ? "PASS" : "FAIL", expect.text.c_str(), result);
+        pass = pass && ok;
+    }
+
+    robot = nullptr;
+    return pass;
+}
+
+int main(int argc, char** argv) {
+    std::vector<const char*> files;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-v") == 0) {
+            plant.verbose = true;
+        } else {
+            files.push_back(argv[i]);
+        }
+    }
+
+    if (files.empty()) {
+        fprintf(stderr, "usage: %s [-v] scenario...\n", argv[0]);
+        return 2;
+    }
+
+    Logger::begin();
+
+    int failed = 0;
+    for (const char* file : files) {
+        Scenario scenario;
+        if (!loadScenario(file, scenario) || !runScenario(scenario)) {
+            failed++;
+        }
+    }
+
+    printf("\n%d of %d scenarios passed\n", (int)files.size() - failed, (int)files.size());
+    return failed == 0 ? 0 : 1;
+}
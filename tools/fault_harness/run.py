@@ -0,0 +1,84 @@
+#!/usr/bin/env python3
+"""
+Fault harness - bygger og kører sikkerheds scenarierne på host
+
+Oversætter de rigtige drivere, StateManager og SafetyMonitor sammen med
+Arduino shim'et i tools/fault_harness/shim og afspiller scenarierne i
+tools/fault_harness/scenarios på virtuel tid. Se harness.cpp for formatet.
+
+Kør alle scenarier:
+    python3 tools/fault_harness/run.py
+
+Kør udvalgte scenarier med Serial/Logger output:
+    python3 tools/fault_harness/run.py -v tools/fault_harness/scenarios/brownout.scn
+
+Kræver en C++17 compiler (g++ eller clang++, vælges med CXX).
+"""
+
+import glob
+import os
+import subprocess
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+ROOT = os.path.normpath(os.path.join(HERE, "..", ".."))
+SRC = os.path.join(ROOT, "src")
+BUILD = os.path.join(HERE, ".build")
+
+SOURCES = [
+    os.path.join(HERE, "harness.cpp"),
+    os.path.join(HERE, "Plant.cpp"),
+    os.path.join(HERE, "BlackBoxStub.cpp"),
+    # Koden der testes - uændret fra firmwaren
+    os.path.join(SRC, "system", "SafetyMonitor.cpp"),
+    os.path.join(SRC, "system", "StateManager.cpp"),
+    os.path.join(SRC, "system", "Logger.cpp"),
+    os.path.join(SRC, "hardware", "Motors.cpp"),
+    os.path.join(SRC, "hardware", "Sensors.cpp"),
+    os.path.join(SRC, "hardware", "IMU.cpp"),
+    os.path.join(SRC, "hardware", "CuttingMechanism.cpp"),
+    os.path.join(SRC, "hardware", "Battery.cpp"),
+    os.path.join(SRC, "hardware", "PerimeterReceiver.cpp"),
+    os.path.join(SRC, "navigation", "ObstacleAvoidance.cpp"),
+    os.path.join(SRC, "utils", "RangeFilter.cpp"),
+    os.path.join(SRC, "utils", "Math.cpp"),
+    os.path.join(SRC, "utils", "Timer.cpp"),
+]
+
+
+def build():
+    os.makedirs(BUILD, exist_ok=True)
+    binary = os.path.join(BUILD, "fault_harness")
+
+    # Byg kun igen hvis en kilde er nyere end binæren
+    inputs = SOURCES + glob.glob(os.path.join(HERE, "shim", "*.h")) + [os.path.join(HERE, "Plant.h")]
+    inputs += glob.glob(os.path.join(SRC, "**", "*.h"), recursive=True)
+    if os.path.exists(binary):
+        built = os.path.getmtime(binary)
+        if all(os.path.getmtime(path) <= built for path in inputs):
+            return binary
+
+    cxx = os.environ.get("CXX", "g++")
+    cmd = [cxx, "-std=gnu++17", "-O1", "-Wall", "-Wno-unused-variable",
+           "-I", os.path.join(HERE, "shim"), "-I", HERE, "-I", SRC,
+           "-o", binary] + SOURCES + ["-lm"]
+    print("Building fault harness...", file=sys.stderr)
+    result = subprocess.run(cmd)
+    if result.returncode != 0:
+        sys.exit(result.returncode)
+    return binary
+
+
+def main():
+    args = sys.argv[1:]
+    flags = [a for a in args if a.startswith("-")]
+    scenarios = [a for a in args if not a.startswith("-")]
+    if not scenarios:
+        scenarios = sorted(glob.glob(os.path.join(HERE, "scenarios", "*.scn")))
+
+    binary = build()
+    sys.exit(subprocess.run([binary] + flags + scenarios).returncode)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,136 @@
+#ifndef HARNESS_ARDUINO_H
+#define HARNESS_ARDUINO_H
+
+/**
+ * Host udgave af Arduino API'et til fault harness
+ *
+ * Kun det de simulerede drivere bruger. Tid er virtuel: millis()/micros()
+ * læser simulatorens ur, og delay(), pulseIn() og I2C timeouts flytter
+ * det frem - så blokerende kode koster lige så meget tid som på robotten.
+ * Pin I/O går til Plant (se Plant.h).
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stdarg.h>
+#include <math.h>
+#include <string>
+#include <algorithm>
+
+using std::min;
+using std::max;
+using std::abs;
+
+typedef uint8_t byte;
+
+#define HIGH                1
+#define LOW                 0
+#define INPUT               0
+#define OUTPUT              1
+#define ADC_11db            3
+
+#ifndef PI
+#define PI                  3.1415926535897932384626433832795
+#endif
+#define DEG_TO_RAD          0.017453292519943295769236907684886
+#define RAD_TO_DEG          57.295779513082320876798154814105
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+inline long map(long x, long inMin, long inMax, long outMin, long outMax) {
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+// ============================================================================
+// String (tynd wrapper om std::string)
+// ============================================================================
+
+class String {
+public:
+    String() {}
+    String(const char* text) : value(text ? text : "") {}
+    String(const std::string& text) : value(text) {}
+    String(char c) : value(1, c) {}
+    String(int v) : value(std::to_string(v)) {}
+    String(unsigned int v) : value(std::to_string(v)) {}
+    String(long v) : value(std::to_string(v)) {}
+    String(unsigned long v) : value(std::to_string(v)) {}
+    String(float v, int decimals = 2) { format(v, decimals); }
+    String(double v, int decimals = 2) { format(v, decimals); }
+
+    const char* c_str() const { return value.c_str(); }
+    unsigned int length() const { return value.size(); }
+    bool equalsIgnoreCase(const String& other) const {
+        return strcasecmp(value.c_str(), other.value.c_str()) == 0;
+    }
+
+    String& operator+=(const String& other) { value += other.value; return *this; }
+    String& operator+=(const char* other) { value += other; return *this; }
+    String& operator+=(char c) { value += c; return *this; }
+    bool operator==(const String& other) const { return value == other.value; }
+    bool operator!=(const String& other) const { return value != other.value; }
+
+    friend String operator+(const String& a, const String& b) { return String(a.value + b.value); }
+    friend String operator+(const String& a, const char* b) { return String(a.value + b); }
+    friend String operator+(const char* a, const String& b) { return String(std::string(a) + b.value); }
+
+private:
+    void format(double v, int decimals) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%.*f", decimals, v);
+        value = buf;
+    }
+
+    std::string value;
+};
+
+// ============================================================================
+// Serial (skrives kun ud med -v)
+// ============================================================================
+
+class HarnessSerial {
+public:
+    void begin(unsigned long) {}
+    void print(const String& text);
+    void println(const String& text = String());
+    int printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+extern HarnessSerial Serial;
+
+// ============================================================================
+// Tid og pins (implementeret i Plant.cpp)
+// ============================================================================
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+void pinMode(int pin, int mode);
+void digitalWrite(int pin, int value);
+int digitalRead(int pin);
+int analogRead(int pin);
+void analogReadResolution(int bits);
+void analogSetAttenuation(int attenuation);
+unsigned long pulseIn(int pin, int state, unsigned long timeoutUs);
+bool ledcAttach(int pin, uint32_t frequency, uint8_t resolution);
+void ledcWrite(int pin, uint32_t duty);
+
+// ============================================================================
+// FreeRTOS - ét loop, ingen tasks
+// ============================================================================
+
+typedef int portMUX_TYPE;
+typedef void* TaskHandle_t;
+typedef int BaseType_t;
+#define portMUX_INITIALIZER_UNLOCKED    0
+#define portENTER_CRITICAL(mux)         ((void)(mux))
+#define portEXIT_CRITICAL(mux)          ((void)(mux))
+
+#endif // HARNESS_ARDUINO_H
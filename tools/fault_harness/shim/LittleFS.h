@@ -0,0 +1,14 @@
+#ifndef HARNESS_LITTLEFS_H
+#define HARNESS_LITTLEFS_H
+
+#include <Arduino.h>
+
+/**
+ * Kun typen File, så BlackBox.h kan inkluderes (black box kører ikke i harness)
+ */
+class File {
+public:
+    operator bool() const { return false; }
+};
+
+#endif // HARNESS_LITTLEFS_H
@@ -0,0 +1,19 @@
+#ifndef HARNESS_PREFERENCES_H
+#define HARNESS_PREFERENCES_H
+
+#include <Arduino.h>
+
+/**
+ * Host udgave af Preferences - tom NVS (ingen gemt kalibrering)
+ */
+class Preferences {
+public:
+    bool begin(const char*, bool = false) { return false; }
+    void end() {}
+    size_t putFloat(const char*, float) { return 0; }
+    float getFloat(const char*, float fallback = 0) { return fallback; }
+    size_t putBool(const char*, bool) { return 0; }
+    bool getBool(const char*, bool fallback = false) { return fallback; }
+};
+
+#endif // HARNESS_PREFERENCES_H
@@ -0,0 +1,32 @@
+#ifndef HARNESS_WIRE_H
+#define HARNESS_WIRE_H
+
+#include <Arduino.h>
+
+/**
+ * Host udgave af TwoWire - transaktioner går til Plants simulerede
+ * MPU-9250 (uden magnetometer). Hængt bus koster I2C timeout i virtuel tid.
+ */
+class TwoWire {
+public:
+    bool begin(int sda = -1, int scl = -1);
+    void setClock(uint32_t frequency);
+    void beginTransmission(uint8_t address);
+    size_t write(uint8_t data);
+    uint8_t endTransmission(bool sendStop = true);
+    uint8_t requestFrom(uint8_t address, uint8_t count);
+    int available();
+    int read();
+
+private:
+    uint8_t address = 0;
+    uint8_t txBuffer[16] = {};
+    uint8_t txCount = 0;
+    uint8_t rxBuffer[32] = {};
+    uint8_t rxCount = 0;
+    uint8_t rxIndex = 0;
+};
+
+extern TwoWire Wire;
+
+#endif // HARNESS_WIRE_H
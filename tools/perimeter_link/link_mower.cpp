@@ -0,0 +1,158 @@
+/**
+ * Host mower - simulerer robottens side af perimeter UDP kanalen på loopback
+ *
+ * Samme logik som PerimeterClient::pollUdp/sendUdpCommand: venter på
+ * heartbeat, sender START med gensendelse indtil ack, og måler hvor
+ * hurtigt et kabelbrud og et tabt link opdages.
+ *
+ * Brug: link_mower --break-ms N [--max-detect-ms N]
+ * Exit code 0 hvis alle tjek bestås.
+ */
+
+#include <arpa/inet.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "PerimeterProtocol.h"
+
+// Fra src/config/Config.h
+#define PERIMETER_HEARTBEAT_TIMEOUT 1000
+#define PERIMETER_UDP_RETRY_MS      200
+#define PERIMETER_UDP_RETRIES       3
+
+static unsigned long nowMs() {
+    using namespace std::chrono;
+    static const steady_clock::time_point start = steady_clock::now();
+    return (unsigned long)duration_cast<milliseconds>(steady_clock::now() - start).count();
+}
+
+enum Step {
+    STEP_WAIT_HEARTBEAT,
+    STEP_WAIT_ACK,
+    STEP_WAIT_BREAK,
+    STEP_WAIT_LINK_LOST,
+    STEP_DONE
+};
+
+int main(int argc, char** argv) {
+    long breakMs = 1500;
+    long maxDetectMs = 1500;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--break-ms") && i + 1 < argc) breakMs = atol(argv[++i]);
+        else if (!strcmp(argv[i], "--max-detect-ms") && i + 1 < argc) maxDetectMs = atol(argv[++i]);
+    }
+
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in local = {};
+    local.sin_family = AF_INET;
+    local.sin_port = htons(PERIMETER_UDP_MOWER_PORT);
+    local.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (sock < 0 || bind(sock, (sockaddr*)&local, sizeof(local)) < 0) {
+        perror("[mower] bind");
+        return 2;
+    }
+
+    sockaddr_in sender = {};
+    sender.sin_family = AF_INET;
+    sender.sin_port = htons(PERIMETER_UDP_SENDER_PORT);
+    sender.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    Step step = STEP_WAIT_HEARTBEAT;
+    bool ok = true;
+    unsigned long stepStart = nowMs();
+    unsigned long lastHeartbeat = 0;
+    uint16_t heartbeatSequence = 0;
+    uint32_t heartbeats = 0;
+    uint32_t outOfOrder = 0;
+
+    uint16_t commandSequence = 1;
+    int attempts = 0;
+    unsigned long firstSent = 0;
+    unsigned long lastSent = 0;
+
+    auto sendStart = [&](unsigned long now) {
+        PerimeterCommandPacket packet;
+        perimeterInitHeader(packet.header, PERIMETER_PKT_COMMAND, commandSequence);
+        packet.command = PERIMETER_LINK_START;
+        sendto(sock, &packet, sizeof(packet), 0, (sockaddr*)&sender, sizeof(sender));
+        attempts++;
+        lastSent = now;
+    };
+
+    while (step != STEP_DONE) {
+        pollfd pfd = { sock, POLLIN, 0 };
+        poll(&pfd, 1, 5);
+        unsigned long now = nowMs();
+
+        uint8_t buffer[64];
+        ssize_t length = recv(sock, buffer, sizeof(buffer), MSG_DONTWAIT);
+        uint8_t type = length > 0 ? perimeterPacketType(buffer, length) : 0;
+
+        if (type == PERIMETER_PKT_HEARTBEAT) {
+            PerimeterHeartbeat heartbeat;
+            memcpy(&heartbeat, buffer, sizeof(heartbeat));
+            if (heartbeats > 0 && !perimeterSequenceNewer(heartbeat.header.sequence, heartbeatSequence)) {
+                outOfOrder++;
+            } else {
+                heartbeatSequence = heartbeat.header.sequence;
+                heartbeats++;
+                lastHeartbeat = now;
+
+                if (step == STEP_WAIT_HEARTBEAT) {
+                    printf("[mower] %lu ms: link up (state %d)\n", now, heartbeat.state);
+                    step = STEP_WAIT_ACK;
+                    firstSent = now;
+                    sendStart(now);
+                } else if (step == STEP_WAIT_BREAK && heartbeat.error == PERIMETER_LINK_ERR_WIRE_BREAK) {
+                    // Senderen startede ved første forsøg, også selvom ack gik tabt
+                    long detect = (long)(now - firstSent) - breakMs;
+                    printf("[mower] %lu ms: wire break reported after %ld ms (max %ld, current %u mA)\n",
+                           now, detect, maxDetectMs, heartbeat.currentMA);
+                    if (detect > maxDetectMs) ok = false;
+                    step = STEP_WAIT_LINK_LOST;
+                    stepStart = now;
+                }
+            }
+        } else if (type == PERIMETER_PKT_ACK && step == STEP_WAIT_ACK) {
+            PerimeterAckPacket ack;
+            memcpy(&ack, buffer, sizeof(ack));
+            if (ack.ackSequence == commandSequence) {
+                printf("[mower] %lu ms: START acked after %lu ms, %d attempt(s), state %d\n",
+                       now, now - firstSent, attempts, ack.state);
+                if (ack.error != PERIMETER_LINK_OK || ack.state != PERIMETER_LINK_RUNNING) ok = false;
+                step = STEP_WAIT_BREAK;
+                stepStart = now;
+            }
+        }
+
+        // Gensendelse som PerimeterClient - derefter ville HTTP overtage
+        if (step == STEP_WAIT_ACK && now - lastSent >= PERIMETER_UDP_RETRY_MS) {
+            if (attempts >= PERIMETER_UDP_RETRIES) {
+                printf("[mower] FAIL: no ack after %d attempts\n", attempts);
+                return 1;
+            }
+            sendStart(now);
+        }
+
+        if (step == STEP_WAIT_LINK_LOST && lastHeartbeat != 0 && now - lastHeartbeat > PERIMETER_HEARTBEAT_TIMEOUT) {
+            printf("[mower] %lu ms: link lost (no heartbeat for %d ms)\n", now, PERIMETER_HEARTBEAT_TIMEOUT);
+            step = STEP_DONE;
+        }
+
+        // Overordnet timeout pr. trin
+        long limit = step == STEP_WAIT_BREAK ? breakMs + maxDetectMs + 2000 : 10000;
+        if (step != STEP_DONE && (long)(now - stepStart) > limit) {
+            printf("[mower] FAIL: timeout in step %d\n", step);
+            return 1;
+        }
+    }
+
+    printf("[mower] heartbeats: %u, out of order: %u\n", heartbeats, outOfOrder);
+    close(sock);
+    return ok ? 0 : 1;
+}
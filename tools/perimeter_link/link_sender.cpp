@@ -0,0 +1,201 @@
+/**
+ * Host sender - simulerer perimeter senderens UDP kanal på loopback
+ *
+ * Samme logik som perimeterwire_sender/src/web/UdpLink.cpp: heartbeat hvert
+ * HEARTBEAT_INTERVAL ms og ved tilstands-/fejlskift, kommandoer kvitteres
+ * med ack og gensendelser udføres ikke igen. Kabel status evalueres pr.
+ * kode cyklus og skifter efter WIRE_FAULT_CYCLES ens cyklusser som i
+ * SignalGenerator::evaluateCycle, så kabelbrud meldes med samme
+ * forsinkelse som på hardwaren.
+ *
+ * Brug: link_sender [--break-ms N] [--duration-ms N] [--drop-first-ack]
+ */
+
+#include <arpa/inet.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "PerimeterProtocol.h"
+
+// Fra perimeterwire_sender/src/config/Config.h
+#define HEARTBEAT_INTERVAL      200
+#define WIRE_BREAK_CURRENT_MA   10
+#define WIRE_FAULT_CYCLES       3
+
+static const unsigned long CYCLE_MS = 50;       // Kode cyklus inkl. loop delay(1) pr. halvperiode
+static const float WIRE_CURRENT_MA = 600.0f;    // Simuleret kabelstrøm (amplitude)
+
+static unsigned long nowMs() {
+    using namespace std::chrono;
+    static const steady_clock::time_point start = steady_clock::now();
+    return (unsigned long)duration_cast<milliseconds>(steady_clock::now() - start).count();
+}
+
+struct SimSender {
+    uint8_t state = PERIMETER_LINK_OFF;
+    unsigned long startedAt = 0;
+    unsigned long cycleCount = 0;
+    unsigned long lastCycle = 0;
+    float amplitudeMA = 0;
+    bool wireOpen = false;
+    bool pendingOpen = false;
+    int pendingCycles = 0;
+
+    bool running() const { return state == PERIMETER_LINK_RUNNING; }
+    unsigned long runtime(unsigned long now) const { return running() ? now - startedAt : 0; }
+
+    void start(unsigned long now) {
+        state = PERIMETER_LINK_RUNNING;
+        startedAt = now;
+        lastCycle = now;
+        cycleCount = 0;
+        wireOpen = false;
+        pendingOpen = false;
+        pendingCycles = 0;
+    }
+
+    void update(unsigned long now, bool wireBroken) {
+        if (!running() || now - lastCycle < CYCLE_MS) return;
+        lastCycle = now;
+        cycleCount++;
+
+        amplitudeMA = wireBroken ? 0.0f : WIRE_CURRENT_MA;
+        bool open = amplitudeMA < WIRE_BREAK_CURRENT_MA;
+        if (open != pendingOpen) {
+            pendingOpen = open;
+            pendingCycles = 0;
+        }
+        if (++pendingCycles >= WIRE_FAULT_CYCLES) {
+            wireOpen = pendingOpen;
+        }
+    }
+
+    uint8_t linkError() const {
+        if (state == PERIMETER_LINK_OVERCURRENT) return PERIMETER_LINK_ERR_OVERCURRENT;
+        if (running() && wireOpen) return PERIMETER_LINK_ERR_WIRE_BREAK;
+        return PERIMETER_LINK_OK;
+    }
+};
+
+int main(int argc, char** argv) {
+    long breakMs = -1;          // Kabelbrud N ms efter start (-1 = aldrig)
+    long durationMs = 5000;
+    bool dropFirstAck = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--break-ms") && i + 1 < argc) breakMs = atol(argv[++i]);
+        else if (!strcmp(argv[i], "--duration-ms") && i + 1 < argc) durationMs = atol(argv[++i]);
+        else if (!strcmp(argv[i], "--drop-first-ack")) dropFirstAck = true;
+    }
+
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in local = {};
+    local.sin_family = AF_INET;
+    local.sin_port = htons(PERIMETER_UDP_SENDER_PORT);
+    local.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (sock < 0 || bind(sock, (sockaddr*)&local, sizeof(local)) < 0) {
+        perror("[sender] bind");
+        return 2;
+    }
+
+    // På loopback sendes heartbeat direkte i stedet for broadcast
+    sockaddr_in mower = {};
+    mower.sin_family = AF_INET;
+    mower.sin_port = htons(PERIMETER_UDP_MOWER_PORT);
+    mower.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    SimSender sim;
+    uint16_t sequence = 0;
+    unsigned long lastHeartbeat = 0;
+    uint8_t lastState = 0xFF;
+    uint8_t lastError = 0xFF;
+    int executed = 0;
+    bool ackDropped = false;
+
+    bool hasLastCommand = false;
+    uint16_t lastCommandSequence = 0;
+    PerimeterAckPacket lastAck = {};
+
+    while ((long)nowMs() < durationMs) {
+        pollfd pfd = { sock, POLLIN, 0 };
+        poll(&pfd, 1, 5);
+        unsigned long now = nowMs();
+
+        uint8_t buffer[64];
+        sockaddr_in remote = {};
+        socklen_t remoteLength = sizeof(remote);
+        ssize_t length = recvfrom(sock, buffer, sizeof(buffer), MSG_DONTWAIT, (sockaddr*)&remote, &remoteLength);
+
+        if (length > 0 && perimeterPacketType(buffer, length) == PERIMETER_PKT_COMMAND) {
+            PerimeterCommandPacket packet;
+            memcpy(&packet, buffer, sizeof(packet));
+
+            if (!(hasLastCommand && packet.header.sequence == lastCommandSequence)) {
+                PerimeterAckPacket ack;
+                perimeterInitHeader(ack.header, PERIMETER_PKT_ACK, ++sequence);
+                ack.ackSequence = packet.header.sequence;
+                ack.command = packet.command;
+                ack.error = PERIMETER_LINK_OK;
+
+                switch (packet.command) {
+                    case PERIMETER_LINK_START:
+                        if (!sim.running()) {
+                            sim.start(now);
+                        }
+                        break;
+                    case PERIMETER_LINK_STOP:
+                    case PERIMETER_LINK_RESET:
+                        sim.state = PERIMETER_LINK_OFF;
+                        break;
+                    default:
+                        ack.error = PERIMETER_LINK_ERR_REJECTED;
+                        break;
+                }
+                ack.state = sim.state;
+                executed++;
+                printf("[sender] %lu ms: command %d seq %u executed\n", now, packet.command, packet.header.sequence);
+
+                hasLastCommand = true;
+                lastCommandSequence = packet.header.sequence;
+                lastAck = ack;
+            } else {
+                printf("[sender] %lu ms: retransmit seq %u - ack resent\n", now, packet.header.sequence);
+            }
+
+            if (dropFirstAck && !ackDropped) {
+                ackDropped = true;
+                printf("[sender] %lu ms: dropping ack\n", now);
+            } else {
+                sendto(sock, &lastAck, sizeof(lastAck), 0, (sockaddr*)&remote, remoteLength);
+            }
+        }
+
+        bool wireBroken = breakMs >= 0 && sim.running() && (long)sim.runtime(now) >= breakMs;
+        sim.update(now, wireBroken);
+
+        uint8_t error = sim.linkError();
+        if (now - lastHeartbeat >= HEARTBEAT_INTERVAL || sim.state != lastState || error != lastError) {
+            lastHeartbeat = now;
+            lastState = sim.state;
+            lastError = error;
+
+            PerimeterHeartbeat heartbeat;
+            perimeterInitHeader(heartbeat.header, PERIMETER_PKT_HEARTBEAT, ++sequence);
+            heartbeat.state = sim.state;
+            heartbeat.error = error;
+            heartbeat.currentMA = (uint16_t)sim.amplitudeMA;
+            heartbeat.cycleCount = sim.cycleCount;
+            heartbeat.runtimeMs = sim.runtime(now);
+            heartbeat.uptimeMs = now + 60000;   // Som en sender der har kørt et stykke tid
+            sendto(sock, &heartbeat, sizeof(heartbeat), 0, (sockaddr*)&mower, sizeof(mower));
+        }
+    }
+
+    printf("[sender] commands executed: %d\n", executed);
+    close(sock);
+    return 0;
+}
@@ -0,0 +1,99 @@
+#!/usr/bin/env python3
+"""
+Perimeter link test - kører sender og robot side af UDP kanalen på loopback
+
+Bygger link_sender (mod perimeterwire_sender/src/web/PerimeterProtocol.h)
+og link_mower (mod src/system/PerimeterProtocol.h) som to host processer,
+så en uoverensstemmelse mellem de to protokol filer også fanges. Senderen
+taber det første ack, så robottens gensendelse og senderens dublet filter
+testes, og simulerer derefter et kabelbrud.
+
+Kør:
+    python3 tools/perimeter_link/run.py
+
+Kræver en C++17 compiler (g++ eller clang++, vælges med CXX) og at UDP
+port 4210/4211 er ledige på 127.0.0.1.
+"""
+
+import os
+import re
+import subprocess
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+ROOT = os.path.normpath(os.path.join(HERE, "..", ".."))
+BUILD = os.path.join(HERE, ".build")
+
+TARGETS = {
+    "link_sender": os.path.join(ROOT, "perimeterwire_sender", "src", "web"),
+    "link_mower": os.path.join(ROOT, "src", "system"),
+}
+
+BREAK_MS = 1500         # Kabelbrud efter start
+MAX_DETECT_MS = 400     # WIRE_FAULT_CYCLES kode cyklusser + heartbeat
+DURATION_MS = 5000      # Senderen stopper herefter - robotten skal opdage tabt link
+
+
+def build(name, include):
+    os.makedirs(BUILD, exist_ok=True)
+    binary = os.path.join(BUILD, name)
+    source = os.path.join(HERE, name + ".cpp")
+    header = os.path.join(include, "PerimeterProtocol.h")
+
+    if os.path.exists(binary):
+        built = os.path.getmtime(binary)
+        if os.path.getmtime(source) <= built and os.path.getmtime(header) <= built:
+            return binary
+
+    cxx = os.environ.get("CXX", "g++")
+    cmd = [cxx, "-std=gnu++17", "-O1", "-Wall", "-I", include, "-o", binary, source]
+    result = subprocess.run(cmd)
+    if result.returncode != 0:
+        sys.exit(result.returncode)
+    return binary
+
+
+def main():
+    print("Building perimeter link tools...", file=sys.stderr)
+    sender_bin = build("link_sender", TARGETS["link_sender"])
+    mower_bin = build("link_mower", TARGETS["link_mower"])
+
+    # Robotten først, så det første heartbeat ikke går tabt
+    mower = subprocess.Popen([mower_bin, "--break-ms", str(BREAK_MS), "--max-detect-ms", str(MAX_DETECT_MS)],
+                             stdout=subprocess.PIPE, text=True)
+    sender = subprocess.Popen([sender_bin, "--break-ms", str(BREAK_MS), "--duration-ms", str(DURATION_MS),
+                               "--drop-first-ack"], stdout=subprocess.PIPE, text=True)
+
+    try:
+        mower_out, _ = mower.communicate(timeout=30)
+        sender_out, _ = sender.communicate(timeout=30)
+    except subprocess.TimeoutExpired:
+        mower.kill()
+        sender.kill()
+        print("FAIL: timeout")
+        sys.exit(1)
+
+    print(sender_out, end="")
+    print(mower_out, end="")
+
+    failures = []
+    if mower.returncode != 0:
+        failures.append("mower checks failed")
+    if sender.returncode != 0:
+        failures.append("sender exited with %d" % sender.returncode)
+
+    executed = re.search(r"commands executed: (\d+)", sender_out)
+    if not executed or executed.group(1) != "1":
+        failures.append("retransmitted command was executed more than once")
+    if "retransmit" not in sender_out:
+        failures.append("lost ack was not retransmitted")
+
+    if failures:
+        for failure in failures:
+            print("FAIL: " + failure)
+        sys.exit(1)
+    print("PASS")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,70 @@
+#!/usr/bin/env python3
+"""
+Wire follow test - bygger og kører WireFollower mod en simuleret robot
+
+Oversætter PerimeterReceiver, Motors, WireFollower og DockingController
+sammen med fault harness' Arduino shim og Plant (tools/fault_harness) og
+kører magnitude sweeps, lukket sløjfe kabel følgning og indkørsel til
+ladestationen på virtuel tid. Se wire_follow.cpp.
+
+Kør:
+    python3 tools/wire_follow/run.py
+
+Kræver en C++17 compiler (g++ eller clang++, vælges med CXX).
+"""
+
+import glob
+import os
+import subprocess
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+ROOT = os.path.normpath(os.path.join(HERE, "..", ".."))
+SRC = os.path.join(ROOT, "src")
+HARNESS = os.path.join(ROOT, "tools", "fault_harness")
+BUILD = os.path.join(HERE, ".build")
+
+SOURCES = [
+    os.path.join(HERE, "wire_follow.cpp"),
+    os.path.join(HARNESS, "Plant.cpp"),
+    os.path.join(HARNESS, "BlackBoxStub.cpp"),
+    # Koden der testes - uændret fra firmwaren
+    os.path.join(SRC, "system", "Logger.cpp"),
+    os.path.join(SRC, "hardware", "Motors.cpp"),
+    os.path.join(SRC, "hardware", "PerimeterReceiver.cpp"),
+    os.path.join(SRC, "navigation", "WireFollower.cpp"),
+    os.path.join(SRC, "navigation", "DockingController.cpp"),
+]
+
+
+def build():
+    os.makedirs(BUILD, exist_ok=True)
+    binary = os.path.join(BUILD, "wire_follow")
+
+    # Byg kun igen hvis en kilde er nyere end binæren
+    inputs = SOURCES + glob.glob(os.path.join(HARNESS, "shim", "*.h")) + [os.path.join(HARNESS, "Plant.h")]
+    inputs += glob.glob(os.path.join(SRC, "**", "*.h"), recursive=True)
+    if os.path.exists(binary):
+        built = os.path.getmtime(binary)
+        if all(os.path.getmtime(path) <= built for path in inputs):
+            return binary
+
+    cxx = os.environ.get("CXX", "g++")
+    cmd = [cxx, "-std=gnu++17", "-O1", "-Wall", "-Wno-unused-variable",
+           "-I", os.path.join(HARNESS, "shim"), "-I", HARNESS, "-I", SRC,
+           "-o", binary] + SOURCES + ["-lm"]
+    print("Building wire follow test...", file=sys.stderr)
+    result = subprocess.run(cmd)
+    if result.returncode != 0:
+        sys.exit(result.returncode)
+    return binary
+
+
+def main():
+    flags = [a for a in sys.argv[1:] if a.startswith("-")]
+    binary = build()
+    sys.exit(subprocess.run([binary] + flags).returncode)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,269 @@
+/**
+ * Wire follow test - kører WireFollower mod en simuleret robot ved kablet
+ *
+ * De rigtige PerimeterReceiver, Motors og WireFollower oversættes mod fault
+ * harness' Arduino shim og Plant. Plant genererer perimeter signalet; her
+ * styres dets amplitude ud fra robottens afstand til kablet med samme model
+ * som modtageren bruger uden kalibrering (styrke = magnitude / 10,
+ * afstand = 100 - styrke).
+ *
+ * Test:
+ *   sweep   Magnitude fra ingen signal til på kablet, inden for og uden for.
+ *           Sideafstanden skal være monoton og kontinuert - også gennem
+ *           ON_WIRE båndet, hvor WIRE_FOLLOW_OFFSET_CM ligger.
+ *   follow  Lukket sløjfe fra 60 cm og 10 cm inden for kablet. Robotten skal
+ *           falde til ro ved WIRE_FOLLOW_OFFSET_CM uden at integralet
+ *           mættes og uden at styringen slår fra side til side. Desuden en
+ *           perimeter omgang i 70 cm afstand med klippefart (setTarget()).
+ *   dock    Hjemkørsel mod ladestationen. Signalstyrken stiger på de sidste
+ *           50-100 cm før docken (ladestationens felt); DockingController skal
+ *           skifte til slutindkørsel inden docken og ramme kontakterne i
+ *           første forsøg.
+ *
+ * Kør:
+ *     python3 tools/wire_follow/run.py
+ */
+
+#include "Plant.h"
+#include "config/Config.h"
+#include "system/Logger.h"
+#include "hardware/Motors.h"
+#include "hardware/PerimeterReceiver.h"
+#include "navigation/WireFollower.h"
+#include "navigation/DockingController.h"
+
+#define SWEEP_STEP_MAGNITUDE    10      // Magnitude skridt i sweep
+#define SWEEP_SETTLE_MS         300     // Glatning falder til ro pr. skridt
+#define SWEEP_MAX_JUMP_CM       3.0     // Største spring mellem to skridt (cm)
+#define FOLLOW_DURATION_MS      40000   // Simuleret tid i lukket sløjfe
+#define FOLLOW_SETTLE_MS        20000   // Målingen starter efter (ms)
+#define FOLLOW_MAX_ERROR_CM     5.0     // Største middel afvigelse efter indsvingning (cm)
+#define FOLLOW_MAX_SATURATED    0.05    // Største andel af tiden med mættet styring
+#define DOCK_DISTANCE_CM        800     // Kørsel langs kablet til docken (cm)
+#define DOCK_TIMEOUT_MS         120000  // Simuleret tid før testen opgiver
+
+// Samme model som PerimeterReceiver uden kalibrering (boost = ekstra styrke i %)
+static float magnitudeAt(float distanceCm, float boost = 0.0) {
+    return constrain(10.0f * (100.0f - fabsf(distanceCm) + boost), 0.0f, 1000.0f);
+}
+
+static void setSignal(float magnitude, bool inside) {
+    plant.perimeter = inside ? SIGNAL_INSIDE : SIGNAL_OUTSIDE;
+    plant.perimeterScale = magnitude / PLANT_PERIMETER_RMS;
+}
+
+// Differential drev: x langs kablet, y = afstand (inden for positiv),
+// theta = vinkel mod kablet (positiv = drejet mod kablet, som er til venstre)
+struct Pose {
+    float x;
+    float y;
+    float theta;
+};
+
+static void movePose(Pose& pose, float dt) {
+    float left = ((int)plant.pwmDuty[MOTOR_LEFT_RPWM] - (int)plant.pwmDuty[MOTOR_LEFT_LPWM]) *
+                 CRUISE_SPEED_CM_S / MOTOR_CRUISE_SPEED;
+    float right = ((int)plant.pwmDuty[MOTOR_RIGHT_RPWM] - (int)plant.pwmDuty[MOTOR_RIGHT_LPWM]) *
+                  CRUISE_SPEED_CM_S / MOTOR_CRUISE_SPEED;
+    float speed = (left + right) / 2.0;
+    pose.theta += (right - left) / WHEEL_TRACK_CM * dt;
+    pose.x += speed * cosf(pose.theta) * dt;
+    pose.y -= speed * sinf(pose.theta) * dt;
+}
+
+// Kør modtageren i ms virtuel tid med dens egen sample takt
+static void runReceiver(PerimeterReceiver& receiver, unsigned long ms) {
+    uint64_t end = plant.nowUs + (uint64_t)ms * 1000;
+    while (plant.nowUs < end) {
+        receiver.update();
+        delayMicroseconds(52);
+    }
+}
+
+static bool sweep(bool inside) {
+    plantReset();
+    PerimeterReceiver receiver;
+    receiver.begin();
+
+    bool pass = true;
+    bool first = true;
+    float last = 0.0;
+    float maxJump = 0.0;
+    float closest = 1000.0;
+
+    for (int magnitude = 100; magnitude <= 1000; magnitude += SWEEP_STEP_MAGNITUDE) {
+        setSignal(magnitude, inside);
+        runReceiver(receiver, SWEEP_SETTLE_MS);
+
+        float offset = receiver.getLateralOffset();
+        float expected = inside ? 100.0 - magnitude / 10.0 : -(100.0 - magnitude / 10.0);
+        closest = min(closest, fabsf(fabsf(offset) - WIRE_FOLLOW_OFFSET_CM));
+
+        if ((inside && offset < 0.0) || (!inside && offset > 0.0)) {
+            printf("  FAIL  magnitude %d: offset %.1f cm on the wrong side\n", magnitude, offset);
+            pass = false;
+        }
+        if (fabsf(offset - expected) > SWEEP_MAX_JUMP_CM) {
+            printf("  FAIL  magnitude %d: offset %.1f cm, expected %.1f cm\n", magnitude, offset, expected);
+            pass = false;
+        }
+        if (!first) {
+            maxJump = max(maxJump, fabsf(offset - last));
+        }
+        last = offset;
+        first = false;
+    }
+
+    bool continuous = maxJump <= SWEEP_MAX_JUMP_CM;
+    bool reachesSetpoint = closest <= SWEEP_MAX_JUMP_CM;
+    printf("  %s  sweep %-8s max step %.1f cm, closest to setpoint %.1f cm\n",
+           (pass && continuous && reachesSetpoint) ? "PASS" : "FAIL",
+           inside ? "inside" : "outside", maxJump, closest);
+    return pass && continuous && reachesSetpoint;
+}
+
+static bool follow(float startCm, float targetCm = WIRE_FOLLOW_OFFSET_CM, int maxSpeed = WIRE_FOLLOW_SPEED_MAX) {
+    plantReset();
+    Motors motors;
+    PerimeterReceiver receiver;
+    WireFollower follower;
+    motors.begin();
+    receiver.begin();
+    follower.begin(&motors, &receiver);
+
+    Pose pose = { 0.0, startCm, 0.0 };
+    follower.setTarget(targetCm, maxSpeed);
+
+    uint64_t startUs = plant.nowUs;
+    uint64_t lastUs = startUs;
+    double errorSum = 0.0;
+    double maxIntegral = 0.0;
+    unsigned long samples = 0;
+    unsigned long saturated = 0;
+
+    while (plant.nowUs - startUs < (uint64_t)FOLLOW_DURATION_MS * 1000) {
+        setSignal(magnitudeAt(pose.y), pose.y >= 0.0);
+        receiver.update();
+        follower.update();
+        delayMicroseconds(52);
+
+        movePose(pose, (plant.nowUs - lastUs) / 1000000.0);
+        lastUs = plant.nowUs;
+
+        if (plant.nowUs - startUs >= (uint64_t)FOLLOW_SETTLE_MS * 1000) {
+            errorSum += fabsf(pose.y - targetCm);
+            maxIntegral = max(maxIntegral, (double)fabsf(follower.getIntegral()));
+            if (abs(follower.getSteering()) >= WIRE_FOLLOW_STEER_MAX) {
+                saturated++;
+            }
+            samples++;
+        }
+    }
+
+    float meanError = errorSum / samples;
+    float saturatedShare = (float)saturated / samples;
+    bool wound = maxIntegral >= WIRE_FOLLOW_I_MAX;
+    bool pass = meanError <= FOLLOW_MAX_ERROR_CM && saturatedShare <= FOLLOW_MAX_SATURATED && !wound;
+
+    printf("  %s  follow %3.0f -> %2.0f cm  mean error %.1f cm, saturated %.0f%%, |I| max %.1f PWM\n",
+           pass ? "PASS" : "FAIL", startCm, targetCm, meanError, saturatedShare * 100.0, maxIntegral);
+    return pass;
+}
+
+static bool dock(float boost, float rampCm) {
+    plantReset();
+    Motors motors;
+    PerimeterReceiver receiver;
+    WireFollower follower;
+    DockingController docking;
+    motors.begin();
+    receiver.begin();
+    follower.begin(&motors, &receiver);
+    docking.begin(&motors, &receiver);
+
+    // Robotten følger allerede kablet i ønsket afstand når hjemkørslen starter
+    Pose pose = { 0.0, WIRE_FOLLOW_OFFSET_CM, 0.0 };
+    docking.startDocking();
+
+    uint64_t startUs = plant.nowUs;
+    uint64_t lastUs = startUs;
+    float approachX = -1.0;
+    int backoffs = 0;
+    DockPhase phase = DOCK_FOLLOW;
+    DockPhase last = phase;
+
+    while (plant.nowUs - startUs < (uint64_t)DOCK_TIMEOUT_MS * 1000) {
+        // Ladestationens felt: styrken stiger op til 'boost' % ved docken
+        float ramp = constrain((pose.x - (DOCK_DISTANCE_CM - rampCm)) / rampCm, 0.0f, 1.0f);
+        setSignal(magnitudeAt(pose.y, boost * ramp), pose.y >= 0.0);
+
+        // Kontakterne rammer kun når robotten kører ind i DOCK_WIRE_OFFSET_CM afstand
+        bool atDock = pose.x >= DOCK_DISTANCE_CM &&
+                      fabsf(pose.y - DOCK_WIRE_OFFSET_CM) <= DOCK_ALIGN_TOLERANCE_CM;
+        plant.pinLevel[DOCK_CONTACT_PIN] = atDock ? HIGH : LOW;
+
+        // Som handleReturningState() i main.cpp
+        receiver.update();
+        docking.update();
+        phase = docking.updateApproach();
+        if (phase == DOCK_DOCKED || phase == DOCK_FAILED) {
+            break;
+        }
+        if (!docking.isApproaching()) {
+            follower.update();
+        }
+        delayMicroseconds(52);
+
+        if (phase != last) {
+            if (phase == DOCK_APPROACH && approachX < 0.0) {
+                approachX = pose.x;
+            }
+            if (phase == DOCK_BACKOFF) {
+                backoffs++;
+            }
+            last = phase;
+        }
+
+        movePose(pose, (plant.nowUs - lastUs) / 1000000.0);
+        lastUs = plant.nowUs;
+    }
+
+    // Slutindkørslen skal være startet inden docken, ellers er den ikke testet
+    bool pass = phase == DOCK_DOCKED && backoffs == 0 && approachX >= 0.0 && approachX < DOCK_DISTANCE_CM;
+    printf("  %s  dock +%2.0f%% / %3.0f cm  %s, approach from %.0f cm, %d retries\n",
+           pass ? "PASS" : "FAIL", boost, rampCm, docking.getPhaseName(),
+           approachX >= 0.0 ? DOCK_DISTANCE_CM - approachX : 0.0, backoffs);
+    return pass;
+}
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-v") == 0) {
+            plant.verbose = true;
+        }
+    }
+
+    Logger::begin();
+
+    int failed = 0;
+    int total = 0;
+
+    printf("Lateral offset sweep\n");
+    failed += !sweep(true);
+    failed += !sweep(false);
+    total += 2;
+
+    printf("Wire following\n");
+    failed += !follow(60.0);
+    failed += !follow(10.0);
+    failed += !follow(WIRE_FOLLOW_OFFSET_CM, 70.0, MOTOR_CRUISE_SPEED);
+    total += 3;
+
+    printf("Docking approach\n");
+    failed += !dock(10.0, 100.0);
+    failed += !dock(14.0, 50.0);
+    total += 2;
+
+    printf("\n%d of %d tests passed\n", total - failed, total);
+    return failed == 0 ? 0 : 1;
+}